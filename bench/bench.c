@@ -0,0 +1,851 @@
+/* Microbenchmark harness for schema-compare
+ *
+ * Builds a synthetic DDL corpus in memory and times the hot paths:
+ * lexing, statement parsing, per-table comparison, hash table operations,
+ * CREATE TABLE generation and the report/migration generators.
+ *
+ * Each benchmark runs warm-up iterations followed by timed repetitions and
+ * reports the median and p99 per iteration. Results can be written as JSON
+ * and compared against a previous run with --baseline.
+ */
+#define _GNU_SOURCE
+#include "lexer.h"
+#include "parser.h"
+#include "compare.h"
+#include "report.h"
+#include "sql_generator.h"
+#include "sc_memory.h"
+#include "trace.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#define BENCH_MAX_SAMPLES 10000
+#define BENCH_COUNTER_COUNT 4
+/* Peak RSS growth allowed over a parse soak once the allocator has warmed up */
+#define SOAK_RSS_TOLERANCE_KB 1024
+
+/* Harness options */
+typedef struct {
+    int tables;
+    int columns;
+    int warmup;
+    int reps;
+    bool counters;
+    const char *filter;
+    const char *json_file;
+    const char *baseline_file;
+    const char *corpus_file;
+    const char *drift_corpus_file;
+    int soak;
+} BenchOptions;
+
+/* Shared fixture built once before the benchmarks run */
+typedef struct {
+    char *source_ddl;
+    char *target_ddl;
+    size_t source_bytes;
+    CreateTableStmt **source_tables;
+    CreateTableStmt **target_tables;
+    CreateTableStmt **paired_targets;  /* target_tables matched to source order by name */
+    int table_count;
+    int target_table_count;
+    int pair_count;
+    int statement_count;
+    SchemaDiff *diff;
+    CompareOptions *compare_opts;
+    ReportOptions *report_opts;
+    SQLGenOptions *sql_opts;
+    char **hash_keys;
+    int hash_key_count;
+} BenchFixture;
+
+/* One benchmark: run() performs a single iteration covering 'items' units */
+typedef struct {
+    const char *name;
+    const char *unit;
+    void (*run)(BenchFixture *fx);
+    double (*items)(const BenchFixture *fx);
+} Benchmark;
+
+/* Result of one benchmark */
+typedef struct {
+    const char *name;
+    const char *unit;
+    double items;
+    int samples;
+    double median_ns;
+    double p99_ns;
+    double min_ns;
+    double mean_ns;
+    bool has_counters;
+    double counters[BENCH_COUNTER_COUNT];
+} BenchResult;
+
+static const char *counter_names[BENCH_COUNTER_COUNT] = {
+    "cycles", "instructions", "branch_misses", "cache_misses"
+};
+
+/* Keep the optimizer from discarding benchmark results */
+static volatile size_t bench_sink;
+
+/* ========== Hardware counters ========== */
+
+#ifdef __linux__
+static int counter_fds[BENCH_COUNTER_COUNT] = {-1, -1, -1, -1};
+
+static int perf_open(uint64_t config, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = group_fd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+static bool counters_open(void) {
+    static const uint64_t configs[BENCH_COUNTER_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_MISSES
+    };
+
+    for (int i = 0; i < BENCH_COUNTER_COUNT; i++) {
+        counter_fds[i] = perf_open(configs[i], i == 0 ? -1 : counter_fds[0]);
+        if (counter_fds[i] < 0) {
+            for (int j = 0; j < i; j++) {
+                close(counter_fds[j]);
+                counter_fds[j] = -1;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+static void counters_close(void) {
+    for (int i = 0; i < BENCH_COUNTER_COUNT; i++) {
+        if (counter_fds[i] >= 0) {
+            close(counter_fds[i]);
+            counter_fds[i] = -1;
+        }
+    }
+}
+
+static void counters_start(void) {
+    ioctl(counter_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(counter_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+static bool counters_stop(uint64_t values[BENCH_COUNTER_COUNT]) {
+    ioctl(counter_fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    uint64_t buf[1 + BENCH_COUNTER_COUNT];
+    if (read(counter_fds[0], buf, sizeof(buf)) != (ssize_t)sizeof(buf) ||
+        buf[0] != BENCH_COUNTER_COUNT) {
+        return false;
+    }
+    memcpy(values, buf + 1, sizeof(uint64_t) * BENCH_COUNTER_COUNT);
+    return true;
+}
+#else
+static bool counters_open(void) { return false; }
+static void counters_close(void) {}
+static void counters_start(void) {}
+static bool counters_stop(uint64_t values[BENCH_COUNTER_COUNT]) { (void)values; return false; }
+#endif
+
+/* ========== Corpus ========== */
+
+/* Generate a CREATE TABLE corpus. The 'drift' variant changes every fourth
+ * table (type change, dropped column, added column, nullability change). */
+static char *build_corpus(int tables, int columns, bool drift, int *statements) {
+    static const char *types[] = {
+        "integer", "bigint", "varchar(64)", "text", "numeric(12,2)",
+        "timestamptz", "boolean", "uuid", "jsonb", "date"
+    };
+    int type_count = (int)(sizeof(types) / sizeof(types[0]));
+
+    StringBuilder *sb = sb_create();
+    *statements = 0;
+
+    for (int t = 0; t < tables; t++) {
+        bool drifted = drift && (t % 4) == 1;
+
+        sb_append_fmt(sb, "CREATE TABLE bench_t%05d (\n", t);
+        sb_append(sb, "    id bigint PRIMARY KEY");
+
+        for (int c = 1; c < columns; c++) {
+            if (drifted && c == columns - 1) {
+                continue;  /* dropped column */
+            }
+
+            const char *type = types[(t + c) % type_count];
+            if (drifted && c == 1) {
+                type = "bigint";
+            }
+
+            sb_append_fmt(sb, ",\n    c%02d %s", c, type);
+            if (c % 3 == 0) {
+                sb_append(sb, drifted ? "" : " NOT NULL");
+            }
+            if (c % 5 == 0 && strcmp(type, "integer") == 0) {
+                sb_append(sb, " DEFAULT 0");
+            }
+        }
+
+        if (drifted) {
+            sb_append(sb, ",\n    extra_col text");
+        }
+
+        if (t > 0 && t % 3 == 0) {
+            sb_append_fmt(sb, ",\n    parent_id bigint REFERENCES bench_t%05d (id)", t - 1);
+        }
+        if (columns > 2) {
+            sb_append_fmt(sb, ",\n    CONSTRAINT bench_t%05d_uq UNIQUE (c01, c02)", t);
+        }
+        sb_append(sb, "\n);\n\n");
+        (*statements)++;
+    }
+
+    char *ddl = sb_to_string(sb);
+    sb_free(sb);
+    return ddl;
+}
+
+/* Parse DDL and take ownership of the resulting table statements */
+static CreateTableStmt **parse_tables(const char *ddl, int *count) {
+    *count = 0;
+
+    Parser *parser = parser_create(ddl);
+    if (!parser) {
+        return NULL;
+    }
+
+    Schema *schema = parse_all_statements(parser);
+    CreateTableStmt **tables = NULL;
+    for (int i = 0; schema && i < schema->type_count; i++) {
+        free_create_type_stmt(schema->types[i]);
+    }
+    for (int i = 0; schema && i < schema->index_count; i++) {
+        free_create_index_stmt(schema->indexes[i]);
+    }
+    if (schema && schema->table_count > 0) {
+        tables = malloc(sizeof(CreateTableStmt *) * schema->table_count);
+        if (tables) {
+            memcpy(tables, schema->tables, sizeof(CreateTableStmt *) * schema->table_count);
+            *count = schema->table_count;
+        }
+    }
+
+    parser_destroy(parser);
+    return tables;
+}
+
+/* Count statements in a corpus read from disk */
+static int count_statements(const char *ddl) {
+    int count = 0;
+    for (const char *p = ddl; (p = strstr(p, "CREATE ")) != NULL; p += 7) {
+        count++;
+    }
+    return count;
+}
+
+/* Match each source table to the target table of the same name */
+static bool pair_tables(BenchFixture *fx) {
+    fx->paired_targets = calloc(fx->table_count, sizeof(CreateTableStmt *));
+    HashTable *by_name = hash_table_create(fx->target_table_count * 2 + 1);
+    if (!fx->paired_targets || !by_name) {
+        hash_table_destroy(by_name);
+        return false;
+    }
+
+    for (int i = 0; i < fx->target_table_count; i++) {
+        hash_table_insert(by_name, fx->target_tables[i]->table_name, fx->target_tables[i]);
+    }
+    for (int i = 0; i < fx->table_count; i++) {
+        fx->paired_targets[i] = hash_table_get(by_name, fx->source_tables[i]->table_name);
+        fx->pair_count += fx->paired_targets[i] != NULL;
+    }
+
+    hash_table_destroy(by_name);
+    return true;
+}
+
+static bool fixture_init(BenchFixture *fx, const BenchOptions *opts) {
+    memset(fx, 0, sizeof(*fx));
+
+    if (opts->corpus_file) {
+        /* Corpus from tools/schema_gen (--single-file); target defaults to the source */
+        const char *target_file = opts->drift_corpus_file ? opts->drift_corpus_file
+                                                          : opts->corpus_file;
+        fx->source_ddl = read_file_to_string(opts->corpus_file);
+        fx->target_ddl = read_file_to_string(target_file);
+        if (!fx->source_ddl || !fx->target_ddl) {
+            fprintf(stderr, "Error: Failed to read corpus: %s\n",
+                    fx->source_ddl ? target_file : opts->corpus_file);
+            return false;
+        }
+        fx->statement_count = count_statements(fx->source_ddl);
+    } else {
+        int target_statements = 0;
+        fx->source_ddl = build_corpus(opts->tables, opts->columns, false, &fx->statement_count);
+        fx->target_ddl = build_corpus(opts->tables, opts->columns, true, &target_statements);
+        if (!fx->source_ddl || !fx->target_ddl) {
+            return false;
+        }
+    }
+    fx->source_bytes = strlen(fx->source_ddl);
+
+    fx->source_tables = parse_tables(fx->source_ddl, &fx->table_count);
+    fx->target_tables = parse_tables(fx->target_ddl, &fx->target_table_count);
+    if (!fx->source_tables || !fx->target_tables) {
+        fprintf(stderr, "Error: Failed to parse benchmark corpus (%d/%d tables)\n",
+                fx->table_count, fx->target_table_count);
+        return false;
+    }
+    if (!pair_tables(fx)) {
+        return false;
+    }
+
+    fx->compare_opts = compare_options_default();
+    fx->report_opts = report_options_default();
+    fx->report_opts->use_color = false;
+    fx->report_opts->verbosity = REPORT_VERBOSITY_DETAILED;
+    fx->sql_opts = sql_gen_options_default();
+
+    Schema source_schema = {0};
+    Schema target_schema = {0};
+    source_schema.tables = fx->source_tables;
+    source_schema.table_count = fx->table_count;
+    target_schema.tables = fx->target_tables;
+    target_schema.table_count = fx->target_table_count;
+    fx->diff = compare_schemas(&source_schema, &target_schema, fx->compare_opts, NULL);
+    if (!fx->diff) {
+        return false;
+    }
+
+    fx->hash_key_count = 10000;
+    fx->hash_keys = malloc(sizeof(char *) * fx->hash_key_count);
+    if (!fx->hash_keys) {
+        return false;
+    }
+    for (int i = 0; i < fx->hash_key_count; i++) {
+        char key[64];
+        snprintf(key, sizeof(key), "schema_%d.table_name_%05d", i % 7, i);
+        fx->hash_keys[i] = strdup(key);
+    }
+
+    return true;
+}
+
+static void fixture_free(BenchFixture *fx) {
+    schema_diff_free(fx->diff);
+    for (int i = 0; i < fx->table_count; i++) {
+        free_create_table_stmt(fx->source_tables[i]);
+    }
+    for (int i = 0; i < fx->target_table_count; i++) {
+        free_create_table_stmt(fx->target_tables[i]);
+    }
+    free(fx->source_tables);
+    free(fx->target_tables);
+    free(fx->paired_targets);
+    for (int i = 0; i < fx->hash_key_count; i++) {
+        free(fx->hash_keys[i]);
+    }
+    free(fx->hash_keys);
+    compare_options_free(fx->compare_opts);
+    report_options_free(fx->report_opts);
+    sql_gen_options_free(fx->sql_opts);
+    free(fx->source_ddl);
+    free(fx->target_ddl);
+}
+
+/* ========== Benchmarks ========== */
+
+static void bench_lexer(BenchFixture *fx) {
+    Lexer lexer;
+    lexer_init(&lexer, fx->source_ddl);
+
+    size_t tokens = 0;
+    while (true) {
+        Token token = lexer_next_token(&lexer);
+        TokenType type = token.type;
+        lexer_free_token(&token);
+        tokens++;
+        if (type == TOKEN_EOF || type == TOKEN_ERROR) {
+            break;
+        }
+    }
+    lexer_cleanup(&lexer);
+    bench_sink += tokens;
+}
+
+static double items_lexer(const BenchFixture *fx) {
+    return (double)fx->source_bytes;
+}
+
+static void bench_parse(BenchFixture *fx) {
+    int count = 0;
+    CreateTableStmt **tables = parse_tables(fx->source_ddl, &count);
+    for (int i = 0; i < count; i++) {
+        free_create_table_stmt(tables[i]);
+    }
+    free(tables);
+    bench_sink += (size_t)count;
+}
+
+static double items_parse(const BenchFixture *fx) {
+    return (double)fx->statement_count;
+}
+
+static void bench_compare_tables(BenchFixture *fx) {
+    for (int i = 0; i < fx->table_count; i++) {
+        if (!fx->paired_targets[i]) {
+            continue;
+        }
+        TableDiff *diff = compare_tables(fx->source_tables[i], fx->paired_targets[i],
+                                         fx->compare_opts, NULL);
+        bench_sink += diff ? (size_t)diff->diff_count : 0;
+        table_diff_free(diff);
+    }
+}
+
+static double items_tables(const BenchFixture *fx) {
+    return (double)fx->table_count;
+}
+
+static double items_pairs(const BenchFixture *fx) {
+    return (double)fx->pair_count;
+}
+
+static void bench_hash_table(BenchFixture *fx) {
+    HashTable *ht = hash_table_create(fx->hash_key_count);
+    for (int i = 0; i < fx->hash_key_count; i++) {
+        hash_table_insert(ht, fx->hash_keys[i], fx->hash_keys[i]);
+    }
+    for (int i = 0; i < fx->hash_key_count; i++) {
+        bench_sink += hash_table_get(ht, fx->hash_keys[i]) != NULL;
+    }
+    hash_table_destroy(ht);
+}
+
+static double items_hash_table(const BenchFixture *fx) {
+    return (double)fx->hash_key_count * 2.0;
+}
+
+static void bench_create_table_sql(BenchFixture *fx) {
+    StringBuilder *sb = sb_create();
+    for (int i = 0; i < fx->table_count; i++) {
+        generate_create_table_sql(sb, fx->source_tables[i], fx->sql_opts);
+    }
+    char *sql = sb_to_string(sb);
+    bench_sink += strlen(sql);
+    free(sql);
+    sb_free(sb);
+}
+
+static void bench_report_text(BenchFixture *fx) {
+    fx->report_opts->format = REPORT_FORMAT_TEXT;
+    char *report = generate_report(fx->diff, fx->report_opts);
+    bench_sink += report ? strlen(report) : 0;
+    free(report);
+}
+
+static void bench_report_markdown(BenchFixture *fx) {
+    fx->report_opts->format = REPORT_FORMAT_MARKDOWN;
+    char *report = generate_report(fx->diff, fx->report_opts);
+    bench_sink += report ? strlen(report) : 0;
+    free(report);
+}
+
+static void bench_migration_sql(BenchFixture *fx) {
+    SQLMigration *migration = generate_migration_sql(fx->diff, fx->sql_opts);
+    bench_sink += migration ? (size_t)migration->statement_count : 0;
+    sql_migration_free(migration);
+}
+
+static double items_one(const BenchFixture *fx) {
+    (void)fx;
+    return 1.0;
+}
+
+static const Benchmark benchmarks[] = {
+    {"lexer",               "bytes",      bench_lexer,            items_lexer},
+    {"parse_statements",    "statements", bench_parse,            items_parse},
+    {"compare_tables",      "pairs",      bench_compare_tables,   items_pairs},
+    {"hash_table",          "ops",        bench_hash_table,       items_hash_table},
+    {"create_table_sql",    "tables",     bench_create_table_sql, items_tables},
+    {"report_text",         "reports",    bench_report_text,      items_one},
+    {"report_markdown",     "reports",    bench_report_markdown,  items_one},
+    {"migration_sql",       "migrations", bench_migration_sql,    items_one},
+};
+
+/* ========== Harness ========== */
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, int n, double pct) {
+    if (n <= 0) {
+        return 0.0;
+    }
+    int idx = (int)(pct / 100.0 * (n - 1) + 0.5);
+    if (idx >= n) {
+        idx = n - 1;
+    }
+    return sorted[idx];
+}
+
+static void run_benchmark(const Benchmark *bench, BenchFixture *fx,
+                          const BenchOptions *opts, bool counters_ok,
+                          BenchResult *result) {
+    memset(result, 0, sizeof(*result));
+    result->name = bench->name;
+    result->unit = bench->unit;
+    result->items = bench->items(fx);
+    result->samples = opts->reps;
+
+    for (int i = 0; i < opts->warmup; i++) {
+        bench->run(fx);
+    }
+
+    double *samples = malloc(sizeof(double) * opts->reps);
+    uint64_t totals[BENCH_COUNTER_COUNT] = {0};
+    bool have_counters = counters_ok;
+
+    for (int i = 0; i < opts->reps; i++) {
+        if (have_counters) {
+            counters_start();
+        }
+
+        uint64_t start = trace_now_ns();
+        bench->run(fx);
+        uint64_t end = trace_now_ns();
+
+        if (have_counters) {
+            uint64_t values[BENCH_COUNTER_COUNT];
+            if (counters_stop(values)) {
+                for (int c = 0; c < BENCH_COUNTER_COUNT; c++) {
+                    totals[c] += values[c];
+                }
+            } else {
+                have_counters = false;
+            }
+        }
+
+        samples[i] = (double)(end - start);
+    }
+
+    double sum = 0.0;
+    for (int i = 0; i < opts->reps; i++) {
+        sum += samples[i];
+    }
+    qsort(samples, opts->reps, sizeof(double), compare_doubles);
+
+    result->median_ns = percentile(samples, opts->reps, 50.0);
+    result->p99_ns = percentile(samples, opts->reps, 99.0);
+    result->min_ns = samples[0];
+    result->mean_ns = sum / opts->reps;
+
+    if (have_counters) {
+        result->has_counters = true;
+        for (int c = 0; c < BENCH_COUNTER_COUNT; c++) {
+            result->counters[c] = (double)totals[c] / opts->reps / result->items;
+        }
+    }
+
+    free(samples);
+}
+
+/* Find "median_ns" for a benchmark in a previous JSON result file */
+static bool baseline_median(const char *json, const char *name, double *median) {
+    char needle[128];
+    snprintf(needle, sizeof(needle), "\"name\": \"%s\"", name);
+
+    const char *entry = strstr(json, needle);
+    if (!entry) {
+        return false;
+    }
+
+    const char *end = strchr(entry, '}');
+    const char *field = strstr(entry, "\"median_ns\":");
+    if (!field || (end && field > end)) {
+        return false;
+    }
+
+    *median = strtod(field + strlen("\"median_ns\":"), NULL);
+    return *median > 0.0;
+}
+
+static void print_result(const BenchResult *r, const char *baseline_json) {
+    double per_item = r->median_ns / r->items;
+    double throughput = r->items / (r->median_ns / 1e9);
+
+    printf("%-20s %12.3f %12.3f %12.1f %14.0f %s/s",
+           r->name, r->median_ns / 1e6, r->p99_ns / 1e6, per_item, throughput, r->unit);
+
+    if (strcmp(r->unit, "bytes") == 0) {
+        printf(" (%.1f MB/s)", throughput / (1024.0 * 1024.0));
+    }
+
+    double base = 0.0;
+    if (baseline_json && baseline_median(baseline_json, r->name, &base)) {
+        printf("  [%+.1f%% vs baseline]", 100.0 * (r->median_ns - base) / base);
+    }
+    printf("\n");
+
+    if (r->has_counters) {
+        printf("%-20s", "");
+        for (int c = 0; c < BENCH_COUNTER_COUNT; c++) {
+            printf(" %s/%s=%.1f", counter_names[c], r->unit, r->counters[c]);
+        }
+        printf("\n");
+    }
+}
+
+static char *results_to_json(const BenchResult *results, int count, const BenchOptions *opts) {
+    StringBuilder *sb = sb_create();
+
+    sb_append(sb, "{\n");
+    sb_append_fmt(sb, "  \"tables\": %d,\n  \"columns\": %d,\n  \"warmup\": %d,\n  \"reps\": %d,\n",
+                  opts->tables, opts->columns, opts->warmup, opts->reps);
+    sb_append(sb, "  \"benchmarks\": [\n");
+
+    for (int i = 0; i < count; i++) {
+        const BenchResult *r = &results[i];
+        sb_append_fmt(sb, "    {\"name\": \"%s\", \"unit\": \"%s\", \"items\": %.0f, "
+                      "\"samples\": %d, \"median_ns\": %.0f, \"p99_ns\": %.0f, "
+                      "\"min_ns\": %.0f, \"mean_ns\": %.0f, \"per_item_ns\": %.3f, "
+                      "\"items_per_sec\": %.1f",
+                      r->name, r->unit, r->items, r->samples, r->median_ns, r->p99_ns,
+                      r->min_ns, r->mean_ns, r->median_ns / r->items,
+                      r->items / (r->median_ns / 1e9));
+        if (r->has_counters) {
+            sb_append(sb, ", \"counters_per_item\": {");
+            for (int c = 0; c < BENCH_COUNTER_COUNT; c++) {
+                sb_append_fmt(sb, "%s\"%s\": %.3f", c ? ", " : "", counter_names[c], r->counters[c]);
+            }
+            sb_append_char(sb, '}');
+        }
+        sb_append_fmt(sb, "}%s\n", i + 1 < count ? "," : "");
+    }
+
+    sb_append(sb, "  ]\n}\n");
+
+    char *json = sb_to_string(sb);
+    sb_free(sb);
+    return json;
+}
+
+/* ========== Parse soak ========== */
+
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : -1;
+}
+
+/* Parse the source corpus repeatedly; every allocation is released each
+ * round, so peak RSS must stay flat after the first rounds */
+static int run_soak(BenchFixture *fx, int iterations) {
+    int warmup = iterations / 10 > 0 ? iterations / 10 : 1;
+    long start_kb = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        bench_parse(fx);
+        if (i + 1 == warmup) {
+            start_kb = peak_rss_kb();
+        }
+    }
+    long end_kb = peak_rss_kb();
+
+    printf("Parse soak: %d iterations over %d statements\n", iterations, fx->statement_count);
+    printf("Peak RSS after %d iterations: %ld KB, after %d: %ld KB (%+ld KB)\n",
+           warmup, start_kb, iterations, end_kb, end_kb - start_kb);
+    if (start_kb < 0 || end_kb - start_kb > SOAK_RSS_TOLERANCE_KB) {
+        fprintf(stderr, "Error: RSS grew by more than %d KB during the soak\n", SOAK_RSS_TOLERANCE_KB);
+        return 1;
+    }
+    return 0;
+}
+
+static void print_usage(const char *program_name) {
+    printf("Usage: %s [OPTIONS]\n\n", program_name);
+    printf("Options:\n");
+    printf("  -t, --tables N        Tables in the synthetic corpus (default: 500)\n");
+    printf("  -c, --columns N       Columns per table (default: 12)\n");
+    printf("      --corpus FILE     Use a single-file corpus from schema-gen instead\n");
+    printf("      --drift-corpus FILE  Target corpus to compare against (default: --corpus)\n");
+    printf("  -w, --warmup N        Warm-up iterations per benchmark (default: 3)\n");
+    printf("  -r, --reps N          Timed repetitions per benchmark (default: 30)\n");
+    printf("  -b, --bench NAME      Run only benchmarks whose name contains NAME\n");
+    printf("  -j, --json FILE       Write results as JSON to FILE\n");
+    printf("  -B, --baseline FILE   Compare medians against a previous JSON result\n");
+    printf("  -p, --counters        Read hardware counters via perf_event_open\n");
+    printf("      --soak[=N]        Parse the corpus N times (default: 1000) and fail\n");
+    printf("                        if peak RSS keeps growing\n");
+    printf("  -l, --list            List benchmarks\n");
+    printf("  -h, --help            Show this help message\n");
+}
+
+int main(int argc, char **argv) {
+    BenchOptions opts = {
+        .tables = 500,
+        .columns = 12,
+        .warmup = 3,
+        .reps = 30,
+        .counters = false,
+        .filter = NULL,
+        .json_file = NULL,
+        .baseline_file = NULL,
+        .corpus_file = NULL,
+        .drift_corpus_file = NULL,
+        .soak = 0
+    };
+
+    static struct option long_options[] = {
+        {"tables",   required_argument, 0, 't'},
+        {"columns",  required_argument, 0, 'c'},
+        {"warmup",   required_argument, 0, 'w'},
+        {"reps",     required_argument, 0, 'r'},
+        {"bench",    required_argument, 0, 'b'},
+        {"json",     required_argument, 0, 'j'},
+        {"baseline", required_argument, 0, 'B'},
+        {"counters", no_argument,       0, 'p'},
+        {"list",     no_argument,       0, 'l'},
+        {"help",     no_argument,       0, 'h'},
+        {"corpus",   required_argument, 0, 1000},
+        {"drift-corpus", required_argument, 0, 1001},
+        {"soak",     optional_argument, 0, 1002},
+        {0, 0, 0, 0}
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "t:c:w:r:b:j:B:plh", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 't': opts.tables = atoi(optarg); break;
+            case 'c': opts.columns = atoi(optarg); break;
+            case 'w': opts.warmup = atoi(optarg); break;
+            case 'r': opts.reps = atoi(optarg); break;
+            case 'b': opts.filter = optarg; break;
+            case 'j': opts.json_file = optarg; break;
+            case 'B': opts.baseline_file = optarg; break;
+            case 'p': opts.counters = true; break;
+            case 1000: opts.corpus_file = optarg; break;
+            case 1001: opts.drift_corpus_file = optarg; break;
+            case 1002: opts.soak = optarg ? atoi(optarg) : 1000; break;
+            case 'l':
+                for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+                    printf("%s\n", benchmarks[i].name);
+                }
+                return 0;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (opts.tables < 1 || opts.columns < 1 || opts.warmup < 0 ||
+        opts.reps < 1 || opts.reps > BENCH_MAX_SAMPLES || opts.soak < 0) {
+        fprintf(stderr, "Error: Invalid benchmark options\n");
+        return 1;
+    }
+
+    log_init(NULL, LOG_LEVEL_ERROR);
+
+    char *baseline_json = NULL;
+    if (opts.baseline_file) {
+        baseline_json = read_file_to_string(opts.baseline_file);
+        if (!baseline_json) {
+            fprintf(stderr, "Error: Failed to read baseline: %s\n", opts.baseline_file);
+            return 1;
+        }
+    }
+
+    BenchFixture fx;
+    if (!fixture_init(&fx, &opts)) {
+        fprintf(stderr, "Error: Failed to build benchmark fixture\n");
+        fixture_free(&fx);
+        free(baseline_json);
+        return 1;
+    }
+    if (opts.corpus_file) {
+        opts.tables = fx.table_count;
+    }
+
+    if (opts.soak > 0) {
+        int status = run_soak(&fx, opts.soak);
+        fixture_free(&fx);
+        free(baseline_json);
+        log_shutdown();
+        return status;
+    }
+
+    bool counters_ok = false;
+    if (opts.counters) {
+        counters_ok = counters_open();
+        if (!counters_ok) {
+            fprintf(stderr, "Warning: Hardware counters unavailable (perf_event_open failed)\n");
+        }
+    }
+
+    printf("Corpus: %d tables x %d columns, %zu bytes; warm-up %d, reps %d\n\n",
+           fx.table_count, opts.columns, fx.source_bytes, opts.warmup, opts.reps);
+    printf("%-20s %12s %12s %12s %14s\n", "Benchmark", "Median ms", "P99 ms", "ns/item", "Throughput");
+
+    int bench_count = (int)(sizeof(benchmarks) / sizeof(benchmarks[0]));
+    BenchResult *results = calloc(bench_count, sizeof(BenchResult));
+    int result_count = 0;
+
+    for (int i = 0; i < bench_count; i++) {
+        if (opts.filter && !strstr(benchmarks[i].name, opts.filter)) {
+            continue;
+        }
+        run_benchmark(&benchmarks[i], &fx, &opts, counters_ok, &results[result_count]);
+        print_result(&results[result_count], baseline_json);
+        result_count++;
+    }
+
+    int status = 0;
+    if (opts.json_file) {
+        char *json = results_to_json(results, result_count, &opts);
+        if (json && write_string_to_file(opts.json_file, json)) {
+            printf("\nResults written to: %s\n", opts.json_file);
+        } else {
+            fprintf(stderr, "Error: Failed to write results to %s\n", opts.json_file);
+            status = 1;
+        }
+        free(json);
+    }
+
+    if (counters_ok) {
+        counters_close();
+    }
+    free(results);
+    free(baseline_json);
+    fixture_free(&fx);
+    log_shutdown();
+
+    return status;
+}
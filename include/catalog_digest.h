@@ -0,0 +1,36 @@
+#ifndef CATALOG_DIGEST_H
+#define CATALOG_DIGEST_H
+
+/*
+ * Catalog digest of one table: md5 over its kind, persistence, columns
+ * (name, type, NOT NULL, identity, default, collation) and constraints, as
+ * the server stores them. The expression reads the pg_class row aliased
+ * "c". Introspection records it for every table it reads, and generated
+ * migrations recompute it for the tables they touch, so that a migration
+ * refuses to run against a table that changed after it was generated.
+ * Both sides must use this exact text.
+ *
+ * Only raw catalog values go in: type OIDs and modifiers, node trees of
+ * defaults and CHECK expressions, and key column numbers. format_type,
+ * pg_get_expr and pg_get_constraintdef qualify names by search_path, which
+ * the introspecting and the applying session need not share; the rendered
+ * definition is kept only for primary keys and unique constraints (for
+ * INCLUDE columns and options), which name no schema objects.
+ */
+#define CATALOG_TABLE_DIGEST_SQL \
+    "md5(concat_ws('|', c.relkind::text, c.relpersistence::text, " \
+    "(SELECT string_agg(concat_ws(' ', a.attname::text, a.atttypid::text, a.atttypmod::text, " \
+    "a.attnotnull::text, a.attidentity::text, d.adbin::text, " \
+    "a.attcollation::text), ',' ORDER BY a.attnum) " \
+    "FROM pg_attribute a " \
+    "LEFT JOIN pg_attrdef d ON d.adrelid = a.attrelid AND d.adnum = a.attnum " \
+    "WHERE a.attrelid = c.oid AND a.attnum > 0 AND NOT a.attisdropped), " \
+    "(SELECT string_agg(concat_ws(' ', con.conname::text, con.contype::text, " \
+    "con.condeferrable::text, con.condeferred::text, con.convalidated::text, " \
+    "con.conkey::text, con.confrelid::text, con.confkey::text, con.confupdtype::text, " \
+    "con.confdeltype::text, con.confmatchtype::text, con.conbin::text, " \
+    "CASE WHEN con.contype IN ('p', 'u') THEN pg_get_constraintdef(con.oid) END), " \
+    "',' ORDER BY con.conname) " \
+    "FROM pg_constraint con WHERE con.conrelid = c.oid)))"
+
+#endif /* CATALOG_DIGEST_H */
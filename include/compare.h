@@ -5,7 +5,9 @@
 #include "pg_create_table.h"
 #include "diff.h"
 #include "sc_memory.h"
+#include "pg_table_layout.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /* Forward declarations */
 typedef struct Schema Schema;
@@ -50,6 +52,35 @@ void compare_all_tables(CreateTableStmt **source_tables, int source_count,
                           const CompareOptions *opts,
                           MemoryContext *mem_ctx);
 
+/* Diff one table pair; either side may be NULL (added/removed table) */
+TableDiff *compare_table_pair(const CreateTableStmt *source, const CreateTableStmt *target,
+                              const CompareOptions *opts,
+                              MemoryContext *mem_ctx);
+
+/* Compare types - helper for compare_schemas(). Needs both schemas so that
+ * columns storing a type that must be recreated can be converted. */
+void compare_all_types(const Schema *source, const Schema *target,
+                       SchemaDiff *result,
+                       const CompareOptions *opts,
+                       MemoryContext *mem_ctx);
+
+/* Diff one type pair; either side may be NULL (added/removed type) */
+TypeDiff *compare_type_pair(const CreateTypeStmt *source, const CreateTypeStmt *target,
+                            const CompareOptions *opts,
+                            MemoryContext *mem_ctx);
+
+/* Compare indexes - helper for compare_schemas(). Indexes are paired by
+ * name, then by signature so that renames are not rebuilt. */
+void compare_all_indexes(const Schema *source, const Schema *target,
+                         SchemaDiff *result,
+                         const CompareOptions *opts,
+                         MemoryContext *mem_ctx);
+
+/* Canonical definition of an index (without name, storage and tablespace)
+ * and its 64-bit hash; equal signatures mean interchangeable indexes */
+char *index_canonical_form(const CreateIndexStmt *stmt);
+uint64_t index_signature(const CreateIndexStmt *stmt);
+
 /* Compare two individual tables */
 TableDiff *compare_tables(const CreateTableStmt *source, const CreateTableStmt *target,
                          const CompareOptions *opts,
@@ -61,6 +92,12 @@ void compare_columns(const CreateTableStmt *source, const CreateTableStmt *targe
                     const CompareOptions *opts,
                     MemoryContext *mem_ctx);
 
+/* Compare the columns of two table layouts (compare_columns builds them) */
+void compare_column_layouts(const TableLayout *source, const TableLayout *target,
+                            TableDiff *result,
+                            const CompareOptions *opts,
+                            MemoryContext *mem_ctx);
+
 /* Compare individual columns */
 ColumnDiff *compare_column_details(const ColumnDef *source, const ColumnDef *target,
                                   const CompareOptions *opts,
@@ -72,6 +109,12 @@ void compare_constraints(const CreateTableStmt *source, const CreateTableStmt *t
                         const CompareOptions *opts,
                         MemoryContext *mem_ctx);
 
+/* Compare the constraints of two table layouts */
+void compare_constraint_layouts(const TableLayout *source, const TableLayout *target,
+                                TableDiff *result,
+                                const CompareOptions *opts,
+                                MemoryContext *mem_ctx);
+
 /* Compare individual constraints */
 bool constraints_equivalent(const TableConstraint *c1, const TableConstraint *c2,
                            const CompareOptions *opts);
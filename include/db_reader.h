@@ -5,6 +5,7 @@
 #include "pg_create_table.h"
 #include "sc_memory.h"
 #include <libpq-fe.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include "pg_schema.h"
 
@@ -24,6 +25,8 @@ typedef struct {
     DBConfig config;
     bool connected;
     char *last_error;
+    unsigned int prepared;   /* CatalogQuery bits prepared on this session */
+    const atomic_int *interrupt;  /* nonzero: run no further catalog queries (NULL: none) */
 } DBConnection;
 
 /* Schema introspection options */
@@ -49,14 +52,76 @@ const char *db_get_error(DBConnection *conn);
 char *db_escape_identifier(const char *identifier);
 char *db_build_conninfo(const DBConfig *config);
 
+/* db_pool.c - connections kept open across requests, per target */
+typedef struct DBPool DBPool;
+
+typedef struct {
+    int connects;    /* new connections opened */
+    int reused;      /* acquisitions served from the pool */
+    int discarded;   /* connections closed as broken or surplus */
+    int idle;        /* connections currently idle */
+    int targets;     /* distinct targets seen */
+} DBPoolStats;
+
+DBPool *db_pool_create(int max_idle);
+void db_pool_destroy(DBPool *pool);
+DBConnection *db_pool_acquire(DBPool *pool, const DBConfig *config);
+void db_pool_release(DBPool *pool, DBConnection *conn, bool healthy);
+void db_pool_get_stats(DBPool *pool, DBPoolStats *stats);
+
 /* db_table.c */
 CreateTableStmt **db_read_all_tables(DBConnection *conn, const char *schema_name,
                                         int *table_count, MemoryContext *mem_ctx);
+bool db_read_schema_objects(DBConnection *conn, const char *schema_name,
+                            Schema *schema, MemoryContext *mem_ctx);
 CreateTableStmt *db_read_table(DBConnection *conn, const char *schema,
                                const char *table_name, MemoryContext *mem_ctx);
 bool db_populate_table_info(DBConnection *conn, const char *schema,
                             CreateTableStmt **stmts, int stmt_count,
                             MemoryContext *mem_ctx);
+CreateTableStmt **db_read_tables(DBConnection *conn, const char *schema_name,
+                                 const char *const *names, int name_count,
+                                 MemoryContext *mem_ctx);
+
+/* db_catalog.c - catalog queries, prepared once per connection */
+typedef enum {
+    CATALOG_TABLE_LIST,
+    CATALOG_TYPES,
+    CATALOG_INDEXES,
+    CATALOG_TABLE_INFO,
+    CATALOG_COLUMNS,
+    CATALOG_CONSTRAINTS,
+    CATALOG_DRIFT,
+    CATALOG_QUERY_COUNT
+} CatalogQuery;
+
+PGresult *db_catalog_exec(DBConnection *conn, CatalogQuery query, const char *schema,
+                          CreateTableStmt **stmts, int stmt_count);
+PGresult *db_catalog_exec_params(DBConnection *conn, CatalogQuery query,
+                                 const char *const *params);
+bool db_catalog_exec_batch(DBConnection *conn, const CatalogQuery *queries, int count,
+                           const char *schema, PGresult **results);
+CreateTableStmt *db_catalog_row_table(const PGresult *res, int row,
+                                      CreateTableStmt **stmts, int stmt_count);
+
+/* Statement text: $1 is the schema name, $2 the name[] of tables to read */
+extern const char db_table_list_sql[];
+extern const char db_table_info_sql[];
+extern const char db_columns_sql[];        /* $1 the oid[] of tables to read */
+extern const char db_constraints_sql[];    /* $1 the oid[] of tables to read */
+extern const char db_type_sql[];
+extern const char db_index_sql[];
+extern const char db_drift_sql[];    /* $1 the current schema, $2 the desired one */
+
+/* db_type.c - enum, composite and range types */
+CreateTypeStmt **db_types_from_result(PGresult *res, int *type_count, MemoryContext *mem_ctx);
+
+/* db_index.c - indexes not backing a constraint */
+CreateIndexStmt **db_indexes_from_result(PGresult *res, int *index_count, MemoryContext *mem_ctx);
+
+/* db_compare.c - two schemas of one database, compared on the server */
+bool db_read_drift(DBConnection *conn, const char *current_schema, const char *desired_schema,
+                   Schema **current, Schema **desired, MemoryContext *mem_ctx);
 
 /* db_columns.c */
 bool db_populate_columns(DBConnection *conn, const char *schema,
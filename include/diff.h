@@ -2,7 +2,10 @@
 #define DIFF_H
 
 #include "pg_create_table.h"
+#include "pg_create_type.h"
+#include "pg_create_index.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /* Difference types */
 typedef enum {
@@ -27,7 +30,22 @@ typedef enum {
     DIFF_TABLESPACE_CHANGED,
     DIFF_PARTITION_CHANGED,
     DIFF_INHERITS_CHANGED,
-    DIFF_STORAGE_PARAMS_CHANGED
+    DIFF_STORAGE_PARAMS_CHANGED,
+
+    DIFF_ENUM_VALUE_ADDED,
+    DIFF_ENUM_VALUE_RENAMED,
+    DIFF_ENUM_VALUE_REMOVED,
+    DIFF_ENUM_VALUES_REORDERED,
+    DIFF_ATTRIBUTE_ADDED,
+    DIFF_ATTRIBUTE_REMOVED,
+    DIFF_ATTRIBUTE_TYPE_CHANGED,
+    DIFF_ATTRIBUTES_REORDERED,
+    DIFF_TYPE_DEFINITION_CHANGED,
+
+    DIFF_INDEX_ADDED,
+    DIFF_INDEX_REMOVED,
+    DIFF_INDEX_MODIFIED,
+    DIFF_INDEX_RENAMED
 } DiffType;
 
 /* Severity levels */
@@ -41,7 +59,7 @@ typedef enum {
 typedef struct Diff {
     DiffType type;
     DiffSeverity severity;
-    char *table_name;    /* Table this diff applies to */
+    char *table_name;    /* Table (or type) this diff applies to */
     char *element_name;  /* Column/constraint name (NULL for table-level diffs) */
     char *old_value;     /* Previous value (NULL for additions) */
     char *new_value;     /* New value (NULL for removals) */
@@ -143,6 +161,96 @@ typedef struct TableDiff {
     struct TableDiff *next;
 } TableDiff;
 
+/* Enum label addition or rename */
+typedef struct EnumValueChange {
+    char *label;         /* Label as desired */
+    char *old_label;     /* Renamed from (NULL for additions) */
+    char *anchor;        /* Additions: existing label to add next to, NULL to append */
+    bool before;         /* Add BEFORE anchor rather than AFTER */
+    struct EnumValueChange *next;
+} EnumValueChange;
+
+/* Column of an existing table that stores a type being recreated */
+typedef struct TypeDependentColumn {
+    char *table_name;
+    char *column_name;
+    char *data_type;     /* As declared, e.g. "mood" or "mood[]" */
+    char *default_expr;  /* Dropped and restored around the conversion */
+    struct TypeDependentColumn *next;
+} TypeDependentColumn;
+
+/* Type-level difference aggregation */
+typedef struct TypeDiff {
+    char *type_name;
+    bool type_added;
+    bool type_removed;
+    bool type_modified;
+    bool requires_recreate;   /* Change ALTER TYPE cannot express (removed/reordered labels...) */
+
+    /* Type definitions for added/removed types and SQL generation */
+    CreateTypeStmt *source_type;    /* NULL if type was added */
+    CreateTypeStmt *target_type;    /* NULL if type was removed */
+
+    /* Enum label changes, in the order they are applied */
+    EnumValueChange *values_added;
+    EnumValueChange *values_renamed;
+    int value_add_count;
+    int value_rename_count;
+
+    /* Composite attribute changes (column_name holds the attribute name) */
+    ColumnDiff *attributes_added;
+    ColumnDiff *attributes_removed;
+    ColumnDiff *attributes_modified;
+    int attribute_add_count;
+    int attribute_remove_count;
+    int attribute_modify_count;
+
+    /* Columns converted when the type is recreated */
+    TypeDependentColumn *dependents;
+
+    /* Generic diff list for all changes */
+    Diff *diffs;
+    int diff_count;
+
+    struct TypeDiff *next;
+} TypeDiff;
+
+/* Index-level difference. Indexes are matched by name, then unmatched ones
+ * by signature so that a renamed index is not rebuilt. */
+typedef struct IndexDiff {
+    char *index_name;         /* Desired name (current name for removals) */
+    char *old_name;           /* Current name when renamed or rebuilt */
+    char *table_name;
+    bool index_added;
+    bool index_removed;
+    bool index_modified;      /* Same name, different definition: rebuilt */
+    bool index_renamed;       /* Same definition, different name */
+    bool table_added;         /* Built together with its new table */
+
+    uint64_t old_signature;
+    uint64_t new_signature;
+
+    /* Index definitions for SQL generation */
+    CreateIndexStmt *source_index;  /* NULL if index was added */
+    CreateIndexStmt *target_index;  /* NULL if index was removed */
+
+    /* Generic diff list for all changes */
+    Diff *diffs;
+    int diff_count;
+
+    struct IndexDiff *next;
+} IndexDiff;
+
+typedef struct HashTable HashTable;
+
+/* A table diff's slot in the SchemaDiff index, with what ordering foreign
+ * keys against it needs to know */
+typedef struct {
+    TableDiff *diff;
+    bool keys_added;          /* Adds a PRIMARY KEY or UNIQUE constraint */
+    bool keys_removed;        /* Drops a PRIMARY KEY or UNIQUE constraint */
+} TableDiffEntry;
+
 /* Schema-level comparison results */
 typedef struct SchemaDiff {
     char *schema_name;
@@ -151,6 +259,12 @@ typedef struct SchemaDiff {
     int tables_added;
     int tables_removed;
     int tables_modified;
+    int types_added;
+    int types_removed;
+    int types_modified;
+    int indexes_added;
+    int indexes_removed;
+    int indexes_modified;
     int total_diffs;
 
     /* Severity breakdown */
@@ -161,6 +275,18 @@ typedef struct SchemaDiff {
     /* Detailed table differences */
     TableDiff *table_diffs;
 
+    /* table_diffs by position and by name (name -> position + 1); set by
+     * schema_diff_index_tables, NULL until then */
+    TableDiffEntry *table_entries;
+    int table_entry_count;
+    HashTable *table_index;
+
+    /* Detailed type differences */
+    TypeDiff *type_diffs;
+
+    /* Detailed index differences */
+    IndexDiff *index_diffs;
+
     /* Quick lookup: added/removed table names */
     char **added_tables;
     char **removed_tables;
@@ -192,10 +318,27 @@ TableDiff *table_diff_create(const char *table_name);
 void table_diff_free(TableDiff *td);
 void table_diff_list_free(TableDiff *list);
 
+/* TypeDiff creation */
+TypeDiff *type_diff_create(const char *type_name);
+void type_diff_free(TypeDiff *td);
+void type_diff_list_free(TypeDiff *list);
+EnumValueChange *enum_value_change_create(const char *label, const char *old_label);
+void enum_value_change_list_free(EnumValueChange *list);
+
+/* IndexDiff creation */
+IndexDiff *index_diff_create(const char *index_name, const char *table_name);
+void index_diff_free(IndexDiff *id);
+void index_diff_list_free(IndexDiff *list);
+
 /* SchemaDiff creation */
 SchemaDiff *schema_diff_create(const char *schema_name);
 void schema_diff_free(SchemaDiff *sd);
 
+/* (Re)build the table index after table_diffs changes; returns false on
+ * allocation failure, leaving the diff unindexed */
+bool schema_diff_index_tables(SchemaDiff *sd);
+const TableDiffEntry *schema_diff_find_table(const SchemaDiff *sd, const char *table_name);
+
 /* Utility functions */
 const char *diff_type_to_string(DiffType type);
 const char *diff_severity_to_string(DiffSeverity severity);
@@ -0,0 +1,55 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "schema_compare.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Progress journal for multi-target runs: one JSON line per finished
+ * target, flushed to disk as it is written, so a run that dies part-way
+ * can be resumed. A later line for the same target replaces earlier ones.
+ *
+ *   {"target":"app@db1:5432/app/public","status":"ok",
+ *    "fingerprint":"9c1e...","output":"migration-app.sql","statements":4}
+ */
+
+typedef enum {
+    JOURNAL_STATUS_OK,
+    JOURNAL_STATUS_FAILED,
+    JOURNAL_STATUS_TIMED_OUT      /* over its time or memory budget */
+} JournalStatus;
+
+typedef struct {
+    const char *target;           /* key from journal_target_key() */
+    JournalStatus status;
+    uint64_t fingerprint;         /* source digest, target, output and options */
+    const char *output;           /* migration file, NULL if none */
+    int statements;
+    const char *error;            /* why it failed, NULL if ok */
+} JournalEntry;
+
+typedef struct Journal Journal;
+
+/* Open a journal for writing. With resume, the entries already in the file
+ * are loaded and new ones are appended; otherwise the file is truncated. A
+ * missing file is not an error when resuming. */
+Journal *journal_open(const char *path, bool resume);
+void journal_close(Journal *journal);
+
+/* Entry loaded from the file at open time, or NULL. Entries appended since
+ * are not visible here, so lookups are safe from any thread. */
+const JournalEntry *journal_lookup(const Journal *journal, const char *target);
+
+/* Targets loaded at open time, optionally only those whose last status is ok */
+int journal_loaded_count(const Journal *journal, bool ok_only);
+
+/* Append one entry and flush it to disk */
+bool journal_append(Journal *journal, const JournalEntry *entry);
+
+/* Stable identity of a target without credentials: user@host:port/db/schema */
+char *journal_target_key(const SchemaSource *target, const char *schema_name);
+
+/* Digest of a schema's table, type and index definitions, for fingerprints */
+uint64_t journal_schema_digest(const Schema *schema);
+
+#endif /* JOURNAL_H */
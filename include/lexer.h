@@ -185,7 +185,8 @@ typedef struct {
     const char *start;         /* start of current token */
     const char *current;       /* current position */
     int line;                  /* current line */
-    int column;                /* current column */
+    int column;                /* current column, in characters */
+    int start_column;          /* column of the current token */
     bool had_error;            /* error flag */
     char *error_message;       /* last error message */
 } Lexer;
@@ -0,0 +1,139 @@
+#ifndef LIBSCHEMACOMPARE_H
+#define LIBSCHEMACOMPARE_H
+
+/* Stable C API of libschemacompare.
+ *
+ * Only this header is installed. All types are opaque, counts are read
+ * through enum-keyed getters, and new functionality is added as new
+ * functions or enum values, so programs built against API 1.x keep working
+ * with later 1.x libraries.
+ *
+ * Objects belong to the SCContext that created them. Schemas and diffs can
+ * be released early; otherwise they live until sc_context_reset() or
+ * sc_context_free(). A context is not thread-safe: use one per thread.
+ *
+ * A context keeps its options and a cache of parsed files and directories
+ * between calls. Loading the same path again returns the cached schema
+ * when no file under it has changed (size, mtime and inode). */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(SC_BUILDING_LIBRARY) && defined(__GNUC__)
+#define SC_API __attribute__((visibility("default")))
+#else
+#define SC_API
+#endif
+
+#define SC_API_VERSION_MAJOR 1
+#define SC_API_VERSION_MINOR 1
+
+/* libpq connection handle (from libpq-fe.h) */
+typedef struct pg_conn PGconn;
+
+typedef struct SCContext SCContext;
+typedef struct SCSchema SCSchema;
+typedef struct SCDiff SCDiff;
+
+typedef enum {
+    SC_OK = 0,
+    SC_ERROR_INVALID_ARG = 1,   /* NULL argument, unknown option or value */
+    SC_ERROR_MEMORY = 2,
+    SC_ERROR_IO = 3,            /* file or directory not readable */
+    SC_ERROR_PARSE = 4,         /* DDL could not be parsed */
+    SC_ERROR_DB = 5,            /* connection not usable or catalog query failed */
+    SC_ERROR_INTERNAL = 6
+} SCStatus;
+
+typedef enum {
+    SC_COUNT_TABLES_ADDED = 0,
+    SC_COUNT_TABLES_REMOVED = 1,
+    SC_COUNT_TABLES_MODIFIED = 2,
+    SC_COUNT_CHANGES = 3,           /* changes in modified tables, types and indexes */
+    SC_COUNT_CRITICAL = 4,
+    SC_COUNT_WARNING = 5,
+    SC_COUNT_INFO = 6,
+    SC_COUNT_STATEMENTS = 7,        /* generates the migration if needed */
+    SC_COUNT_DESTRUCTIVE = 8,       /* 1 if the migration drops or narrows anything */
+    SC_COUNT_TYPES_ADDED = 9,
+    SC_COUNT_TYPES_REMOVED = 10,
+    SC_COUNT_TYPES_MODIFIED = 11,
+    SC_COUNT_INDEXES_ADDED = 12,
+    SC_COUNT_INDEXES_REMOVED = 13,
+    SC_COUNT_INDEXES_MODIFIED = 14    /* rebuilt or renamed */
+} SCDiffCount;
+
+/* Library version: (major << 16) | minor, and as "major.minor (tool version)" */
+SC_API unsigned int sc_version(void);
+SC_API const char *sc_version_string(void);
+SC_API const char *sc_status_string(SCStatus status);
+
+/* Contexts */
+SC_API SCContext *sc_context_create(void);
+SC_API void sc_context_free(SCContext *ctx);
+
+/* Release every schema and diff of the context and clear its cache;
+ * options are kept */
+SC_API void sc_context_reset(SCContext *ctx);
+
+/* Message for the last failed call on this context ("" if none) */
+SC_API const char *sc_context_error(const SCContext *ctx);
+
+/* Options (values are strings; booleans accept true/false, on/off, 1/0):
+ *   schema               schema for sc_introspect when NULL is passed (public)
+ *   transactions         wrap migrations in BEGIN/COMMIT (true)
+ *   if_exists            add IF EXISTS to DROP statements (true)
+ *   comments             add explanatory comments to migrations (true)
+ *   precondition         abort migrations whose touched tables changed since
+ *                        they were introspected (true)
+ *   case_sensitive       compare identifiers case-sensitively (false)
+ *   normalize_types      treat int4/integer etc. as equal (true)
+ *   compare_constraints  include constraints (true)
+ *   compare_tablespaces  include tablespaces (false)
+ *   report_format        text | markdown (text)
+ *   report_verbosity     summary | normal | detailed | verbose (normal) */
+SC_API SCStatus sc_context_set_option(SCContext *ctx, const char *name, const char *value);
+
+/* Sources. File and directory loads are cached per path. */
+SC_API SCStatus sc_load_sql(SCContext *ctx, const char *sql, SCSchema **out);
+SC_API SCStatus sc_load_file(SCContext *ctx, const char *path, SCSchema **out);
+SC_API SCStatus sc_load_directory(SCContext *ctx, const char *path, SCSchema **out);
+
+/* Load a directory to diff against 'reference', another directory load (API
+ * 1.1). Files byte-identical to reference's file of the same relative path
+ * are not parsed and compare as identical; the schema keeps reference alive
+ * until it is released. Not cached. */
+SC_API SCStatus sc_load_directory_against(SCContext *ctx, const char *path,
+                                          SCSchema *reference, SCSchema **out);
+
+/* Introspect through a connection owned by the caller; it is left open and
+ * idle. schema_name NULL uses the "schema" option. */
+SC_API SCStatus sc_introspect(SCContext *ctx, PGconn *conn, const char *schema_name,
+                              SCSchema **out);
+
+SC_API int sc_schema_table_count(const SCSchema *schema);
+SC_API void sc_schema_release(SCSchema *schema);
+
+/* Diff 'current' (e.g. a live database) against 'desired' (e.g. DDL files).
+ * The diff keeps both schemas alive until it is released. */
+SC_API SCStatus sc_compare(SCContext *ctx, SCSchema *current, SCSchema *desired,
+                           SCDiff **out);
+
+SC_API int sc_diff_count(SCDiff *diff, SCDiffCount what);
+
+/* Migration SQL and report text; generated on first use and owned by the
+ * diff, using the context's options at that time */
+SC_API SCStatus sc_diff_sql(SCDiff *diff, const char **sql);
+SC_API SCStatus sc_diff_report(SCDiff *diff, const char **report);
+
+SC_API void sc_diff_release(SCDiff *diff);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBSCHEMACOMPARE_H */
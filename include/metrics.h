@@ -0,0 +1,54 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "diff.h"
+#include <stdbool.h>
+
+/* Run metrics in the Prometheus text format, for the node exporter's
+ * textfile collector (--metrics-file). Each target is recorded as it is
+ * written; the document is built once at the end of the run from those
+ * records, the trace phase totals and counters, and the peak RSS, and
+ * replaces the previous file atomically. */
+
+typedef enum {
+    METRICS_TARGET_PENDING,      /* never written (the run was aborted) */
+    METRICS_TARGET_OK,
+    METRICS_TARGET_FAILED,
+    METRICS_TARGET_SKIPPED,      /* unchanged since an earlier run (--resume) */
+    METRICS_TARGET_TIMED_OUT     /* over its time or memory budget */
+} MetricsTargetStatus;
+
+typedef struct {
+    char *label;                 /* value of the target label */
+    MetricsTargetStatus status;
+    bool has_diff;               /* the counts below are set */
+    int critical_count;
+    int warning_count;
+    int info_count;
+    int tables_added;
+    int tables_removed;
+    int tables_modified;
+    double fetch_ms;
+    double compare_ms;
+} MetricsTarget;
+
+typedef struct {
+    MetricsTarget *targets;
+    int target_count;
+    bool source_ok;
+    double elapsed_ms;
+} Metrics;
+
+Metrics *metrics_create(int target_count);
+void metrics_free(Metrics *metrics);
+
+/* Record one target; diff may be NULL (failed or skipped targets) */
+bool metrics_set_target(Metrics *metrics, int index, const char *label,
+                        MetricsTargetStatus status, const SchemaDiff *diff,
+                        double fetch_ms, double compare_ms);
+
+/* The document (caller frees), and writing it */
+char *metrics_format(const Metrics *metrics);
+bool metrics_write(const Metrics *metrics, const char *filename);
+
+#endif /* METRICS_H */
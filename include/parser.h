@@ -4,6 +4,7 @@
 #include "pg_schema.h"
 #include "pg_create_table.h"
 #include "pg_create_type.h"
+#include "pg_create_index.h"
 #include "lexer.h"
 #include "sc_memory.h"
 #include <stdbool.h>
@@ -42,6 +43,31 @@ ParseError *parser_get_errors(Parser *parser);
 void parser_free_errors(ParseError *errors);
 void parse_result_free(ParseResult *result);
 
+/* Allocation. Everything the parser allocates is tracked in memory_ctx.
+ * The statement parsers mark the context on entry: a statement that parses
+ * completely is released to the caller (free it with free_create_*_stmt),
+ * and everything a failed one allocated is freed at once. */
+void *parser_alloc(Parser *parser, size_t size);
+void *parser_realloc(Parser *parser, void *ptr, size_t size);
+char *parser_strdup(Parser *parser, const char *str);
+char *parser_strndup(Parser *parser, const char *str, size_t n);
+void parser_free(Parser *parser, void *ptr);
+
+/* Mark the context before parsing something that may fail; discard frees
+ * everything allocated since the mark, keep hands it to the caller */
+size_t parser_mark(Parser *parser);
+void parser_discard(Parser *parser, size_t mark);
+void parser_keep(Parser *parser, size_t mark);
+
+/* Text assembled from tokens, grown in the parser's context */
+typedef struct {
+    char *text;
+    size_t len;
+    size_t capacity;
+} ParserText;
+
+bool parser_text_append(Parser *parser, ParserText *pt, const char *str, size_t n);
+
 /* Token navigation functions */
 bool parser_match(Parser *parser, TokenType type);
 bool parser_check(Parser *parser, TokenType type);
@@ -86,5 +112,8 @@ char *parse_data_type(Parser *parser);
 /* parse_type.c */
 CreateTypeStmt *parser_parse_create_type(Parser *parser);
 
+/* parse_index.c */
+CreateIndexStmt *parser_parse_create_index(Parser *parser);
+
 
 #endif /* PARSER_H */
@@ -0,0 +1,39 @@
+#ifndef PG_CREATE_INDEX_H
+#define PG_CREATE_INDEX_H
+
+#include "pg_create_table.h"
+#include <stdbool.h>
+
+/* One key of an index: a column or a parenthesized expression */
+typedef struct {
+    char *column_name;            // Column key, or NULL for an expression
+    char *expression;             // Expression key without its parentheses
+    char *collation;              // Optional COLLATE
+    char *opclass;                // Optional operator class (NULL = default)
+    SortOrder sort_order;
+    NullsOrder nulls_order;
+    bool has_nulls_order;         // NULLS FIRST/LAST given explicitly
+} IndexElement;
+
+/* Main CREATE INDEX structure */
+typedef struct CreateIndexStmt {
+    char *index_name;             // Index name (NULL when omitted)
+    char *table_name;             // Indexed table (may be schema-qualified)
+    bool unique;
+    bool concurrently;
+    bool if_not_exists;
+    bool only;                    // ON ONLY (partitioned parent)
+    bool nulls_not_distinct;      // PG15+
+    char *access_method;          // USING method (NULL = btree)
+
+    IndexElement *elements;       // Key columns/expressions, in order
+    int element_count;
+    char **include_columns;       // INCLUDE (...) non-key columns
+    int include_count;
+
+    StorageParameterList *with_options;
+    char *tablespace_name;
+    char *where_clause;           // Partial index predicate
+} CreateIndexStmt;
+
+#endif /* PG_CREATE_INDEX_H */
@@ -2,6 +2,7 @@
 #define PG_CREATE_TABLE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /* Forward declarations */
 typedef struct ColumnConstraint ColumnConstraint;
@@ -313,15 +314,16 @@ struct ColumnConstraint {
         PrimaryKeyConstraint primary_key;
         ReferencesConstraint references;
     } constraint;
-    bool deferrable;
-    bool not_deferrable;
-    bool initially_deferred;
-    bool initially_immediate;
-    bool enforced;
-    bool not_enforced;
-    bool has_deferrable;
-    bool has_initially;
-    bool has_enforced;
+    /* DEFERRABLE / INITIALLY / ENFORCED clauses, packed one bit each */
+    bool deferrable : 1;
+    bool not_deferrable : 1;
+    bool initially_deferred : 1;
+    bool initially_immediate : 1;
+    bool enforced : 1;
+    bool not_enforced : 1;
+    bool has_deferrable : 1;
+    bool has_initially : 1;
+    bool has_enforced : 1;
     ColumnConstraint *next;
 };
 
@@ -388,15 +390,17 @@ struct TableConstraint {
         ExcludeConstraint exclude;
         ForeignKeyConstraint foreign_key;
     } constraint;
-    bool deferrable;
-    bool not_deferrable;
-    bool initially_deferred;
-    bool initially_immediate;
-    bool enforced;
-    bool not_enforced;
-    bool has_deferrable;
-    bool has_initially;
-    bool has_enforced;
+    uint32_t conoid;         /* pg_constraint.oid, introspected constraints only; 0 otherwise */
+    /* DEFERRABLE / INITIALLY / ENFORCED clauses, packed one bit each */
+    bool deferrable : 1;
+    bool not_deferrable : 1;
+    bool initially_deferred : 1;
+    bool initially_immediate : 1;
+    bool enforced : 1;
+    bool not_enforced : 1;
+    bool has_deferrable : 1;
+    bool has_initially : 1;
+    bool has_enforced : 1;
     TableConstraint *next;
 };
 
@@ -410,6 +414,7 @@ typedef struct {
     char *compression_method;
     char *collation;
     ColumnConstraint *constraints;
+    int attnum;              /* pg_attribute.attnum, introspected columns only; 0 otherwise */
 } ColumnDef;
 
 /* Table element (can be column, constraint, or LIKE) */
@@ -502,6 +507,8 @@ typedef struct {
     OnCommitAction on_commit;
     bool has_on_commit;
     char *tablespace_name;
+    char *catalog_digest;    /* CATALOG_TABLE_DIGEST_SQL, introspected tables only */
+    uint32_t relid;          /* pg_class.oid, introspected tables only; 0 otherwise */
 } CreateTableStmt;
 
 #endif /* PG_CREATE_TABLE_H */
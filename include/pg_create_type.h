@@ -2,6 +2,7 @@
 #define PG_CREATE_TYPE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /* Type variant enumeration */
 typedef enum {
@@ -11,23 +12,34 @@ typedef enum {
     TYPE_VARIANT_BASE
 } TypeVariant;
 
+/* Order-preserving hash index over a type's member names (enum labels or
+ * composite attribute names). Each slot holds a member position + 1, or 0
+ * when empty; hashes holds the members' case-folded name hashes in member
+ * order. Built with the members, in the same block (see type_members.c). */
+typedef struct {
+    uint32_t *hashes;
+    uint32_t *slots;
+    uint32_t mask;                // Slot count - 1
+} TypeMemberIndex;
+
 /* ENUM Type Definition */
 typedef struct {
-    char **labels;                // Array of enum labels
+    char **labels;                // Labels in declaration order
     int label_count;              // Number of labels
+    TypeMemberIndex index;        // Label -> position
 } EnumTypeDef;
 
 /* COMPOSITE Type Definition */
-typedef struct CompositeAttribute {
+typedef struct {
     char *attr_name;
     char *data_type;
     char *collation;              // Optional COLLATE clause
-    struct CompositeAttribute *next;
 } CompositeAttribute;
 
 typedef struct {
-    CompositeAttribute *attributes;  // Linked list of attributes
+    CompositeAttribute *attributes;  // Attributes in declaration order
     int attribute_count;
+    TypeMemberIndex index;        // Attribute name -> position
 } CompositeTypeDef;
 
 /* RANGE Type Definition */
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "pg_create_table.h"
+#include <stddef.h>
 
 typedef enum {
     STMT_TABLE,
@@ -31,15 +32,32 @@ typedef struct SchemaStatement {
     struct SchemaStatement *next;
 } SchemaStatement;
 
+/* One .sql file of a directory load and the statements it contributed, which
+ * are consecutive in the schema's arrays */
+typedef struct SchemaFile {
+    char *path;                  /* relative to the loaded directory */
+    uint64_t digest;             /* FNV-1a over the file's bytes */
+    size_t size;
+    bool shared;                 /* byte-identical to the reference schema's file of
+                                  * the same path: its statements are borrowed */
+    int table_start, table_count;
+    int type_start, type_count;
+    int index_start, index_count;
+} SchemaFile;
+
 /* Schema container for all database objects */
 typedef struct Schema {
     CreateTypeStmt **types;
     int type_count;
     CreateTableStmt **tables;
     int table_count;
+    CreateIndexStmt **indexes;
+    int index_count;
     CreateFunctionStmt **functions;
     int function_count;
     CreateProcedureStmt **procedures;
     int procedure_count;
-    /* Note: Indexes and triggers are stored in table->indexes[] and table->triggers[] */
+    SchemaFile *files;           /* directory loads only; NULL otherwise */
+    int file_count;
+    /* Note: Indexes refer to their table by name; triggers are not stored yet */
 } Schema;
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef PG_TABLE_LAYOUT_H
+#define PG_TABLE_LAYOUT_H
+
+#include "pg_create_table.h"
+#include "sc_memory.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Compact, read-only layout of a regular table's columns and constraints.
+ *
+ * The parser's CreateTableStmt keeps columns and constraints in linked
+ * TableElement / ColumnConstraint chains, one heap node each. A TableLayout
+ * flattens them into contiguous arrays inside a single allocation: the
+ * fields compare reads on every column, bit-packed flags, and strings as
+ * 32-bit offsets into one string table. The AST stays the canonical form;
+ * the view arrays map every layout entry back to its AST node for the code
+ * (SQL generation, diff values) that needs the full definition.
+ */
+
+/* Offset into a layout's string table; 0 stands for NULL */
+typedef uint32_t LayoutString;
+
+/* Constraint clause flags, one bit each */
+typedef struct {
+    unsigned int deferrable : 1;
+    unsigned int not_deferrable : 1;
+    unsigned int initially_deferred : 1;
+    unsigned int initially_immediate : 1;
+    unsigned int enforced : 1;
+    unsigned int not_enforced : 1;
+    unsigned int has_deferrable : 1;
+    unsigned int has_initially : 1;
+    unsigned int has_enforced : 1;
+} ConstraintFlags;
+
+typedef struct {
+    LayoutString name;
+    LayoutString data_type;
+    LayoutString collation;
+    LayoutString compression;
+    LayoutString default_expr;      /* first DEFAULT expression */
+    uint32_t first_constraint;      /* this column's constraints, contiguous */
+    uint32_t constraint_count;
+    uint8_t storage_type;           /* StorageType */
+    unsigned int has_storage : 1;
+    unsigned int not_null : 1;
+} LayoutColumn;
+
+typedef struct {
+    LayoutString name;
+    int32_t column;                 /* owning column, -1 for table constraints */
+    uint8_t type;                   /* TableConstraintType for table constraints,
+                                     * ConstraintType for column constraints */
+    ConstraintFlags flags;
+} LayoutConstraint;
+
+typedef struct {
+    LayoutColumn *columns;
+    uint32_t column_count;
+    /* Table constraints first, then each column's constraints in column order */
+    LayoutConstraint *constraints;
+    uint32_t constraint_count;
+    uint32_t table_constraint_count;
+    char *strings;
+    uint32_t string_size;
+
+    /* View back into the AST, parallel to the arrays above */
+    const ColumnDef **column_defs;
+    const TableConstraint **table_constraint_defs;    /* [0, table_constraint_count) */
+    const ColumnConstraint **column_constraint_defs;  /* the remaining constraints */
+} TableLayout;
+
+/* Build the layout of a regular table (other variants get an empty one).
+ * Returns NULL on allocation failure or if the strings exceed 4 GiB. */
+TableLayout *table_layout_build(const CreateTableStmt *stmt, MemoryContext *mem_ctx);
+void table_layout_free(TableLayout *layout, MemoryContext *mem_ctx);
+
+/* String for an offset, NULL for 0 */
+const char *table_layout_string(const TableLayout *layout, LayoutString ref);
+
+/* AST node behind a column or constraint; the constraint accessors return
+ * NULL when the entry is of the other kind */
+const ColumnDef *table_layout_column_def(const TableLayout *layout, uint32_t column);
+const TableConstraint *table_layout_table_constraint(const TableLayout *layout, uint32_t constraint);
+const ColumnConstraint *table_layout_column_constraint(const TableLayout *layout, uint32_t constraint);
+
+/* Whether two columns have identical definitions, byte for byte */
+bool table_layout_columns_identical(const TableLayout *a, uint32_t a_column,
+                                    const TableLayout *b, uint32_t b_column);
+
+#endif /* PG_TABLE_LAYOUT_H */
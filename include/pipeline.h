@@ -0,0 +1,97 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "schema_compare.h"
+#include <stdbool.h>
+
+/* Staged run over many targets. The source is loaded on its own thread
+ * (unless every target is diffed on the server) while fetch workers connect
+ * to and introspect targets; compare workers diff each target (and generate
+ * its SQL and report) as soon as both sides are ready; the calling thread
+ * writes results in target order while later targets are still being
+ * fetched and compared. Finished targets reach the writer through a
+ * lock-free ring (result_collector.h), so workers never wait on it or on
+ * each other to hand results back. With a time budget, a watchdog thread
+ * cancels the queries of targets that have been fetching for too long. */
+
+#define PIPELINE_DEFAULT_FETCH_JOBS 4
+
+/* Optional hooks, called with pipeline_run's user_data. source_loaded runs
+ * on the source thread before any target is compared; skip runs on a fetch
+ * thread once the source is loaded and may be called concurrently. */
+typedef void (*PipelineSourceFn)(const Schema *source, void *user_data);
+typedef bool (*PipelineSkipFn)(int index, void *user_data);
+
+typedef struct {
+    const SchemaSource *source;
+    SchemaSource *const *targets;
+    int target_count;
+    const char *schema_name;             /* overrides each source's schema; NULL: own or public */
+
+    const CompareOptions *compare_opts;
+    const SQLGenOptions *sql_opts;
+    const ReportOptions *report_opts;
+    bool generate_sql;
+    bool generate_report;
+
+    bool server_side;                    /* diff targets that are another schema of the
+                                          * source's database on the server (db_read_drift) */
+
+    int fetch_jobs;                      /* targets connected/introspected at once (<= 0: default) */
+    int compare_jobs;                    /* targets compared at once (<= 0: online CPUs) */
+
+    /* Budgets for connecting to and reading one database target (0: none).
+     * A target over either is abandoned and reported as timed out; its
+     * running query is cancelled and its memory freed. */
+    double target_timeout_ms;
+    size_t target_memory_limit;          /* bytes of introspected schema */
+
+    PipelineSourceFn source_loaded;
+    PipelineSkipFn skip;                 /* true: target is not fetched or compared */
+} PipelineConfig;
+
+/* One target's results, handed to the writer */
+typedef struct {
+    int index;
+    const SchemaSource *spec;
+    bool ok;                             /* false: error says which stage failed */
+    bool skipped;                        /* PipelineConfig.skip returned true */
+    bool timed_out;                      /* over its time or memory budget (not ok) */
+    char error[256];
+
+    Schema *schema;                      /* introspected target */
+    Schema *desired;                     /* server_side: the source's drifting tables */
+    bool server_side;                    /* diffed on the server */
+    SchemaDiff *diff;
+    SQLMigration *migration;             /* NULL unless generate_sql */
+    char *report;                        /* NULL unless generate_report */
+
+    double fetch_ms;
+    double compare_ms;
+} PipelineTarget;
+
+/* Called on the calling thread once per target, in target order. Returns
+ * false if the target's output could not be written. */
+typedef bool (*PipelineWriteFn)(const PipelineTarget *target, void *user_data);
+
+typedef struct {
+    bool source_ok;
+    int source_table_count;
+    int targets_written;                 /* ok and written */
+    int targets_failed;
+    int targets_timed_out;               /* failed over budget (counted in targets_failed) */
+    int targets_skipped;
+    int targets_server_side;             /* ok and diffed on the server */
+    double elapsed_ms;
+} PipelineSummary;
+
+/* Run the pipeline. Returns false if the source could not be loaded or the
+ * workers could not be started; no target is written in that case. */
+bool pipeline_run(const PipelineConfig *config, PipelineWriteFn write, void *user_data,
+                  PipelineSummary *summary);
+
+/* Load a schema source of any type (connects for database sources) */
+Schema *pipeline_load_source(const SchemaSource *source, const char *schema_name,
+                             char *error, size_t error_size);
+
+#endif /* PIPELINE_H */
@@ -47,6 +47,8 @@ bool write_report_to_file(const SchemaDiff *diff, const char *filename,
 /* Generate report sections */
 char *generate_summary(const SchemaDiff *diff, const ReportOptions *opts);
 char *generate_table_diff_report(const TableDiff *diff, const ReportOptions *opts);
+char *generate_type_diff_report(const TypeDiff *diff, const ReportOptions *opts);
+char *generate_index_diff_report(const IndexDiff *diff, const ReportOptions *opts);
 char *generate_column_diff_report(const ColumnDiff *diff, const ReportOptions *opts);
 char *generate_constraint_diff_report(const ConstraintDiff *diff, const ReportOptions *opts);
 
@@ -0,0 +1,44 @@
+#ifndef RESULT_COLLECTOR_H
+#define RESULT_COLLECTOR_H
+
+#include <stdbool.h>
+
+/* Hands finished targets from pipeline workers to the writer without a
+ * shared lock. Workers push a target's index into a bounded multi-producer,
+ * single-consumer ring as soon as its results are complete; the writer pops
+ * them in whatever order they finish and hands them out in target order.
+ * Outcome counters are atomic, so progress can be read from any thread
+ * while the run is going. */
+
+typedef enum {
+    RESULT_WRITTEN,              /* ok and written */
+    RESULT_FAILED,
+    RESULT_TIMED_OUT,            /* failed over budget (also counted as failed) */
+    RESULT_SKIPPED,
+    RESULT_SERVER_SIDE,          /* written and diffed on the server */
+    RESULT_COUNTER_COUNT
+} ResultCounter;
+
+typedef struct ResultCollector ResultCollector;
+
+/* Collector for targets 0..count-1 */
+ResultCollector *result_collector_create(int count);
+void result_collector_free(ResultCollector *collector);
+
+/* Any thread: target index is finished. Each index is pushed at most once. */
+void result_collector_push(ResultCollector *collector, int index);
+
+/* Any thread: stop handing out targets, and wake the consumer */
+void result_collector_abort(ResultCollector *collector);
+
+/* Consumer only: wait for the next target in order to finish. Returns its
+ * index, or -1 once every target was handed out or the run was aborted. */
+int result_collector_next(ResultCollector *collector);
+
+/* Targets pushed so far (any thread) */
+int result_collector_finished(const ResultCollector *collector);
+
+void result_collector_add(ResultCollector *collector, ResultCounter counter);
+int result_collector_count(const ResultCollector *collector, ResultCounter counter);
+
+#endif /* RESULT_COLLECTOR_H */
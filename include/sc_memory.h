@@ -3,6 +3,7 @@
 
 #include "pg_create_table.h"
 #include "pg_create_type.h"
+#include "pg_create_index.h"
 #include <stddef.h>
 #include <stdbool.h>
 
@@ -14,6 +15,20 @@ MemoryContext *memory_context_create(const char *name);
 void memory_context_destroy(MemoryContext *ctx);
 void memory_context_reset(MemoryContext *ctx);
 
+/* Marks: everything allocated in a context after memory_context_mark() can
+ * be freed (reset_to) or handed over to the caller (release) as a unit */
+size_t memory_context_mark(MemoryContext *ctx);
+void memory_context_reset_to(MemoryContext *ctx, size_t mark);
+void memory_context_release(MemoryContext *ctx, size_t mark);
+
+/* Budget: once more than limit bytes are allocated in the context (0: no
+ * limit), exceeded is called with arg, once, on the allocating thread.
+ * Allocations keep succeeding; the caller decides what to abandon. */
+typedef void (*MemoryLimitFn)(void *arg);
+void memory_context_set_limit(MemoryContext *ctx, size_t limit, MemoryLimitFn exceeded,
+                              void *arg);
+bool memory_context_over_limit(const MemoryContext *ctx);
+
 /* Allocation functions */
 void *mem_alloc(MemoryContext *ctx, size_t size);
 void *mem_calloc(MemoryContext *ctx, size_t nmemb, size_t size);
@@ -47,14 +62,39 @@ ColumnDef *clone_column_def(const ColumnDef *src, MemoryContext *ctx);
 /* CreateTypeStmt construction helpers */
 CreateTypeStmt *create_type_stmt_alloc(MemoryContext *ctx);
 
+/* Enum labels and composite attributes: copied into one block per type
+ * together with their name index. Freeing labels or attributes frees it. */
+bool enum_type_def_init(EnumTypeDef *def, const char *const *labels, int label_count,
+                        MemoryContext *ctx);
+bool composite_type_def_init(CompositeTypeDef *def, const CompositeAttribute *attributes,
+                             int attribute_count, MemoryContext *ctx);
+
+/* Position of a label or attribute, or -1 */
+int enum_type_def_find(const EnumTypeDef *def, const char *label);
+int composite_type_def_find(const CompositeTypeDef *def, const char *name, bool case_sensitive);
+
 /* CreateTypeStmt destruction */
 void free_create_type_stmt(CreateTypeStmt *stmt);
 
 /* Deep copy functions for types */
 CreateTypeStmt *clone_create_type_stmt(const CreateTypeStmt *src, MemoryContext *ctx);
 
+/* CreateIndexStmt construction and destruction */
+CreateIndexStmt *create_index_stmt_alloc(MemoryContext *ctx);
+void free_create_index_stmt(CreateIndexStmt *stmt);
+
 /* Memory statistics (for debugging) */
 size_t memory_context_get_allocated(MemoryContext *ctx);
 void memory_context_stats(MemoryContext *ctx);
 
+/* Process-wide counters over all mem_* allocation calls */
+typedef struct {
+    size_t allocations;   /* mem_alloc, mem_calloc, mem_realloc, mem_strdup, mem_strndup */
+    size_t frees;         /* mem_free */
+    size_t bytes;         /* bytes requested by the allocations */
+} MemoryCounters;
+
+void memory_counters_get(MemoryCounters *counters);
+void memory_counters_reset(void);
+
 #endif /* SC_MEMORY_H */
@@ -36,7 +36,7 @@ typedef struct {
         char *directory_path;    /* For SOURCE_TYPE_DIRECTORY */
     } source;
     char *database_name;         /* Database name (extracted from directory or connection) */
-    char *schema_name;           /* Schema name (for database sources) */
+    char *schema_name;           /* Schema name (directory path or ?schema= of a URI) */
 } SchemaSource;
 
 /* Application context */
@@ -58,6 +58,18 @@ typedef struct {
     bool quiet;
 
     char *schema_name_override;      /* Override schema name from --schema */
+
+    char *trace_file;                /* Chrome trace output from --trace */
+    bool show_timings;               /* Print per-phase timings from --timings */
+    bool watch;                      /* Re-diff on source changes from --watch */
+    int fetch_jobs;                  /* Pipeline fetch workers from --fetch-jobs (0: default) */
+    int compare_jobs;                /* Pipeline compare workers from --compare-jobs (0: CPUs) */
+    char *journal_file;              /* Progress journal from --journal or --resume */
+    bool resume;                     /* Skip targets the journal shows as up to date */
+    bool server_side;                /* Diff same-database targets on the server (--server-side) */
+    char *metrics_file;              /* Prometheus textfile from --metrics-file */
+    double target_timeout;           /* Seconds per target from --target-timeout (0: none) */
+    int target_memory_mb;            /* MB per target from --target-memory (0: none) */
 } AppContext;
 
 /* Initialize and free application context */
@@ -70,6 +82,7 @@ AppContext *parse_command_line(int argc, char **argv);
 /* Parse schema source specification */
 SchemaSource *parse_schema_source(const char *spec);
 void schema_source_free(SchemaSource *source);
+bool schema_sources_share_database(const SchemaSource *a, const SchemaSource *b);
 
 /* Print usage information */
 void print_usage(const char *program_name);
@@ -82,6 +95,15 @@ int compare_and_report(SchemaSource *source, SchemaSource *target, AppContext *c
 Schema *load_from_database(DBConnection *conn, const char *schema_name,
                            MemoryContext *mem_ctx);
 Schema *load_from_file(const char *file_path, MemoryContext *mem_ctx);
+Schema *load_from_string(const char *sql, MemoryContext *mem_ctx);
 Schema *load_from_directory(const char *dir_path, MemoryContext *mem_ctx);
+/* Load a directory to compare with reference, a directory load. Files that are
+ * byte-identical to reference's file of the same relative path are not parsed:
+ * their statements are borrowed from reference, which must outlive the result,
+ * and compare as identical without a deep comparison. */
+Schema *load_from_directory_against(const char *dir_path, const Schema *reference,
+                                    MemoryContext *mem_ctx);
+void schema_free(Schema *schema);
+char **find_sql_files_recursive(const char *dir_path, int *count);
 
 #endif /* SCHEMA_COMPARE_H */
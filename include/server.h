@@ -0,0 +1,44 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "schema_compare.h"
+#include <stdbool.h>
+
+/* Daemon mode: the source schema is loaded once and kept warm, target
+ * connections are pooled, and requests arrive as newline-delimited JSON
+ * objects over a Unix domain socket. Each request gets one JSON line back.
+ *
+ *   {"op":"compare","target":"postgresql://...","schema":"public","format":"text"}
+ *   {"op":"check","target":"postgresql://..."}
+ *   {"op":"generate","target":"postgresql://..."}
+ *   {"op":"reload"} {"op":"stats"} {"op":"ping"} {"op":"shutdown"}
+ *
+ * An optional "id" is echoed back. Responses carry "ok" and "elapsed_ms",
+ * and "error" when ok is false. */
+
+typedef struct {
+    const char *socket_path;        /* Unix socket to listen on */
+    const char *source_spec;        /* --source as given on the command line */
+    const char *schema_name;        /* Default schema (NULL: from source, else public) */
+    int pool_size;                  /* Idle connections kept per target */
+    CompareOptions *compare_opts;   /* Borrowed */
+    ReportOptions *report_opts;     /* Borrowed */
+    SQLGenOptions *sql_opts;        /* Borrowed */
+} ServerConfig;
+
+typedef struct Server Server;
+
+/* Load the source schema and set up the pool; NULL on failure */
+Server *server_create(const ServerConfig *config);
+void server_destroy(Server *server);
+
+/* Handle one request line; returns a malloc'd JSON response (no newline) */
+char *server_handle_request(Server *server, const char *line);
+
+/* True once a shutdown request was handled */
+bool server_should_stop(const Server *server);
+
+/* Listen on config->socket_path until shutdown or SIGINT/SIGTERM */
+int server_run(Server *server);
+
+#endif /* SERVER_H */
@@ -13,6 +13,7 @@ typedef struct {
     bool add_warnings;           /* Add warning comments for destructive ops */
     bool generate_rollback;      /* Generate rollback SQL (future) */
     bool safe_mode;              /* Extra safety checks */
+    bool add_precondition;       /* Abort if touched tables drifted (introspected targets) */
     const char *schema_name;     /* Schema name for qualified identifiers */
 } SQLGenOptions;
 
@@ -42,11 +43,52 @@ bool write_migration_to_file(const SQLMigration *migration, const char *filename
 void generate_create_table_sql(StringBuilder *sb, const CreateTableStmt *stmt, const SQLGenOptions *opts);
 void generate_drop_table_sql(StringBuilder *sb, const char *table_name, const SQLGenOptions *opts);
 
+/* DO block that raises unless the touched tables still have their
+ * introspected catalog digests - returns the number of tables guarded */
+int generate_table_precondition_sql(StringBuilder *sb, const SchemaDiff *diff,
+                                    const SQLGenOptions *opts);
+
 /* Generate migration SQL for all table diffs - returns statement count */
 int generate_table_migration_sql(StringBuilder *sb, const SchemaDiff *diff,
                                   const SQLGenOptions *opts,
                                   bool *has_destructive);
 
+/* ========== TYPE OPERATIONS (sql_generator_type.c) ========== */
+
+void generate_create_type_sql(StringBuilder *sb, const CreateTypeStmt *stmt, const SQLGenOptions *opts);
+void generate_drop_type_sql(StringBuilder *sb, const char *type_name, const SQLGenOptions *opts);
+
+/* ALTER TYPE ... ADD VALUE for modified enums; emitted before BEGIN */
+int generate_enum_value_sql(StringBuilder *sb, const SchemaDiff *diff, const SQLGenOptions *opts);
+
+/* CREATE TYPE, RENAME VALUE, attribute changes and recreations; before tables */
+int generate_type_migration_sql(StringBuilder *sb, const SchemaDiff *diff,
+                                const SQLGenOptions *opts,
+                                bool *has_destructive);
+
+/* DROP TYPE for removed types; after tables */
+int generate_type_drop_sql(StringBuilder *sb, const SchemaDiff *diff,
+                           const SQLGenOptions *opts,
+                           bool *has_destructive);
+
+/* ========== INDEX OPERATIONS (sql_generator_index.c) ========== */
+
+/* Where index statements go relative to the transaction block */
+typedef enum {
+    INDEX_PHASE_DROP,          /* before BEGIN: DROP INDEX CONCURRENTLY */
+    INDEX_PHASE_TRANSACTION,   /* renames, indexes of new tables */
+    INDEX_PHASE_CONCURRENT     /* after COMMIT: CREATE INDEX CONCURRENTLY */
+} IndexMigrationPhase;
+
+void generate_create_index_sql(StringBuilder *sb, const CreateIndexStmt *stmt, const char *name,
+                               bool concurrently, const SQLGenOptions *opts);
+void generate_drop_index_sql(StringBuilder *sb, const char *index_name, const char *table_name,
+                             bool concurrently, const SQLGenOptions *opts);
+
+/* Generate the index statements of one phase - returns statement count */
+int generate_index_migration_sql(StringBuilder *sb, const SchemaDiff *diff,
+                                 const SQLGenOptions *opts, IndexMigrationPhase phase);
+
 /* ========== COLUMN OPERATIONS (sql_generator_column.c) ========== */
 
 void generate_add_column_sql(StringBuilder *sb, const char *table_name, const ColumnDiff *col,
@@ -70,6 +112,7 @@ void generate_drop_constraint_sql(StringBuilder *sb, const char *table_name, con
 /* ========== UTILITIES (sql_generator_util.c) ========== */
 
 void sb_append_identifier(StringBuilder *sb, const char *identifier);
+void sb_append_qualified_identifier(StringBuilder *sb, const char *name);
 void sb_append_literal(StringBuilder *sb, const char *literal);
 char *format_data_type(const char *type);
 
@@ -0,0 +1,85 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Workflow phases used to group spans in the --timings summary */
+typedef enum {
+    TRACE_PHASE_READ,
+    TRACE_PHASE_CONNECT,
+    TRACE_PHASE_INTROSPECT,
+    TRACE_PHASE_PARSE,
+    TRACE_PHASE_COMPARE,
+    TRACE_PHASE_SQLGEN,
+    TRACE_PHASE_WRITE,
+    TRACE_PHASE_OTHER,
+    TRACE_PHASE_COUNT
+} TracePhase;
+
+/* Per-phase totals. A span only counts towards its phase when it is not
+ * nested inside another span of the same phase, so totals are wall time. */
+typedef struct {
+    uint64_t total_ns;
+    uint64_t max_ns;
+    int span_count;
+} TracePhaseStats;
+
+/* Counters reported under the --timings table */
+typedef enum {
+    TRACE_COUNTER_CATALOG_PLANS,        /* catalog statements prepared */
+    TRACE_COUNTER_CATALOG_EXECUTIONS,   /* catalog statements executed */
+    TRACE_COUNTER_CATALOG_BYTES,        /* bytes of catalog result values */
+    TRACE_COUNTER_COUNT
+} TraceCounter;
+
+/* Global switch checked by the TRACE_* macros before any work is done */
+extern bool g_trace_enabled;
+
+/* Tracing lifecycle. trace_init records every span (for the Chrome trace);
+ * trace_init_stats keeps only the phase totals and counters. */
+void trace_init(void);
+void trace_init_stats(void);
+void trace_reset(void);
+void trace_shutdown(void);
+
+/* Monotonic clock in nanoseconds */
+uint64_t trace_now_ns(void);
+
+/* Span API - prefer the macros below, which compile to a single branch
+ * when tracing is disabled. 'name' must be a string literal; 'detail' is
+ * copied and may be NULL. Returns a span handle, or -1 if not recorded. */
+int trace_span_begin(TracePhase phase, const char *name, const char *detail);
+void trace_span_end(int span);
+
+#define TRACE_BEGIN(phase, name, detail) \
+    (g_trace_enabled ? trace_span_begin((phase), (name), (detail)) : -1)
+
+#define TRACE_END(span) do { \
+    if ((span) >= 0) { \
+        trace_span_end(span); \
+    } \
+} while (0)
+
+/* Counters - prefer the macro, which is a single branch when disabled */
+void trace_counter_add(TraceCounter counter, int64_t delta);
+int64_t trace_counter_get(TraceCounter counter);
+const char *trace_counter_name(TraceCounter counter);
+
+#define TRACE_COUNT(counter, delta) do { \
+    if (g_trace_enabled) { \
+        trace_counter_add((counter), (delta)); \
+    } \
+} while (0)
+
+/* Results */
+int trace_event_count(void);
+void trace_get_phase_stats(TracePhase phase, TracePhaseStats *stats);
+const char *trace_phase_name(TracePhase phase);
+
+/* Export */
+char *trace_to_chrome_json(void);
+bool trace_write_chrome_json(const char *filename);
+char *trace_format_timings(void);
+
+#endif /* TRACE_H */
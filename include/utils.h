@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stdarg.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /* String utilities */
 char *str_trim(const char *str);
@@ -22,6 +23,7 @@ StringBuilder *sb_create(void);
 void sb_append(StringBuilder *sb, const char *str);
 void sb_append_char(StringBuilder *sb, char c);
 void sb_append_fmt(StringBuilder *sb, const char *format, ...);
+void sb_append_json_string(StringBuilder *sb, const char *str);
 char *sb_to_string(StringBuilder *sb);
 void sb_free(StringBuilder *sb);
 
@@ -76,9 +78,35 @@ bool hash_table_contains(HashTable *ht, const char *key);
 void hash_table_remove(HashTable *ht, const char *key);
 int hash_table_size(HashTable *ht);
 
+/* 64-bit FNV-1a for fingerprints; chain calls starting from FNV1A_64_INIT */
+#define FNV1A_64_INIT 14695981039346656037ULL
+uint64_t fnv1a_64(uint64_t hash, const void *data, size_t length);
+
+/* UTF-8 validation with a vectorized ASCII fast path */
+bool utf8_validate(const char *data, size_t length, size_t *error_offset);
+
+/* Flat JSON objects (string, number and literal values) */
+typedef struct {
+    char *key;
+    char *value;       /* unescaped string, or raw number/literal text */
+    bool is_string;
+} JsonField;
+
+typedef struct {
+    JsonField *fields;
+    int count;
+} JsonObject;
+
+JsonObject *json_parse_object(const char *text, const char **error);
+const JsonField *json_object_get(const JsonObject *obj, const char *key);
+const char *json_object_get_string(const JsonObject *obj, const char *key);
+void sb_append_json_value(StringBuilder *sb, const JsonField *field);
+void json_object_free(JsonObject *obj);
+
 /* File I/O utilities */
 char *read_file_to_string(const char *filename);
 bool write_string_to_file(const char *filename, const char *content);
+bool write_string_to_file_atomic(const char *filename, const char *content);
 char **read_directory_files(const char *dir_path, const char *extension, int *file_count);
 
 #endif /* UTILS_H */
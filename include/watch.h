@@ -0,0 +1,43 @@
+#ifndef WATCH_H
+#define WATCH_H
+
+#include "schema_compare.h"
+#include <stdbool.h>
+
+/* Watch mode: the source directory is parsed file by file and kept in
+ * memory next to a cached target snapshot. When files change only those
+ * files are re-parsed, and only the tables they define (before or after
+ * the change) are compared again; every other table keeps its cached diff. */
+
+typedef struct WatchSession WatchSession;
+
+/* Work done by the last update */
+typedef struct {
+    int file_count;          /* .sql files tracked */
+    int table_count;         /* source tables across all files */
+    int files_reparsed;      /* files parsed by the last update */
+    int tables_recompared;   /* tables compared by the last update */
+    double update_ms;        /* re-parse plus re-compare time of the last update */
+} WatchStats;
+
+/* Parse every .sql file under dir and diff against current (borrowed,
+ * must outlive the session) */
+WatchSession *watch_session_create(const char *dir, const Schema *current,
+                                   const CompareOptions *opts);
+void watch_session_destroy(WatchSession *session);
+
+/* Re-parse one file, or drop it if it no longer exists */
+bool watch_session_update_file(WatchSession *session, const char *path);
+
+/* Wait up to timeout_ms (-1: forever) for changes under the directory and
+ * apply them. Returns the number of files updated, 0 on timeout or signal,
+ * -1 on error. */
+int watch_session_poll(WatchSession *session, int timeout_ms);
+
+/* Re-compare tables touched since the last call and return the full diff.
+ * The diff belongs to the session and stays valid until the next update. */
+const SchemaDiff *watch_session_diff(WatchSession *session);
+
+void watch_session_get_stats(const WatchSession *session, WatchStats *stats);
+
+#endif /* WATCH_H */
@@ -0,0 +1,570 @@
+#include "libschemacompare.h"
+#include "schema_compare.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+
+#define SC_STRINGIFY_(x) #x
+#define SC_STRINGIFY(x) SC_STRINGIFY_(x)
+
+struct SCSchema {
+    SCContext *ctx;
+    Schema *schema;
+    int refs;                 /* caller handle, cache entry, diffs */
+    char *cache_key;          /* set while the schema is in the source cache */
+    uint64_t fingerprint;
+    SCSchema *reference;      /* lends this schema statements (sc_load_directory_against) */
+    SCSchema *next;
+};
+
+struct SCDiff {
+    SCContext *ctx;
+    SchemaDiff *diff;
+    SCSchema *current;
+    SCSchema *desired;
+    SQLMigration *migration;  /* generated on first use */
+    char *report;             /* generated on first use */
+    SCDiff *next;
+};
+
+struct SCContext {
+    CompareOptions *compare_opts;
+    SQLGenOptions *sql_opts;
+    ReportOptions *report_opts;
+    char *schema_name;
+    SCSchema *schemas;        /* live schemas, cached or referenced */
+    SCDiff *diffs;            /* live diffs */
+    char error[512];
+};
+
+static SCStatus set_error(SCContext *ctx, SCStatus status, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(ctx->error, sizeof(ctx->error), format, args);
+    va_end(args);
+    return status;
+}
+
+unsigned int sc_version(void) {
+    return (SC_API_VERSION_MAJOR << 16) | SC_API_VERSION_MINOR;
+}
+
+const char *sc_version_string(void) {
+    return SC_STRINGIFY(SC_API_VERSION_MAJOR) "." SC_STRINGIFY(SC_API_VERSION_MINOR)
+           " (schema-compare " SCHEMA_COMPARE_VERSION ")";
+}
+
+const char *sc_status_string(SCStatus status) {
+    switch (status) {
+        case SC_OK: return "ok";
+        case SC_ERROR_INVALID_ARG: return "invalid argument";
+        case SC_ERROR_MEMORY: return "out of memory";
+        case SC_ERROR_IO: return "I/O error";
+        case SC_ERROR_PARSE: return "parse error";
+        case SC_ERROR_DB: return "database error";
+        case SC_ERROR_INTERNAL: return "internal error";
+    }
+    return "unknown status";
+}
+
+/* ========== Contexts ========== */
+
+/* Create a context with default options */
+SCContext *sc_context_create(void) {
+    SCContext *ctx = calloc(1, sizeof(SCContext));
+    if (!ctx) {
+        return NULL;
+    }
+
+    ctx->compare_opts = compare_options_default();
+    ctx->sql_opts = sql_gen_options_default();
+    ctx->report_opts = report_options_default();
+    ctx->schema_name = strdup("public");
+    if (!ctx->compare_opts || !ctx->sql_opts || !ctx->report_opts || !ctx->schema_name) {
+        sc_context_free(ctx);
+        return NULL;
+    }
+    ctx->report_opts->use_color = false;
+    return ctx;
+}
+
+static void diff_destroy(SCDiff *diff) {
+    schema_diff_free(diff->diff);
+    sql_migration_free(diff->migration);
+    free(diff->report);
+    free(diff);
+}
+
+static void schema_destroy(SCSchema *schema) {
+    schema_free(schema->schema);
+    free(schema->cache_key);
+    free(schema);
+}
+
+/* Release every schema and diff; keep options */
+void sc_context_reset(SCContext *ctx) {
+    if (!ctx) {
+        return;
+    }
+
+    while (ctx->diffs) {
+        SCDiff *next = ctx->diffs->next;
+        diff_destroy(ctx->diffs);
+        ctx->diffs = next;
+    }
+    while (ctx->schemas) {
+        SCSchema *next = ctx->schemas->next;
+        schema_destroy(ctx->schemas);
+        ctx->schemas = next;
+    }
+    ctx->error[0] = '\0';
+}
+
+void sc_context_free(SCContext *ctx) {
+    if (!ctx) {
+        return;
+    }
+
+    sc_context_reset(ctx);
+    compare_options_free(ctx->compare_opts);
+    sql_gen_options_free(ctx->sql_opts);
+    report_options_free(ctx->report_opts);
+    free(ctx->schema_name);
+    free(ctx);
+}
+
+const char *sc_context_error(const SCContext *ctx) {
+    return ctx ? ctx->error : "";
+}
+
+static bool parse_bool(const char *value, bool *out) {
+    if (strcmp(value, "true") == 0 || strcmp(value, "on") == 0 || strcmp(value, "1") == 0) {
+        *out = true;
+        return true;
+    }
+    if (strcmp(value, "false") == 0 || strcmp(value, "off") == 0 || strcmp(value, "0") == 0) {
+        *out = false;
+        return true;
+    }
+    return false;
+}
+
+/* Set one named option */
+SCStatus sc_context_set_option(SCContext *ctx, const char *name, const char *value) {
+    if (!ctx) {
+        return SC_ERROR_INVALID_ARG;
+    }
+    if (!name || !value) {
+        return set_error(ctx, SC_ERROR_INVALID_ARG, "option name and value are required");
+    }
+
+    struct {
+        const char *name;
+        bool *field;
+    } bool_options[] = {
+        {"transactions", &ctx->sql_opts->use_transactions},
+        {"if_exists", &ctx->sql_opts->use_if_exists},
+        {"comments", &ctx->sql_opts->add_comments},
+        {"precondition", &ctx->sql_opts->add_precondition},
+        {"case_sensitive", &ctx->compare_opts->case_sensitive},
+        {"normalize_types", &ctx->compare_opts->normalize_types},
+        {"compare_constraints", &ctx->compare_opts->compare_constraints},
+        {"compare_tablespaces", &ctx->compare_opts->compare_tablespaces},
+    };
+    for (size_t i = 0; i < sizeof(bool_options) / sizeof(bool_options[0]); i++) {
+        if (strcmp(name, bool_options[i].name) == 0) {
+            if (!parse_bool(value, bool_options[i].field)) {
+                return set_error(ctx, SC_ERROR_INVALID_ARG, "option %s expects a boolean, got '%s'",
+                                 name, value);
+            }
+            return SC_OK;
+        }
+    }
+
+    if (strcmp(name, "schema") == 0) {
+        char *copy = strdup(value);
+        if (!copy) {
+            return set_error(ctx, SC_ERROR_MEMORY, "out of memory");
+        }
+        free(ctx->schema_name);
+        ctx->schema_name = copy;
+        return SC_OK;
+    }
+
+    if (strcmp(name, "report_format") == 0) {
+        if (strcmp(value, "text") == 0) {
+            ctx->report_opts->format = REPORT_FORMAT_TEXT;
+        } else if (strcmp(value, "markdown") == 0) {
+            ctx->report_opts->format = REPORT_FORMAT_MARKDOWN;
+        } else {
+            return set_error(ctx, SC_ERROR_INVALID_ARG, "unknown report_format '%s'", value);
+        }
+        return SC_OK;
+    }
+
+    if (strcmp(name, "report_verbosity") == 0) {
+        static const char *levels[] = {"summary", "normal", "detailed", "verbose"};
+        for (int i = 0; i < 4; i++) {
+            if (strcmp(value, levels[i]) == 0) {
+                ctx->report_opts->verbosity = (ReportVerbosity)(REPORT_VERBOSITY_SUMMARY + i);
+                return SC_OK;
+            }
+        }
+        return set_error(ctx, SC_ERROR_INVALID_ARG, "unknown report_verbosity '%s'", value);
+    }
+
+    return set_error(ctx, SC_ERROR_INVALID_ARG, "unknown option '%s'", name);
+}
+
+/* ========== Schemas ========== */
+
+static SCStatus wrap_schema(SCContext *ctx, Schema *loaded, SCSchema **out) {
+    SCSchema *schema = calloc(1, sizeof(SCSchema));
+    if (!schema) {
+        schema_free(loaded);
+        return set_error(ctx, SC_ERROR_MEMORY, "out of memory");
+    }
+    schema->ctx = ctx;
+    schema->schema = loaded;
+    schema->refs = 1;
+    schema->next = ctx->schemas;
+    ctx->schemas = schema;
+    *out = schema;
+    return SC_OK;
+}
+
+static void schema_unref(SCSchema *schema) {
+    if (--schema->refs > 0) {
+        return;
+    }
+
+    SCContext *ctx = schema->ctx;
+    for (SCSchema **link = &ctx->schemas; *link; link = &(*link)->next) {
+        if (*link == schema) {
+            *link = schema->next;
+            break;
+        }
+    }
+    SCSchema *reference = schema->reference;
+    schema_destroy(schema);
+    if (reference) {
+        schema_unref(reference);
+    }
+}
+
+/* FNV-1a over a file's identity: path, size, mtime, inode */
+static bool fingerprint_file(const char *path, uint64_t *hash) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return false;
+    }
+    int64_t fields[4] = {(int64_t)st.st_size, (int64_t)st.st_mtim.tv_sec,
+                         (int64_t)st.st_mtim.tv_nsec, (int64_t)st.st_ino};
+    *hash = fnv1a_64(*hash, path, strlen(path) + 1);
+    *hash = fnv1a_64(*hash, fields, sizeof(fields));
+    return true;
+}
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+static uint64_t fingerprint_directory(const char *path) {
+    uint64_t hash = FNV1A_64_INIT;
+    int count = 0;
+    char **files = find_sql_files_recursive(path, &count);
+    if (!files) {
+        return hash;
+    }
+    qsort(files, (size_t)count, sizeof(char *), compare_paths);
+    for (int i = 0; i < count; i++) {
+        fingerprint_file(files[i], &hash);
+        free(files[i]);
+    }
+    free(files);
+    return hash;
+}
+
+/* Return a cached schema for key if its fingerprint still matches; evict it otherwise */
+static SCSchema *cache_lookup(SCContext *ctx, const char *key, uint64_t fingerprint) {
+    for (SCSchema *schema = ctx->schemas; schema; schema = schema->next) {
+        if (!schema->cache_key || strcmp(schema->cache_key, key) != 0) {
+            continue;
+        }
+        if (schema->fingerprint == fingerprint) {
+            return schema;
+        }
+        free(schema->cache_key);
+        schema->cache_key = NULL;
+        schema_unref(schema);
+        return NULL;
+    }
+    return NULL;
+}
+
+/* Load a file or directory through the cache */
+static SCStatus load_cached(SCContext *ctx, const char *path, bool directory, SCSchema **out) {
+    if (!ctx || !path || !out) {
+        return ctx ? set_error(ctx, SC_ERROR_INVALID_ARG, "path and out are required")
+                   : SC_ERROR_INVALID_ARG;
+    }
+    *out = NULL;
+
+    struct stat st;
+    if (stat(path, &st) != 0 || (directory ? !S_ISDIR(st.st_mode) : !S_ISREG(st.st_mode))) {
+        return set_error(ctx, SC_ERROR_IO, "%s is not a readable %s", path,
+                         directory ? "directory" : "file");
+    }
+
+    uint64_t fingerprint = FNV1A_64_INIT;
+    if (directory) {
+        fingerprint = fingerprint_directory(path);
+    } else {
+        fingerprint_file(path, &fingerprint);
+    }
+
+    size_t key_length = strlen(path) + 6;
+    char *key = malloc(key_length);
+    if (!key) {
+        return set_error(ctx, SC_ERROR_MEMORY, "out of memory");
+    }
+    snprintf(key, key_length, "%s:%s", directory ? "dir" : "file", path);
+
+    SCSchema *cached = cache_lookup(ctx, key, fingerprint);
+    if (cached) {
+        free(key);
+        cached->refs++;
+        *out = cached;
+        return SC_OK;
+    }
+
+    Schema *loaded = directory ? load_from_directory(path, NULL) : load_from_file(path, NULL);
+    if (!loaded) {
+        free(key);
+        return set_error(ctx, SC_ERROR_PARSE, "no tables could be parsed from %s", path);
+    }
+
+    SCSchema *schema = NULL;
+    SCStatus status = wrap_schema(ctx, loaded, &schema);
+    if (status != SC_OK) {
+        free(key);
+        return status;
+    }
+    schema->cache_key = key;
+    schema->fingerprint = fingerprint;
+    schema->refs++;  /* held by the cache */
+    *out = schema;
+    return SC_OK;
+}
+
+SCStatus sc_load_file(SCContext *ctx, const char *path, SCSchema **out) {
+    return load_cached(ctx, path, false, out);
+}
+
+SCStatus sc_load_directory(SCContext *ctx, const char *path, SCSchema **out) {
+    return load_cached(ctx, path, true, out);
+}
+
+/* Directory sharing reference's byte-identical files (not cached) */
+SCStatus sc_load_directory_against(SCContext *ctx, const char *path, SCSchema *reference,
+                                   SCSchema **out) {
+    if (!ctx || !path || !reference || !out) {
+        return ctx ? set_error(ctx, SC_ERROR_INVALID_ARG, "path, reference and out are required")
+                   : SC_ERROR_INVALID_ARG;
+    }
+    *out = NULL;
+    if (reference->ctx != ctx) {
+        return set_error(ctx, SC_ERROR_INVALID_ARG, "reference belongs to another context");
+    }
+
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        return set_error(ctx, SC_ERROR_IO, "%s is not a readable directory", path);
+    }
+
+    Schema *loaded = load_from_directory_against(path, reference->schema, NULL);
+    if (!loaded) {
+        return set_error(ctx, SC_ERROR_PARSE, "no tables could be parsed from %s", path);
+    }
+    SCStatus status = wrap_schema(ctx, loaded, out);
+    if (status == SC_OK) {
+        (*out)->reference = reference;
+        reference->refs++;
+    }
+    return status;
+}
+
+/* Parse DDL text (not cached) */
+SCStatus sc_load_sql(SCContext *ctx, const char *sql, SCSchema **out) {
+    if (!ctx || !sql || !out) {
+        return ctx ? set_error(ctx, SC_ERROR_INVALID_ARG, "sql and out are required")
+                   : SC_ERROR_INVALID_ARG;
+    }
+    *out = NULL;
+
+    Schema *loaded = load_from_string(sql, NULL);
+    if (!loaded) {
+        return set_error(ctx, SC_ERROR_PARSE, "failed to parse SQL");
+    }
+    return wrap_schema(ctx, loaded, out);
+}
+
+/* Introspect through a caller-owned connection */
+SCStatus sc_introspect(SCContext *ctx, PGconn *conn, const char *schema_name, SCSchema **out) {
+    if (!ctx || !conn || !out) {
+        return ctx ? set_error(ctx, SC_ERROR_INVALID_ARG, "conn and out are required")
+                   : SC_ERROR_INVALID_ARG;
+    }
+    *out = NULL;
+
+    if (PQstatus(conn) != CONNECTION_OK) {
+        return set_error(ctx, SC_ERROR_DB, "connection is not usable: %s", PQerrorMessage(conn));
+    }
+
+    /* Borrow the connection; DBConnection only wraps it for the readers */
+    DBConnection wrapper;
+    memset(&wrapper, 0, sizeof(wrapper));
+    wrapper.conn = conn;
+    wrapper.connected = true;
+
+    Schema *loaded = load_from_database(&wrapper, schema_name ? schema_name : ctx->schema_name,
+                                        NULL);
+    free(wrapper.last_error);
+    if (!loaded) {
+        return set_error(ctx, SC_ERROR_DB, "introspection failed: %s", PQerrorMessage(conn));
+    }
+    return wrap_schema(ctx, loaded, out);
+}
+
+int sc_schema_table_count(const SCSchema *schema) {
+    return schema && schema->schema ? schema->schema->table_count : 0;
+}
+
+void sc_schema_release(SCSchema *schema) {
+    if (schema) {
+        schema_unref(schema);
+    }
+}
+
+/* ========== Diffs ========== */
+
+/* Compare two schemas of the same context */
+SCStatus sc_compare(SCContext *ctx, SCSchema *current, SCSchema *desired, SCDiff **out) {
+    if (!ctx || !current || !desired || !out) {
+        return ctx ? set_error(ctx, SC_ERROR_INVALID_ARG, "current, desired and out are required")
+                   : SC_ERROR_INVALID_ARG;
+    }
+    *out = NULL;
+    if (current->ctx != ctx || desired->ctx != ctx) {
+        return set_error(ctx, SC_ERROR_INVALID_ARG, "schemas belong to another context");
+    }
+
+    SCDiff *diff = calloc(1, sizeof(SCDiff));
+    if (!diff) {
+        return set_error(ctx, SC_ERROR_MEMORY, "out of memory");
+    }
+
+    diff->diff = compare_schemas(current->schema, desired->schema, ctx->compare_opts, NULL);
+    if (!diff->diff) {
+        free(diff);
+        return set_error(ctx, SC_ERROR_INTERNAL, "comparison failed");
+    }
+
+    diff->ctx = ctx;
+    diff->current = current;
+    diff->desired = desired;
+    current->refs++;
+    desired->refs++;
+    diff->next = ctx->diffs;
+    ctx->diffs = diff;
+    *out = diff;
+    return SC_OK;
+}
+
+static SCStatus ensure_migration(SCDiff *diff) {
+    if (!diff->migration) {
+        diff->migration = generate_migration_sql(diff->diff, diff->ctx->sql_opts);
+        if (!diff->migration) {
+            return set_error(diff->ctx, SC_ERROR_INTERNAL, "migration generation failed");
+        }
+    }
+    return SC_OK;
+}
+
+int sc_diff_count(SCDiff *diff, SCDiffCount what) {
+    if (!diff) {
+        return -1;
+    }
+
+    const SchemaDiff *d = diff->diff;
+    switch (what) {
+        case SC_COUNT_TABLES_ADDED: return d->tables_added;
+        case SC_COUNT_TABLES_REMOVED: return d->tables_removed;
+        case SC_COUNT_TABLES_MODIFIED: return d->tables_modified;
+        case SC_COUNT_CHANGES: return d->total_diffs;
+        case SC_COUNT_CRITICAL: return d->critical_count;
+        case SC_COUNT_WARNING: return d->warning_count;
+        case SC_COUNT_INFO: return d->info_count;
+        case SC_COUNT_STATEMENTS:
+            return ensure_migration(diff) == SC_OK ? diff->migration->statement_count : -1;
+        case SC_COUNT_DESTRUCTIVE:
+            return ensure_migration(diff) == SC_OK ? diff->migration->has_destructive_changes : -1;
+        case SC_COUNT_TYPES_ADDED: return d->types_added;
+        case SC_COUNT_TYPES_REMOVED: return d->types_removed;
+        case SC_COUNT_TYPES_MODIFIED: return d->types_modified;
+        case SC_COUNT_INDEXES_ADDED: return d->indexes_added;
+        case SC_COUNT_INDEXES_REMOVED: return d->indexes_removed;
+        case SC_COUNT_INDEXES_MODIFIED: return d->indexes_modified;
+    }
+    return -1;
+}
+
+SCStatus sc_diff_sql(SCDiff *diff, const char **sql) {
+    if (!diff || !sql) {
+        return SC_ERROR_INVALID_ARG;
+    }
+
+    SCStatus status = ensure_migration(diff);
+    *sql = status == SC_OK ? diff->migration->forward_sql : NULL;
+    return status;
+}
+
+SCStatus sc_diff_report(SCDiff *diff, const char **report) {
+    if (!diff || !report) {
+        return SC_ERROR_INVALID_ARG;
+    }
+
+    if (!diff->report) {
+        diff->report = generate_report(diff->diff, diff->ctx->report_opts);
+        if (!diff->report) {
+            *report = NULL;
+            return set_error(diff->ctx, SC_ERROR_INTERNAL, "report generation failed");
+        }
+    }
+    *report = diff->report;
+    return SC_OK;
+}
+
+void sc_diff_release(SCDiff *diff) {
+    if (!diff) {
+        return;
+    }
+
+    SCContext *ctx = diff->ctx;
+    for (SCDiff **link = &ctx->diffs; *link; link = &(*link)->next) {
+        if (*link == diff) {
+            *link = diff->next;
+            break;
+        }
+    }
+
+    SCSchema *current = diff->current;
+    SCSchema *desired = diff->desired;
+    diff_destroy(diff);
+    schema_unref(current);
+    schema_unref(desired);
+}
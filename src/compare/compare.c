@@ -110,7 +110,7 @@ char *normalize_type_name(const char *type_name, MemoryContext *mem_ctx) {
     }
 
     for (char *p = normalized; *p; p++) {
-        *p = tolower(*p);
+        *p = tolower((unsigned char)*p);
     }
 
     /* Remove schema qualification (e.g., "public.enum_type" -> "enum_type") */
@@ -120,7 +120,7 @@ char *normalize_type_name(const char *type_name, MemoryContext *mem_ctx) {
         /* Check if it's a schema.type pattern (not numeric like "3.14") */
         bool is_schema = true;
         for (char *p = normalized; p < dot; p++) {
-            if (!isalpha(*p) && *p != '_') {
+            if (!isalpha((unsigned char)*p) && *p != '_') {
                 is_schema = false;
                 break;
             }
@@ -3,14 +3,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-/* Helper to extract ColumnDef from TableElement */
-static const ColumnDef *get_column_def(const TableElement *elem) {
-    if (elem && elem->type == TABLE_ELEM_COLUMN) {
-        return &elem->elem.column;
-    }
-    return NULL;
-}
-
 /* Helper to check if column has NOT NULL constraint */
 static bool column_is_not_null(const ColumnDef *col) {
     if (!col) {
@@ -149,6 +141,22 @@ void compare_columns(const CreateTableStmt *source, const CreateTableStmt *targe
         return;
     }
 
+    TableLayout *source_layout = table_layout_build(source, mem_ctx);
+    TableLayout *target_layout = table_layout_build(target, mem_ctx);
+    if (source_layout && target_layout) {
+        compare_column_layouts(source_layout, target_layout, result, opts, mem_ctx);
+    }
+    table_layout_free(source_layout, mem_ctx);
+    table_layout_free(target_layout, mem_ctx);
+}
+
+/* Compare the column arrays of two tables */
+void compare_column_layouts(const TableLayout *source, const TableLayout *target,
+                            TableDiff *result, const CompareOptions *opts, MemoryContext *mem_ctx) {
+    if (!source || !target || !result) {
+        return;
+    }
+
     /* Build hash tables of columns by name */
     HashTable *source_ht = hash_table_create(32);
     HashTable *target_ht = hash_table_create(32);
@@ -160,18 +168,18 @@ void compare_columns(const CreateTableStmt *source, const CreateTableStmt *targe
     }
 
     /* Populate source columns */
-    for (TableElement *elem = source->table_def.regular.elements; elem; elem = elem->next) {
-        const ColumnDef *col = get_column_def(elem);
-        if (col && col->column_name) {
-            hash_table_insert(source_ht, col->column_name, (void *)col);
+    for (uint32_t i = 0; i < source->column_count; i++) {
+        const char *name = table_layout_string(source, source->columns[i].name);
+        if (name) {
+            hash_table_insert(source_ht, name, &source->columns[i]);
         }
     }
 
     /* Populate target columns */
-    for (TableElement *elem = target->table_def.regular.elements; elem; elem = elem->next) {
-        const ColumnDef *col = get_column_def(elem);
-        if (col && col->column_name) {
-            hash_table_insert(target_ht, col->column_name, (void *)col);
+    for (uint32_t i = 0; i < target->column_count; i++) {
+        const char *name = table_layout_string(target, target->columns[i].name);
+        if (name) {
+            hash_table_insert(target_ht, name, &target->columns[i]);
         }
     }
 
@@ -180,20 +188,21 @@ void compare_columns(const CreateTableStmt *source, const CreateTableStmt *targe
     ColumnDiff *last_modified = NULL;
 
     /* Find added and modified columns */
-    for (TableElement *elem = target->table_def.regular.elements; elem; elem = elem->next) {
-        const ColumnDef *target_col = get_column_def(elem);
-        if (!target_col || !target_col->column_name) {
+    for (uint32_t t = 0; t < target->column_count; t++) {
+        const LayoutColumn *target_lc = &target->columns[t];
+        const ColumnDef *target_col = table_layout_column_def(target, t);
+        if (!target_lc->name) {
             continue;
         }
 
-        const ColumnDef *source_col = hash_table_get(source_ht, target_col->column_name);
+        const LayoutColumn *source_lc = hash_table_get(source_ht, target_col->column_name);
 
-        if (!source_col) {
+        if (!source_lc) {
             /* Column added */
             ColumnDiff *cd = column_diff_create(target_col->column_name);
             if (cd) {
                 cd->new_type = target_col->data_type;
-                cd->new_nullable = !column_is_not_null(target_col);
+                cd->new_nullable = !target_lc->not_null;
                 cd->new_default = (char *)get_column_default(target_col);
                 result->column_add_count++;
 
@@ -214,8 +223,13 @@ void compare_columns(const CreateTableStmt *source, const CreateTableStmt *targe
                 }
             }
         } else {
-            /* Column exists - compare details */
-            ColumnDiff *cd = compare_column_details(source_col, target_col, opts, mem_ctx);
+            /* Column exists - compare details, unless byte-identical */
+            uint32_t s = (uint32_t)(source_lc - source->columns);
+            ColumnDiff *cd = NULL;
+            if (!table_layout_columns_identical(source, s, target, t)) {
+                cd = compare_column_details(table_layout_column_def(source, s), target_col,
+                                            opts, mem_ctx);
+            }
             if (cd) {
                 result->column_modify_count++;
 
@@ -301,15 +315,13 @@ void compare_columns(const CreateTableStmt *source, const CreateTableStmt *targe
     }
 
     /* Find removed columns */
-    for (TableElement *elem = source->table_def.regular.elements; elem; elem = elem->next) {
-        const ColumnDef *source_col = get_column_def(elem);
-        if (!source_col || !source_col->column_name) {
+    for (uint32_t i = 0; i < source->column_count; i++) {
+        const ColumnDef *source_col = table_layout_column_def(source, i);
+        if (!source->columns[i].name) {
             continue;
         }
 
-        const ColumnDef *target_col = hash_table_get(target_ht, source_col->column_name);
-
-        if (!target_col) {
+        if (!hash_table_get(target_ht, source_col->column_name)) {
             /* Column removed */
             ColumnDiff *cd = column_diff_create(source_col->column_name);
             if (cd) {
@@ -3,14 +3,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-/* Helper to extract TableConstraint from TableElement */
-static const TableConstraint *get_table_constraint(const TableElement *elem) {
-    if (elem && elem->type == TABLE_ELEM_TABLE_CONSTRAINT) {
-        return elem->elem.table_constraint;
-    }
-    return NULL;
-}
-
 /* Compare two column constraints for equivalence */
 bool column_constraints_equivalent(const ColumnConstraint *c1, const ColumnConstraint *c2,
                                   const CompareOptions *opts) {
@@ -417,14 +409,6 @@ bool constraints_equivalent(const TableConstraint *c1, const TableConstraint *c2
     }
 }
 
-/* Helper to get ColumnDef from TableElement */
-static const ColumnDef *get_column_def(const TableElement *elem) {
-    if (elem && elem->type == TABLE_ELEM_COLUMN) {
-        return &elem->elem.column;
-    }
-    return NULL;
-}
-
 /* Structure to track constraint info (table-level or column-level) */
 typedef struct {
     const TableConstraint *table_constraint;  /* NULL for column constraints */
@@ -615,138 +599,83 @@ static bool column_uniques_match_table_unique(const ConstraintInfo *source_const
     return true;
 }
 
-/* Compare constraints between two tables */
-void compare_constraints(const CreateTableStmt *source, const CreateTableStmt *target,
-                        TableDiff *result, const CompareOptions *opts, MemoryContext *mem_ctx) {
-    (void)mem_ctx;  /* Not used yet */
-
-    if (!source || !target || !result) {
-        return;
+/* Gather a table's table-level constraints and its inline PRIMARY KEY and
+ * UNIQUE column constraints, in that order. Returns the count. */
+static int collect_constraints(const TableLayout *layout, ConstraintInfo **out) {
+    *out = NULL;
+    int count = (int)layout->table_constraint_count;
+    for (uint32_t i = layout->table_constraint_count; i < layout->constraint_count; i++) {
+        uint8_t type = layout->constraints[i].type;
+        if (type == CONSTRAINT_PRIMARY_KEY || type == CONSTRAINT_UNIQUE) {
+            count++;
+        }
+    }
+    if (count == 0) {
+        return 0;
     }
 
-    /* Build lists of table constraints */
-    int source_count = 0;
-    int target_count = 0;
-
-    /* Count table-level constraints */
-    for (TableElement *elem = source->table_def.regular.elements; elem; elem = elem->next) {
-        if (get_table_constraint(elem)) {
-            source_count++;
-        }
+    ConstraintInfo *infos = calloc(count, sizeof(ConstraintInfo));
+    if (!infos) {
+        return -1;
     }
 
-    for (TableElement *elem = target->table_def.regular.elements; elem; elem = elem->next) {
-        if (get_table_constraint(elem)) {
-            target_count++;
+    int idx = 0;
+    for (uint32_t i = 0; i < layout->constraint_count; i++) {
+        const LayoutConstraint *lc = &layout->constraints[i];
+        if (lc->column < 0) {
+            infos[idx].table_constraint = table_layout_table_constraint(layout, i);
+            infos[idx].constraint_type = lc->type;
+            idx++;
+        } else if (lc->type == CONSTRAINT_PRIMARY_KEY || lc->type == CONSTRAINT_UNIQUE) {
+            infos[idx].column_constraint = table_layout_column_constraint(layout, i);
+            infos[idx].column_name = table_layout_column_def(layout, (uint32_t)lc->column)->column_name;
+            infos[idx].constraint_type = lc->type == CONSTRAINT_PRIMARY_KEY
+                                         ? TABLE_CONSTRAINT_PRIMARY_KEY : TABLE_CONSTRAINT_UNIQUE;
+            idx++;
         }
     }
 
-    /* Also count inline PRIMARY KEY and UNIQUE constraints on columns */
-    for (TableElement *elem = source->table_def.regular.elements; elem; elem = elem->next) {
-        const ColumnDef *col = get_column_def(elem);
-        if (col && col->constraints) {
-            for (ColumnConstraint *cc = col->constraints; cc; cc = cc->next) {
-                if (cc->type == CONSTRAINT_PRIMARY_KEY || cc->type == CONSTRAINT_UNIQUE) {
-                    source_count++;
-                }
-            }
-        }
+    *out = infos;
+    return count;
+}
+
+/* Compare constraints between two tables */
+void compare_constraints(const CreateTableStmt *source, const CreateTableStmt *target,
+                        TableDiff *result, const CompareOptions *opts, MemoryContext *mem_ctx) {
+    if (!source || !target || !result) {
+        return;
     }
 
-    for (TableElement *elem = target->table_def.regular.elements; elem; elem = elem->next) {
-        const ColumnDef *col = get_column_def(elem);
-        if (col && col->constraints) {
-            for (ColumnConstraint *cc = col->constraints; cc; cc = cc->next) {
-                if (cc->type == CONSTRAINT_PRIMARY_KEY || cc->type == CONSTRAINT_UNIQUE) {
-                    target_count++;
-                }
-            }
-        }
+    TableLayout *source_layout = table_layout_build(source, mem_ctx);
+    TableLayout *target_layout = table_layout_build(target, mem_ctx);
+    if (source_layout && target_layout) {
+        compare_constraint_layouts(source_layout, target_layout, result, opts, mem_ctx);
     }
+    table_layout_free(source_layout, mem_ctx);
+    table_layout_free(target_layout, mem_ctx);
+}
 
-    if (source_count == 0 && target_count == 0) {
+/* Compare the constraint arrays of two tables */
+void compare_constraint_layouts(const TableLayout *source, const TableLayout *target,
+                                TableDiff *result, const CompareOptions *opts, MemoryContext *mem_ctx) {
+    (void)mem_ctx;  /* Not used yet */
+
+    if (!source || !target || !result) {
         return;
     }
 
-    /* Build arrays of constraints */
     ConstraintInfo *source_constraints = NULL;
     ConstraintInfo *target_constraints = NULL;
-
-    if (source_count > 0) {
-        source_constraints = calloc(source_count, sizeof(ConstraintInfo));
-        if (!source_constraints) {
-            return;
-        }
-        int idx = 0;
-
-        /* Add table-level constraints */
-        for (TableElement *elem = source->table_def.regular.elements; elem; elem = elem->next) {
-            const TableConstraint *tc = get_table_constraint(elem);
-            if (tc) {
-                source_constraints[idx].table_constraint = tc;
-                source_constraints[idx].constraint_type = tc->type;
-                idx++;
-            }
-        }
-
-        /* Add inline column constraints (PK and UNIQUE only) */
-        for (TableElement *elem = source->table_def.regular.elements; elem; elem = elem->next) {
-            const ColumnDef *col = get_column_def(elem);
-            if (col && col->constraints) {
-                for (ColumnConstraint *cc = col->constraints; cc; cc = cc->next) {
-                    if (cc->type == CONSTRAINT_PRIMARY_KEY) {
-                        source_constraints[idx].column_constraint = cc;
-                        source_constraints[idx].column_name = col->column_name;
-                        source_constraints[idx].constraint_type = TABLE_CONSTRAINT_PRIMARY_KEY;
-                        idx++;
-                    } else if (cc->type == CONSTRAINT_UNIQUE) {
-                        source_constraints[idx].column_constraint = cc;
-                        source_constraints[idx].column_name = col->column_name;
-                        source_constraints[idx].constraint_type = TABLE_CONSTRAINT_UNIQUE;
-                        idx++;
-                    }
-                }
-            }
-        }
+    int source_count = collect_constraints(source, &source_constraints);
+    int target_count = collect_constraints(target, &target_constraints);
+    if (source_count < 0 || target_count < 0) {
+        free(source_constraints);
+        free(target_constraints);
+        return;
     }
 
-    if (target_count > 0) {
-        target_constraints = calloc(target_count, sizeof(ConstraintInfo));
-        if (!target_constraints) {
-            free(source_constraints);
-            return;
-        }
-        int idx = 0;
-
-        /* Add table-level constraints */
-        for (TableElement *elem = target->table_def.regular.elements; elem; elem = elem->next) {
-            const TableConstraint *tc = get_table_constraint(elem);
-            if (tc) {
-                target_constraints[idx].table_constraint = tc;
-                target_constraints[idx].constraint_type = tc->type;
-                idx++;
-            }
-        }
-
-        /* Add inline column constraints (PK and UNIQUE only) */
-        for (TableElement *elem = target->table_def.regular.elements; elem; elem = elem->next) {
-            const ColumnDef *col = get_column_def(elem);
-            if (col && col->constraints) {
-                for (ColumnConstraint *cc = col->constraints; cc; cc = cc->next) {
-                    if (cc->type == CONSTRAINT_PRIMARY_KEY) {
-                        target_constraints[idx].column_constraint = cc;
-                        target_constraints[idx].column_name = col->column_name;
-                        target_constraints[idx].constraint_type = TABLE_CONSTRAINT_PRIMARY_KEY;
-                        idx++;
-                    } else if (cc->type == CONSTRAINT_UNIQUE) {
-                        target_constraints[idx].column_constraint = cc;
-                        target_constraints[idx].column_name = col->column_name;
-                        target_constraints[idx].constraint_type = TABLE_CONSTRAINT_UNIQUE;
-                        idx++;
-                    }
-                }
-            }
-        }
+    if (source_count == 0 && target_count == 0) {
+        return;
     }
 
     /* Track which constraints have been matched */
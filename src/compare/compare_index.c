@@ -0,0 +1,439 @@
+#include "compare.h"
+#include "utils.h"
+#include "trace.h"
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+/* Append a name the way PostgreSQL resolves it: unquoted parts fold to
+ * lower case, quoted parts keep theirs. The schema is dropped because
+ * schemas are compared one at a time. */
+static void append_canonical_name(StringBuilder *sb, const char *name) {
+    if (!name) {
+        return;
+    }
+    const char *start = name;
+    bool quoted = false;
+    for (const char *p = name; *p; p++) {
+        if (*p == '"') {
+            quoted = !quoted;
+        } else if (*p == '.' && !quoted) {
+            start = p + 1;
+        }
+    }
+    quoted = false;
+    for (const char *p = start; *p; p++) {
+        if (*p == '"') {
+            quoted = !quoted;
+        } else {
+            sb_append_char(sb, quoted ? *p : (char)tolower((unsigned char)*p));
+        }
+    }
+}
+
+static bool is_word_char(char c) {
+    return isalnum((unsigned char)c) || c == '_' || c == '.';
+}
+
+/* Skip a "::type" cast starting at p (just past the "::"). Two-word type
+ * names are the only ones the catalog adds casts with. */
+static const char *skip_cast(const char *p) {
+    while (isspace((unsigned char)*p)) p++;
+    while (is_word_char(*p) || *p == '"') p++;
+    const char *after = p;
+    while (isspace((unsigned char)*after)) after++;
+    if (strncasecmp(after, "varying", 7) == 0 || strncasecmp(after, "precision", 9) == 0) {
+        p = after + (tolower((unsigned char)*after) == 'v' ? 7 : 9);
+    }
+    while (p[0] == '[' && p[1] == ']') p += 2;
+    return p;
+}
+
+/* Append an expression in a form that does not depend on who wrote it: the
+ * parser keeps the source text, while pg_get_indexdef() adds casts and
+ * grouping parentheses. Whitespace, casts and grouping parentheses are
+ * dropped and unquoted text is folded to lower case; literals are kept. */
+static void append_canonical_expression(StringBuilder *sb, const char *expr) {
+    if (!expr) {
+        return;
+    }
+
+    /* For each open parenthesis: was it kept (a call) or dropped (grouping)? */
+    bool kept[64];
+    int depth = 0;
+    char last = '\0';
+
+    for (const char *p = expr; *p; ) {
+        char c = *p;
+        if (c == '\'') {
+            /* String literal, '' escapes included */
+            sb_append_char(sb, c);
+            p++;
+            while (*p) {
+                sb_append_char(sb, *p);
+                if (*p == '\'' && p[1] != '\'') {
+                    p++;
+                    break;
+                }
+                if (*p == '\'') {
+                    sb_append_char(sb, *++p);
+                }
+                p++;
+            }
+            last = '\'';
+        } else if (c == '"') {
+            /* Quoted identifier: keep its case, drop the quotes */
+            p++;
+            while (*p && *p != '"') {
+                sb_append_char(sb, *p);
+                last = *p++;
+            }
+            if (*p) p++;
+        } else if (c == ':' && p[1] == ':') {
+            p = skip_cast(p + 2);
+        } else if (isspace((unsigned char)c)) {
+            p++;
+        } else if (c == '(') {
+            bool call = is_word_char(last);
+            if (depth < (int)(sizeof(kept) / sizeof(kept[0]))) {
+                kept[depth] = call;
+            }
+            depth++;
+            if (call) {
+                sb_append_char(sb, c);
+                last = c;
+            }
+            p++;
+        } else if (c == ')') {
+            bool call = depth > 0 && (depth > (int)(sizeof(kept) / sizeof(kept[0])) || kept[depth - 1]);
+            if (depth > 0) depth--;
+            if (call) {
+                sb_append_char(sb, c);
+                last = c;
+            }
+            p++;
+        } else {
+            last = (char)tolower((unsigned char)c);
+            sb_append_char(sb, last);
+            p++;
+        }
+    }
+}
+
+/* Canonical text of everything that decides what an index does. The name,
+ * storage parameters and tablespace are left out: they can change without
+ * changing which queries the index serves. */
+char *index_canonical_form(const CreateIndexStmt *stmt) {
+    if (!stmt) {
+        return NULL;
+    }
+    StringBuilder *sb = sb_create();
+    if (!sb) {
+        return NULL;
+    }
+
+    append_canonical_name(sb, stmt->table_name);
+    sb_append(sb, stmt->unique ? "|unique" : "|");
+    sb_append(sb, stmt->nulls_not_distinct ? "|nulls not distinct|" : "||");
+    append_canonical_name(sb, stmt->access_method ? stmt->access_method : "btree");
+
+    sb_append(sb, "|(");
+    for (int i = 0; i < stmt->element_count; i++) {
+        const IndexElement *elem = &stmt->elements[i];
+        if (i > 0) {
+            sb_append_char(sb, ',');
+        }
+        if (elem->expression) {
+            sb_append_char(sb, '(');
+            append_canonical_expression(sb, elem->expression);
+            sb_append_char(sb, ')');
+        } else {
+            append_canonical_name(sb, elem->column_name);
+        }
+        if (elem->collation) {
+            sb_append(sb, " collate ");
+            append_canonical_name(sb, elem->collation);
+        }
+        if (elem->opclass) {
+            sb_append_char(sb, ' ');
+            append_canonical_name(sb, elem->opclass);
+        }
+        /* NULLS FIRST is the default for DESC, NULLS LAST for ASC */
+        bool desc = elem->sort_order == SORT_DESC;
+        bool nulls_first = elem->has_nulls_order ? elem->nulls_order == NULLS_FIRST : desc;
+        sb_append(sb, desc ? " desc" : "");
+        sb_append(sb, nulls_first != desc ? (nulls_first ? " nulls first" : " nulls last") : "");
+    }
+    sb_append_char(sb, ')');
+
+    if (stmt->include_count > 0) {
+        sb_append(sb, "|include(");
+        for (int i = 0; i < stmt->include_count; i++) {
+            if (i > 0) {
+                sb_append_char(sb, ',');
+            }
+            append_canonical_name(sb, stmt->include_columns[i]);
+        }
+        sb_append_char(sb, ')');
+    }
+
+    if (stmt->where_clause) {
+        sb_append(sb, "|where ");
+        append_canonical_expression(sb, stmt->where_clause);
+    }
+
+    char *form = sb_to_string(sb);
+    sb_free(sb);
+    return form;
+}
+
+/* 64-bit hash of index_canonical_form() */
+uint64_t index_signature(const CreateIndexStmt *stmt) {
+    char *form = index_canonical_form(stmt);
+    if (!form) {
+        return 0;
+    }
+    uint64_t hash = fnv1a_64(FNV1A_64_INIT, form, strlen(form));
+    free(form);
+    return hash;
+}
+
+/* Case-folded, unqualified name used to match indexes and tables */
+static char *canonical_name(const char *name) {
+    StringBuilder *sb = sb_create();
+    if (!sb) {
+        return NULL;
+    }
+    append_canonical_name(sb, name);
+    char *result = sb_to_string(sb);
+    sb_free(sb);
+    return result;
+}
+
+static void signature_key(char *key, size_t size, uint64_t signature) {
+    snprintf(key, size, "%016llx", (unsigned long long)signature);
+}
+
+static IndexDiff *new_index_diff(DiffType type, const CreateIndexStmt *current,
+                                 const CreateIndexStmt *desired) {
+    const CreateIndexStmt *named = desired ? desired : current;
+    IndexDiff *diff = index_diff_create(named->index_name, named->table_name);
+    if (!diff) {
+        return NULL;
+    }
+    diff->source_index = (CreateIndexStmt *)current;
+    diff->target_index = (CreateIndexStmt *)desired;
+    diff->old_signature = current ? index_signature(current) : 0;
+    diff->new_signature = desired ? index_signature(desired) : 0;
+    if (current && desired && current->index_name) {
+        diff->old_name = strdup(current->index_name);
+    }
+
+    switch (type) {
+        case DIFF_INDEX_ADDED:    diff->index_added = true; break;
+        case DIFF_INDEX_REMOVED:  diff->index_removed = true; break;
+        case DIFF_INDEX_MODIFIED: diff->index_modified = true; break;
+        default:                  diff->index_renamed = true; break;
+    }
+
+    Diff *d = diff_create(type, diff_determine_severity(type), diff->table_name, diff->index_name);
+    if (d) {
+        if (type == DIFF_INDEX_MODIFIED) {
+            char *old_form = index_canonical_form(current);
+            char *new_form = index_canonical_form(desired);
+            diff_set_values(d, old_form, new_form);
+            free(old_form);
+            free(new_form);
+        } else if (type == DIFF_INDEX_RENAMED) {
+            diff_set_values(d, current->index_name, desired->index_name);
+        }
+        diff_append(&diff->diffs, d);
+        diff->diff_count++;
+    }
+    return diff;
+}
+
+static void link_index_diff(SchemaDiff *result, IndexDiff **last, IndexDiff *diff) {
+    if (*last) {
+        (*last)->next = diff;
+    } else {
+        result->index_diffs = diff;
+    }
+    *last = diff;
+}
+
+/* Table names (canonical) present in a schema */
+static HashTable *table_names(const Schema *schema) {
+    HashTable *ht = hash_table_create(schema->table_count * 2 + 1);
+    for (int i = 0; ht && i < schema->table_count; i++) {
+        if (schema->tables[i] && schema->tables[i]->table_name) {
+            char *name = canonical_name(schema->tables[i]->table_name);
+            if (name) {
+                hash_table_insert(ht, name, schema->tables[i]);
+                free(name);
+            }
+        }
+    }
+    return ht;
+}
+
+static bool table_in(HashTable *tables, const char *table_name) {
+    char *name = canonical_name(table_name);
+    bool found = name && hash_table_contains(tables, name);
+    free(name);
+    return found;
+}
+
+/* Compare all indexes in a schema */
+void compare_all_indexes(const Schema *source, const Schema *target, SchemaDiff *result,
+                         const CompareOptions *opts, MemoryContext *mem_ctx) {
+    (void)mem_ctx;
+    if (!source || !target || !result) {
+        return;
+    }
+    if (source->index_count == 0 && target->index_count == 0) {
+        return;
+    }
+
+    int span = TRACE_BEGIN(TRACE_PHASE_COMPARE, "compare_indexes", NULL);
+
+    int count = source->index_count;
+    HashTable *by_name = hash_table_create(count * 2 + 1);
+    HashTable *by_signature = hash_table_create(count * 2 + 1);
+    HashTable *source_tables = table_names(source);
+    HashTable *target_tables = table_names(target);
+    int *same_signature = calloc(count + 1, sizeof(int));  /* next position + 1 */
+    bool *matched = calloc(count + 1, sizeof(bool));
+    const CreateIndexStmt **pair = calloc(target->index_count + 1, sizeof(CreateIndexStmt *));
+    if (!by_name || !by_signature || !source_tables || !target_tables ||
+        !same_signature || !matched || !pair) {
+        goto done;
+    }
+
+    /* Current indexes by name, and chained by signature in schema order */
+    char key[32];
+    for (int i = count - 1; i >= 0; i--) {
+        const CreateIndexStmt *index = source->indexes[i];
+        if (index->index_name) {
+            char *name = canonical_name(index->index_name);
+            if (name) {
+                hash_table_insert(by_name, name, (void *)(intptr_t)(i + 1));
+                free(name);
+            }
+        }
+        signature_key(key, sizeof(key), index_signature(index));
+        same_signature[i] = (int)(intptr_t)hash_table_get(by_signature, key);
+        hash_table_insert(by_signature, key, (void *)(intptr_t)(i + 1));
+    }
+
+    /* Pair by name first, so a changed definition is rebuilt in place */
+    for (int j = 0; j < target->index_count; j++) {
+        const CreateIndexStmt *index = target->indexes[j];
+        if (!index->index_name || !should_compare_table(index->table_name, opts)) {
+            continue;
+        }
+        char *name = canonical_name(index->index_name);
+        intptr_t pos = name ? (intptr_t)hash_table_get(by_name, name) : 0;
+        free(name);
+        if (pos && !matched[pos - 1]) {
+            matched[pos - 1] = true;
+            pair[j] = source->indexes[pos - 1];
+        }
+    }
+
+    IndexDiff *last = result->index_diffs;
+    while (last && last->next) {
+        last = last->next;
+    }
+
+    /* Desired indexes in order: unchanged, rebuilt, renamed or added */
+    for (int j = 0; j < target->index_count; j++) {
+        const CreateIndexStmt *index = target->indexes[j];
+        if (!should_compare_table(index->table_name, opts)) {
+            continue;
+        }
+        uint64_t signature = index_signature(index);
+        IndexDiff *diff = NULL;
+
+        if (pair[j]) {
+            if (index_signature(pair[j]) != signature) {
+                diff = new_index_diff(DIFF_INDEX_MODIFIED, pair[j], index);
+            }
+        } else {
+            /* Same definition under another (unpaired) name */
+            signature_key(key, sizeof(key), signature);
+            intptr_t pos = (intptr_t)hash_table_get(by_signature, key);
+            while (pos && matched[pos - 1]) {
+                pos = same_signature[pos - 1];
+            }
+            if (pos) {
+                const CreateIndexStmt *current = source->indexes[pos - 1];
+                matched[pos - 1] = true;
+                if (index->index_name && current->index_name &&
+                    !names_equal(index->index_name, current->index_name, opts)) {
+                    diff = new_index_diff(DIFF_INDEX_RENAMED, current, index);
+                }
+            } else {
+                diff = new_index_diff(DIFF_INDEX_ADDED, NULL, index);
+                if (diff) {
+                    diff->table_added = !table_in(source_tables, index->table_name);
+                }
+            }
+        }
+
+        if (diff) {
+            if (diff->index_added) {
+                result->indexes_added++;
+            } else {
+                result->indexes_modified++;
+                result->total_diffs += diff->diff_count;
+            }
+            link_index_diff(result, &last, diff);
+        }
+    }
+
+    /* Removed indexes. Those of removed tables go with the table, and
+     * unnamed ones (only possible in DDL files) cannot be dropped. */
+    for (int i = 0; i < count; i++) {
+        const CreateIndexStmt *index = source->indexes[i];
+        if (matched[i] || !index->index_name || !should_compare_table(index->table_name, opts) ||
+            !table_in(target_tables, index->table_name)) {
+            continue;
+        }
+        IndexDiff *diff = new_index_diff(DIFF_INDEX_REMOVED, index, NULL);
+        if (diff) {
+            result->indexes_removed++;
+            link_index_diff(result, &last, diff);
+        }
+    }
+
+    /* Severity counts */
+    for (IndexDiff *id = result->index_diffs; id; id = id->next) {
+        for (Diff *d = id->diffs; d; d = d->next) {
+            switch (d->severity) {
+                case SEVERITY_CRITICAL:
+                    result->critical_count++;
+                    break;
+                case SEVERITY_WARNING:
+                    result->warning_count++;
+                    break;
+                case SEVERITY_INFO:
+                    result->info_count++;
+                    break;
+            }
+        }
+    }
+
+done:
+    free(pair);
+    free(matched);
+    free(same_signature);
+    hash_table_destroy(target_tables);
+    hash_table_destroy(source_tables);
+    hash_table_destroy(by_signature);
+    hash_table_destroy(by_name);
+    TRACE_END(span);
+}
@@ -21,7 +21,11 @@ SchemaDiff *compare_schemas(const Schema *source, const Schema *target,
                          target->tables, target->table_count,
                          result, opts, mem_ctx);
 
-    /* Future: Compare types, functions, procedures */
+    compare_all_types(source, target, result, opts, mem_ctx);
+
+    compare_all_indexes(source, target, result, opts, mem_ctx);
+
+    /* Future: Compare functions, procedures */
 
     return result;
 }
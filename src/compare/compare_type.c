@@ -0,0 +1,511 @@
+#include "compare.h"
+#include "utils.h"
+#include "trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Record a generic diff on a type. Diffs are pushed on the front, so a type
+ * with thousands of changed labels is built in linear time, and put back in
+ * order by reverse_type_diffs once the type is compared. */
+static void add_type_diff(TypeDiff *result, DiffType type, const char *element,
+                          const char *old_value, const char *new_value) {
+    Diff *d = diff_create(type, diff_determine_severity(type), result->type_name, element);
+    if (!d) {
+        return;
+    }
+    diff_set_values(d, old_value, new_value);
+    d->next = result->diffs;
+    result->diffs = d;
+    result->diff_count++;
+}
+
+static void reverse_type_diffs(TypeDiff *result) {
+    Diff *reversed = NULL;
+    while (result->diffs) {
+        Diff *d = result->diffs;
+        result->diffs = d->next;
+        d->next = reversed;
+        reversed = d;
+    }
+    result->diffs = reversed;
+}
+
+static const char *variant_name(TypeVariant variant) {
+    switch (variant) {
+        case TYPE_VARIANT_ENUM:      return "ENUM";
+        case TYPE_VARIANT_COMPOSITE: return "COMPOSITE";
+        case TYPE_VARIANT_RANGE:     return "RANGE";
+        case TYPE_VARIANT_BASE:      return "BASE";
+        default:                     return "UNKNOWN";
+    }
+}
+
+/* Same labels in the same order; member hashes rule out most mismatches
+ * without touching the label text */
+static bool enum_labels_identical(const EnumTypeDef *a, const EnumTypeDef *b) {
+    if (a->label_count != b->label_count) {
+        return false;
+    }
+    for (int i = 0; i < a->label_count; i++) {
+        if ((a->index.hashes && b->index.hashes && a->index.hashes[i] != b->index.hashes[i]) ||
+            strcmp(a->labels[i], b->labels[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Label a change will find in the type when ADD VALUE runs: additions are
+ * applied before renames, so a renamed label still has its old name */
+static const char *label_before_renames(HashTable *renamed, const char *label) {
+    const char *old_label = hash_table_get(renamed, label);
+    return old_label ? old_label : label;
+}
+
+/* Enum labels can be added anywhere and renamed in place, but not removed or
+ * reordered. Labels kept on both sides split each list into gaps; within a
+ * gap, removed and added labels pair up in order as renames. */
+static void compare_enum_labels(const EnumTypeDef *source, const EnumTypeDef *target,
+                                TypeDiff *result) {
+    if (enum_labels_identical(source, target)) {
+        return;
+    }
+
+    /* Each side's label index answers "kept?" and "where?" */
+    HashTable *renamed = hash_table_create(target->label_count * 2 + 1);
+    int *source_gap = calloc(source->label_count + 1, sizeof(int));
+    int *target_gap = calloc(target->label_count + 1, sizeof(int));
+    if (!renamed || !source_gap || !target_gap) {
+        goto done;
+    }
+
+    /* Kept labels must appear in the same relative order */
+    bool reordered = false;
+    int kept = 0;
+    for (int i = 0; i < source->label_count; i++) {
+        source_gap[i] = kept;
+        if (enum_type_def_find(target, source->labels[i]) >= 0) {
+            kept++;
+        }
+    }
+    kept = 0;
+    int next_source = 0;
+    for (int j = 0; j < target->label_count; j++) {
+        target_gap[j] = kept;
+        int pos = enum_type_def_find(source, target->labels[j]);
+        if (pos >= 0) {
+            if (pos < next_source) {
+                reordered = true;
+            }
+            next_source = pos + 1;
+            kept++;
+        }
+    }
+
+    if (reordered) {
+        add_type_diff(result, DIFF_ENUM_VALUES_REORDERED, NULL, NULL, NULL);
+        result->requires_recreate = true;
+    }
+
+    /* Walk removed and added labels together, gap by gap */
+    EnumValueChange **last_rename = &result->values_renamed;
+    int i = 0, j = 0;
+    while (i < source->label_count || j < target->label_count) {
+        while (i < source->label_count && enum_type_def_find(target, source->labels[i]) >= 0) {
+            i++;
+        }
+        while (j < target->label_count && enum_type_def_find(source, target->labels[j]) >= 0) {
+            j++;
+        }
+        bool have_removed = i < source->label_count;
+        bool have_added = j < target->label_count;
+
+        if (have_removed && have_added && !reordered && source_gap[i] == target_gap[j]) {
+            EnumValueChange *change = enum_value_change_create(target->labels[j], source->labels[i]);
+            if (change) {
+                *last_rename = change;
+                last_rename = &change->next;
+                result->value_rename_count++;
+                hash_table_insert(renamed, change->label, change->old_label);
+            }
+            add_type_diff(result, DIFF_ENUM_VALUE_RENAMED, source->labels[i],
+                          source->labels[i], target->labels[j]);
+            i++;
+            j++;
+        } else if (have_removed && (!have_added || reordered || source_gap[i] < target_gap[j])) {
+            add_type_diff(result, DIFF_ENUM_VALUE_REMOVED, source->labels[i],
+                          source->labels[i], NULL);
+            result->requires_recreate = true;
+            i++;
+        } else if (have_added) {
+            j++;  /* Plain additions are collected below, once renames are known */
+        }
+    }
+
+    /* Additions in desired order, each anchored to a label that exists by then */
+    EnumValueChange **last_add = &result->values_added;
+    for (int k = 0; k < target->label_count; k++) {
+        const char *label = target->labels[k];
+        if (enum_type_def_find(source, label) >= 0 || hash_table_contains(renamed, label)) {
+            continue;
+        }
+
+        EnumValueChange *change = enum_value_change_create(label, NULL);
+        if (!change) {
+            continue;
+        }
+        if (k > 0) {
+            change->anchor = strdup(label_before_renames(renamed, target->labels[k - 1]));
+        } else {
+            for (int n = k + 1; n < target->label_count; n++) {
+                const char *next = target->labels[n];
+                if (enum_type_def_find(source, next) >= 0 || hash_table_contains(renamed, next)) {
+                    change->anchor = strdup(label_before_renames(renamed, next));
+                    change->before = true;
+                    break;
+                }
+            }
+        }
+        *last_add = change;
+        last_add = &change->next;
+        result->value_add_count++;
+        add_type_diff(result, DIFF_ENUM_VALUE_ADDED, label, NULL, label);
+    }
+
+done:
+    hash_table_destroy(renamed);
+    free(source_gap);
+    free(target_gap);
+}
+
+static const CompositeAttribute *find_attribute(const CompositeTypeDef *def, const char *name,
+                                                const CompareOptions *opts) {
+    int pos = composite_type_def_find(def, name, !opts || opts->case_sensitive);
+    return pos >= 0 ? &def->attributes[pos] : NULL;
+}
+
+/* Composite attributes: ADD ATTRIBUTE appends, so the resulting order is the
+ * kept attributes in their current order followed by the added ones */
+static void compare_composite_attributes(const CompositeTypeDef *source,
+                                         const CompositeTypeDef *target,
+                                         TypeDiff *result, const CompareOptions *opts) {
+    ColumnDiff **last_removed = &result->attributes_removed;
+    ColumnDiff **last_added = &result->attributes_added;
+    ColumnDiff **last_modified = &result->attributes_modified;
+
+    for (int i = 0; i < source->attribute_count; i++) {
+        const CompositeAttribute *attr = &source->attributes[i];
+        if (!find_attribute(target, attr->attr_name, opts)) {
+            ColumnDiff *cd = column_diff_create(attr->attr_name);
+            if (cd) {
+                cd->old_type = attr->data_type;
+                *last_removed = cd;
+                last_removed = &cd->next;
+                result->attribute_remove_count++;
+            }
+            add_type_diff(result, DIFF_ATTRIBUTE_REMOVED, attr->attr_name, attr->data_type, NULL);
+        }
+    }
+
+    for (int i = 0; i < target->attribute_count; i++) {
+        const CompositeAttribute *attr = &target->attributes[i];
+        const CompositeAttribute *current = find_attribute(source, attr->attr_name, opts);
+        if (!current) {
+            ColumnDiff *cd = column_diff_create(attr->attr_name);
+            if (cd) {
+                cd->new_type = attr->data_type;
+                cd->new_collation = attr->collation;
+                *last_added = cd;
+                last_added = &cd->next;
+                result->attribute_add_count++;
+            }
+            add_type_diff(result, DIFF_ATTRIBUTE_ADDED, attr->attr_name, NULL, attr->data_type);
+            continue;
+        }
+
+        bool type_changed = !data_types_equal(current->data_type, attr->data_type, opts);
+        bool collation_changed = current->collation && attr->collation &&
+                                 !names_equal(current->collation, attr->collation, opts);
+        if (type_changed || collation_changed) {
+            ColumnDiff *cd = column_diff_create(attr->attr_name);
+            if (cd) {
+                cd->type_changed = true;
+                cd->collation_changed = collation_changed;
+                cd->old_type = current->data_type;
+                cd->new_type = attr->data_type;
+                cd->old_collation = current->collation;
+                cd->new_collation = attr->collation;
+                *last_modified = cd;
+                last_modified = &cd->next;
+                result->attribute_modify_count++;
+            }
+            add_type_diff(result, DIFF_ATTRIBUTE_TYPE_CHANGED, attr->attr_name,
+                          current->data_type, attr->data_type);
+        }
+    }
+
+    /* Compare the order ALTER TYPE will produce with the desired one */
+    int want = 0;
+    bool in_order = true;
+    for (int i = 0; i < source->attribute_count && in_order; i++) {
+        const CompositeAttribute *attr = &source->attributes[i];
+        if (find_attribute(target, attr->attr_name, opts)) {
+            in_order = want < target->attribute_count &&
+                       names_equal(target->attributes[want].attr_name, attr->attr_name, opts);
+            want++;
+        }
+    }
+    for (; want < target->attribute_count && in_order; want++) {
+        in_order = !find_attribute(source, target->attributes[want].attr_name, opts);
+    }
+    if (!in_order) {
+        add_type_diff(result, DIFF_ATTRIBUTES_REORDERED, NULL, NULL, NULL);
+    }
+}
+
+/* Optional range settings only differ when both sides name one */
+static bool optional_names_differ(const char *a, const char *b, const CompareOptions *opts) {
+    return a && b && !names_equal(a, b, opts);
+}
+
+static bool range_definitions_equal(const RangeTypeDef *a, const RangeTypeDef *b,
+                                    const CompareOptions *opts) {
+    return data_types_equal(a->subtype, b->subtype, opts) &&
+           !optional_names_differ(a->subtype_opclass, b->subtype_opclass, opts) &&
+           !optional_names_differ(a->collation, b->collation, opts) &&
+           !optional_names_differ(a->canonical_function, b->canonical_function, opts) &&
+           !optional_names_differ(a->subtype_diff_function, b->subtype_diff_function, opts);
+}
+
+static bool base_definitions_equal(const BaseTypeDef *a, const BaseTypeDef *b,
+                                   const CompareOptions *opts) {
+    return names_equal(a->input_function, b->input_function, opts) &&
+           names_equal(a->output_function, b->output_function, opts) &&
+           a->internallength == b->internallength &&
+           a->is_variable_length == b->is_variable_length;
+}
+
+/* Diff one type by name: added when source is NULL, removed when target is
+ * NULL, otherwise compared. Returns NULL when both exist and are equal. */
+TypeDiff *compare_type_pair(const CreateTypeStmt *source, const CreateTypeStmt *target,
+                            const CompareOptions *opts, MemoryContext *mem_ctx) {
+    (void)mem_ctx;  /* Not used yet */
+
+    if (!source && !target) {
+        return NULL;
+    }
+
+    const CreateTypeStmt *type = target ? target : source;
+    TypeDiff *result = type_diff_create(type->type_name);
+    if (!result) {
+        return NULL;
+    }
+    result->source_type = (CreateTypeStmt *)source;
+    result->target_type = (CreateTypeStmt *)target;
+
+    if (!source || !target) {
+        result->type_added = !source;
+        result->type_removed = !target;
+        return result;
+    }
+
+    if (source->variant != target->variant) {
+        add_type_diff(result, DIFF_TYPE_DEFINITION_CHANGED, NULL,
+                      variant_name(source->variant), variant_name(target->variant));
+        result->requires_recreate = true;
+    } else if (source->variant == TYPE_VARIANT_ENUM) {
+        compare_enum_labels(&source->type_def.enum_def, &target->type_def.enum_def, result);
+    } else if (source->variant == TYPE_VARIANT_COMPOSITE) {
+        compare_composite_attributes(&source->type_def.composite_def,
+                                     &target->type_def.composite_def, result, opts);
+    } else if (source->variant == TYPE_VARIANT_RANGE) {
+        if (!range_definitions_equal(&source->type_def.range_def, &target->type_def.range_def, opts)) {
+            add_type_diff(result, DIFF_TYPE_DEFINITION_CHANGED, NULL,
+                          source->type_def.range_def.subtype, target->type_def.range_def.subtype);
+            result->requires_recreate = true;
+        }
+    } else if (!base_definitions_equal(&source->type_def.base_def, &target->type_def.base_def, opts)) {
+        add_type_diff(result, DIFF_TYPE_DEFINITION_CHANGED, NULL, NULL, NULL);
+        result->requires_recreate = true;
+    }
+
+    if (result->diff_count == 0) {
+        type_diff_free(result);
+        return NULL;
+    }
+    reverse_type_diffs(result);
+    result->type_modified = true;
+    return result;
+}
+
+/* True if a column's declared type is the type or an array of it */
+static bool column_uses_type(const char *data_type, const char *type_name,
+                             const CompareOptions *opts) {
+    if (!data_type || !type_name) {
+        return false;
+    }
+    size_t len = strlen(type_name);
+    if (strlen(data_type) == len + 2 && strcmp(data_type + len, "[]") == 0) {
+        char *element = strndup(data_type, len);
+        bool uses = element && names_equal(element, type_name, opts);
+        free(element);
+        return uses;
+    }
+    return names_equal(data_type, type_name, opts);
+}
+
+/* Columns of tables kept on both sides that store a type being recreated */
+static void collect_dependents(TypeDiff *td, const Schema *source, HashTable *target_tables,
+                               const CompareOptions *opts) {
+    TypeDependentColumn **last = &td->dependents;
+    for (int i = 0; i < source->table_count; i++) {
+        const CreateTableStmt *table = source->tables[i];
+        if (!table || !table->table_name || table->variant != CREATE_TABLE_REGULAR ||
+            !hash_table_contains(target_tables, table->table_name)) {
+            continue;
+        }
+        for (TableElement *elem = table->table_def.regular.elements; elem; elem = elem->next) {
+            if (elem->type != TABLE_ELEM_COLUMN ||
+                !column_uses_type(elem->elem.column.data_type, td->type_name, opts)) {
+                continue;
+            }
+            TypeDependentColumn *dep = calloc(1, sizeof(TypeDependentColumn));
+            if (!dep) {
+                return;
+            }
+            dep->table_name = strdup(table->table_name);
+            dep->column_name = strdup(elem->elem.column.column_name);
+            dep->data_type = strdup(elem->elem.column.data_type);
+            for (ColumnConstraint *c = elem->elem.column.constraints; c; c = c->next) {
+                if (c->type == CONSTRAINT_DEFAULT && c->constraint.default_val.expr &&
+                    c->constraint.default_val.expr->expression) {
+                    dep->default_expr = strdup(c->constraint.default_val.expr->expression);
+                }
+            }
+            *last = dep;
+            last = &dep->next;
+        }
+    }
+}
+
+static void link_type_diff(SchemaDiff *result, TypeDiff **last, TypeDiff *diff) {
+    if (*last) {
+        (*last)->next = diff;
+    } else {
+        result->type_diffs = diff;
+    }
+    *last = diff;
+}
+
+/* Compare all types in a schema */
+void compare_all_types(const Schema *source, const Schema *target, SchemaDiff *result,
+                       const CompareOptions *opts, MemoryContext *mem_ctx) {
+    if (!source || !target || !result) {
+        return;
+    }
+    if (source->type_count == 0 && target->type_count == 0) {
+        return;
+    }
+
+    int span = TRACE_BEGIN(TRACE_PHASE_COMPARE, "compare_types", NULL);
+
+    HashTable *source_ht = hash_table_create(source->type_count * 2 + 1);
+    HashTable *target_ht = hash_table_create(target->type_count * 2 + 1);
+    if (!source_ht || !target_ht) {
+        hash_table_destroy(source_ht);
+        hash_table_destroy(target_ht);
+        TRACE_END(span);
+        return;
+    }
+    for (int i = 0; i < source->type_count; i++) {
+        if (source->types[i] && source->types[i]->type_name) {
+            hash_table_insert(source_ht, source->types[i]->type_name, source->types[i]);
+        }
+    }
+    for (int i = 0; i < target->type_count; i++) {
+        if (target->types[i] && target->types[i]->type_name) {
+            hash_table_insert(target_ht, target->types[i]->type_name, target->types[i]);
+        }
+    }
+
+    TypeDiff *last = result->type_diffs;
+    while (last && last->next) {
+        last = last->next;
+    }
+
+    /* Added and modified types, in desired order so CREATE TYPE can follow it */
+    for (int i = 0; i < target->type_count; i++) {
+        const CreateTypeStmt *type = target->types[i];
+        if (!type || !type->type_name) {
+            continue;
+        }
+        const CreateTypeStmt *current = hash_table_get(source_ht, type->type_name);
+        if (current == type) {
+            continue;  /* borrowed from a byte-identical file */
+        }
+        TypeDiff *diff = compare_type_pair(current, type, opts, mem_ctx);
+        if (!diff) {
+            continue;
+        }
+        if (diff->type_added) {
+            result->types_added++;
+        } else {
+            result->types_modified++;
+            result->total_diffs += diff->diff_count;
+        }
+        link_type_diff(result, &last, diff);
+    }
+
+    /* Removed types */
+    for (int i = 0; i < source->type_count; i++) {
+        const CreateTypeStmt *type = source->types[i];
+        if (type && type->type_name && !hash_table_get(target_ht, type->type_name)) {
+            TypeDiff *diff = compare_type_pair(type, NULL, opts, mem_ctx);
+            if (diff) {
+                result->types_removed++;
+                link_type_diff(result, &last, diff);
+            }
+        }
+    }
+
+    /* Recreated types need their stored columns converted */
+    HashTable *target_tables = NULL;
+    for (TypeDiff *td = result->type_diffs; td; td = td->next) {
+        if (!td->requires_recreate) {
+            continue;
+        }
+        if (!target_tables) {
+            target_tables = hash_table_create(target->table_count * 2 + 1);
+            for (int i = 0; target_tables && i < target->table_count; i++) {
+                if (target->tables[i] && target->tables[i]->table_name) {
+                    hash_table_insert(target_tables, target->tables[i]->table_name, target->tables[i]);
+                }
+            }
+        }
+        if (target_tables) {
+            collect_dependents(td, source, target_tables, opts);
+        }
+    }
+
+    /* Severity counts */
+    for (TypeDiff *td = result->type_diffs; td; td = td->next) {
+        for (Diff *d = td->diffs; d; d = d->next) {
+            switch (d->severity) {
+                case SEVERITY_CRITICAL:
+                    result->critical_count++;
+                    break;
+                case SEVERITY_WARNING:
+                    result->warning_count++;
+                    break;
+                case SEVERITY_INFO:
+                    result->info_count++;
+                    break;
+            }
+        }
+    }
+
+    hash_table_destroy(target_tables);
+    hash_table_destroy(source_ht);
+    hash_table_destroy(target_ht);
+    TRACE_END(span);
+}
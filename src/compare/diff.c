@@ -1,4 +1,6 @@
 #include "diff.h"
+#include "utils.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -199,6 +201,119 @@ void table_diff_list_free(TableDiff *list) {
     }
 }
 
+/* Create a TypeDiff */
+TypeDiff *type_diff_create(const char *type_name) {
+    TypeDiff *td = calloc(1, sizeof(TypeDiff));
+    if (!td) {
+        return NULL;
+    }
+
+    td->type_name = type_name ? strdup(type_name) : NULL;
+    td->next = NULL;
+
+    return td;
+}
+
+/* Create an EnumValueChange */
+EnumValueChange *enum_value_change_create(const char *label, const char *old_label) {
+    EnumValueChange *change = calloc(1, sizeof(EnumValueChange));
+    if (!change) {
+        return NULL;
+    }
+
+    change->label = label ? strdup(label) : NULL;
+    change->old_label = old_label ? strdup(old_label) : NULL;
+
+    return change;
+}
+
+/* Free list of EnumValueChanges */
+void enum_value_change_list_free(EnumValueChange *list) {
+    while (list) {
+        EnumValueChange *next = list->next;
+        free(list->label);
+        free(list->old_label);
+        free(list->anchor);
+        free(list);
+        list = next;
+    }
+}
+
+/* Free a TypeDiff */
+void type_diff_free(TypeDiff *td) {
+    if (!td) {
+        return;
+    }
+
+    free(td->type_name);
+
+    enum_value_change_list_free(td->values_added);
+    enum_value_change_list_free(td->values_renamed);
+
+    column_diff_list_free(td->attributes_added);
+    column_diff_list_free(td->attributes_removed);
+    column_diff_list_free(td->attributes_modified);
+
+    while (td->dependents) {
+        TypeDependentColumn *next = td->dependents->next;
+        free(td->dependents->table_name);
+        free(td->dependents->column_name);
+        free(td->dependents->data_type);
+        free(td->dependents->default_expr);
+        free(td->dependents);
+        td->dependents = next;
+    }
+
+    diff_list_free(td->diffs);
+
+    free(td);
+}
+
+/* Free list of TypeDiffs */
+void type_diff_list_free(TypeDiff *list) {
+    while (list) {
+        TypeDiff *next = list->next;
+        type_diff_free(list);
+        list = next;
+    }
+}
+
+/* Create an IndexDiff */
+IndexDiff *index_diff_create(const char *index_name, const char *table_name) {
+    IndexDiff *id = calloc(1, sizeof(IndexDiff));
+    if (!id) {
+        return NULL;
+    }
+
+    id->index_name = index_name ? strdup(index_name) : NULL;
+    id->table_name = table_name ? strdup(table_name) : NULL;
+
+    return id;
+}
+
+/* Free an IndexDiff */
+void index_diff_free(IndexDiff *id) {
+    if (!id) {
+        return;
+    }
+
+    free(id->index_name);
+    free(id->old_name);
+    free(id->table_name);
+    diff_list_free(id->diffs);
+
+    free(id);
+}
+
+/* Free list of IndexDiffs */
+void index_diff_list_free(IndexDiff *list) {
+    while (list) {
+        IndexDiff *next = list->next;
+        index_diff_free(list);
+        list = next;
+    }
+}
+
 /* Create a SchemaDiff */
 SchemaDiff *schema_diff_create(const char *schema_name) {
     SchemaDiff *sd = calloc(1, sizeof(SchemaDiff));
@@ -211,6 +326,78 @@ SchemaDiff *schema_diff_create(const char *schema_name) {
     return sd;
 }
 
+static bool is_key_constraint(int type) {
+    return type == TABLE_CONSTRAINT_PRIMARY_KEY || type == TABLE_CONSTRAINT_UNIQUE;
+}
+
+static void note_key_changes(TableDiffEntry *entry) {
+    const TableDiff *td = entry->diff;
+    for (const ConstraintDiff *cd = td->constraints_added; cd; cd = cd->next) {
+        entry->keys_added |= is_key_constraint(cd->new_type);
+    }
+    for (const ConstraintDiff *cd = td->constraints_removed; cd; cd = cd->next) {
+        entry->keys_removed |= is_key_constraint(cd->old_type);
+    }
+    for (const ConstraintDiff *cd = td->constraints_modified; cd; cd = cd->next) {
+        entry->keys_added |= is_key_constraint(cd->new_type);
+        entry->keys_removed |= is_key_constraint(cd->old_type);
+    }
+}
+
+/* Index table_diffs by position and name, so SQL generation can resolve a
+ * foreign key's referenced table without walking the list */
+bool schema_diff_index_tables(SchemaDiff *sd) {
+    if (!sd) {
+        return false;
+    }
+    free(sd->table_entries);
+    hash_table_destroy(sd->table_index);
+    sd->table_entries = NULL;
+    sd->table_index = NULL;
+    sd->table_entry_count = 0;
+
+    int count = 0;
+    for (TableDiff *td = sd->table_diffs; td; td = td->next) {
+        count++;
+    }
+    TableDiffEntry *entries = calloc(count > 0 ? count : 1, sizeof(TableDiffEntry));
+    HashTable *index = hash_table_create(count * 2 + 1);
+    if (!entries || !index) {
+        free(entries);
+        hash_table_destroy(index);
+        return false;
+    }
+
+    int i = 0;
+    for (TableDiff *td = sd->table_diffs; td; td = td->next, i++) {
+        entries[i].diff = td;
+        note_key_changes(&entries[i]);
+        if (td->table_name) {
+            hash_table_insert(index, td->table_name, (void *)(intptr_t)(i + 1));
+        }
+    }
+    sd->table_entries = entries;
+    sd->table_entry_count = count;
+    sd->table_index = index;
+    return true;
+}
+
+/* Entry of a table by name, also trying the unqualified name of a
+ * schema-qualified reference; NULL if unchanged or not indexed */
+const TableDiffEntry *schema_diff_find_table(const SchemaDiff *sd, const char *table_name) {
+    if (!sd || !sd->table_index || !table_name) {
+        return NULL;
+    }
+    intptr_t pos = (intptr_t)hash_table_get(sd->table_index, table_name);
+    if (!pos) {
+        const char *dot = strrchr(table_name, '.');
+        if (dot) {
+            pos = (intptr_t)hash_table_get(sd->table_index, dot + 1);
+        }
+    }
+    return pos ? &sd->table_entries[pos - 1] : NULL;
+}
+
 /* Free a SchemaDiff */
 void schema_diff_free(SchemaDiff *sd) {
     if (!sd) {
@@ -219,7 +406,11 @@ void schema_diff_free(SchemaDiff *sd) {
 
     free(sd->schema_name);
 
+    free(sd->table_entries);
+    hash_table_destroy(sd->table_index);
     table_diff_list_free(sd->table_diffs);
+    type_diff_list_free(sd->type_diffs);
+    index_diff_list_free(sd->index_diffs);
 
     for (int i = 0; i < sd->added_table_count; i++) {
         free(sd->added_tables[i]);
@@ -256,6 +447,19 @@ const char *diff_type_to_string(DiffType type) {
         case DIFF_PARTITION_CHANGED: return "Partition Changed";
         case DIFF_INHERITS_CHANGED: return "Inherits Changed";
         case DIFF_STORAGE_PARAMS_CHANGED: return "Storage Parameters Changed";
+        case DIFF_ENUM_VALUE_ADDED: return "Enum Value Added";
+        case DIFF_ENUM_VALUE_RENAMED: return "Enum Value Renamed";
+        case DIFF_ENUM_VALUE_REMOVED: return "Enum Value Removed";
+        case DIFF_ENUM_VALUES_REORDERED: return "Enum Values Reordered";
+        case DIFF_ATTRIBUTE_ADDED: return "Attribute Added";
+        case DIFF_ATTRIBUTE_REMOVED: return "Attribute Removed";
+        case DIFF_ATTRIBUTE_TYPE_CHANGED: return "Attribute Type Changed";
+        case DIFF_ATTRIBUTES_REORDERED: return "Attributes Reordered";
+        case DIFF_TYPE_DEFINITION_CHANGED: return "Type Definition Changed";
+        case DIFF_INDEX_ADDED: return "Index Added";
+        case DIFF_INDEX_REMOVED: return "Index Removed";
+        case DIFF_INDEX_MODIFIED: return "Index Modified";
+        case DIFF_INDEX_RENAMED: return "Index Renamed";
         default: return "Unknown";
     }
 }
@@ -277,12 +481,21 @@ DiffSeverity diff_determine_severity(DiffType type) {
         case DIFF_COLUMN_REMOVED:
         case DIFF_COLUMN_TYPE_CHANGED:
         case DIFF_TABLE_TYPE_CHANGED:
+        case DIFF_ENUM_VALUE_REMOVED:
+        case DIFF_ENUM_VALUES_REORDERED:
+        case DIFF_ATTRIBUTE_REMOVED:
+        case DIFF_ATTRIBUTE_TYPE_CHANGED:
+        case DIFF_TYPE_DEFINITION_CHANGED:
             return SEVERITY_CRITICAL;
 
         case DIFF_TABLE_ADDED:
         case DIFF_COLUMN_ADDED:
         case DIFF_COLUMN_NULLABLE_CHANGED:
         case DIFF_CONSTRAINT_REMOVED:
+        case DIFF_ENUM_VALUE_RENAMED:
+        case DIFF_ATTRIBUTES_REORDERED:
+        case DIFF_INDEX_REMOVED:
+        case DIFF_INDEX_MODIFIED:
             return SEVERITY_WARNING;
 
         case DIFF_COLUMN_DEFAULT_CHANGED:
@@ -296,6 +509,10 @@ DiffSeverity diff_determine_severity(DiffType type) {
         case DIFF_INHERITS_CHANGED:
         case DIFF_STORAGE_PARAMS_CHANGED:
         case DIFF_TABLE_MODIFIED:
+        case DIFF_ENUM_VALUE_ADDED:
+        case DIFF_ATTRIBUTE_ADDED:
+        case DIFF_INDEX_ADDED:
+        case DIFF_INDEX_RENAMED:
             return SEVERITY_INFO;
 
         default:
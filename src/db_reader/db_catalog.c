@@ -0,0 +1,372 @@
+#include "db_reader.h"
+#include "utils.h"
+#include "trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SQLSTATE_DUPLICATE_PSTATEMENT "42P05"
+#define SQLSTATE_UNDEFINED_PSTATEMENT "26000"
+
+/* How a catalog query names the tables it reads */
+typedef enum {
+    CATALOG_TABLES_NONE,     /* $1 the schema name (CATALOG_DRIFT: both schemas) */
+    CATALOG_TABLES_NAMES,    /* $1 the schema name, $2 the name[] of the tables */
+    CATALOG_TABLES_RELIDS    /* $1 the oid[] of the tables, from CATALOG_TABLE_INFO */
+} CatalogTables;
+
+typedef struct {
+    const char *name;
+    const char *sql;
+    int param_count;
+    CatalogTables tables;
+} CatalogStatement;
+
+static const CatalogStatement statements[CATALOG_QUERY_COUNT] = {
+    [CATALOG_TABLE_LIST]  = {"schema_compare_table_list", db_table_list_sql, 1, CATALOG_TABLES_NONE},
+    [CATALOG_TYPES]       = {"schema_compare_types", db_type_sql, 1, CATALOG_TABLES_NONE},
+    [CATALOG_INDEXES]     = {"schema_compare_indexes", db_index_sql, 1, CATALOG_TABLES_NONE},
+    [CATALOG_TABLE_INFO]  = {"schema_compare_table_info", db_table_info_sql, 2, CATALOG_TABLES_NAMES},
+    [CATALOG_COLUMNS]     = {"schema_compare_columns", db_columns_sql, 1, CATALOG_TABLES_RELIDS},
+    [CATALOG_CONSTRAINTS] = {"schema_compare_constraints", db_constraints_sql, 1, CATALOG_TABLES_RELIDS},
+    [CATALOG_DRIFT]       = {"schema_compare_drift", db_drift_sql, 2, CATALOG_TABLES_NONE},
+};
+
+static bool has_sqlstate(const PGresult *res, const char *sqlstate) {
+    const char *state = res ? PQresultErrorField(res, PG_DIAG_SQLSTATE) : NULL;
+    return state && strcmp(state, sqlstate) == 0;
+}
+
+/* Skipped because an earlier command of the same pipeline failed */
+static bool is_aborted(const PGresult *res) {
+#ifdef LIBPQ_HAS_PIPELINING
+    return PQresultStatus(res) == PGRES_PIPELINE_ABORTED;
+#else
+    (void)res;
+    return false;
+#endif
+}
+
+/* Size of a result's values, for TRACE_COUNTER_CATALOG_BYTES */
+static int64_t result_bytes(const PGresult *res) {
+    int64_t bytes = 0;
+    int rows = PQntuples(res);
+    int fields = PQnfields(res);
+    for (int row = 0; row < rows; row++) {
+        for (int field = 0; field < fields; field++) {
+            bytes += PQgetlength(res, row, field);
+        }
+    }
+    return bytes;
+}
+
+static bool is_prepared(const DBConnection *conn, CatalogQuery query) {
+    return (conn->prepared & (1u << query)) != 0;
+}
+
+/* Record the outcome of preparing a statement. A statement that already
+ * exists counts as prepared: a borrowed connection (libschemacompare) may
+ * have prepared it in an earlier call. */
+static bool note_prepared(DBConnection *conn, CatalogQuery query, const PGresult *res) {
+    if (PQresultStatus(res) == PGRES_COMMAND_OK) {
+        TRACE_COUNT(TRACE_COUNTER_CATALOG_PLANS, 1);
+        conn->prepared |= 1u << query;
+        return true;
+    }
+    if (has_sqlstate(res, SQLSTATE_DUPLICATE_PSTATEMENT)) {
+        conn->prepared |= 1u << query;
+        return false;
+    }
+    if (!is_aborted(res)) {
+        log_error("Failed to prepare %s: %s", statements[query].name, PQresultErrorMessage(res));
+    }
+    return false;
+}
+
+/* The server forgot a statement we prepared (DISCARD ALL from a pooler,
+ * for one); it is prepared again on the next attempt */
+static bool note_forgotten(DBConnection *conn, CatalogQuery query, const PGresult *res) {
+    if (!has_sqlstate(res, SQLSTATE_UNDEFINED_PSTATEMENT)) {
+        return false;
+    }
+    conn->prepared &= ~(1u << query);
+    return true;
+}
+
+/* Table names as a name[] literal */
+static char *table_name_array(CreateTableStmt **stmts, int stmt_count) {
+    StringBuilder *sb = sb_create();
+    if (!sb) {
+        return NULL;
+    }
+
+    sb_append_char(sb, '{');
+    for (int i = 0; i < stmt_count; i++) {
+        if (i > 0) {
+            sb_append_char(sb, ',');
+        }
+        sb_append_char(sb, '"');
+        for (const char *p = stmts[i]->table_name; *p; p++) {
+            if (*p == '"' || *p == '\\') {
+                sb_append_char(sb, '\\');
+            }
+            sb_append_char(sb, *p);
+        }
+        sb_append_char(sb, '"');
+    }
+    sb_append_char(sb, '}');
+
+    char *array = sb_to_string(sb);
+    sb_free(sb);
+    return array;
+}
+
+/* Table OIDs as an oid[] literal, in statement order */
+static char *table_relid_array(CreateTableStmt **stmts, int stmt_count) {
+    StringBuilder *sb = sb_create();
+    if (!sb) {
+        return NULL;
+    }
+
+    sb_append_char(sb, '{');
+    for (int i = 0; i < stmt_count; i++) {
+        sb_append_fmt(sb, i > 0 ? ",%u" : "%u", (unsigned int)stmts[i]->relid);
+    }
+    sb_append_char(sb, '}');
+
+    char *array = sb_to_string(sb);
+    sb_free(sb);
+    return array;
+}
+
+/* The connection's owner has abandoned the work (a budget ran out) */
+static bool is_interrupted(const DBConnection *conn) {
+    if (conn->interrupt && atomic_load(conn->interrupt)) {
+        log_debug("Catalog query skipped: connection interrupted");
+        return true;
+    }
+    return false;
+}
+
+/* Run one catalog query with its parameters as given, preparing it on first
+ * use on this connection. Returns the result (check its status; PQclear
+ * it), or NULL. */
+PGresult *db_catalog_exec_params(DBConnection *conn, CatalogQuery query,
+                                 const char *const *params) {
+    const CatalogStatement *stmt = &statements[query];
+    PGresult *res = NULL;
+    if (is_interrupted(conn)) {
+        return NULL;
+    }
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (!is_prepared(conn, query)) {
+            PGresult *prep = PQprepare(conn->conn, stmt->name, stmt->sql, stmt->param_count, NULL);
+            bool ok = note_prepared(conn, query, prep);
+            PQclear(prep);
+            if (!ok && !is_prepared(conn, query)) {
+                break;
+            }
+        }
+
+        res = PQexecPrepared(conn->conn, stmt->name, stmt->param_count, params, NULL, NULL, 0);
+        TRACE_COUNT(TRACE_COUNTER_CATALOG_EXECUTIONS, 1);
+        TRACE_COUNT(TRACE_COUNTER_CATALOG_BYTES, result_bytes(res));
+        if (PQresultStatus(res) == PGRES_TUPLES_OK || !note_forgotten(conn, query, res)) {
+            break;
+        }
+        PQclear(res);
+        res = NULL;
+    }
+    return res;
+}
+
+/* Run one catalog query on a schema and, for queries reading tables, the
+ * given tables: by name, or by the relid CATALOG_TABLE_INFO recorded */
+PGresult *db_catalog_exec(DBConnection *conn, CatalogQuery query, const char *schema,
+                          CreateTableStmt **stmts, int stmt_count) {
+    const char *params[2] = {schema, NULL};
+    char *tables = NULL;
+    switch (statements[query].tables) {
+        case CATALOG_TABLES_NAMES:
+            tables = table_name_array(stmts, stmt_count);
+            params[1] = tables;
+            break;
+        case CATALOG_TABLES_RELIDS:
+            tables = table_relid_array(stmts, stmt_count);
+            params[0] = tables;
+            break;
+        case CATALOG_TABLES_NONE:
+            break;
+    }
+    if (statements[query].tables != CATALOG_TABLES_NONE && !tables) {
+        return NULL;
+    }
+
+    PGresult *res = db_catalog_exec_params(conn, query, params);
+    free(tables);
+    return res;
+}
+
+/* The statement a row of a table-reading query belongs to. Such queries
+ * return the table's 1-based position in the array they were given as the
+ * first column, so rows map to statements without comparing names. */
+CreateTableStmt *db_catalog_row_table(const PGresult *res, int row,
+                                      CreateTableStmt **stmts, int stmt_count) {
+    long pos = strtol(PQgetvalue(res, row, 0), NULL, 10);
+    return pos >= 1 && pos <= stmt_count ? stmts[pos - 1] : NULL;
+}
+
+#ifdef LIBPQ_HAS_PIPELINING
+/* Discard what is left of one pipelined command's results */
+static void drain_command(PGconn *pg) {
+    PGresult *res;
+    while ((res = PQgetResult(pg)) != NULL) {
+        PQclear(res);
+    }
+}
+
+/* Leave pipeline mode after a failed send, so later PQprepare and
+ * PQexecPrepared calls on the connection work. Whatever was queued is synced
+ * and discarded; the prepares among it may or may not have run, so they are
+ * sent again next time (a duplicate counts as prepared). A pipeline that
+ * cannot be wound down costs the session: the connection is reset. */
+static void abandon_pipeline(DBConnection *conn, unsigned int preparing) {
+    PGconn *pg = conn->conn;
+    conn->prepared &= ~preparing;
+
+    if (PQpipelineSync(pg)) {
+        for (;;) {
+            PGresult *res = PQgetResult(pg);
+            if (!res) {
+                if (PQstatus(pg) != CONNECTION_OK) {
+                    break;
+                }
+                continue;
+            }
+            bool synced = PQresultStatus(res) == PGRES_PIPELINE_SYNC;
+            PQclear(res);
+            if (synced) {
+                break;
+            }
+        }
+    }
+    if (PQexitPipelineMode(pg)) {
+        return;
+    }
+
+    log_warn("Resetting connection after a failed catalog pipeline: %s", PQerrorMessage(pg));
+    PQreset(pg);
+    conn->prepared = 0;
+}
+
+/* Send every query (and the prepares they need) in one pipeline, so the
+ * whole batch costs one round trip. Sets *retry when a failure was due to
+ * the prepared-statement state, which is corrected for the next attempt. */
+static bool run_pipeline(DBConnection *conn, const CatalogQuery *queries, int count,
+                         const char *schema, PGresult **results, bool *retry) {
+    PGconn *pg = conn->conn;
+    const char *params[1] = {schema};
+    unsigned int preparing = 0;
+    bool prepares[CATALOG_QUERY_COUNT] = {false};
+
+    if (!PQenterPipelineMode(pg)) {
+        log_error("Failed to enter pipeline mode: %s", PQerrorMessage(pg));
+        return false;
+    }
+
+    bool sent = true;
+    for (int i = 0; i < count && sent; i++) {
+        const CatalogStatement *stmt = &statements[queries[i]];
+        unsigned int bit = 1u << queries[i];
+        if (!is_prepared(conn, queries[i]) && !(preparing & bit)) {
+            sent = PQsendPrepare(pg, stmt->name, stmt->sql, stmt->param_count, NULL);
+            preparing |= bit;
+            prepares[i] = true;
+        }
+        sent = sent && PQsendQueryPrepared(pg, stmt->name, 1, params, NULL, NULL, 0);
+    }
+    if (!sent || !PQpipelineSync(pg)) {
+        log_error("Failed to send catalog queries: %s", PQerrorMessage(pg));
+        abandon_pipeline(conn, preparing);
+        return false;
+    }
+
+    bool ok = true;
+    for (int i = 0; i < count; i++) {
+        if (prepares[i]) {
+            PGresult *res = PQgetResult(pg);
+            if (!note_prepared(conn, queries[i], res)) {
+                *retry = *retry || is_prepared(conn, queries[i]);
+                ok = false;
+            }
+            PQclear(res);
+            drain_command(pg);
+        }
+
+        PGresult *res = PQgetResult(pg);
+        ExecStatusType status = PQresultStatus(res);
+        if (status == PGRES_TUPLES_OK) {
+            TRACE_COUNT(TRACE_COUNTER_CATALOG_EXECUTIONS, 1);
+            TRACE_COUNT(TRACE_COUNTER_CATALOG_BYTES, result_bytes(res));
+            results[i] = res;
+        } else {
+            if (note_forgotten(conn, queries[i], res)) {
+                *retry = true;
+            } else if (!is_aborted(res)) {
+                log_error("Failed to query catalog: %s", PQresultErrorMessage(res));
+            }
+            ok = false;
+            PQclear(res);
+        }
+        drain_command(pg);
+    }
+
+    /* The PGRES_PIPELINE_SYNC result */
+    PQclear(PQgetResult(pg));
+    PQexitPipelineMode(pg);
+    return ok;
+}
+#endif
+
+/* Run several schema-only catalog queries ($1 only), one result per query.
+ * Returns false (with every result cleared) unless all succeed. */
+bool db_catalog_exec_batch(DBConnection *conn, const CatalogQuery *queries, int count,
+                           const char *schema, PGresult **results) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        for (int i = 0; i < count; i++) {
+            results[i] = NULL;
+        }
+        if (is_interrupted(conn)) {
+            return false;
+        }
+
+#ifdef LIBPQ_HAS_PIPELINING
+        bool retry = false;
+        if (run_pipeline(conn, queries, count, schema, results, &retry)) {
+            return true;
+        }
+#else
+        /* No pipelining before libpq 14: one round trip per query */
+        bool retry = false;
+        bool ok = true;
+        for (int i = 0; i < count && ok; i++) {
+            results[i] = db_catalog_exec(conn, queries[i], schema, NULL, 0);
+            if (PQresultStatus(results[i]) != PGRES_TUPLES_OK) {
+                log_error("Failed to query catalog: %s", PQerrorMessage(conn->conn));
+                ok = false;
+            }
+        }
+        if (ok) {
+            return true;
+        }
+#endif
+
+        for (int i = 0; i < count; i++) {
+            PQclear(results[i]);
+            results[i] = NULL;
+        }
+        if (!retry) {
+            break;
+        }
+    }
+    return false;
+}
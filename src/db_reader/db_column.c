@@ -1,9 +1,31 @@
 #include "db_reader.h"
 #include "utils.h"
+#include "trace.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+/* Columns of the tables whose OIDs are in $1, in table and column order */
+const char db_columns_sql[] =
+    "SELECT "
+    "  t.pos, "                        /* position in $1 */
+    "  a.attname, "                    /* column name */
+    "  pg_catalog.format_type(a.atttypid, a.atttypmod), " /* data type */
+    "  a.attnotnull, "                 /* NOT NULL */
+    "  pg_get_expr(d.adbin, d.adrelid), " /* DEFAULT value */
+    "  a.attidentity, "                /* GENERATED identity */
+    "  a.attgenerated, "               /* GENERATED column */
+    "  col.collname, "                 /* COLLATE */
+    "  a.attstorage, "                 /* STORAGE */
+    "  a.attnum "
+    "FROM unnest($1::oid[]) WITH ORDINALITY AS t(relid, pos) "
+    "JOIN pg_attribute a ON a.attrelid = t.relid "
+    "LEFT JOIN pg_attrdef d ON a.attrelid = d.adrelid AND a.attnum = d.adnum "
+    "LEFT JOIN pg_collation col ON a.attcollation = col.oid AND a.attcollation <> 0 "
+    "WHERE a.attnum > 0 "
+    "  AND NOT a.attisdropped "
+    "ORDER BY t.pos, a.attnum";
+
 /* Populate columns for multiple tables in a single batch query */
 bool db_populate_columns(DBConnection *conn, const char *schema,
                         CreateTableStmt **stmts, int stmt_count,
@@ -12,43 +34,9 @@ bool db_populate_columns(DBConnection *conn, const char *schema,
         return false;
     }
 
-    /* Build query with all table names */
-    char query[8192];
-    int offset = snprintf(query, sizeof(query),
-             "SELECT "
-             "  c.relname, "                    /* table name */
-             "  a.attname, "                    /* column name */
-             "  pg_catalog.format_type(a.atttypid, a.atttypmod), " /* data type */
-             "  a.attnotnull, "                 /* NOT NULL */
-             "  pg_get_expr(d.adbin, d.adrelid), " /* DEFAULT value */
-             "  a.attidentity, "                /* GENERATED identity */
-             "  a.attgenerated, "               /* GENERATED column */
-             "  col.collname, "                 /* COLLATE */
-             "  a.attstorage "                  /* STORAGE */
-             "FROM pg_attribute a "
-             "JOIN pg_class c ON a.attrelid = c.oid "
-             "JOIN pg_namespace n ON c.relnamespace = n.oid "
-             "LEFT JOIN pg_attrdef d ON a.attrelid = d.adrelid AND a.attnum = d.adnum "
-             "LEFT JOIN pg_collation col ON a.attcollation = col.oid AND a.attcollation <> 0 "
-             "WHERE n.nspname = '%s' "
-             "  AND c.relname IN (", schema);
-
-    /* Add table names */
-    for (int i = 0; i < stmt_count; i++) {
-        if (i > 0) {
-            offset += snprintf(query + offset, sizeof(query) - offset, ", ");
-        }
-        offset += snprintf(query + offset, sizeof(query) - offset, "'%s'",
-                          stmts[i]->table_name);
-    }
-
-    offset += snprintf(query + offset, sizeof(query) - offset,
-             ") "
-             "  AND a.attnum > 0 "
-             "  AND NOT a.attisdropped "
-             "ORDER BY c.relname, a.attnum");
-
-    PGresult *res = PQexec(conn->conn, query);
+    int span = TRACE_BEGIN(TRACE_PHASE_INTROSPECT, "catalog_query", "columns");
+    PGresult *res = db_catalog_exec(conn, CATALOG_COLUMNS, schema, stmts, stmt_count);
+    TRACE_END(span);
     if (PQresultStatus(res) != PGRES_TUPLES_OK) {
         log_error("Failed to query columns in batch: %s", PQerrorMessage(conn->conn));
         PQclear(res);
@@ -63,36 +51,25 @@ bool db_populate_columns(DBConnection *conn, const char *schema,
     }
 
     /* Process results and organize by table */
-    const char *current_table = NULL;
     CreateTableStmt *current_stmt = NULL;
     TableElement *head = NULL;
     TableElement *tail = NULL;
 
     for (int i = 0; i < nrows; i++) {
-        const char *table_name = PQgetvalue(res, i, 0);
+        CreateTableStmt *stmt = db_catalog_row_table(res, i, stmts, stmt_count);
+        if (!stmt) {
+            log_error("Could not find statement for table at position %s", PQgetvalue(res, i, 0));
+            PQclear(res);
+            return false;
+        }
 
         /* Check if we've moved to a new table */
-        if (!current_table || strcmp(current_table, table_name) != 0) {
+        if (stmt != current_stmt) {
             /* Save previous table's columns */
             if (current_stmt) {
                 current_stmt->table_def.regular.elements = head;
             }
-
-            /* Find the statement for this table */
-            current_table = table_name;
-            current_stmt = NULL;
-            for (int j = 0; j < stmt_count; j++) {
-                if (strcmp(stmts[j]->table_name, table_name) == 0) {
-                    current_stmt = stmts[j];
-                    break;
-                }
-            }
-
-            if (!current_stmt) {
-                log_error("Could not find statement for table %s", table_name);
-                PQclear(res);
-                return false;
-            }
+            current_stmt = stmt;
 
             /* Reset list for new table */
             head = NULL;
@@ -116,8 +93,9 @@ bool db_populate_columns(DBConnection *conn, const char *schema,
             return false;
         }
 
-        /* Column name (index 1 now because table name is first) */
+        /* Column name (index 1 now because table position is first) */
         col->column_name = mem_strdup(mem_ctx, PQgetvalue(res, i, 1));
+        col->attnum = atoi(PQgetvalue(res, i, 9));
 
         /* Data type */
         col->data_type = mem_strdup(mem_ctx, PQgetvalue(res, i, 2));
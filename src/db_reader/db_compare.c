@@ -0,0 +1,182 @@
+#include "db_reader.h"
+#include "utils.h"
+#include "trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Result columns of the drift query */
+enum {
+    DRIFT_COL_TABLE,
+    DRIFT_COL_IN_CURRENT,
+    DRIFT_COL_IN_DESIRED
+};
+
+/* Tables that differ between two schemas of one database: pg_class,
+ * pg_attribute and pg_constraint rows of the current ($1) and desired ($2)
+ * schema, full-joined by table name, (table, column) and (table,
+ * constraint). Only the names of tables with a differing row come back.
+ * Each side's own schema qualifier is stripped from rendered types,
+ * defaults and constraint definitions, so a reference to staging.t and
+ * one to prod.t compare equal. */
+const char db_drift_sql[] =
+    "WITH rel AS ( "
+    "  SELECT c.oid, c.relname, n.nspname, c.relkind, c.relpersistence, ts.spcname, "
+    "         quote_ident(n.nspname) || '.' AS qualifier "
+    "  FROM pg_class c "
+    "  JOIN pg_namespace n ON n.oid = c.relnamespace "
+    "  LEFT JOIN pg_tablespace ts ON ts.oid = c.reltablespace "
+    "  WHERE n.nspname IN ($1, $2) AND c.relkind IN ('r', 'p') "
+    "), col AS ( "
+    "  SELECT r.nspname, r.relname, a.attname, "
+    "         replace(format_type(a.atttypid, a.atttypmod), r.qualifier, '') AS type, "
+    "         replace(pg_get_expr(d.adbin, d.adrelid), r.qualifier, '') AS def, "
+    "         a.attnotnull, a.attidentity, a.attgenerated, a.attcollation, a.attstorage "
+    "  FROM rel r "
+    "  JOIN pg_attribute a ON a.attrelid = r.oid AND a.attnum > 0 AND NOT a.attisdropped "
+    "  LEFT JOIN pg_attrdef d ON d.adrelid = a.attrelid AND d.adnum = a.attnum "
+    "), con AS ( "
+    "  SELECT r.nspname, r.relname, k.conname, "
+    "         replace(pg_get_constraintdef(k.oid), r.qualifier, '') AS def "
+    "  FROM rel r "
+    "  JOIN pg_constraint k ON k.conrelid = r.oid "
+    "), drift(relname) AS ( "
+    "  SELECT coalesce(c.relname, d.relname) "
+    "  FROM (SELECT * FROM rel WHERE nspname = $1) c "
+    "  FULL JOIN (SELECT * FROM rel WHERE nspname = $2) d ON d.relname = c.relname "
+    "  WHERE (c.relkind, c.relpersistence, c.spcname) "
+    "        IS DISTINCT FROM (d.relkind, d.relpersistence, d.spcname) "
+    "  UNION "
+    "  SELECT coalesce(c.relname, d.relname) "
+    "  FROM (SELECT * FROM col WHERE nspname = $1) c "
+    "  FULL JOIN (SELECT * FROM col WHERE nspname = $2) d "
+    "    ON d.relname = c.relname AND d.attname = c.attname "
+    "  WHERE (c.type, c.def, c.attnotnull, c.attidentity, c.attgenerated, c.attcollation, c.attstorage) "
+    "        IS DISTINCT FROM "
+    "        (d.type, d.def, d.attnotnull, d.attidentity, d.attgenerated, d.attcollation, d.attstorage) "
+    "  UNION "
+    "  SELECT coalesce(c.relname, d.relname) "
+    "  FROM (SELECT * FROM con WHERE nspname = $1) c "
+    "  FULL JOIN (SELECT * FROM con WHERE nspname = $2) d "
+    "    ON d.relname = c.relname AND d.conname = c.conname "
+    "  WHERE c.def IS DISTINCT FROM d.def "
+    ") "
+    "SELECT t.relname::text, "
+    "       EXISTS (SELECT 1 FROM rel r WHERE r.nspname = $1 AND r.relname = t.relname), "
+    "       EXISTS (SELECT 1 FROM rel r WHERE r.nspname = $2 AND r.relname = t.relname) "
+    "FROM drift t "
+    "ORDER BY 1";
+
+/* Render catalog text (types, defaults, constraint definitions) relative
+ * to one schema, so both sides come out unqualified */
+static bool use_schema(DBConnection *conn, const char *schema) {
+    char *path = db_escape_identifier(schema);
+    if (!path) {
+        return false;
+    }
+
+    const char *params[1] = {path};
+    PGresult *res = PQexecParams(conn->conn,
+                                 "SELECT pg_catalog.set_config('search_path', $1, false)",
+                                 1, NULL, params, NULL, NULL, 0);
+    bool ok = PQresultStatus(res) == PGRES_TUPLES_OK;
+    if (!ok) {
+        log_error("Failed to set search_path to %s: %s", schema, PQresultErrorMessage(res));
+    }
+    PQclear(res);
+    free(path);
+    return ok;
+}
+
+/* One side of the comparison: its drifting tables, and all of its types
+ * and indexes */
+static bool read_side(DBConnection *conn, const char *schema_name,
+                      const char *const *names, int name_count,
+                      Schema *schema, MemoryContext *mem_ctx) {
+    if (!use_schema(conn, schema_name)) {
+        return false;
+    }
+
+    PGresult *results[2];
+    static const CatalogQuery queries[] = {CATALOG_TYPES, CATALOG_INDEXES};
+    int span = TRACE_BEGIN(TRACE_PHASE_INTROSPECT, "catalog_query", "type_and_index_list");
+    bool ok = db_catalog_exec_batch(conn, queries, 2, schema_name, results);
+    TRACE_END(span);
+    if (!ok) {
+        return false;
+    }
+    schema->types = db_types_from_result(results[0], &schema->type_count, mem_ctx);
+    PQclear(results[0]);
+    schema->indexes = db_indexes_from_result(results[1], &schema->index_count, mem_ctx);
+    PQclear(results[1]);
+
+    if (name_count > 0) {
+        schema->tables = db_read_tables(conn, schema_name, names, name_count, mem_ctx);
+        if (!schema->tables) {
+            return false;
+        }
+        schema->table_count = name_count;
+    }
+
+    log_info("Read %d drifting tables from schema %s", schema->table_count, schema_name);
+    return true;
+}
+
+/* Compare two schemas of the connected database on the server and read
+ * back only what differs: *current and *desired get the tables that are
+ * missing on the other side or differ from it, plus every type and index.
+ * Diffing them with compare_schemas gives the same result as diffing the
+ * complete schemas. Both schemas are returned even on failure, for the
+ * caller to free. Leaves search_path set to the desired schema. */
+bool db_read_drift(DBConnection *conn, const char *current_schema, const char *desired_schema,
+                   Schema **current, Schema **desired, MemoryContext *mem_ctx) {
+    *current = mem_alloc(mem_ctx, sizeof(Schema));
+    *desired = mem_alloc(mem_ctx, sizeof(Schema));
+    if (!*current || !*desired) {
+        return false;
+    }
+    memset(*current, 0, sizeof(Schema));
+    memset(*desired, 0, sizeof(Schema));
+    if (!conn || !db_is_connected(conn)) {
+        return false;
+    }
+
+    const char *params[2] = {current_schema, desired_schema};
+    int span = TRACE_BEGIN(TRACE_PHASE_INTROSPECT, "catalog_query", "drift");
+    PGresult *res = db_catalog_exec_params(conn, CATALOG_DRIFT, params);
+    TRACE_END(span);
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        log_error("Failed to compare schemas %s and %s: %s", current_schema, desired_schema,
+                  PQerrorMessage(conn->conn));
+        PQclear(res);
+        return false;
+    }
+
+    int nrows = PQntuples(res);
+    const char **names = malloc(sizeof(char *) * (2 * nrows + 1));
+    if (!names) {
+        PQclear(res);
+        return false;
+    }
+
+    /* Current tables in the first half, desired ones in the second */
+    int current_count = 0;
+    int desired_count = 0;
+    const char **desired_names = names + nrows;
+    for (int i = 0; i < nrows; i++) {
+        const char *name = PQgetvalue(res, i, DRIFT_COL_TABLE);
+        if (PQgetvalue(res, i, DRIFT_COL_IN_CURRENT)[0] == 't') {
+            names[current_count++] = name;
+        }
+        if (PQgetvalue(res, i, DRIFT_COL_IN_DESIRED)[0] == 't') {
+            desired_names[desired_count++] = name;
+        }
+    }
+    log_info("%d tables differ between schemas %s and %s", nrows, current_schema, desired_schema);
+
+    bool ok = read_side(conn, current_schema, names, current_count, *current, mem_ctx) &&
+              read_side(conn, desired_schema, desired_names, desired_count, *desired, mem_ctx);
+
+    free(names);
+    PQclear(res);
+    return ok;
+}
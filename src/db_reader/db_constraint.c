@@ -1,5 +1,6 @@
 #include "db_reader.h"
 #include "utils.h"
+#include "trace.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -7,8 +8,8 @@
 /* Helper function to process a single constraint and add it to a statement */
 static bool process_constraint(const char *conname, const char *contype,
                               const char *condef, const char *condeferrable,
-                              const char *condeferred, CreateTableStmt *stmt,
-                              MemoryContext *mem_ctx) {
+                              const char *condeferred, uint32_t conoid,
+                              CreateTableStmt *stmt, MemoryContext *mem_ctx) {
     /* Find end of element list for this statement */
     TableElement *tail = stmt->table_def.regular.elements;
     while (tail && tail->next) {
@@ -22,6 +23,7 @@ static bool process_constraint(const char *conname, const char *contype,
     }
 
     constraint->constraint_name = mem_strdup(mem_ctx, conname);
+    constraint->conoid = conoid;
     constraint->next = NULL;
 
     /* Set deferrable flags */
@@ -347,6 +349,20 @@ static bool process_constraint(const char *conname, const char *contype,
     return true;
 }
 
+/* Constraints of the tables whose OIDs are in $1, in table and name order */
+const char db_constraints_sql[] =
+    "SELECT "
+    "  t.pos, "                    /* position in $1 */
+    "  con.conname, "              /* constraint name */
+    "  con.contype, "              /* constraint type */
+    "  pg_get_constraintdef(con.oid), " /* constraint definition */
+    "  con.condeferrable, "        /* deferrable */
+    "  con.condeferred, "          /* initially deferred */
+    "  con.oid "
+    "FROM unnest($1::oid[]) WITH ORDINALITY AS t(relid, pos) "
+    "JOIN pg_constraint con ON con.conrelid = t.relid "
+    "ORDER BY t.pos, con.conname";
+
 /* Populate constraints for multiple tables in a single batch query */
 bool db_populate_constraints(DBConnection *conn, const char *schema,
                              CreateTableStmt **stmts, int stmt_count,
@@ -355,35 +371,9 @@ bool db_populate_constraints(DBConnection *conn, const char *schema,
         return false;
     }
 
-    /* Build query with all table names */
-    char query[8192];
-    int offset = snprintf(query, sizeof(query),
-             "SELECT "
-             "  c.relname, "                /* table name */
-             "  con.conname, "              /* constraint name */
-             "  con.contype, "              /* constraint type */
-             "  pg_get_constraintdef(con.oid), " /* constraint definition */
-             "  con.condeferrable, "        /* deferrable */
-             "  con.condeferred "           /* initially deferred */
-             "FROM pg_constraint con "
-             "JOIN pg_class c ON con.conrelid = c.oid "
-             "JOIN pg_namespace n ON c.relnamespace = n.oid "
-             "WHERE n.nspname = '%s' "
-             "  AND c.relname IN (", schema);
-
-    /* Add table names */
-    for (int i = 0; i < stmt_count; i++) {
-        if (i > 0) {
-            offset += snprintf(query + offset, sizeof(query) - offset, ", ");
-        }
-        offset += snprintf(query + offset, sizeof(query) - offset, "'%s'",
-                          stmts[i]->table_name);
-    }
-
-    offset += snprintf(query + offset, sizeof(query) - offset,
-             ") ORDER BY c.relname, con.conname");
-
-    PGresult *res = PQexec(conn->conn, query);
+    int span = TRACE_BEGIN(TRACE_PHASE_INTROSPECT, "catalog_query", "constraints");
+    PGresult *res = db_catalog_exec(conn, CATALOG_CONSTRAINTS, schema, stmts, stmt_count);
+    TRACE_END(span);
     if (PQresultStatus(res) != PGRES_TUPLES_OK) {
         log_error("Failed to query constraints in batch: %s", PQerrorMessage(conn->conn));
         PQclear(res);
@@ -399,31 +389,23 @@ bool db_populate_constraints(DBConnection *conn, const char *schema,
 
     /* Process results and organize by table */
     for (int i = 0; i < nrows; i++) {
-        const char *table_name = PQgetvalue(res, i, 0);
         const char *conname = PQgetvalue(res, i, 1);
         const char *contype = PQgetvalue(res, i, 2);
         const char *condef = PQgetvalue(res, i, 3);
         const char *condeferrable = PQgetvalue(res, i, 4);
         const char *condeferred = PQgetvalue(res, i, 5);
+        uint32_t conoid = (uint32_t)strtoul(PQgetvalue(res, i, 6), NULL, 10);
 
-        /* Find the statement for this table */
-        CreateTableStmt *stmt = NULL;
-        for (int j = 0; j < stmt_count; j++) {
-            if (strcmp(stmts[j]->table_name, table_name) == 0) {
-                stmt = stmts[j];
-                break;
-            }
-        }
-
+        CreateTableStmt *stmt = db_catalog_row_table(res, i, stmts, stmt_count);
         if (!stmt) {
-            log_error("Could not find statement for table %s", table_name);
+            log_error("Could not find statement for table at position %s", PQgetvalue(res, i, 0));
             PQclear(res);
             return false;
         }
 
         /* Process this constraint */
-        if (!process_constraint(conname, contype, condef,
-                               condeferrable, condeferred, stmt, mem_ctx)) {
+        if (!process_constraint(conname, contype, condef, condeferrable, condeferred,
+                                conoid, stmt, mem_ctx)) {
             PQclear(res);
             return false;
         }
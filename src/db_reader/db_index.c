@@ -0,0 +1,189 @@
+#include "db_reader.h"
+#include "pg_create_index.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* Result columns of the index query */
+enum {
+    INDEX_COL_TABLE,
+    INDEX_COL_NAME,
+    INDEX_COL_UNIQUE,
+    INDEX_COL_METHOD,
+    INDEX_COL_PREDICATE,
+    INDEX_COL_POSITION,
+    INDEX_COL_IS_KEY,        /* key column, not INCLUDE */
+    INDEX_COL_IS_EXPRESSION,
+    INDEX_COL_DEFINITION,    /* column name or expression text */
+    INDEX_COL_OPCLASS,       /* only when not the default for the type */
+    INDEX_COL_COLLATION,     /* only when not the column's own */
+    INDEX_COL_DESC,
+    INDEX_COL_NULLS_FIRST,
+    INDEX_COL_NULLS_NOT_DISTINCT,
+    INDEX_COL_OPTIONS,       /* reloptions as name=value,... */
+    INDEX_COL_TABLESPACE
+};
+
+/* One row per index column, in table, index and column order. Indexes
+ * backing a primary key, unique or exclusion constraint belong to the
+ * constraint and are left out, as are partition children of an index on a
+ * partitioned table. Sent in the same batch as the table list. */
+const char db_index_sql[] =
+    "SELECT t.relname::text, ic.relname::text, i.indisunique, am.amname::text, "
+    "       pg_get_expr(i.indpred, i.indrelid, true), k.n, "
+    "       k.n <= i.indnkeyatts, i.indkey[k.n - 1] = 0, "
+    "       pg_get_indexdef(i.indexrelid, k.n, true), "
+    "       CASE WHEN k.n <= i.indnkeyatts AND NOT opc.opcdefault THEN opc.opcname::text END, "
+    "       CASE WHEN k.n <= i.indnkeyatts AND co.oid IS NOT NULL "
+    "                 AND co.collname <> 'default' "
+    "                 AND co.oid IS DISTINCT FROM a.attcollation THEN co.collname::text END, "
+    "       k.n <= i.indnkeyatts AND (i.indoption[k.n - 1] & 1) <> 0, "
+    "       k.n <= i.indnkeyatts AND (i.indoption[k.n - 1] & 2) <> 0, "
+    "       pg_get_indexdef(i.indexrelid) LIKE '% NULLS NOT DISTINCT%', "
+    "       array_to_string(ic.reloptions, ','), ts.spcname::text "
+    "FROM pg_index i "
+    "JOIN pg_class t ON t.oid = i.indrelid AND t.relkind IN ('r', 'p') "
+    "JOIN pg_namespace n ON n.oid = t.relnamespace "
+    "JOIN pg_class ic ON ic.oid = i.indexrelid "
+    "JOIN pg_am am ON am.oid = ic.relam "
+    "LEFT JOIN pg_tablespace ts ON ts.oid = ic.reltablespace "
+    "CROSS JOIN LATERAL generate_series(1, i.indnatts) AS k(n) "
+    "LEFT JOIN pg_opclass opc ON k.n <= i.indnkeyatts AND opc.oid = i.indclass[k.n - 1] "
+    "LEFT JOIN pg_collation co ON k.n <= i.indnkeyatts AND co.oid = i.indcollation[k.n - 1] "
+    "LEFT JOIN pg_attribute a ON a.attrelid = i.indrelid AND a.attnum = i.indkey[k.n - 1] "
+    "WHERE n.nspname = $1 AND NOT ic.relispartition "
+    "  AND NOT EXISTS (SELECT 1 FROM pg_constraint con "
+    "                  WHERE con.conindid = i.indexrelid AND con.contype IN ('p', 'u', 'x')) "
+    "ORDER BY 1, 2, 6";
+
+static char *value_or_null(PGresult *res, int row, int col, MemoryContext *mem_ctx) {
+    return PQgetisnull(res, row, col) ? NULL : mem_strdup(mem_ctx, PQgetvalue(res, row, col));
+}
+
+static bool is_true(PGresult *res, int row, int col) {
+    return !PQgetisnull(res, row, col) && PQgetvalue(res, row, col)[0] == 't';
+}
+
+/* Split "name=value,name=value" into a storage parameter list */
+static StorageParameterList *parse_reloptions(const char *options, MemoryContext *mem_ctx) {
+    StorageParameterList *list = mem_alloc(mem_ctx, sizeof(StorageParameterList));
+    if (!list) {
+        return NULL;
+    }
+    list->count = 0;
+    list->parameters = NULL;
+
+    const char *p = options;
+    while (*p) {
+        const char *end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        const char *eq = memchr(p, '=', len);
+        if (eq) {
+            StorageParameter *params = mem_realloc(mem_ctx, list->parameters,
+                                                   sizeof(StorageParameter) * (list->count + 1));
+            if (!params) {
+                break;
+            }
+            list->parameters = params;
+            list->parameters[list->count].name = mem_strndup(mem_ctx, p, eq - p);
+            list->parameters[list->count].value = mem_strndup(mem_ctx, eq + 1, len - (eq - p) - 1);
+            list->count++;
+        }
+        p += len;
+        if (*p == ',') {
+            p++;
+        }
+    }
+    return list;
+}
+
+/* Add one key or INCLUDE column row to its index */
+static bool add_index_column(CreateIndexStmt *stmt, PGresult *res, int row, MemoryContext *mem_ctx) {
+    const char *definition = PQgetvalue(res, row, INDEX_COL_DEFINITION);
+
+    if (!is_true(res, row, INDEX_COL_IS_KEY)) {
+        char **columns = mem_realloc(mem_ctx, stmt->include_columns,
+                                     sizeof(char *) * (stmt->include_count + 1));
+        if (!columns) {
+            return false;
+        }
+        stmt->include_columns = columns;
+        stmt->include_columns[stmt->include_count++] = mem_strdup(mem_ctx, definition);
+        return true;
+    }
+
+    IndexElement *elements = mem_realloc(mem_ctx, stmt->elements,
+                                         sizeof(IndexElement) * (stmt->element_count + 1));
+    if (!elements) {
+        return false;
+    }
+    stmt->elements = elements;
+    IndexElement *elem = &stmt->elements[stmt->element_count++];
+    memset(elem, 0, sizeof(IndexElement));
+
+    if (is_true(res, row, INDEX_COL_IS_EXPRESSION)) {
+        elem->expression = mem_strdup(mem_ctx, definition);
+    } else {
+        elem->column_name = mem_strdup(mem_ctx, definition);
+    }
+    elem->opclass = value_or_null(res, row, INDEX_COL_OPCLASS, mem_ctx);
+    elem->collation = value_or_null(res, row, INDEX_COL_COLLATION, mem_ctx);
+
+    bool desc = is_true(res, row, INDEX_COL_DESC);
+    bool nulls_first = is_true(res, row, INDEX_COL_NULLS_FIRST);
+    elem->sort_order = desc ? SORT_DESC : SORT_ASC;
+    elem->nulls_order = nulls_first ? NULLS_FIRST : NULLS_LAST;
+    /* NULLS FIRST is the default for DESC and NULLS LAST for ASC */
+    elem->has_nulls_order = nulls_first != desc;
+    return true;
+}
+
+/* Build CREATE INDEX statements from the rows of db_index_sql */
+CreateIndexStmt **db_indexes_from_result(PGresult *res, int *index_count, MemoryContext *mem_ctx) {
+    *index_count = 0;
+    int nrows = PQntuples(res);
+    if (nrows == 0) {
+        return NULL;
+    }
+
+    /* At most one index per row */
+    CreateIndexStmt **indexes = mem_alloc(mem_ctx, sizeof(CreateIndexStmt *) * nrows);
+    if (!indexes) {
+        return NULL;
+    }
+
+    int count = 0;
+    CreateIndexStmt *stmt = NULL;
+    for (int i = 0; i < nrows; i++) {
+        const char *table_name = PQgetvalue(res, i, INDEX_COL_TABLE);
+        const char *index_name = PQgetvalue(res, i, INDEX_COL_NAME);
+        if (!stmt || strcmp(stmt->index_name, index_name) != 0 ||
+            strcmp(stmt->table_name, table_name) != 0) {
+            stmt = create_index_stmt_alloc(mem_ctx);
+            if (!stmt) {
+                log_error("Failed to allocate CreateIndexStmt");
+                break;
+            }
+            stmt->index_name = mem_strdup(mem_ctx, index_name);
+            stmt->table_name = mem_strdup(mem_ctx, table_name);
+            stmt->unique = is_true(res, i, INDEX_COL_UNIQUE);
+            stmt->nulls_not_distinct = is_true(res, i, INDEX_COL_NULLS_NOT_DISTINCT);
+            stmt->access_method = mem_strdup(mem_ctx, PQgetvalue(res, i, INDEX_COL_METHOD));
+            stmt->where_clause = value_or_null(res, i, INDEX_COL_PREDICATE, mem_ctx);
+            stmt->tablespace_name = value_or_null(res, i, INDEX_COL_TABLESPACE, mem_ctx);
+            if (!PQgetisnull(res, i, INDEX_COL_OPTIONS)) {
+                stmt->with_options = parse_reloptions(PQgetvalue(res, i, INDEX_COL_OPTIONS), mem_ctx);
+            }
+            indexes[count++] = stmt;
+        }
+
+        if (!add_index_column(stmt, res, i, mem_ctx)) {
+            log_error("Failed to read index %s", index_name);
+            break;
+        }
+    }
+
+    *index_count = count;
+    return indexes;
+}
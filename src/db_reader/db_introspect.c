@@ -27,21 +27,30 @@ Schema *db_read_schema(DBConnection *conn, const char *schema_name,
     schema->type_count = 0;
     schema->tables = NULL;
     schema->table_count = 0;
+    schema->indexes = NULL;
+    schema->index_count = 0;
     schema->functions = NULL;
     schema->function_count = 0;
     schema->procedures = NULL;
     schema->procedure_count = 0;
+    schema->files = NULL;
+    schema->file_count = 0;
 
-    /* Read tables */
-    schema->tables = db_read_all_tables(conn, schema_name, &schema->table_count, mem_ctx);
+    /* Read tables, types and indexes (listed in one catalog round trip) */
+    db_read_schema_objects(conn, schema_name, schema, mem_ctx);
     if (!schema->tables) {
         log_warn("No tables found in schema %s", schema_name);
     } else {
         log_info("Read %d tables from schema %s", schema->table_count, schema_name);
     }
+    if (schema->type_count > 0) {
+        log_info("Read %d types from schema %s", schema->type_count, schema_name);
+    }
+    if (schema->index_count > 0) {
+        log_info("Read %d indexes from schema %s", schema->index_count, schema_name);
+    }
 
-    /* Future: Read types, functions, procedures */
-    /* schema->types = db_read_types(conn, schema_name, &schema->type_count, mem_ctx); */
+    /* Future: Read functions, procedures */
     /* schema->functions = db_read_functions(conn, schema_name, &schema->function_count, mem_ctx); */
     /* schema->procedures = db_read_procedures(conn, schema_name, &schema->procedure_count, mem_ctx); */
 
@@ -0,0 +1,173 @@
+#include "db_reader.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/* Idle connections for one target, keyed by its conninfo string */
+typedef struct {
+    char *key;
+    DBConnection **idle;
+    int idle_count;
+} DBPoolSlot;
+
+/* Connection pool implementation */
+struct DBPool {
+    DBPoolSlot *slots;
+    int slot_count;
+    int max_idle;
+    DBPoolStats stats;
+    pthread_mutex_t lock;
+};
+
+/* Create a pool keeping up to max_idle connections per target */
+DBPool *db_pool_create(int max_idle) {
+    DBPool *pool = calloc(1, sizeof(DBPool));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->max_idle = max_idle > 0 ? max_idle : 1;
+    pthread_mutex_init(&pool->lock, NULL);
+    return pool;
+}
+
+/* Disconnect all idle connections and free the pool */
+void db_pool_destroy(DBPool *pool) {
+    if (!pool) {
+        return;
+    }
+
+    for (int i = 0; i < pool->slot_count; i++) {
+        for (int j = 0; j < pool->slots[i].idle_count; j++) {
+            db_disconnect(pool->slots[i].idle[j]);
+        }
+        free(pool->slots[i].idle);
+        free(pool->slots[i].key);
+    }
+    free(pool->slots);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+/* Find (or add) the slot for a conninfo key; caller holds the lock */
+static DBPoolSlot *pool_slot(DBPool *pool, const char *key, bool create) {
+    for (int i = 0; i < pool->slot_count; i++) {
+        if (strcmp(pool->slots[i].key, key) == 0) {
+            return &pool->slots[i];
+        }
+    }
+
+    if (!create) {
+        return NULL;
+    }
+
+    DBPoolSlot *slots = realloc(pool->slots, sizeof(DBPoolSlot) * (pool->slot_count + 1));
+    if (!slots) {
+        return NULL;
+    }
+    pool->slots = slots;
+
+    DBPoolSlot *slot = &pool->slots[pool->slot_count];
+    slot->key = strdup(key);
+    slot->idle = calloc(pool->max_idle, sizeof(DBConnection *));
+    slot->idle_count = 0;
+    if (!slot->key || !slot->idle) {
+        free(slot->key);
+        free(slot->idle);
+        return NULL;
+    }
+    pool->slot_count++;
+    return slot;
+}
+
+/* An idle connection is reusable if it is up and not inside a transaction */
+static bool connection_reusable(DBConnection *conn) {
+    return db_is_connected(conn) && PQtransactionStatus(conn->conn) == PQTRANS_IDLE;
+}
+
+/* Take an idle connection for config, or open a new one */
+DBConnection *db_pool_acquire(DBPool *pool, const DBConfig *config) {
+    if (!pool || !config) {
+        return NULL;
+    }
+
+    char *key = db_build_conninfo(config);
+    if (!key) {
+        return NULL;
+    }
+
+    DBConnection *conn = NULL;
+    pthread_mutex_lock(&pool->lock);
+    DBPoolSlot *slot = pool_slot(pool, key, false);
+    while (slot && slot->idle_count > 0 && !conn) {
+        DBConnection *candidate = slot->idle[--slot->idle_count];
+        if (connection_reusable(candidate)) {
+            conn = candidate;
+            pool->stats.reused++;
+        } else {
+            db_disconnect(candidate);
+            pool->stats.discarded++;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    free(key);
+
+    if (conn) {
+        return conn;
+    }
+
+    conn = db_connect(config);
+    pthread_mutex_lock(&pool->lock);
+    pool->stats.connects++;
+    pthread_mutex_unlock(&pool->lock);
+    return conn;
+}
+
+/* Return a connection; broken or surplus connections are closed */
+void db_pool_release(DBPool *pool, DBConnection *conn, bool healthy) {
+    if (!conn) {
+        return;
+    }
+    if (!pool || !healthy || !connection_reusable(conn)) {
+        if (pool) {
+            pthread_mutex_lock(&pool->lock);
+            pool->stats.discarded++;
+            pthread_mutex_unlock(&pool->lock);
+        }
+        db_disconnect(conn);
+        return;
+    }
+
+    char *key = db_build_conninfo(&conn->config);
+    pthread_mutex_lock(&pool->lock);
+    DBPoolSlot *slot = key ? pool_slot(pool, key, true) : NULL;
+    bool kept = slot && slot->idle_count < pool->max_idle;
+    if (kept) {
+        slot->idle[slot->idle_count++] = conn;
+    } else {
+        pool->stats.discarded++;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    free(key);
+
+    if (!kept) {
+        db_disconnect(conn);
+    }
+}
+
+/* Snapshot pool counters */
+void db_pool_get_stats(DBPool *pool, DBPoolStats *stats) {
+    if (!pool || !stats) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    *stats = pool->stats;
+    stats->idle = 0;
+    for (int i = 0; i < pool->slot_count; i++) {
+        stats->idle += pool->slots[i].idle_count;
+    }
+    stats->targets = pool->slot_count;
+    pthread_mutex_unlock(&pool->lock);
+}
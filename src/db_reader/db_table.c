@@ -1,9 +1,33 @@
 #include "db_reader.h"
+#include "catalog_digest.h"
 #include "utils.h"
+#include "trace.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+/* Tables of the schema, by name */
+const char db_table_list_sql[] =
+    "SELECT tablename FROM pg_tables "
+    "WHERE schemaname = $1 "
+    "ORDER BY tablename";
+
+/* Persistence, kind, tablespace, catalog digest and OID of the tables
+ * named in $2. The OID keys every later query on these tables. */
+const char db_table_info_sql[] =
+    "SELECT "
+    "  t.pos, "              /* position in $2 */
+    "  c.relpersistence, "  /* t=temp, u=unlogged, p=permanent */
+    "  c.relkind, "          /* r=ordinary table, p=partitioned table */
+    "  ts.spcname, "         /* tablespace */
+    "  " CATALOG_TABLE_DIGEST_SQL ", "
+    "  c.oid "
+    "FROM unnest($2::name[]) WITH ORDINALITY AS t(relname, pos) "
+    "JOIN pg_class c ON c.relname = t.relname "
+    "JOIN pg_namespace n ON c.relnamespace = n.oid "
+    "LEFT JOIN pg_tablespace ts ON c.reltablespace = ts.oid "
+    "WHERE n.nspname = $1";
+
 /* Populate basic table information for multiple tables in a single batch query */
 bool db_populate_table_info(DBConnection *conn, const char *schema,
                             CreateTableStmt **stmts, int stmt_count,
@@ -12,32 +36,9 @@ bool db_populate_table_info(DBConnection *conn, const char *schema,
         return false;
     }
 
-    /* Build query with all table names */
-    char query[4096];
-    int offset = snprintf(query, sizeof(query),
-             "SELECT "
-             "  c.relname, "          /* table name */
-             "  c.relpersistence, "  /* t=temp, u=unlogged, p=permanent */
-             "  c.relkind, "          /* r=ordinary table, p=partitioned table */
-             "  ts.spcname "          /* tablespace */
-             "FROM pg_class c "
-             "JOIN pg_namespace n ON c.relnamespace = n.oid "
-             "LEFT JOIN pg_tablespace ts ON c.reltablespace = ts.oid "
-             "WHERE n.nspname = '%s' "
-             "  AND c.relname IN (", schema);
-
-    /* Add table names */
-    for (int i = 0; i < stmt_count; i++) {
-        if (i > 0) {
-            offset += snprintf(query + offset, sizeof(query) - offset, ", ");
-        }
-        offset += snprintf(query + offset, sizeof(query) - offset, "'%s'",
-                          stmts[i]->table_name);
-    }
-
-    offset += snprintf(query + offset, sizeof(query) - offset, ")");
-
-    PGresult *res = PQexec(conn->conn, query);
+    int span = TRACE_BEGIN(TRACE_PHASE_INTROSPECT, "catalog_query", "table_info");
+    PGresult *res = db_catalog_exec(conn, CATALOG_TABLE_INFO, schema, stmts, stmt_count);
+    TRACE_END(span);
     if (PQresultStatus(res) != PGRES_TUPLES_OK) {
         log_error("Failed to query table info in batch: %s", PQerrorMessage(conn->conn));
         PQclear(res);
@@ -53,22 +54,13 @@ bool db_populate_table_info(DBConnection *conn, const char *schema,
 
     /* Process results and match to statements */
     for (int i = 0; i < nrows; i++) {
-        const char *table_name = PQgetvalue(res, i, 0);
-
-        /* Find the statement for this table */
-        CreateTableStmt *stmt = NULL;
-        for (int j = 0; j < stmt_count; j++) {
-            if (strcmp(stmts[j]->table_name, table_name) == 0) {
-                stmt = stmts[j];
-                break;
-            }
-        }
-
+        CreateTableStmt *stmt = db_catalog_row_table(res, i, stmts, stmt_count);
         if (!stmt) {
-            log_error("Could not find statement for table %s", table_name);
+            log_error("Could not find statement for table at position %s", PQgetvalue(res, i, 0));
             PQclear(res);
             return false;
         }
+        const char *table_name = stmt->table_name;
 
         /* Parse relpersistence */
         const char *persistence = PQgetvalue(res, i, 1);
@@ -95,6 +87,9 @@ bool db_populate_table_info(DBConnection *conn, const char *schema,
         } else {
             stmt->tablespace_name = NULL;
         }
+
+        stmt->catalog_digest = mem_strdup(mem_ctx, PQgetvalue(res, i, 4));
+        stmt->relid = (uint32_t)strtoul(PQgetvalue(res, i, 5), NULL, 10);
     }
 
     PQclear(res);
@@ -154,9 +149,12 @@ CreateTableStmt *db_read_table(DBConnection *conn, const char *schema,
     return stmt;
 }
 
-/* Read all tables from a schema */
-CreateTableStmt **db_read_all_tables(DBConnection *conn, const char *schema_name,
-                                        int *table_count, MemoryContext *mem_ctx) {
+/* Read all tables from a schema, and its types and indexes into objects
+ * when it is non-NULL. The table list, the type rows and the index rows are
+ * fetched in the same catalog batch. */
+static CreateTableStmt **read_tables(DBConnection *conn, const char *schema_name,
+                                     int *table_count, Schema *objects,
+                                     MemoryContext *mem_ctx) {
     if (!conn || !db_is_connected(conn) || !table_count) {
         return NULL;
     }
@@ -167,91 +165,122 @@ CreateTableStmt **db_read_all_tables(DBConnection *conn, const char *schema_name
 
     *table_count = 0;
 
-    /* Query to get all tables in schema */
-    char query[512];
-    snprintf(query, sizeof(query),
-             "SELECT tablename FROM pg_tables "
-             "WHERE schemaname = '%s' "
-             "ORDER BY tablename",
-             schema_name);
+    PGresult *results[3];
+    static const CatalogQuery queries[] = {CATALOG_TABLE_LIST, CATALOG_TYPES, CATALOG_INDEXES};
+    int query_count = 1;
+    if (objects) {
+        objects->types = NULL;
+        objects->type_count = 0;
+        objects->indexes = NULL;
+        objects->index_count = 0;
+        query_count = 3;
+    }
 
-    PGresult *res = PQexec(conn->conn, query);
-    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
-        log_error("Failed to query tables: %s", PQerrorMessage(conn->conn));
-        PQclear(res);
+    int span = TRACE_BEGIN(TRACE_PHASE_INTROSPECT, "catalog_query",
+                           objects ? "table_type_and_index_list" : "table_list");
+    bool ok = db_catalog_exec_batch(conn, queries, query_count, schema_name, results);
+    TRACE_END(span);
+    if (!ok) {
         return NULL;
     }
 
+    if (objects) {
+        objects->types = db_types_from_result(results[1], &objects->type_count, mem_ctx);
+        PQclear(results[1]);
+        objects->indexes = db_indexes_from_result(results[2], &objects->index_count, mem_ctx);
+        PQclear(results[2]);
+    }
+
+    PGresult *res = results[0];
     int nrows = PQntuples(res);
-    if (nrows == 0) {
-        PQclear(res);
+    const char **names = nrows > 0 ? malloc(sizeof(char *) * nrows) : NULL;
+    for (int i = 0; names && i < nrows; i++) {
+        names[i] = PQgetvalue(res, i, 0);
+    }
+
+    CreateTableStmt **tables = names ?
+        db_read_tables(conn, schema_name, names, nrows, mem_ctx) : NULL;
+    if (tables) {
+        *table_count = nrows;
+    }
+
+    free(names);
+    PQclear(res);
+    return tables;
+}
+
+/* Read the named tables of a schema: table info, columns and constraints,
+ * one batch query each. Every name must exist. */
+CreateTableStmt **db_read_tables(DBConnection *conn, const char *schema_name,
+                                 const char *const *names, int name_count,
+                                 MemoryContext *mem_ctx) {
+    if (name_count <= 0) {
         return NULL;
     }
 
     /* Allocate array for table statements */
-    CreateTableStmt **tables = mem_alloc(mem_ctx, sizeof(CreateTableStmt *) * nrows);
+    CreateTableStmt **tables = mem_alloc(mem_ctx, sizeof(CreateTableStmt *) * name_count);
     if (!tables) {
-        PQclear(res);
         return NULL;
     }
 
     /* Create statements for all tables */
-    int count = 0;
-    for (int i = 0; i < nrows; i++) {
-        const char *table_name = PQgetvalue(res, i, 0);
-
-        log_info("Reading table: %s.%s", schema_name, table_name);
+    for (int i = 0; i < name_count; i++) {
+        log_info("Reading table: %s.%s", schema_name, names[i]);
 
         /* Create statement */
         CreateTableStmt *stmt = create_table_stmt_alloc(mem_ctx);
         if (!stmt) {
             log_error("Failed to allocate CreateTableStmt");
-            continue;
+            return NULL;
         }
 
         /* Initialize */
         stmt->variant = CREATE_TABLE_REGULAR;
-        stmt->table_name = mem_strdup(mem_ctx, table_name);
+        stmt->table_name = mem_strdup(mem_ctx, names[i]);
         stmt->temp_scope = TEMP_SCOPE_NONE;
         stmt->table_type = TABLE_TYPE_NORMAL;
         stmt->if_not_exists = false;
 
-        tables[count++] = stmt;
-    }
-
-    PQclear(res);
-
-    if (count == 0) {
-        *table_count = 0;
-        return NULL;
+        tables[i] = stmt;
     }
 
     /* Batch populate table info for all tables in one query */
-    if (!db_populate_table_info(conn, schema_name, tables, count, mem_ctx)) {
+    if (!db_populate_table_info(conn, schema_name, tables, name_count, mem_ctx)) {
         log_error("Failed to batch populate table info for schema %s", schema_name);
-        *table_count = 0;
         return NULL;
     }
 
     /* Batch populate columns for all tables in one query */
-    if (!db_populate_columns(conn, schema_name, tables, count, mem_ctx)) {
+    if (!db_populate_columns(conn, schema_name, tables, name_count, mem_ctx)) {
         log_error("Failed to batch populate columns for schema %s", schema_name);
-        *table_count = 0;
         return NULL;
     }
 
     /* Batch populate constraints for all tables in one query */
-    if (!db_populate_constraints(conn, schema_name, tables, count, mem_ctx)) {
+    if (!db_populate_constraints(conn, schema_name, tables, name_count, mem_ctx)) {
         log_error("Failed to batch populate constraints for schema %s", schema_name);
-        *table_count = 0;
         return NULL;
     }
 
     /* Log success for all tables */
-    for (int i = 0; i < count; i++) {
+    for (int i = 0; i < name_count; i++) {
         log_info("Successfully read table: %s.%s", schema_name, tables[i]->table_name);
     }
 
-    *table_count = count;
     return tables;
-}
\ No newline at end of file
+}
+
+/* Read all tables from a schema */
+CreateTableStmt **db_read_all_tables(DBConnection *conn, const char *schema_name,
+                                        int *table_count, MemoryContext *mem_ctx) {
+    return read_tables(conn, schema_name, table_count, NULL, mem_ctx);
+}
+
+/* Read all tables, types and indexes of a schema into 'schema'. Returns
+ * false only when the catalog could not be read; an empty schema is fine. */
+bool db_read_schema_objects(DBConnection *conn, const char *schema_name,
+                            Schema *schema, MemoryContext *mem_ctx) {
+    schema->tables = read_tables(conn, schema_name, &schema->table_count, schema, mem_ctx);
+    return schema->tables || schema->table_count == 0;
+}
@@ -0,0 +1,146 @@
+#include "db_reader.h"
+#include "pg_create_type.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* Result columns of the type query */
+enum {
+    TYPE_COL_NAME,
+    TYPE_COL_KIND,          /* e=enum, c=composite, r=range */
+    TYPE_COL_MEMBER,        /* enum label or attribute name */
+    TYPE_COL_MEMBER_TYPE,   /* attribute type or range subtype */
+    TYPE_COL_COLLATION,     /* only when not the member type's default */
+    TYPE_COL_POSITION,
+    TYPE_COL_CANONICAL,
+    TYPE_COL_SUBTYPE_DIFF
+};
+
+/* One row per enum label, composite attribute and range type, in type and
+ * member order. Sent in the same batch as the table list. */
+const char db_type_sql[] =
+    "SELECT t.typname::text, 'e'::text, e.enumlabel::text, NULL::text, NULL::text, "
+    "       e.enumsortorder::float8, NULL::text, NULL::text "
+    "FROM pg_type t "
+    "JOIN pg_namespace n ON n.oid = t.typnamespace "
+    "JOIN pg_enum e ON e.enumtypid = t.oid "
+    "WHERE n.nspname = $1 AND t.typtype = 'e' "
+    "UNION ALL "
+    "SELECT t.typname, 'c', a.attname, format_type(a.atttypid, a.atttypmod), "
+    "       CASE WHEN a.attcollation <> at.typcollation THEN co.collname::text END, "
+    "       a.attnum, NULL, NULL "
+    "FROM pg_type t "
+    "JOIN pg_namespace n ON n.oid = t.typnamespace "
+    "JOIN pg_class c ON c.oid = t.typrelid AND c.relkind = 'c' "
+    "JOIN pg_attribute a ON a.attrelid = c.oid AND a.attnum > 0 AND NOT a.attisdropped "
+    "JOIN pg_type at ON at.oid = a.atttypid "
+    "LEFT JOIN pg_collation co ON co.oid = a.attcollation "
+    "WHERE n.nspname = $1 AND t.typtype = 'c' "
+    "UNION ALL "
+    "SELECT t.typname, 'r', NULL, format_type(r.rngsubtype, NULL), "
+    "       CASE WHEN r.rngcollation <> st.typcollation THEN co.collname::text END, "
+    "       0, "
+    "       CASE WHEN r.rngcanonical::oid <> 0 THEN r.rngcanonical::text END, "
+    "       CASE WHEN r.rngsubdiff::oid <> 0 THEN r.rngsubdiff::text END "
+    "FROM pg_type t "
+    "JOIN pg_namespace n ON n.oid = t.typnamespace "
+    "JOIN pg_range r ON r.rngtypid = t.oid "
+    "JOIN pg_type st ON st.oid = r.rngsubtype "
+    "LEFT JOIN pg_collation co ON co.oid = r.rngcollation "
+    "WHERE n.nspname = $1 AND t.typtype = 'r' "
+    "ORDER BY 1, 6";
+
+static char *value_or_null(PGresult *res, int row, int col, MemoryContext *mem_ctx) {
+    return PQgetisnull(res, row, col) ? NULL : mem_strdup(mem_ctx, PQgetvalue(res, row, col));
+}
+
+/* Fill a type from its rows [first, end): the labels or attributes in one
+ * block, or the range row */
+static bool read_type_members(CreateTypeStmt *stmt, PGresult *res, int first, int end,
+                              MemoryContext *mem_ctx) {
+    int count = end - first;
+    if (stmt->variant == TYPE_VARIANT_ENUM) {
+        const char **labels = malloc(sizeof(char *) * count);
+        if (!labels) {
+            return false;
+        }
+        for (int i = 0; i < count; i++) {
+            labels[i] = PQgetvalue(res, first + i, TYPE_COL_MEMBER);
+        }
+        bool ok = enum_type_def_init(&stmt->type_def.enum_def, labels, count, mem_ctx);
+        free(labels);
+        return ok;
+    }
+
+    if (stmt->variant == TYPE_VARIANT_COMPOSITE) {
+        CompositeAttribute *attrs = malloc(sizeof(CompositeAttribute) * count);
+        if (!attrs) {
+            return false;
+        }
+        for (int i = 0; i < count; i++) {
+            int row = first + i;
+            attrs[i].attr_name = PQgetvalue(res, row, TYPE_COL_MEMBER);
+            attrs[i].data_type = PQgetvalue(res, row, TYPE_COL_MEMBER_TYPE);
+            attrs[i].collation = PQgetisnull(res, row, TYPE_COL_COLLATION) ? NULL :
+                                 PQgetvalue(res, row, TYPE_COL_COLLATION);
+        }
+        bool ok = composite_type_def_init(&stmt->type_def.composite_def, attrs, count, mem_ctx);
+        free(attrs);
+        return ok;
+    }
+
+    RangeTypeDef *def = &stmt->type_def.range_def;
+    def->subtype = mem_strdup(mem_ctx, PQgetvalue(res, first, TYPE_COL_MEMBER_TYPE));
+    def->collation = value_or_null(res, first, TYPE_COL_COLLATION, mem_ctx);
+    def->canonical_function = value_or_null(res, first, TYPE_COL_CANONICAL, mem_ctx);
+    def->subtype_diff_function = value_or_null(res, first, TYPE_COL_SUBTYPE_DIFF, mem_ctx);
+    return true;
+}
+
+/* Build CREATE TYPE statements from the rows of db_type_sql */
+CreateTypeStmt **db_types_from_result(PGresult *res, int *type_count, MemoryContext *mem_ctx) {
+    *type_count = 0;
+    int nrows = PQntuples(res);
+    if (nrows == 0) {
+        return NULL;
+    }
+
+    /* At most one type per row */
+    CreateTypeStmt **types = mem_alloc(mem_ctx, sizeof(CreateTypeStmt *) * nrows);
+    if (!types) {
+        return NULL;
+    }
+
+    int count = 0;
+    int end = 0;
+    for (int first = 0; first < nrows; first = end) {
+        const char *type_name = PQgetvalue(res, first, TYPE_COL_NAME);
+        for (end = first + 1; end < nrows; end++) {
+            if (strcmp(PQgetvalue(res, end, TYPE_COL_NAME), type_name) != 0) {
+                break;
+            }
+        }
+
+        CreateTypeStmt *stmt = create_type_stmt_alloc(mem_ctx);
+        if (!stmt) {
+            log_error("Failed to allocate CreateTypeStmt");
+            break;
+        }
+        stmt->type_name = mem_strdup(mem_ctx, type_name);
+        switch (PQgetvalue(res, first, TYPE_COL_KIND)[0]) {
+            case 'e': stmt->variant = TYPE_VARIANT_ENUM; break;
+            case 'c': stmt->variant = TYPE_VARIANT_COMPOSITE; break;
+            default:  stmt->variant = TYPE_VARIANT_RANGE; break;
+        }
+        types[count++] = stmt;
+
+        if (!read_type_members(stmt, res, first, end, mem_ctx)) {
+            log_error("Failed to read type %s", type_name);
+            break;
+        }
+    }
+
+    *type_count = count;
+    return types;
+}
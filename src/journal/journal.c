@@ -0,0 +1,331 @@
+#include "journal.h"
+#include "sql_generator.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Loaded entry with owned strings */
+typedef struct {
+    JournalEntry entry;
+    char *target;
+    char *output;
+    char *error;
+} StoredEntry;
+
+struct Journal {
+    FILE *file;
+    char *path;
+    HashTable *by_target;         /* target key -> StoredEntry (last line wins) */
+    StoredEntry **stored;         /* every loaded line, for freeing */
+    int stored_count;
+    int stored_capacity;
+    int loaded_count;             /* distinct targets */
+};
+
+static const char *const status_names[] = {
+    [JOURNAL_STATUS_OK] = "ok",
+    [JOURNAL_STATUS_FAILED] = "failed",
+    [JOURNAL_STATUS_TIMED_OUT] = "timed_out",
+};
+
+static const char *status_name(JournalStatus status) {
+    return status_names[status];
+}
+
+/* Unknown statuses read as failed, so the target is retried */
+static JournalStatus parse_status(const char *name) {
+    for (int s = JOURNAL_STATUS_OK; s <= JOURNAL_STATUS_TIMED_OUT; s++) {
+        if (strcmp(name, status_names[s]) == 0) {
+            return (JournalStatus)s;
+        }
+    }
+    return JOURNAL_STATUS_FAILED;
+}
+
+static char *dup_or_null(const char *str) {
+    return str ? strdup(str) : NULL;
+}
+
+static void stored_free(StoredEntry *stored) {
+    free(stored->target);
+    free(stored->output);
+    free(stored->error);
+    free(stored);
+}
+
+/* Parse one journal line; NULL if it is not a complete entry */
+static StoredEntry *parse_line(const char *line) {
+    const char *error = NULL;
+    JsonObject *obj = json_parse_object(line, &error);
+    if (!obj) {
+        return NULL;
+    }
+
+    const char *target = json_object_get_string(obj, "target");
+    const char *status = json_object_get_string(obj, "status");
+    const char *fingerprint = json_object_get_string(obj, "fingerprint");
+    const JsonField *statements = json_object_get(obj, "statements");
+    StoredEntry *stored = NULL;
+
+    if (target && status && fingerprint) {
+        stored = calloc(1, sizeof(StoredEntry));
+    }
+    if (stored) {
+        stored->target = strdup(target);
+        stored->output = dup_or_null(json_object_get_string(obj, "output"));
+        stored->error = dup_or_null(json_object_get_string(obj, "error"));
+        stored->entry.target = stored->target;
+        stored->entry.output = stored->output;
+        stored->entry.error = stored->error;
+        stored->entry.status = parse_status(status);
+        stored->entry.fingerprint = strtoull(fingerprint, NULL, 16);
+        stored->entry.statements = statements && !statements->is_string ? atoi(statements->value)
+                                                                         : 0;
+    }
+
+    json_object_free(obj);
+    return stored;
+}
+
+/* Load every complete line of an existing journal, and cut off a torn tail
+ * so the next append starts a line of its own. A killed run can leave a
+ * partial line or, when the size was extended before the data landed, a run
+ * of NUL bytes; either ends the journal at the last newline before it. */
+static bool journal_load(Journal *journal) {
+    struct stat st;
+    if (stat(journal->path, &st) != 0) {
+        return access(journal->path, F_OK) != 0;  /* missing is fine, unreadable is not */
+    }
+    char *content = read_file_to_string(journal->path);
+    if (!content) {
+        return false;
+    }
+
+    size_t complete = 0;          /* bytes up to the last newline */
+    char *line = content;
+    while (*line) {
+        char *end = strchr(line, '\n');
+        if (!end) {
+            break;                /* torn: no newline before the end or a NUL */
+        }
+        *end = '\0';
+
+        StoredEntry *stored = *line ? parse_line(line) : NULL;
+        if (stored) {
+            if (journal->stored_count == journal->stored_capacity) {
+                int capacity = journal->stored_capacity ? journal->stored_capacity * 2 : 64;
+                StoredEntry **grown = realloc(journal->stored, sizeof(StoredEntry *) * capacity);
+                if (!grown) {
+                    stored_free(stored);
+                    free(content);
+                    return false;
+                }
+                journal->stored = grown;
+                journal->stored_capacity = capacity;
+            }
+            journal->stored[journal->stored_count++] = stored;
+            if (!hash_table_contains(journal->by_target, stored->target)) {
+                journal->loaded_count++;
+            }
+            hash_table_insert(journal->by_target, stored->target, stored);
+        }
+
+        complete = (size_t)(end + 1 - content);
+        line = end + 1;
+    }
+
+    free(content);
+    if ((off_t)complete < st.st_size) {
+        log_warn("Discarding a torn tail of journal %s", journal->path);
+        if (truncate(journal->path, (off_t)complete) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Open a journal, loading previous entries when resuming */
+Journal *journal_open(const char *path, bool resume) {
+    Journal *journal = calloc(1, sizeof(Journal));
+    if (!journal) {
+        return NULL;
+    }
+    journal->path = strdup(path);
+    journal->by_target = hash_table_create(256);
+    if (!journal->path || !journal->by_target) {
+        journal_close(journal);
+        return NULL;
+    }
+
+    if (resume && !journal_load(journal)) {
+        log_error("Cannot read journal %s", path);
+        journal_close(journal);
+        return NULL;
+    }
+
+    journal->file = fopen(path, resume ? "a" : "w");
+    if (!journal->file) {
+        log_error("Cannot open journal %s for writing", path);
+        journal_close(journal);
+        return NULL;
+    }
+    return journal;
+}
+
+void journal_close(Journal *journal) {
+    if (!journal) {
+        return;
+    }
+    if (journal->file) {
+        fclose(journal->file);
+    }
+    for (int i = 0; i < journal->stored_count; i++) {
+        stored_free(journal->stored[i]);
+    }
+    free(journal->stored);
+    hash_table_destroy(journal->by_target);
+    free(journal->path);
+    free(journal);
+}
+
+const JournalEntry *journal_lookup(const Journal *journal, const char *target) {
+    StoredEntry *stored = hash_table_get(journal->by_target, target);
+    return stored ? &stored->entry : NULL;
+}
+
+int journal_loaded_count(const Journal *journal, bool ok_only) {
+    if (!ok_only) {
+        return journal->loaded_count;
+    }
+
+    int count = 0;
+    for (int i = 0; i < journal->stored_count; i++) {
+        const StoredEntry *stored = journal->stored[i];
+        if (stored->entry.status == JOURNAL_STATUS_OK &&
+            hash_table_get(journal->by_target, stored->target) == stored) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/* Append one line and make it durable before the next target is reported */
+bool journal_append(Journal *journal, const JournalEntry *entry) {
+    StringBuilder *sb = sb_create();
+    if (!sb) {
+        return false;
+    }
+
+    sb_append(sb, "{\"target\":");
+    sb_append_json_string(sb, entry->target);
+    sb_append_fmt(sb, ",\"status\":\"%s\",\"fingerprint\":\"%016llx\"",
+                  status_name(entry->status), (unsigned long long)entry->fingerprint);
+    if (entry->output) {
+        sb_append(sb, ",\"output\":");
+        sb_append_json_string(sb, entry->output);
+    }
+    sb_append_fmt(sb, ",\"statements\":%d", entry->statements);
+    if (entry->error) {
+        sb_append(sb, ",\"error\":");
+        sb_append_json_string(sb, entry->error);
+    }
+    sb_append(sb, "}\n");
+
+    char *line = sb_to_string(sb);
+    sb_free(sb);
+    if (!line) {
+        return false;
+    }
+
+    bool ok = fputs(line, journal->file) >= 0 && fflush(journal->file) == 0 &&
+              fsync(fileno(journal->file)) == 0;
+    free(line);
+    if (!ok) {
+        log_error("Failed to write journal %s", journal->path);
+    }
+    return ok;
+}
+
+/* user@host:port/database/schema */
+char *journal_target_key(const SchemaSource *target, const char *schema_name) {
+    const char *schema = schema_name ? schema_name :
+                         (target->schema_name ? target->schema_name : "public");
+    StringBuilder *sb = sb_create();
+    if (!sb) {
+        return NULL;
+    }
+
+    if (target->type == SOURCE_TYPE_DATABASE) {
+        const DBConfig *db = &target->source.db_config;
+        sb_append_fmt(sb, "%s@%s:%s/%s/%s", db->user ? db->user : "",
+                      db->host ? db->host : "", db->port ? db->port : "",
+                      db->database ? db->database : "", schema);
+    } else if (target->type == SOURCE_TYPE_DIRECTORY) {
+        sb_append_fmt(sb, "dir:%s", target->source.directory_path);
+    } else {
+        sb_append_fmt(sb, "file:%s", target->source.file_path);
+    }
+
+    char *key = sb_to_string(sb);
+    sb_free(sb);
+    return key;
+}
+
+/* Hash of the CREATE TABLE, CREATE TYPE and CREATE INDEX text of every
+ * object, in schema order */
+uint64_t journal_schema_digest(const Schema *schema) {
+    uint64_t hash = FNV1A_64_INIT;
+    SQLGenOptions *opts = sql_gen_options_default();
+    if (!opts) {
+        return hash;
+    }
+    opts->add_comments = false;
+
+    for (int i = 0; i < schema->table_count; i++) {
+        StringBuilder *sb = sb_create();
+        if (!sb) {
+            break;
+        }
+        generate_create_table_sql(sb, schema->tables[i], opts);
+        char *sql = sb_to_string(sb);
+        sb_free(sb);
+        if (sql) {
+            hash = fnv1a_64(hash, sql, strlen(sql) + 1);
+            free(sql);
+        }
+    }
+
+    for (int i = 0; i < schema->type_count; i++) {
+        StringBuilder *sb = sb_create();
+        if (!sb) {
+            break;
+        }
+        generate_create_type_sql(sb, schema->types[i], opts);
+        char *sql = sb_to_string(sb);
+        sb_free(sb);
+        if (sql) {
+            hash = fnv1a_64(hash, sql, strlen(sql) + 1);
+            free(sql);
+        }
+    }
+
+    for (int i = 0; i < schema->index_count; i++) {
+        StringBuilder *sb = sb_create();
+        if (!sb) {
+            break;
+        }
+        generate_create_index_sql(sb, schema->indexes[i], NULL, false, opts);
+        char *sql = sb_to_string(sb);
+        sb_free(sb);
+        if (sql) {
+            hash = fnv1a_64(hash, sql, strlen(sql) + 1);
+            free(sql);
+        }
+    }
+
+    sql_gen_options_free(opts);
+    return hash;
+}
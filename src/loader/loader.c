@@ -0,0 +1,423 @@
+#include "schema_compare.h"
+#include "utils.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <limits.h>
+
+/* Load schemas from database */
+Schema *load_from_database(DBConnection *conn, const char *schema_name,
+                           MemoryContext *mem_ctx) {
+    int span = TRACE_BEGIN(TRACE_PHASE_INTROSPECT, "load_from_database", schema_name);
+    Schema *schema = db_read_schema(conn, schema_name, mem_ctx);
+    TRACE_END(span);
+    return schema;
+}
+
+/* Append the statements of a parsed file to a schema. The statement arrays
+ * belong to the parser's memory context, so this must run before the parser
+ * is destroyed; the statements themselves are heap-allocated and survive. */
+static void merge_schema(Schema *dest, const Schema *src, MemoryContext *mem_ctx) {
+    if (src->table_count > 0) {
+        int new_count = dest->table_count + src->table_count;
+        CreateTableStmt **new_tables = mem_realloc(mem_ctx, dest->tables,
+                                                    new_count * sizeof(CreateTableStmt *));
+        if (new_tables) {
+            dest->tables = new_tables;
+            for (int j = 0; j < src->table_count; j++) {
+                dest->tables[dest->table_count++] = src->tables[j];
+            }
+        }
+    }
+
+    if (src->type_count > 0) {
+        int new_count = dest->type_count + src->type_count;
+        CreateTypeStmt **new_types = mem_realloc(mem_ctx, dest->types,
+                                                  new_count * sizeof(CreateTypeStmt *));
+        if (new_types) {
+            dest->types = new_types;
+            for (int j = 0; j < src->type_count; j++) {
+                dest->types[dest->type_count++] = src->types[j];
+            }
+        }
+    }
+
+    if (src->index_count > 0) {
+        int new_count = dest->index_count + src->index_count;
+        CreateIndexStmt **new_indexes = mem_realloc(mem_ctx, dest->indexes,
+                                                     new_count * sizeof(CreateIndexStmt *));
+        if (new_indexes) {
+            dest->indexes = new_indexes;
+            for (int j = 0; j < src->index_count; j++) {
+                dest->indexes[dest->index_count++] = src->indexes[j];
+            }
+        }
+    }
+
+    /* Future: Merge other statement types (functions, procedures) */
+}
+
+/* Reject text that is not UTF-8 before it reaches the lexer, which takes
+ * every high-bit byte for part of a letter */
+static bool check_utf8(const char *sql, const char *name) {
+    size_t offset;
+    if (utf8_validate(sql, strlen(sql), &offset)) {
+        return true;
+    }
+    log_error("Invalid UTF-8 in %s at byte %zu", name ? name : "input", offset);
+    return false;
+}
+
+/* Parse DDL text into a schema; 'name' labels the trace span */
+static Schema *load_from_text(const char *sql, const char *name, MemoryContext *mem_ctx) {
+    if (!check_utf8(sql, name)) {
+        return NULL;
+    }
+
+    Parser *parser = parser_create(sql);
+    if (!parser) {
+        return NULL;
+    }
+
+    /* Parse all statements */
+    int span = TRACE_BEGIN(TRACE_PHASE_PARSE, "parse_file", name);
+    Schema *file_schema = parse_all_statements(parser);
+    TRACE_END(span);
+
+    Schema *schema = NULL;
+    if (file_schema) {
+        schema = mem_calloc(mem_ctx, 1, sizeof(Schema));
+        if (schema) {
+            merge_schema(schema, file_schema, mem_ctx);
+        }
+    }
+
+    parser_destroy(parser);
+    return schema;
+}
+
+/* Load schemas from DDL held in memory */
+Schema *load_from_string(const char *sql, MemoryContext *mem_ctx) {
+    return sql ? load_from_text(sql, NULL, mem_ctx) : NULL;
+}
+
+/* Load schemas from file */
+Schema *load_from_file(const char *file_path, MemoryContext *mem_ctx) {
+    /* Read file content */
+    int span = TRACE_BEGIN(TRACE_PHASE_READ, "read_file", file_path);
+    char *source = read_file_to_string(file_path);
+    TRACE_END(span);
+    if (!source) {
+        return NULL;
+    }
+
+    Schema *schema = load_from_text(source, file_path, mem_ctx);
+    free(source);
+    return schema;
+}
+
+/* Recursively find all .sql files in directory; caller frees each path and the array */
+char **find_sql_files_recursive(const char *dir_path, int *count) {
+    *count = 0;
+    int capacity = 64;
+    char **files = malloc(sizeof(char *) * capacity);
+    if (!files) {
+        return NULL;
+    }
+
+    /* Use a simple stack for directory traversal */
+    char **dir_stack = malloc(sizeof(char *) * 256);
+    if (!dir_stack) {
+        free(files);
+        return NULL;
+    }
+
+    int stack_size = 0;
+    dir_stack[stack_size++] = strdup(dir_path);
+
+    while (stack_size > 0) {
+        char *current_dir = dir_stack[--stack_size];
+        DIR *dir = opendir(current_dir);
+
+        if (!dir) {
+            free(current_dir);
+            continue;
+        }
+
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+                continue;
+            }
+
+            char path[PATH_MAX];
+            snprintf(path, sizeof(path), "%s/%s", current_dir, entry->d_name);
+
+            struct stat st;
+            if (stat(path, &st) != 0) {
+                continue;
+            }
+
+            if (S_ISDIR(st.st_mode)) {
+                /* Add directory to stack */
+                if (stack_size < 256) {
+                    dir_stack[stack_size++] = strdup(path);
+                }
+            } else if (S_ISREG(st.st_mode)) {
+                /* Check if it's a .sql file */
+                size_t name_len = strlen(entry->d_name);
+                if (name_len > 4 && strcmp(entry->d_name + name_len - 4, ".sql") == 0) {
+                    /* Expand array if needed */
+                    if (*count >= capacity) {
+                        capacity *= 2;
+                        char **new_files = realloc(files, sizeof(char *) * capacity);
+                        if (!new_files) {
+                            break;
+                        }
+                        files = new_files;
+                    }
+
+                    files[*count] = strdup(path);
+                    if (files[*count]) {
+                        (*count)++;
+                    }
+                }
+            }
+        }
+
+        closedir(dir);
+        free(current_dir);
+    }
+
+    /* Clean up directory stack */
+    for (int i = 0; i < stack_size; i++) {
+        free(dir_stack[i]);
+    }
+    free(dir_stack);
+
+    return files;
+}
+
+/* Path of a file found under dir_path, relative to it */
+static const char *relative_path(const char *path, const char *dir_path) {
+    size_t length = strlen(dir_path);
+    const char *relative = strncmp(path, dir_path, length) == 0 ? path + length : path;
+    while (*relative == '/') {
+        relative++;
+    }
+    return relative;
+}
+
+/* Record a file and the statements merged from it since the given counts */
+static void add_file(Schema *schema, const char *path, uint64_t digest, size_t size,
+                     bool shared, int table_start, int type_start, int index_start,
+                     MemoryContext *mem_ctx) {
+    SchemaFile *files = mem_realloc(mem_ctx, schema->files,
+                                    (schema->file_count + 1) * sizeof(SchemaFile));
+    if (!files) {
+        return;
+    }
+    schema->files = files;
+
+    SchemaFile *file = &files[schema->file_count];
+    file->path = mem_strdup(mem_ctx, path);
+    if (!file->path) {
+        return;
+    }
+    file->digest = digest;
+    file->size = size;
+    file->shared = shared;
+    file->table_start = table_start;
+    file->table_count = schema->table_count - table_start;
+    file->type_start = type_start;
+    file->type_count = schema->type_count - type_start;
+    file->index_start = index_start;
+    file->index_count = schema->index_count - index_start;
+    schema->file_count++;
+}
+
+/* The statements a reference file contributed, as a schema to merge */
+static Schema file_statements(const Schema *schema, const SchemaFile *file) {
+    Schema view = {0};
+    view.tables = schema->tables + file->table_start;
+    view.table_count = file->table_count;
+    view.types = schema->types + file->type_start;
+    view.type_count = file->type_count;
+    view.indexes = schema->indexes + file->index_start;
+    view.index_count = file->index_count;
+    return view;
+}
+
+/* Reference files by relative path, or NULL without a reference */
+static HashTable *index_files(const Schema *reference) {
+    if (!reference || reference->file_count == 0) {
+        return NULL;
+    }
+    HashTable *files = hash_table_create(reference->file_count * 2 + 1);
+    for (int i = 0; files && i < reference->file_count; i++) {
+        hash_table_insert(files, reference->files[i].path, &reference->files[i]);
+    }
+    return files;
+}
+
+/* Load every .sql file under dir_path. With a reference, files whose bytes
+ * match its file of the same path are borrowed rather than parsed. */
+static Schema *load_directory(const char *dir_path, const Schema *reference,
+                              MemoryContext *mem_ctx) {
+    /* Find all .sql files in directory tree */
+    int file_count = 0;
+    char **sql_files = find_sql_files_recursive(dir_path, &file_count);
+
+    if (!sql_files || file_count == 0) {
+        if (sql_files) {
+            free(sql_files);
+        }
+        return NULL;
+    }
+
+    /* Create combined schema */
+    Schema *combined_schema = mem_calloc(mem_ctx, 1, sizeof(Schema));
+    if (!combined_schema) {
+        for (int i = 0; i < file_count; i++) {
+            free(sql_files[i]);
+        }
+        free(sql_files);
+        return NULL;
+    }
+
+    HashTable *reference_files = index_files(reference);
+    int shared_count = 0;
+
+    /* Parse each SQL file and merge into combined schema */
+    for (int i = 0; i < file_count; i++) {
+        int span = TRACE_BEGIN(TRACE_PHASE_READ, "read_file", sql_files[i]);
+        char *source = read_file_to_string(sql_files[i]);
+        TRACE_END(span);
+        if (!source) {
+            log_warn("Failed to read file: %s", sql_files[i]);
+            free(sql_files[i]);
+            continue;
+        }
+
+        const char *path = relative_path(sql_files[i], dir_path);
+        size_t size = strlen(source);
+        uint64_t digest = fnv1a_64(FNV1A_64_INIT, source, size);
+        int table_start = combined_schema->table_count;
+        int type_start = combined_schema->type_count;
+        int index_start = combined_schema->index_count;
+
+        /* Byte-identical to the reference: same statements, no parse */
+        const SchemaFile *same = reference_files ? hash_table_get(reference_files, path) : NULL;
+        if (same && same->digest == digest && same->size == size) {
+            Schema borrowed = file_statements(reference, same);
+            merge_schema(combined_schema, &borrowed, mem_ctx);
+            add_file(combined_schema, path, digest, size, true,
+                     table_start, type_start, index_start, mem_ctx);
+            shared_count++;
+            free(source);
+            free(sql_files[i]);
+            continue;
+        }
+
+        if (!check_utf8(source, sql_files[i])) {
+            free(source);
+            free(sql_files[i]);
+            continue;
+        }
+
+        Parser *parser = parser_create(source);
+        if (!parser) {
+            log_warn("Failed to create parser for: %s", sql_files[i]);
+            free(source);
+            free(sql_files[i]);
+            continue;
+        }
+
+        /* Parse all statements in the file */
+        span = TRACE_BEGIN(TRACE_PHASE_PARSE, "parse_file", sql_files[i]);
+        Schema *file_schema = parse_all_statements(parser);
+        TRACE_END(span);
+
+        if (!file_schema) {
+            log_warn("Failed to parse statements from: %s", sql_files[i]);
+            parser_destroy(parser);
+            free(source);
+            free(sql_files[i]);
+            continue;
+        }
+
+        /* Merge file schema into combined schema */
+        merge_schema(combined_schema, file_schema, mem_ctx);
+        add_file(combined_schema, path, digest, size, false,
+                 table_start, type_start, index_start, mem_ctx);
+
+        parser_destroy(parser);
+        free(source);
+        free(sql_files[i]);
+    }
+
+    free(sql_files);
+    hash_table_destroy(reference_files);
+
+    if (reference) {
+        log_info("%d of %d files identical to the reference; not parsed",
+                 shared_count, file_count);
+    }
+
+    if (combined_schema->table_count == 0) {
+        return NULL;
+    }
+
+    return combined_schema;
+}
+
+/* Load schemas from directory */
+Schema *load_from_directory(const char *dir_path, MemoryContext *mem_ctx) {
+    return load_directory(dir_path, NULL, mem_ctx);
+}
+
+/* Load schemas from directory, borrowing files identical to reference's */
+Schema *load_from_directory_against(const char *dir_path, const Schema *reference,
+                                    MemoryContext *mem_ctx) {
+    return load_directory(dir_path, reference, mem_ctx);
+}
+
+/* Free a schema loaded with a NULL memory context, including its statements */
+void schema_free(Schema *schema) {
+    if (!schema) {
+        return;
+    }
+
+    /* Statements of shared files belong to the reference schema */
+    for (int f = 0; f < schema->file_count; f++) {
+        const SchemaFile *file = &schema->files[f];
+        for (int i = 0; file->shared && i < file->table_count; i++) {
+            schema->tables[file->table_start + i] = NULL;
+        }
+        for (int i = 0; file->shared && i < file->type_count; i++) {
+            schema->types[file->type_start + i] = NULL;
+        }
+        for (int i = 0; file->shared && i < file->index_count; i++) {
+            schema->indexes[file->index_start + i] = NULL;
+        }
+        free(file->path);
+    }
+    free(schema->files);
+
+    for (int i = 0; i < schema->table_count; i++) {
+        free_create_table_stmt(schema->tables[i]);
+    }
+    for (int i = 0; i < schema->type_count; i++) {
+        free_create_type_stmt(schema->types[i]);
+    }
+    for (int i = 0; i < schema->index_count; i++) {
+        free_create_index_stmt(schema->indexes[i]);
+    }
+    free(schema->tables);
+    free(schema->types);
+    free(schema->indexes);
+    free(schema);
+}
@@ -3,26 +3,61 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <assert.h>
 
-/* Memory block tracking structure */
-typedef struct MemBlock {
+/* One tracked allocation; ptr is NULL once freed out of order */
+typedef struct {
     void *ptr;
     size_t size;
-    struct MemBlock *next;
 } MemBlock;
 
-/* Memory context implementation */
+/* Memory context implementation. Blocks are kept in allocation order in a
+ * growable array, so tracking costs no allocation of its own and a mark
+ * (a block count) delimits everything allocated after it. */
 typedef struct MemoryContext {
     char *name;
     MemBlock *blocks;
+    size_t block_slots;      /* used slots, including freed ones */
+    size_t block_capacity;
     size_t total_allocated;
-    size_t block_count;
+    size_t block_count;      /* live blocks */
+    size_t limit;            /* 0: none */
+    MemoryLimitFn exceeded;  /* called once when total_allocated passes limit */
+    void *exceeded_arg;
+    bool over_limit;
 } MemoryContext;
 
 /* Forward declaration */
 static void memory_context_reset_internal(MemoryContext *ctx);
 
+/* Allocation counters; relaxed atomics keep the hot path to one add each */
+static atomic_size_t counter_allocations;
+static atomic_size_t counter_frees;
+static atomic_size_t counter_bytes;
+
+static inline void count_allocation(size_t size) {
+    atomic_fetch_add_explicit(&counter_allocations, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counter_bytes, size, memory_order_relaxed);
+}
+
+/* Read allocation counters */
+void memory_counters_get(MemoryCounters *counters) {
+    if (!counters) {
+        return;
+    }
+    counters->allocations = atomic_load_explicit(&counter_allocations, memory_order_relaxed);
+    counters->frees = atomic_load_explicit(&counter_frees, memory_order_relaxed);
+    counters->bytes = atomic_load_explicit(&counter_bytes, memory_order_relaxed);
+}
+
+/* Reset allocation counters */
+void memory_counters_reset(void) {
+    atomic_store_explicit(&counter_allocations, 0, memory_order_relaxed);
+    atomic_store_explicit(&counter_frees, 0, memory_order_relaxed);
+    atomic_store_explicit(&counter_bytes, 0, memory_order_relaxed);
+}
+
 /* Create a new memory context */
 MemoryContext *memory_context_create(const char *name) {
     MemoryContext *ctx = malloc(sizeof(MemoryContext));
@@ -32,27 +67,40 @@ MemoryContext *memory_context_create(const char *name) {
 
     ctx->name = name ? strdup(name) : strdup("unnamed");
     ctx->blocks = NULL;
+    ctx->block_slots = 0;
+    ctx->block_capacity = 0;
     ctx->total_allocated = 0;
     ctx->block_count = 0;
+    ctx->limit = 0;
+    ctx->exceeded = NULL;
+    ctx->exceeded_arg = NULL;
+    ctx->over_limit = false;
 
     return ctx;
 }
 
+/* Free every block tracked from slot 'mark' on */
+static void free_blocks_from(MemoryContext *ctx, size_t mark) {
+    for (size_t i = mark; i < ctx->block_slots; i++) {
+        if (ctx->blocks[i].ptr) {
+            free(ctx->blocks[i].ptr);
+            ctx->total_allocated -= ctx->blocks[i].size;
+            ctx->block_count--;
+        }
+    }
+    ctx->block_slots = mark;
+}
+
 /* Reset context (free all blocks but keep context) */
 static void memory_context_reset_internal(MemoryContext *ctx) {
     if (!ctx) {
         return;
     }
 
-    MemBlock *block = ctx->blocks;
-    while (block) {
-        MemBlock *next = block->next;
-        free(block->ptr);
-        free(block);
-        block = next;
-    }
-
+    free_blocks_from(ctx, 0);
+    free(ctx->blocks);
     ctx->blocks = NULL;
+    ctx->block_capacity = 0;
     ctx->total_allocated = 0;
     ctx->block_count = 0;
 }
@@ -73,49 +121,110 @@ void memory_context_reset(MemoryContext *ctx) {
     memory_context_reset_internal(ctx);
 }
 
+/* Mark the current end of the context */
+size_t memory_context_mark(MemoryContext *ctx) {
+    return ctx ? ctx->block_slots : 0;
+}
+
+/* Free everything allocated in the context since 'mark' */
+void memory_context_reset_to(MemoryContext *ctx, size_t mark) {
+    if (ctx && mark <= ctx->block_slots) {
+        free_blocks_from(ctx, mark);
+    }
+}
+
+/* Stop tracking everything allocated since 'mark': the blocks now belong to
+ * the caller, who frees them with free() or the free_* functions */
+void memory_context_release(MemoryContext *ctx, size_t mark) {
+    if (!ctx || mark > ctx->block_slots) {
+        return;
+    }
+    for (size_t i = mark; i < ctx->block_slots; i++) {
+        if (ctx->blocks[i].ptr) {
+            ctx->total_allocated -= ctx->blocks[i].size;
+            ctx->block_count--;
+        }
+    }
+    ctx->block_slots = mark;
+}
+
+/* Soft limit: the allocation that passes it still succeeds, and the owner
+ * is told once so it can stop the work that is allocating */
+void memory_context_set_limit(MemoryContext *ctx, size_t limit, MemoryLimitFn exceeded,
+                              void *arg) {
+    if (!ctx) {
+        return;
+    }
+    ctx->limit = limit;
+    ctx->exceeded = exceeded;
+    ctx->exceeded_arg = arg;
+    ctx->over_limit = false;
+}
+
+bool memory_context_over_limit(const MemoryContext *ctx) {
+    return ctx && ctx->over_limit;
+}
+
+static void check_limit(MemoryContext *ctx) {
+    if (ctx->limit > 0 && !ctx->over_limit && ctx->total_allocated > ctx->limit) {
+        ctx->over_limit = true;
+        if (ctx->exceeded) {
+            ctx->exceeded(ctx->exceeded_arg);
+        }
+    }
+}
+
 /* Internal function to track allocation */
 static void track_allocation(MemoryContext *ctx, void *ptr, size_t size) {
     if (!ctx || !ptr) {
         return;
     }
 
-    MemBlock *block = malloc(sizeof(MemBlock));
-    if (!block) {
-        return;
+    if (ctx->block_slots == ctx->block_capacity) {
+        size_t capacity = ctx->block_capacity ? ctx->block_capacity * 2 : 64;
+        MemBlock *blocks = realloc(ctx->blocks, sizeof(MemBlock) * capacity);
+        if (!blocks) {
+            return;
+        }
+        ctx->blocks = blocks;
+        ctx->block_capacity = capacity;
     }
 
-    block->ptr = ptr;
-    block->size = size;
-    block->next = ctx->blocks;
-    ctx->blocks = block;
+    ctx->blocks[ctx->block_slots].ptr = ptr;
+    ctx->blocks[ctx->block_slots].size = size;
+    ctx->block_slots++;
     ctx->total_allocated += size;
     ctx->block_count++;
+    check_limit(ctx);
+}
+
+/* Slot of a tracked pointer, searching from the newest; -1 if untracked */
+static ptrdiff_t find_block(const MemoryContext *ctx, const void *ptr) {
+    for (size_t i = ctx->block_slots; i > 0; i--) {
+        if (ctx->blocks[i - 1].ptr == ptr) {
+            return (ptrdiff_t)(i - 1);
+        }
+    }
+    return -1;
 }
 
-/* Internal function to untrack allocation */
+/* Internal function to untrack allocation. Freed slots other than the last
+ * are left empty rather than closed up, so marks stay valid. */
 static void untrack_allocation(MemoryContext *ctx, void *ptr) {
     if (!ctx || !ptr) {
         return;
     }
 
-    MemBlock *prev = NULL;
-    MemBlock *block = ctx->blocks;
-
-    while (block) {
-        if (block->ptr == ptr) {
-            if (prev) {
-                prev->next = block->next;
-            } else {
-                ctx->blocks = block->next;
-            }
+    ptrdiff_t slot = find_block(ctx, ptr);
+    if (slot < 0) {
+        return;
+    }
 
-            ctx->total_allocated -= block->size;
-            ctx->block_count--;
-            free(block);
-            return;
-        }
-        prev = block;
-        block = block->next;
+    ctx->total_allocated -= ctx->blocks[slot].size;
+    ctx->block_count--;
+    ctx->blocks[slot].ptr = NULL;
+    while (ctx->block_slots > 0 && !ctx->blocks[ctx->block_slots - 1].ptr) {
+        ctx->block_slots--;
     }
 }
 
@@ -125,6 +234,7 @@ void *mem_alloc(MemoryContext *ctx, size_t size) {
     if (!ptr) {
         return NULL;
     }
+    count_allocation(size);
 
     if (ctx) {
         track_allocation(ctx, ptr, size);
@@ -139,6 +249,7 @@ void *mem_calloc(MemoryContext *ctx, size_t nmemb, size_t size) {
     if (!ptr) {
         return NULL;
     }
+    count_allocation(nmemb * size);
 
     if (ctx) {
         track_allocation(ctx, ptr, nmemb * size);
@@ -153,16 +264,21 @@ void *mem_realloc(MemoryContext *ctx, void *ptr, size_t size) {
         return mem_alloc(ctx, size);
     }
 
-    if (ctx) {
-        untrack_allocation(ctx, ptr);
-    }
+    /* The block keeps its slot, so it stays on the same side of any mark */
+    ptrdiff_t slot = ctx ? find_block(ctx, ptr) : -1;
 
     void *new_ptr = realloc(ptr, size);
     if (!new_ptr) {
         return NULL;
     }
+    count_allocation(size);
 
-    if (ctx) {
+    if (slot >= 0) {
+        ctx->total_allocated += size - ctx->blocks[slot].size;
+        ctx->blocks[slot].ptr = new_ptr;
+        ctx->blocks[slot].size = size;
+        check_limit(ctx);
+    } else if (ctx) {
         track_allocation(ctx, new_ptr, size);
     }
 
@@ -216,6 +332,7 @@ void mem_free(MemoryContext *ctx, void *ptr) {
         untrack_allocation(ctx, ptr);
     }
 
+    atomic_fetch_add_explicit(&counter_frees, 1, memory_order_relaxed);
     free(ptr);
 }
 
@@ -415,6 +532,7 @@ void free_create_table_stmt(CreateTableStmt *stmt) {
     free(stmt->table_name);
     free(stmt->using_method);
     free(stmt->tablespace_name);
+    free(stmt->catalog_digest);
     free_partition_by_clause(stmt->partition_by);
     free_storage_parameter_list(stmt->with_options);
 
@@ -830,6 +948,7 @@ static TableConstraint *clone_table_constraint(const TableConstraint *src, Memor
 
     dst->constraint_name = mem_strdup(ctx, src->constraint_name);
     dst->type = src->type;
+    dst->conoid = src->conoid;
     dst->deferrable = src->deferrable;
     dst->not_deferrable = src->not_deferrable;
     dst->initially_deferred = src->initially_deferred;
@@ -1023,6 +1142,7 @@ static TableElement *clone_table_element(const TableElement *src, MemoryContext
             dst->elem.column.has_storage = src->elem.column.has_storage;
             dst->elem.column.compression_method = mem_strdup(ctx, src->elem.column.compression_method);
             dst->elem.column.collation = mem_strdup(ctx, src->elem.column.collation);
+            dst->elem.column.attnum = src->elem.column.attnum;
 
             /* Clone constraints linked list */
             dst->elem.column.constraints = NULL;
@@ -1112,12 +1232,14 @@ CreateTableStmt *clone_create_table_stmt(const CreateTableStmt *src, MemoryConte
     dst->without_oids = src->without_oids;
     dst->on_commit = src->on_commit;
     dst->has_on_commit = src->has_on_commit;
+    dst->relid = src->relid;
 
     /* Clone common fields */
     dst->partition_by = clone_partition_by_clause(src->partition_by, ctx);
     dst->using_method = mem_strdup(ctx, src->using_method);
     dst->with_options = clone_storage_parameter_list(src->with_options, ctx);
     dst->tablespace_name = mem_strdup(ctx, src->tablespace_name);
+    dst->catalog_digest = mem_strdup(ctx, src->catalog_digest);
 
     /* Clone variant-specific data */
     switch (src->variant) {
@@ -1229,26 +1351,13 @@ void free_create_type_stmt(CreateTypeStmt *stmt) {
 
     switch (stmt->variant) {
         case TYPE_VARIANT_ENUM:
-            if (stmt->type_def.enum_def.labels) {
-                for (int i = 0; i < stmt->type_def.enum_def.label_count; i++) {
-                    free(stmt->type_def.enum_def.labels[i]);
-                }
-                free(stmt->type_def.enum_def.labels);
-            }
+            /* One block holds the labels and their index */
+            free(stmt->type_def.enum_def.labels);
             break;
 
-        case TYPE_VARIANT_COMPOSITE: {
-            CompositeAttribute *attr = stmt->type_def.composite_def.attributes;
-            while (attr) {
-                CompositeAttribute *next = attr->next;
-                free(attr->attr_name);
-                free(attr->data_type);
-                free(attr->collation);
-                free(attr);
-                attr = next;
-            }
+        case TYPE_VARIANT_COMPOSITE:
+            free(stmt->type_def.composite_def.attributes);
             break;
-        }
 
         case TYPE_VARIANT_RANGE:
             free(stmt->type_def.range_def.subtype);
@@ -1294,35 +1403,16 @@ CreateTypeStmt *clone_create_type_stmt(const CreateTypeStmt *src, MemoryContext
 
     switch (src->variant) {
         case TYPE_VARIANT_ENUM:
-            dst->type_def.enum_def.label_count = src->type_def.enum_def.label_count;
-            if (src->type_def.enum_def.label_count > 0 && src->type_def.enum_def.labels) {
-                dst->type_def.enum_def.labels = mem_alloc(ctx,
-                    src->type_def.enum_def.label_count * sizeof(char *));
-                for (int i = 0; i < src->type_def.enum_def.label_count; i++) {
-                    dst->type_def.enum_def.labels[i] =
-                        mem_strdup(ctx, src->type_def.enum_def.labels[i]);
-                }
-            }
+            enum_type_def_init(&dst->type_def.enum_def,
+                               (const char *const *)src->type_def.enum_def.labels,
+                               src->type_def.enum_def.label_count, ctx);
             break;
 
-        case TYPE_VARIANT_COMPOSITE: {
-            dst->type_def.composite_def.attribute_count = src->type_def.composite_def.attribute_count;
-            CompositeAttribute *src_attr = src->type_def.composite_def.attributes;
-            CompositeAttribute **dst_attr_ptr = &dst->type_def.composite_def.attributes;
-
-            while (src_attr) {
-                CompositeAttribute *new_attr = mem_alloc(ctx, sizeof(CompositeAttribute));
-                new_attr->attr_name = mem_strdup(ctx, src_attr->attr_name);
-                new_attr->data_type = mem_strdup(ctx, src_attr->data_type);
-                new_attr->collation = src_attr->collation ? mem_strdup(ctx, src_attr->collation) : NULL;
-                new_attr->next = NULL;
-
-                *dst_attr_ptr = new_attr;
-                dst_attr_ptr = &new_attr->next;
-                src_attr = src_attr->next;
-            }
+        case TYPE_VARIANT_COMPOSITE:
+            composite_type_def_init(&dst->type_def.composite_def,
+                                    src->type_def.composite_def.attributes,
+                                    src->type_def.composite_def.attribute_count, ctx);
             break;
-        }
 
         case TYPE_VARIANT_RANGE:
             dst->type_def.range_def.subtype = src->type_def.range_def.subtype ?
@@ -1384,3 +1474,40 @@ CreateTypeStmt *clone_create_type_stmt(const CreateTypeStmt *src, MemoryContext
 
     return dst;
 }
+
+/* ========== CreateIndexStmt Memory Management ========== */
+
+/* Allocate a CreateIndexStmt */
+CreateIndexStmt *create_index_stmt_alloc(MemoryContext *ctx) {
+    CreateIndexStmt *stmt = mem_alloc(ctx, sizeof(CreateIndexStmt));
+    if (stmt) {
+        memset(stmt, 0, sizeof(CreateIndexStmt));
+    }
+    return stmt;
+}
+
+/* Free a CreateIndexStmt */
+void free_create_index_stmt(CreateIndexStmt *stmt) {
+    if (!stmt) {
+        return;
+    }
+
+    free(stmt->index_name);
+    free(stmt->table_name);
+    free(stmt->access_method);
+    for (int i = 0; i < stmt->element_count; i++) {
+        free(stmt->elements[i].column_name);
+        free(stmt->elements[i].expression);
+        free(stmt->elements[i].collation);
+        free(stmt->elements[i].opclass);
+    }
+    free(stmt->elements);
+    for (int i = 0; i < stmt->include_count; i++) {
+        free(stmt->include_columns[i]);
+    }
+    free(stmt->include_columns);
+    free_storage_parameter_list(stmt->with_options);
+    free(stmt->tablespace_name);
+    free(stmt->where_clause);
+    free(stmt);
+}
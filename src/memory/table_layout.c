@@ -0,0 +1,222 @@
+#include "pg_table_layout.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Sizes gathered by the first pass over the AST */
+typedef struct {
+    size_t columns;
+    size_t table_constraints;
+    size_t column_constraints;
+    size_t string_bytes;
+} LayoutSize;
+
+typedef struct {
+    TableLayout *layout;
+    uint32_t string_used;
+} LayoutBuilder;
+
+static const TableElement *first_element(const CreateTableStmt *stmt) {
+    return stmt->variant == CREATE_TABLE_REGULAR ? stmt->table_def.regular.elements : NULL;
+}
+
+static size_t string_bytes(const char *str) {
+    return str ? strlen(str) + 1 : 0;
+}
+
+static const char *column_default(const ColumnDef *col) {
+    for (const ColumnConstraint *c = col->constraints; c; c = c->next) {
+        if (c->type == CONSTRAINT_DEFAULT && c->constraint.default_val.expr) {
+            return c->constraint.default_val.expr->expression;
+        }
+    }
+    return NULL;
+}
+
+static void measure(const CreateTableStmt *stmt, LayoutSize *size) {
+    memset(size, 0, sizeof(*size));
+    size->string_bytes = 1;  /* offset 0 is NULL */
+
+    for (const TableElement *elem = first_element(stmt); elem; elem = elem->next) {
+        if (elem->type == TABLE_ELEM_TABLE_CONSTRAINT && elem->elem.table_constraint) {
+            size->table_constraints++;
+            size->string_bytes += string_bytes(elem->elem.table_constraint->constraint_name);
+        } else if (elem->type == TABLE_ELEM_COLUMN) {
+            const ColumnDef *col = &elem->elem.column;
+            size->columns++;
+            size->string_bytes += string_bytes(col->column_name) + string_bytes(col->data_type) +
+                                  string_bytes(col->collation) + string_bytes(col->compression_method) +
+                                  string_bytes(column_default(col));
+            for (const ColumnConstraint *c = col->constraints; c; c = c->next) {
+                size->column_constraints++;
+                size->string_bytes += string_bytes(c->constraint_name);
+            }
+        }
+    }
+}
+
+static LayoutString add_string(LayoutBuilder *b, const char *str) {
+    if (!str) {
+        return 0;
+    }
+    LayoutString ref = b->string_used;
+    size_t len = strlen(str) + 1;
+    memcpy(b->layout->strings + ref, str, len);
+    b->string_used += (uint32_t)len;
+    return ref;
+}
+
+#define COPY_CONSTRAINT_FLAGS(dst, src) do { \
+    (dst).deferrable = (src)->deferrable; \
+    (dst).not_deferrable = (src)->not_deferrable; \
+    (dst).initially_deferred = (src)->initially_deferred; \
+    (dst).initially_immediate = (src)->initially_immediate; \
+    (dst).enforced = (src)->enforced; \
+    (dst).not_enforced = (src)->not_enforced; \
+    (dst).has_deferrable = (src)->has_deferrable; \
+    (dst).has_initially = (src)->has_initially; \
+    (dst).has_enforced = (src)->has_enforced; \
+} while (0)
+
+static void add_column(LayoutBuilder *b, const ColumnDef *col, uint32_t *next_constraint) {
+    TableLayout *layout = b->layout;
+    uint32_t index = layout->column_count++;
+    LayoutColumn *lc = &layout->columns[index];
+
+    memset(lc, 0, sizeof(*lc));
+    lc->name = add_string(b, col->column_name);
+    lc->data_type = add_string(b, col->data_type);
+    lc->collation = add_string(b, col->collation);
+    lc->compression = add_string(b, col->compression_method);
+    lc->default_expr = add_string(b, column_default(col));
+    lc->storage_type = (uint8_t)col->storage_type;
+    lc->has_storage = col->has_storage;
+    lc->first_constraint = *next_constraint;
+    layout->column_defs[index] = col;
+
+    for (const ColumnConstraint *c = col->constraints; c; c = c->next) {
+        uint32_t ci = (*next_constraint)++;
+        LayoutConstraint *con = &layout->constraints[ci];
+        memset(con, 0, sizeof(*con));
+        con->name = add_string(b, c->constraint_name);
+        con->column = (int32_t)index;
+        con->type = (uint8_t)c->type;
+        COPY_CONSTRAINT_FLAGS(con->flags, c);
+        layout->column_constraint_defs[ci - layout->table_constraint_count] = c;
+        lc->constraint_count++;
+        if (c->type == CONSTRAINT_NOT_NULL) {
+            lc->not_null = 1;
+        }
+    }
+}
+
+TableLayout *table_layout_build(const CreateTableStmt *stmt, MemoryContext *mem_ctx) {
+    if (!stmt) {
+        return NULL;
+    }
+
+    LayoutSize size;
+    measure(stmt, &size);
+    if (size.string_bytes > UINT32_MAX || size.columns > INT32_MAX) {
+        return NULL;
+    }
+    size_t constraints = size.table_constraints + size.column_constraints;
+
+    /* One block, widest alignment first: the header, the view pointer
+     * arrays, the 4-byte-aligned entry arrays, then the strings */
+    size_t total = sizeof(TableLayout) +
+                   sizeof(ColumnDef *) * size.columns +
+                   sizeof(TableConstraint *) * size.table_constraints +
+                   sizeof(ColumnConstraint *) * size.column_constraints +
+                   sizeof(LayoutColumn) * size.columns +
+                   sizeof(LayoutConstraint) * constraints +
+                   size.string_bytes;
+    char *block = mem_alloc(mem_ctx, total);
+    if (!block) {
+        return NULL;
+    }
+
+    TableLayout *layout = (TableLayout *)block;
+    memset(layout, 0, sizeof(*layout));
+    char *p = block + sizeof(TableLayout);
+    layout->column_defs = (const ColumnDef **)p;
+    p += sizeof(ColumnDef *) * size.columns;
+    layout->table_constraint_defs = (const TableConstraint **)p;
+    p += sizeof(TableConstraint *) * size.table_constraints;
+    layout->column_constraint_defs = (const ColumnConstraint **)p;
+    p += sizeof(ColumnConstraint *) * size.column_constraints;
+    layout->columns = (LayoutColumn *)p;
+    p += sizeof(LayoutColumn) * size.columns;
+    layout->constraints = (LayoutConstraint *)p;
+    p += sizeof(LayoutConstraint) * constraints;
+    layout->strings = p;
+    layout->strings[0] = '\0';
+    layout->string_size = (uint32_t)size.string_bytes;
+    layout->constraint_count = (uint32_t)constraints;
+    layout->table_constraint_count = (uint32_t)size.table_constraints;
+
+    LayoutBuilder b = {layout, 1};
+    uint32_t next_table_constraint = 0;
+    uint32_t next_column_constraint = layout->table_constraint_count;
+    for (const TableElement *elem = first_element(stmt); elem; elem = elem->next) {
+        if (elem->type == TABLE_ELEM_TABLE_CONSTRAINT && elem->elem.table_constraint) {
+            const TableConstraint *tc = elem->elem.table_constraint;
+            uint32_t ci = next_table_constraint++;
+            LayoutConstraint *con = &layout->constraints[ci];
+            memset(con, 0, sizeof(*con));
+            con->name = add_string(&b, tc->constraint_name);
+            con->column = -1;
+            con->type = (uint8_t)tc->type;
+            COPY_CONSTRAINT_FLAGS(con->flags, tc);
+            layout->table_constraint_defs[ci] = tc;
+        } else if (elem->type == TABLE_ELEM_COLUMN) {
+            add_column(&b, &elem->elem.column, &next_column_constraint);
+        }
+    }
+    return layout;
+}
+
+void table_layout_free(TableLayout *layout, MemoryContext *mem_ctx) {
+    mem_free(mem_ctx, layout);
+}
+
+const char *table_layout_string(const TableLayout *layout, LayoutString ref) {
+    return ref ? layout->strings + ref : NULL;
+}
+
+const ColumnDef *table_layout_column_def(const TableLayout *layout, uint32_t column) {
+    return column < layout->column_count ? layout->column_defs[column] : NULL;
+}
+
+const TableConstraint *table_layout_table_constraint(const TableLayout *layout, uint32_t constraint) {
+    return constraint < layout->table_constraint_count ? layout->table_constraint_defs[constraint] : NULL;
+}
+
+const ColumnConstraint *table_layout_column_constraint(const TableLayout *layout, uint32_t constraint) {
+    if (constraint < layout->table_constraint_count || constraint >= layout->constraint_count) {
+        return NULL;
+    }
+    return layout->column_constraint_defs[constraint - layout->table_constraint_count];
+}
+
+static bool strings_identical(const TableLayout *a, LayoutString a_ref,
+                              const TableLayout *b, LayoutString b_ref) {
+    if (!a_ref || !b_ref) {
+        return a_ref == b_ref;
+    }
+    return strcmp(a->strings + a_ref, b->strings + b_ref) == 0;
+}
+
+bool table_layout_columns_identical(const TableLayout *a, uint32_t a_column,
+                                    const TableLayout *b, uint32_t b_column) {
+    const LayoutColumn *ca = &a->columns[a_column];
+    const LayoutColumn *cb = &b->columns[b_column];
+
+    return ca->not_null == cb->not_null &&
+           ca->has_storage == cb->has_storage &&
+           ca->storage_type == cb->storage_type &&
+           strings_identical(a, ca->name, b, cb->name) &&
+           strings_identical(a, ca->data_type, b, cb->data_type) &&
+           strings_identical(a, ca->default_expr, b, cb->default_expr) &&
+           strings_identical(a, ca->collation, b, cb->collation) &&
+           strings_identical(a, ca->compression, b, cb->compression);
+}
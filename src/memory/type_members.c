@@ -0,0 +1,200 @@
+#include "sc_memory.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+/*
+ * Enum labels and composite attributes live in one block per type: the
+ * member array, the index's hash and slot arrays, then the member strings.
+ * Strings are interned within the block, so a composite type's repeated
+ * data types and collations are stored once. Lookups hash the name and
+ * compare only members with an equal hash, so diffing two types is linear
+ * in their member counts.
+ */
+
+/* FNV-1a over ASCII-folded bytes: one index serves case-sensitive and
+ * case-insensitive lookups */
+static uint32_t member_hash(const char *name) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++) {
+        unsigned char c = (*p >= 'A' && *p <= 'Z') ? (unsigned char)(*p + 32) : *p;
+        hash = (hash ^ c) * 16777619u;
+    }
+    return hash;
+}
+
+/* Power of two, at most half full */
+static uint32_t slot_count(size_t entries) {
+    uint32_t slots = 8;
+    while (slots < entries * 2) {
+        slots <<= 1;
+    }
+    return slots;
+}
+
+static size_t string_bytes(const char *str) {
+    return str ? strlen(str) + 1 : 0;
+}
+
+/* Strings copied into the block, each distinct one once */
+typedef struct {
+    char *next;
+    const char **table;     /* open-addressed; NULL disables interning */
+    uint32_t mask;
+} StringPool;
+
+static void pool_init(StringPool *pool, char *space, size_t strings) {
+    pool->next = space;
+    pool->mask = slot_count(strings) - 1;
+    pool->table = calloc(pool->mask + 1, sizeof(char *));
+}
+
+static char *pool_add(StringPool *pool, const char *str) {
+    if (!str) {
+        return NULL;
+    }
+    uint32_t slot = 0;
+    if (pool->table) {
+        for (slot = member_hash(str) & pool->mask; pool->table[slot];
+             slot = (slot + 1) & pool->mask) {
+            if (strcmp(pool->table[slot], str) == 0) {
+                return (char *)pool->table[slot];
+            }
+        }
+    }
+    size_t len = strlen(str) + 1;
+    char *copy = memcpy(pool->next, str, len);
+    pool->next += len;
+    if (pool->table) {
+        pool->table[slot] = copy;
+    }
+    return copy;
+}
+
+/* Allocate the block: members, then hashes and slots, then strings */
+static char *alloc_block(TypeMemberIndex *index, size_t member_size, int count,
+                         size_t string_total, MemoryContext *ctx) {
+    uint32_t slots = slot_count((size_t)count);
+    size_t members = member_size * (size_t)count;
+    char *block = mem_alloc(ctx, members + sizeof(uint32_t) * ((size_t)count + slots) +
+                                 string_total);
+    if (!block) {
+        return NULL;
+    }
+    index->hashes = (uint32_t *)(block + members);
+    index->slots = index->hashes + count;
+    index->mask = slots - 1;
+    memset(index->slots, 0, sizeof(uint32_t) * slots);
+    return block;
+}
+
+static char *strings_start(const TypeMemberIndex *index) {
+    return (char *)(index->slots + index->mask + 1);
+}
+
+static void index_insert(TypeMemberIndex *index, uint32_t position, const char *name) {
+    uint32_t hash = name ? member_hash(name) : 0;
+    index->hashes[position] = hash;
+    if (!name) {
+        return;
+    }
+    uint32_t slot = hash & index->mask;
+    while (index->slots[slot]) {
+        slot = (slot + 1) & index->mask;
+    }
+    index->slots[slot] = position + 1;
+}
+
+bool enum_type_def_init(EnumTypeDef *def, const char *const *labels, int label_count,
+                        MemoryContext *ctx) {
+    memset(def, 0, sizeof(*def));
+    if (label_count < 0) {
+        return false;
+    }
+
+    size_t total = 0;
+    for (int i = 0; i < label_count; i++) {
+        total += string_bytes(labels[i]);
+    }
+
+    char *block = alloc_block(&def->index, sizeof(char *), label_count, total, ctx);
+    if (!block) {
+        return false;
+    }
+    def->labels = (char **)block;
+    def->label_count = label_count;
+
+    StringPool pool;
+    pool_init(&pool, strings_start(&def->index), (size_t)label_count);
+    for (int i = 0; i < label_count; i++) {
+        def->labels[i] = pool_add(&pool, labels[i]);
+        index_insert(&def->index, (uint32_t)i, def->labels[i]);
+    }
+    free(pool.table);
+    return true;
+}
+
+bool composite_type_def_init(CompositeTypeDef *def, const CompositeAttribute *attributes,
+                             int attribute_count, MemoryContext *ctx) {
+    memset(def, 0, sizeof(*def));
+    if (attribute_count < 0) {
+        return false;
+    }
+
+    size_t total = 0;
+    for (int i = 0; i < attribute_count; i++) {
+        total += string_bytes(attributes[i].attr_name) + string_bytes(attributes[i].data_type) +
+                 string_bytes(attributes[i].collation);
+    }
+
+    char *block = alloc_block(&def->index, sizeof(CompositeAttribute), attribute_count, total, ctx);
+    if (!block) {
+        return false;
+    }
+    def->attributes = (CompositeAttribute *)block;
+    def->attribute_count = attribute_count;
+
+    StringPool pool;
+    pool_init(&pool, strings_start(&def->index), (size_t)attribute_count * 3);
+    for (int i = 0; i < attribute_count; i++) {
+        CompositeAttribute *attr = &def->attributes[i];
+        attr->attr_name = pool_add(&pool, attributes[i].attr_name);
+        attr->data_type = pool_add(&pool, attributes[i].data_type);
+        attr->collation = pool_add(&pool, attributes[i].collation);
+        index_insert(&def->index, (uint32_t)i, attr->attr_name);
+    }
+    free(pool.table);
+    return true;
+}
+
+int enum_type_def_find(const EnumTypeDef *def, const char *label) {
+    if (!label || !def->index.slots) {
+        return -1;
+    }
+    uint32_t hash = member_hash(label);
+    for (uint32_t slot = hash & def->index.mask; def->index.slots[slot];
+         slot = (slot + 1) & def->index.mask) {
+        uint32_t position = def->index.slots[slot] - 1;
+        if (def->index.hashes[position] == hash && strcmp(def->labels[position], label) == 0) {
+            return (int)position;
+        }
+    }
+    return -1;
+}
+
+int composite_type_def_find(const CompositeTypeDef *def, const char *name, bool case_sensitive) {
+    if (!name || !def->index.slots) {
+        return -1;
+    }
+    uint32_t hash = member_hash(name);
+    for (uint32_t slot = hash & def->index.mask; def->index.slots[slot];
+         slot = (slot + 1) & def->index.mask) {
+        uint32_t position = def->index.slots[slot] - 1;
+        const char *attr_name = def->attributes[position].attr_name;
+        if (def->index.hashes[position] == hash &&
+            (case_sensitive ? strcmp(attr_name, name) : strcasecmp(attr_name, name)) == 0) {
+            return (int)position;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,226 @@
+#include "metrics.h"
+#include "trace.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#define METRIC_PREFIX "schema_compare_"
+
+Metrics *metrics_create(int target_count) {
+    Metrics *metrics = calloc(1, sizeof(Metrics));
+    if (!metrics) {
+        return NULL;
+    }
+    metrics->targets = calloc(target_count > 0 ? target_count : 1, sizeof(MetricsTarget));
+    if (!metrics->targets) {
+        free(metrics);
+        return NULL;
+    }
+    metrics->target_count = target_count;
+    return metrics;
+}
+
+void metrics_free(Metrics *metrics) {
+    if (!metrics) {
+        return;
+    }
+    for (int i = 0; i < metrics->target_count; i++) {
+        free(metrics->targets[i].label);
+    }
+    free(metrics->targets);
+    free(metrics);
+}
+
+bool metrics_set_target(Metrics *metrics, int index, const char *label,
+                        MetricsTargetStatus status, const SchemaDiff *diff,
+                        double fetch_ms, double compare_ms) {
+    if (!metrics || index < 0 || index >= metrics->target_count || !label) {
+        return false;
+    }
+
+    MetricsTarget *target = &metrics->targets[index];
+    free(target->label);
+    memset(target, 0, sizeof(*target));
+    target->label = strdup(label);
+    if (!target->label) {
+        return false;
+    }
+    target->status = status;
+    target->fetch_ms = fetch_ms;
+    target->compare_ms = compare_ms;
+    if (diff) {
+        target->has_diff = true;
+        target->critical_count = diff->critical_count;
+        target->warning_count = diff->warning_count;
+        target->info_count = diff->info_count;
+        target->tables_added = diff->tables_added;
+        target->tables_removed = diff->tables_removed;
+        target->tables_modified = diff->tables_modified;
+    }
+    return true;
+}
+
+/* Label values escape backslash, double quote and newline */
+static void append_label_value(StringBuilder *sb, const char *value) {
+    sb_append_char(sb, '"');
+    for (const char *p = value; *p; p++) {
+        if (*p == '\\' || *p == '"') {
+            sb_append_char(sb, '\\');
+            sb_append_char(sb, *p);
+        } else if (*p == '\n') {
+            sb_append(sb, "\\n");
+        } else {
+            sb_append_char(sb, *p);
+        }
+    }
+    sb_append_char(sb, '"');
+}
+
+static void append_family(StringBuilder *sb, const char *name, const char *help) {
+    sb_append_fmt(sb, "# HELP " METRIC_PREFIX "%s %s\n", name, help);
+    sb_append_fmt(sb, "# TYPE " METRIC_PREFIX "%s gauge\n", name);
+}
+
+/* One sample: name{target="...",extra} value; extra is a preformatted
+ * label pair or NULL */
+static void append_target_sample(StringBuilder *sb, const char *name, const MetricsTarget *target,
+                                 const char *extra, double value) {
+    sb_append_fmt(sb, METRIC_PREFIX "%s{target=", name);
+    append_label_value(sb, target->label);
+    if (extra) {
+        sb_append_fmt(sb, ",%s", extra);
+    }
+    sb_append_fmt(sb, "} %.9g\n", value);
+}
+
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+}
+
+/* Build the document. Every family is written once with all its samples,
+ * as the format requires; all are gauges describing the latest run. */
+char *metrics_format(const Metrics *metrics) {
+    StringBuilder *sb = sb_create();
+    if (!sb) {
+        return NULL;
+    }
+
+    int counts[METRICS_TARGET_TIMED_OUT + 1] = {0};
+    for (int i = 0; i < metrics->target_count; i++) {
+        counts[metrics->targets[i].status]++;
+    }
+
+    append_family(sb, "source_up", "Whether the source schema was loaded.");
+    sb_append_fmt(sb, METRIC_PREFIX "source_up %d\n", metrics->source_ok ? 1 : 0);
+    append_family(sb, "run_duration_seconds", "Wall time of the run.");
+    sb_append_fmt(sb, METRIC_PREFIX "run_duration_seconds %.6f\n", metrics->elapsed_ms / 1e3);
+    append_family(sb, "last_run_timestamp_seconds", "Unix time the run finished.");
+    sb_append_fmt(sb, METRIC_PREFIX "last_run_timestamp_seconds %lld\n", (long long)time(NULL));
+    append_family(sb, "peak_rss_bytes", "Peak resident set size of the run.");
+    sb_append_fmt(sb, METRIC_PREFIX "peak_rss_bytes %lld\n", (long long)peak_rss_kb() * 1024);
+
+    static const char *status_names[] = {"pending", "ok", "failed", "skipped", "timed_out"};
+    append_family(sb, "targets", "Targets by outcome.");
+    for (int s = 0; s <= METRICS_TARGET_TIMED_OUT; s++) {
+        sb_append_fmt(sb, METRIC_PREFIX "targets{status=\"%s\"} %d\n", status_names[s], counts[s]);
+    }
+
+    append_family(sb, "target_up",
+                  "Whether the target was compared and its output written, or skipped as unchanged.");
+    for (int i = 0; i < metrics->target_count; i++) {
+        const MetricsTarget *target = &metrics->targets[i];
+        if (target->label) {
+            bool up = target->status == METRICS_TARGET_OK || target->status == METRICS_TARGET_SKIPPED;
+            append_target_sample(sb, "target_up", target, NULL, up ? 1 : 0);
+        }
+    }
+
+    append_family(sb, "target_drift", "Differences found on the target, by severity.");
+    for (int i = 0; i < metrics->target_count; i++) {
+        const MetricsTarget *target = &metrics->targets[i];
+        if (target->has_diff) {
+            append_target_sample(sb, "target_drift", target, "severity=\"critical\"",
+                                 target->critical_count);
+            append_target_sample(sb, "target_drift", target, "severity=\"warning\"",
+                                 target->warning_count);
+            append_target_sample(sb, "target_drift", target, "severity=\"info\"",
+                                 target->info_count);
+        }
+    }
+
+    append_family(sb, "target_tables", "Tables the migration adds, removes or modifies.");
+    for (int i = 0; i < metrics->target_count; i++) {
+        const MetricsTarget *target = &metrics->targets[i];
+        if (target->has_diff) {
+            append_target_sample(sb, "target_tables", target, "change=\"added\"",
+                                 target->tables_added);
+            append_target_sample(sb, "target_tables", target, "change=\"removed\"",
+                                 target->tables_removed);
+            append_target_sample(sb, "target_tables", target, "change=\"modified\"",
+                                 target->tables_modified);
+        }
+    }
+
+    append_family(sb, "target_fetch_duration_seconds", "Time spent connecting to and reading the target.");
+    for (int i = 0; i < metrics->target_count; i++) {
+        const MetricsTarget *target = &metrics->targets[i];
+        if (target->label && target->status != METRICS_TARGET_SKIPPED) {
+            append_target_sample(sb, "target_fetch_duration_seconds", target, NULL,
+                                 target->fetch_ms / 1e3);
+        }
+    }
+
+    append_family(sb, "target_compare_duration_seconds",
+                  "Time spent diffing the target and generating its output.");
+    for (int i = 0; i < metrics->target_count; i++) {
+        const MetricsTarget *target = &metrics->targets[i];
+        if (target->has_diff) {
+            append_target_sample(sb, "target_compare_duration_seconds", target, NULL,
+                                 target->compare_ms / 1e3);
+        }
+    }
+
+    /* Phase totals are wall time per thread, summed over all workers */
+    append_family(sb, "phase_duration_seconds", "Time spent in each phase, summed over workers.");
+    for (int p = 0; p < TRACE_PHASE_COUNT; p++) {
+        TracePhaseStats stats;
+        trace_get_phase_stats((TracePhase)p, &stats);
+        sb_append_fmt(sb, METRIC_PREFIX "phase_duration_seconds{phase=\"%s\"} %.6f\n",
+                      trace_phase_name((TracePhase)p), (double)stats.total_ns / 1e9);
+    }
+    append_family(sb, "phase_spans", "Spans recorded in each phase.");
+    for (int p = 0; p < TRACE_PHASE_COUNT; p++) {
+        TracePhaseStats stats;
+        trace_get_phase_stats((TracePhase)p, &stats);
+        sb_append_fmt(sb, METRIC_PREFIX "phase_spans{phase=\"%s\"} %d\n",
+                      trace_phase_name((TracePhase)p), stats.span_count);
+    }
+
+    append_family(sb, "catalog_queries", "Catalog statements executed.");
+    sb_append_fmt(sb, METRIC_PREFIX "catalog_queries %lld\n",
+                  (long long)trace_counter_get(TRACE_COUNTER_CATALOG_EXECUTIONS));
+    append_family(sb, "catalog_plans", "Catalog statements prepared.");
+    sb_append_fmt(sb, METRIC_PREFIX "catalog_plans %lld\n",
+                  (long long)trace_counter_get(TRACE_COUNTER_CATALOG_PLANS));
+    append_family(sb, "catalog_bytes", "Bytes of catalog result values received.");
+    sb_append_fmt(sb, METRIC_PREFIX "catalog_bytes %lld\n",
+                  (long long)trace_counter_get(TRACE_COUNTER_CATALOG_BYTES));
+
+    char *text = sb_to_string(sb);
+    sb_free(sb);
+    return text;
+}
+
+/* Write the document atomically, so the collector never reads half a file */
+bool metrics_write(const Metrics *metrics, const char *filename) {
+    char *text = metrics_format(metrics);
+    if (!text) {
+        return false;
+    }
+    bool ok = write_string_to_file_atomic(filename, text);
+    free(text);
+    return ok;
+}
@@ -89,6 +89,16 @@ char *generate_summary(const SchemaDiff *diff, const ReportOptions *opts) {
     sb_append_fmt(sb, "  Tables Added:    %d\n", diff->tables_added);
     sb_append_fmt(sb, "  Tables Removed:  %d\n", diff->tables_removed);
     sb_append_fmt(sb, "  Tables Modified: %d\n", diff->tables_modified);
+    if (diff->type_diffs) {
+        sb_append_fmt(sb, "  Types Added:     %d\n", diff->types_added);
+        sb_append_fmt(sb, "  Types Removed:   %d\n", diff->types_removed);
+        sb_append_fmt(sb, "  Types Modified:  %d\n", diff->types_modified);
+    }
+    if (diff->index_diffs) {
+        sb_append_fmt(sb, "  Indexes Added:    %d\n", diff->indexes_added);
+        sb_append_fmt(sb, "  Indexes Removed:  %d\n", diff->indexes_removed);
+        sb_append_fmt(sb, "  Indexes Modified: %d\n", diff->indexes_modified);
+    }
     sb_append(sb, "\n");
 
     /* Severity breakdown */
@@ -120,6 +130,31 @@ char *generate_summary(const SchemaDiff *diff, const ReportOptions *opts) {
     return result;
 }
 
+/* One line per diff, with severity icon and old → new values */
+static void append_diff_lines(StringBuilder *sb, const Diff *diffs, const ReportOptions *opts) {
+    for (const Diff *d = diffs; d; d = d->next) {
+        const char *icon = opts->show_severity_icons ? severity_icon(d->severity) : "";
+        const char *color_start = opts->use_color ? severity_color_start(d->severity) : "";
+        const char *color_end = opts->use_color ? severity_color_end() : "";
+
+        sb_append_fmt(sb, "  %s%s %s", color_start, icon, diff_type_to_string(d->type));
+
+        if (d->element_name) {
+            sb_append_fmt(sb, ": %s", d->element_name);
+        }
+
+        if (d->old_value && d->new_value) {
+            sb_append_fmt(sb, " (%s → %s)", d->old_value, d->new_value);
+        } else if (d->old_value) {
+            sb_append_fmt(sb, " (%s)", d->old_value);
+        } else if (d->new_value) {
+            sb_append_fmt(sb, " (%s)", d->new_value);
+        }
+
+        sb_append_fmt(sb, "%s\n", color_end);
+    }
+}
+
 /* Generate table diff report */
 char *generate_table_diff_report(const TableDiff *td, const ReportOptions *opts) {
     if (!td) {
@@ -168,28 +203,36 @@ char *generate_table_diff_report(const TableDiff *td, const ReportOptions *opts)
     }
 
     /* Show individual diffs */
-    for (Diff *d = td->diffs; d; d = d->next) {
-        const char *icon = opts->show_severity_icons ? severity_icon(d->severity) : "";
-        const char *color_start = opts->use_color ? severity_color_start(d->severity) : "";
-        const char *color_end = opts->use_color ? severity_color_end() : "";
+    append_diff_lines(sb, td->diffs, opts);
 
-        sb_append_fmt(sb, "  %s%s %s", color_start, icon, diff_type_to_string(d->type));
+    sb_append(sb, "\n");
 
-        if (d->element_name) {
-            sb_append_fmt(sb, ": %s", d->element_name);
-        }
+    char *result = sb_to_string(sb);
+    sb_free(sb);
+    return result;
+}
 
-        if (d->old_value && d->new_value) {
-            sb_append_fmt(sb, " (%s → %s)", d->old_value, d->new_value);
-        } else if (d->old_value) {
-            sb_append_fmt(sb, " (%s)", d->old_value);
-        } else if (d->new_value) {
-            sb_append_fmt(sb, " (%s)", d->new_value);
-        }
+/* Generate index diff report */
+char *generate_index_diff_report(const IndexDiff *id, const ReportOptions *opts) {
+    if (!id) {
+        return NULL;
+    }
 
-        sb_append_fmt(sb, "%s\n", color_end);
+    StringBuilder *sb = sb_create();
+    if (!sb) {
+        return NULL;
+    }
+
+    if (opts->use_color) {
+        sb_append(sb, ANSI_BOLD);
+    }
+    sb_append_fmt(sb, "Index: %s on %s\n", id->index_name ? id->index_name : "(unnamed)",
+                  id->table_name);
+    if (opts->use_color) {
+        sb_append(sb, ANSI_RESET);
     }
 
+    append_diff_lines(sb, id->diffs, opts);
     sb_append(sb, "\n");
 
     char *result = sb_to_string(sb);
@@ -197,6 +240,46 @@ char *generate_table_diff_report(const TableDiff *td, const ReportOptions *opts)
     return result;
 }
 
+/* Generate type diff report */
+char *generate_type_diff_report(const TypeDiff *td, const ReportOptions *opts) {
+    if (!td) {
+        return NULL;
+    }
+
+    StringBuilder *sb = sb_create();
+    if (!sb) {
+        return NULL;
+    }
+
+    if (opts->use_color) {
+        sb_append(sb, ANSI_BOLD);
+    }
+    sb_append_fmt(sb, "Type: %s\n", td->type_name);
+    if (opts->use_color) {
+        sb_append(sb, ANSI_RESET);
+    }
+
+    if (td->type_added || td->type_removed) {
+        if (opts->use_color) {
+            sb_append(sb, td->type_added ? ANSI_GREEN : ANSI_RED);
+        }
+        sb_append(sb, td->type_added ? "  + Type ADDED\n" : "  - Type REMOVED\n");
+        if (opts->use_color) {
+            sb_append(sb, ANSI_RESET);
+        }
+    } else {
+        append_diff_lines(sb, td->diffs, opts);
+        if (td->requires_recreate) {
+            sb_append(sb, "  (cannot be altered in place; the type is recreated)\n");
+        }
+        sb_append(sb, "\n");
+    }
+
+    char *result = sb_to_string(sb);
+    sb_free(sb);
+    return result;
+}
+
 /* Generate full report */
 char *generate_report(const SchemaDiff *diff, const ReportOptions *opts) {
     if (!diff || !opts) {
@@ -222,8 +305,8 @@ char *generate_report(const SchemaDiff *diff, const ReportOptions *opts) {
         return result;
     }
 
-    /* Generate table-level diffs */
-    if (diff->table_diffs) {
+    /* Generate table-level, type-level and index-level diffs */
+    if (diff->table_diffs || diff->type_diffs || diff->index_diffs) {
         if (opts->use_color) {
             sb_append(sb, ANSI_BOLD);
         }
@@ -240,10 +323,28 @@ char *generate_report(const SchemaDiff *diff, const ReportOptions *opts) {
                 free(table_report);
             }
         }
+
+        for (TypeDiff *td = diff->type_diffs; td; td = td->next) {
+            char *type_report = generate_type_diff_report(td, opts);
+            if (type_report) {
+                sb_append(sb, type_report);
+                free(type_report);
+            }
+        }
+
+        for (IndexDiff *id = diff->index_diffs; id; id = id->next) {
+            char *index_report = generate_index_diff_report(id, opts);
+            if (index_report) {
+                sb_append(sb, index_report);
+                free(index_report);
+            }
+        }
     }
 
     /* Footer */
-    if (diff->total_diffs == 0 && diff->tables_added == 0 && diff->tables_removed == 0) {
+    if (diff->total_diffs == 0 && diff->tables_added == 0 && diff->tables_removed == 0 &&
+        diff->types_added == 0 && diff->types_removed == 0 &&
+        diff->indexes_added == 0 && diff->indexes_removed == 0) {
         if (opts->use_color) {
             sb_append_fmt(sb, "%s✓ No differences found%s\n", ANSI_GREEN, ANSI_RESET);
         } else {
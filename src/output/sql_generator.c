@@ -33,28 +33,57 @@ SQLMigration *generate_migration_sql(const SchemaDiff *diff, const SQLGenOptions
         sb_append(sb, "--\n");
         sb_append_fmt(sb, "-- Tables added: %d, removed: %d, modified: %d\n",
                      diff->tables_added, diff->tables_removed, diff->tables_modified);
+        if (diff->type_diffs) {
+            sb_append_fmt(sb, "-- Types added: %d, removed: %d, modified: %d\n",
+                         diff->types_added, diff->types_removed, diff->types_modified);
+        }
+        if (diff->index_diffs) {
+            sb_append_fmt(sb, "-- Indexes added: %d, removed: %d, modified: %d\n",
+                         diff->indexes_added, diff->indexes_removed, diff->indexes_modified);
+        }
         sb_append(sb, "\n");
     }
 
+    /* Before anything runs, including the statements outside the transaction */
+    generate_table_precondition_sql(sb, diff, opts);
+
+    /* Enum values cannot be used in the transaction that adds them */
+    stmt_count += generate_enum_value_sql(sb, diff, opts);
+
+    /* DROP INDEX CONCURRENTLY cannot run inside a transaction block */
+    stmt_count += generate_index_migration_sql(sb, diff, opts, INDEX_PHASE_DROP);
+
     /* Begin transaction */
     if (opts->use_transactions) {
         sb_append(sb, "BEGIN;\n\n");
     }
 
-    /* Generate table migrations - delegate to table-specific module */
+    /* Types first so that new and altered columns can use them */
     bool has_destructive = false;
+    stmt_count += generate_type_migration_sql(sb, diff, opts, &has_destructive);
+
+    /* Generate table migrations - delegate to table-specific module */
     stmt_count += generate_table_migration_sql(sb, diff, opts, &has_destructive);
+
+    /* Index renames, and indexes of the tables just created */
+    stmt_count += generate_index_migration_sql(sb, diff, opts, INDEX_PHASE_TRANSACTION);
+
+    /* Removed types once no table uses them */
+    stmt_count += generate_type_drop_sql(sb, diff, opts, &has_destructive);
     if (has_destructive) {
         migration->has_destructive_changes = true;
     }
 
-    /* Future: Generate type, function, procedure migrations */
+    /* Future: Generate function, procedure migrations */
 
     /* Commit transaction */
     if (opts->use_transactions) {
         sb_append(sb, "COMMIT;\n");
     }
 
+    /* CREATE INDEX CONCURRENTLY cannot run inside a transaction block either */
+    stmt_count += generate_index_migration_sql(sb, diff, opts, INDEX_PHASE_CONCURRENT);
+
     migration->forward_sql = sb_to_string(sb);
     migration->statement_count = stmt_count;
     sb_free(sb);
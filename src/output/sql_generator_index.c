@@ -0,0 +1,227 @@
+#include "sql_generator.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static const char *unqualified_name(const char *name) {
+    const char *dot = strrchr(name, '.');
+    return dot ? dot + 1 : name;
+}
+
+/* Indexes live in their table's schema: qualify an unqualified index name
+ * with the table's schema for DROP and ALTER */
+static void append_index_name(StringBuilder *sb, const char *index_name, const char *table_name) {
+    const char *dot = table_name ? strrchr(table_name, '.') : NULL;
+    if (dot && !strchr(index_name, '.')) {
+        char *schema = strndup(table_name, dot - table_name);
+        if (schema) {
+            sb_append_qualified_identifier(sb, schema);
+            sb_append(sb, ".");
+            free(schema);
+        }
+    }
+    sb_append_qualified_identifier(sb, index_name);
+}
+
+static void append_index_element(StringBuilder *sb, const IndexElement *elem) {
+    if (elem->expression) {
+        sb_append_fmt(sb, "(%s)", elem->expression);
+    } else {
+        sb_append_identifier(sb, elem->column_name);
+    }
+    if (elem->collation) {
+        sb_append(sb, " COLLATE ");
+        sb_append_qualified_identifier(sb, elem->collation);
+    }
+    if (elem->opclass) {
+        sb_append(sb, " ");
+        sb_append_qualified_identifier(sb, elem->opclass);
+    }
+    if (elem->sort_order == SORT_DESC) {
+        sb_append(sb, " DESC");
+    }
+    if (elem->has_nulls_order) {
+        sb_append(sb, elem->nulls_order == NULLS_FIRST ? " NULLS FIRST" : " NULLS LAST");
+    }
+}
+
+/* Generate CREATE INDEX SQL; 'name' overrides the statement's index name */
+void generate_create_index_sql(StringBuilder *sb, const CreateIndexStmt *stmt, const char *name,
+                               bool concurrently, const SQLGenOptions *opts) {
+    (void)opts;
+    if (!sb || !stmt) {
+        return;
+    }
+    if (!name) {
+        name = stmt->index_name;
+    }
+
+    sb_append(sb, stmt->unique ? "CREATE UNIQUE INDEX " : "CREATE INDEX ");
+    if (concurrently) {
+        sb_append(sb, "CONCURRENTLY ");
+    }
+    if (name) {
+        /* The index is always created in its table's schema */
+        sb_append_identifier(sb, unqualified_name(name));
+        sb_append(sb, " ");
+    }
+    sb_append(sb, stmt->only ? "ON ONLY " : "ON ");
+    sb_append_qualified_identifier(sb, stmt->table_name);
+    if (stmt->access_method && strcasecmp(stmt->access_method, "btree") != 0) {
+        sb_append_fmt(sb, " USING %s", stmt->access_method);
+    }
+
+    sb_append(sb, " (");
+    for (int i = 0; i < stmt->element_count; i++) {
+        if (i > 0) {
+            sb_append(sb, ", ");
+        }
+        append_index_element(sb, &stmt->elements[i]);
+    }
+    sb_append(sb, ")");
+
+    if (stmt->include_count > 0) {
+        sb_append(sb, " INCLUDE (");
+        for (int i = 0; i < stmt->include_count; i++) {
+            if (i > 0) {
+                sb_append(sb, ", ");
+            }
+            sb_append_identifier(sb, stmt->include_columns[i]);
+        }
+        sb_append(sb, ")");
+    }
+    if (stmt->nulls_not_distinct) {
+        sb_append(sb, " NULLS NOT DISTINCT");
+    }
+    if (stmt->with_options && stmt->with_options->count > 0) {
+        sb_append(sb, " WITH (");
+        for (int i = 0; i < stmt->with_options->count; i++) {
+            const StorageParameter *param = &stmt->with_options->parameters[i];
+            sb_append_fmt(sb, "%s%s = %s", i > 0 ? ", " : "", param->name, param->value);
+        }
+        sb_append(sb, ")");
+    }
+    if (stmt->tablespace_name) {
+        sb_append(sb, " TABLESPACE ");
+        sb_append_identifier(sb, stmt->tablespace_name);
+    }
+    if (stmt->where_clause) {
+        sb_append_fmt(sb, " WHERE %s", stmt->where_clause);
+    }
+    sb_append(sb, ";\n");
+}
+
+/* Generate DROP INDEX SQL */
+void generate_drop_index_sql(StringBuilder *sb, const char *index_name, const char *table_name,
+                             bool concurrently, const SQLGenOptions *opts) {
+    if (!sb || !index_name) {
+        return;
+    }
+
+    sb_append(sb, "DROP INDEX ");
+    if (concurrently) {
+        sb_append(sb, "CONCURRENTLY ");
+    }
+    if (opts->use_if_exists) {
+        sb_append(sb, "IF EXISTS ");
+    }
+    append_index_name(sb, index_name, table_name);
+    sb_append(sb, ";\n");
+}
+
+static void generate_rename_index_sql(StringBuilder *sb, const char *old_name, const char *new_name,
+                                      const char *table_name) {
+    sb_append(sb, "ALTER INDEX ");
+    append_index_name(sb, old_name, table_name);
+    sb_append(sb, " RENAME TO ");
+    sb_append_identifier(sb, unqualified_name(new_name));
+    sb_append(sb, ";\n");
+}
+
+/* Build the new definition under a temporary name, then swap it in, so the
+ * table is never without the index */
+static int generate_rebuild_index_sql(StringBuilder *sb, const IndexDiff *id, bool concurrently,
+                                      const SQLGenOptions *opts) {
+    const char *name = unqualified_name(id->index_name);
+    size_t len = strlen(name) + sizeof("__new");
+    char *temp_name = malloc(len);
+    if (!temp_name) {
+        return 0;
+    }
+    snprintf(temp_name, len, "%s__new", name);
+
+    generate_create_index_sql(sb, id->target_index, temp_name, concurrently, opts);
+    generate_drop_index_sql(sb, id->old_name, id->table_name, concurrently, opts);
+    generate_rename_index_sql(sb, temp_name, id->index_name, id->table_name);
+    free(temp_name);
+    return 3;
+}
+
+/* Generate the index statements of one migration phase - returns the
+ * statement count. CREATE/DROP INDEX CONCURRENTLY cannot run inside a
+ * transaction block, so drops run before BEGIN and builds after COMMIT;
+ * renames, and indexes of tables created by this migration, stay inside. */
+int generate_index_migration_sql(StringBuilder *sb, const SchemaDiff *diff,
+                                 const SQLGenOptions *opts, IndexMigrationPhase phase) {
+    if (!sb || !diff || !opts || !diff->index_diffs) {
+        return 0;
+    }
+
+    int stmt_count = 0;
+    bool first = true;
+    for (IndexDiff *id = diff->index_diffs; id; id = id->next) {
+        const CreateIndexStmt *target = id->target_index;
+        /* ON ONLY marks a partitioned parent, which cannot be indexed concurrently */
+        bool concurrent = target && !id->table_added && !target->only;
+        bool in_phase;
+        switch (phase) {
+            case INDEX_PHASE_DROP:
+                in_phase = id->index_removed;
+                break;
+            case INDEX_PHASE_TRANSACTION:
+                in_phase = id->index_renamed ||
+                           ((id->index_added || id->index_modified) && !concurrent);
+                break;
+            default:
+                in_phase = (id->index_added || id->index_modified) && concurrent;
+                break;
+        }
+        if (!in_phase) {
+            continue;
+        }
+
+        if (first && phase == INDEX_PHASE_CONCURRENT && opts->use_transactions) {
+            sb_append(sb, "\n");  /* after COMMIT */
+        }
+        if (first && phase != INDEX_PHASE_TRANSACTION && opts->add_comments && opts->use_transactions) {
+            sb_append(sb, phase == INDEX_PHASE_DROP
+                      ? "-- Index drops (CONCURRENTLY, outside the transaction)\n"
+                      : "-- Index builds (CONCURRENTLY, outside the transaction)\n");
+        }
+        first = false;
+
+        if (opts->add_comments) {
+            const char *what = id->index_added ? "Create" : id->index_removed ? "Drop"
+                             : id->index_renamed ? "Rename" : "Rebuild";
+            sb_append_fmt(sb, "-- %s index %s on %s\n", what,
+                          id->index_name ? id->index_name : "(unnamed)", id->table_name);
+        }
+
+        if (id->index_removed) {
+            generate_drop_index_sql(sb, id->index_name, id->table_name, true, opts);
+            stmt_count++;
+        } else if (id->index_renamed) {
+            generate_rename_index_sql(sb, id->old_name, id->index_name, id->table_name);
+            stmt_count++;
+        } else if (id->index_modified) {
+            stmt_count += generate_rebuild_index_sql(sb, id, concurrent, opts);
+        } else {
+            generate_create_index_sql(sb, target, NULL, concurrent, opts);
+            stmt_count++;
+        }
+        sb_append(sb, "\n");
+    }
+    return stmt_count;
+}
@@ -1,4 +1,5 @@
 #include "sql_generator.h"
+#include "catalog_digest.h"
 #include "utils.h"
 #include <stdlib.h>
 #include <string.h>
@@ -209,6 +210,82 @@ void generate_drop_table_sql(StringBuilder *sb, const char *table_name, const SQ
     sb_append(sb, " CASCADE;\n");
 }
 
+/* Digest a table must have when the migration runs: its introspected
+ * digest, or NULL (absent) for a table the migration creates */
+static bool precondition_digest(const TableDiff *td, const char **digest) {
+    if (td->table_added) {
+        *digest = NULL;
+        return true;
+    }
+    *digest = td->source_table ? td->source_table->catalog_digest : NULL;
+    return *digest != NULL;
+}
+
+/* Guard against drift between generation and apply */
+int generate_table_precondition_sql(StringBuilder *sb, const SchemaDiff *diff,
+                                    const SQLGenOptions *opts) {
+    if (!sb || !diff || !opts || !opts->add_precondition) {
+        return 0;
+    }
+
+    /* Only an introspected target has digests to check against */
+    bool introspected = false;
+    for (const TableDiff *td = diff->table_diffs; td && !introspected; td = td->next) {
+        introspected = !td->table_added && td->source_table && td->source_table->catalog_digest;
+    }
+    if (!introspected) {
+        return 0;
+    }
+
+    if (opts->add_comments) {
+        sb_append(sb, "-- Precondition: stop unless every table this migration touches still\n");
+        sb_append(sb, "-- has the catalog digest it had when the migration was generated\n");
+    }
+    sb_append(sb, "DO $precondition$\nDECLARE\n    changed text;\nBEGIN\n");
+    sb_append(sb, "    SELECT string_agg(e.relation, ', ') INTO changed\n");
+    sb_append(sb, "    FROM (VALUES\n");
+
+    int guarded = 0;
+    for (const TableDiff *td = diff->table_diffs; td; td = td->next) {
+        const char *digest;
+        if (!precondition_digest(td, &digest)) {
+            continue;
+        }
+        /* The relation as the statements below name it */
+        StringBuilder *relation = sb_create();
+        if (!relation) {
+            continue;
+        }
+        sb_append_identifier(relation, td->table_name);
+        char *relation_sql = sb_to_string(relation);
+        sb_free(relation);
+
+        sb_append(sb, guarded ? ",\n        (" : "        (");
+        sb_append_literal(sb, relation_sql);
+        /* An introspected table is found by OID, so one dropped and
+         * recreated under the same name counts as changed */
+        uint32_t relid = td->table_added || !td->source_table ? 0 : td->source_table->relid;
+        if (relid) {
+            sb_append_fmt(sb, ", %u, ", (unsigned int)relid);
+        } else {
+            sb_append(sb, ", NULL, ");
+        }
+        sb_append_literal(sb, digest);
+        sb_append(sb, ")");
+        free(relation_sql);
+        guarded++;
+    }
+
+    sb_append(sb, "\n    ) AS e(relation, relid, digest)\n");
+    sb_append(sb, "    LEFT JOIN pg_class c ON c.oid = coalesce(e.relid::oid, to_regclass(e.relation)::oid)\n");
+    sb_append(sb, "    WHERE CASE WHEN c.oid IS NOT NULL THEN " CATALOG_TABLE_DIGEST_SQL " END\n");
+    sb_append(sb, "          IS DISTINCT FROM e.digest;\n");
+    sb_append(sb, "    IF changed IS NOT NULL THEN\n");
+    sb_append(sb, "        RAISE EXCEPTION 'Tables changed since this migration was generated: %', changed;\n");
+    sb_append(sb, "    END IF;\nEND\n$precondition$;\n\n");
+    return guarded;
+}
+
 /* Forward declarations for column/constraint SQL generation (defined in other modules) */
 void generate_add_column_sql(StringBuilder *sb, const char *table_name, const ColumnDiff *diff, const SQLGenOptions *opts);
 void generate_drop_column_sql(StringBuilder *sb, const char *table_name, const char *column_name, const SQLGenOptions *opts);
@@ -218,6 +295,47 @@ void generate_alter_column_nullable_sql(StringBuilder *sb, const char *table_nam
 void generate_add_constraint_sql(StringBuilder *sb, const char *table_name, const ConstraintDiff *diff, const SQLGenOptions *opts);
 void generate_drop_constraint_sql(StringBuilder *sb, const char *table_name, const char *constraint_name, const SQLGenOptions *opts);
 
+/* The table diff a foreign key constraint references, if that table changes */
+static const TableDiffEntry *referenced_entry(const SchemaDiff *diff, const void *constraint,
+                                              bool is_column_constraint) {
+    if (!constraint) {
+        return NULL;
+    }
+    const char *reftable = NULL;
+    if (is_column_constraint) {
+        const ColumnConstraint *cc = constraint;
+        if (cc->type == CONSTRAINT_REFERENCES) {
+            reftable = cc->constraint.references.reftable;
+        }
+    } else {
+        const TableConstraint *tc = constraint;
+        if (tc->type == TABLE_CONSTRAINT_FOREIGN_KEY) {
+            reftable = tc->constraint.foreign_key.reftable;
+        }
+    }
+    return reftable ? schema_diff_find_table(diff, reftable) : NULL;
+}
+
+/* A dropped foreign key into a table that also drops a key must go before
+ * that key does, since the key cannot be dropped while it is referenced */
+static bool drops_early(const SchemaDiff *diff, const ConstraintDiff *cd) {
+    const TableDiffEntry *ref = referenced_entry(diff, cd->source_constraint, cd->is_column_constraint);
+    return ref && !ref->diff->table_removed && ref->keys_removed;
+}
+
+/* Dropping the referenced table with CASCADE already removed it */
+static bool dropped_with_table(const SchemaDiff *diff, const ConstraintDiff *cd) {
+    const TableDiffEntry *ref = referenced_entry(diff, cd->source_constraint, cd->is_column_constraint);
+    return ref && ref->diff->table_removed;
+}
+
+/* An added foreign key into a table that also adds a key may depend on
+ * that key, so it waits until every table has its keys */
+static bool adds_late(const SchemaDiff *diff, const ConstraintDiff *cd) {
+    const TableDiffEntry *ref = referenced_entry(diff, cd->target_constraint, cd->is_column_constraint);
+    return ref && ref->keys_added;
+}
+
 /* Generate migration SQL for all table diffs */
 int generate_table_migration_sql(StringBuilder *sb, const SchemaDiff *diff,
                                   const SQLGenOptions *opts,
@@ -260,6 +378,26 @@ int generate_table_migration_sql(StringBuilder *sb, const SchemaDiff *diff,
         }
     }
 
+    /* Foreign keys that depend on a key dropped in the next pass */
+    for (TableDiff *td = diff->table_diffs; td; td = td->next) {
+        if (td->table_added || td->table_removed) {
+            continue;
+        }
+        for (int list = 0; list < 2; list++) {
+            ConstraintDiff *first = list == 0 ? td->constraints_removed : td->constraints_modified;
+            for (ConstraintDiff *cd = first; cd; cd = cd->next) {
+                if (cd->constraint_name && drops_early(diff, cd)) {
+                    generate_drop_constraint_sql(sb, td->table_name, cd->constraint_name, opts);
+                    sb_append(sb, "\n");
+                    stmt_count++;
+                    if (has_destructive) {
+                        *has_destructive = true;
+                    }
+                }
+            }
+        }
+    }
+
     /* Third pass: handle modified tables (column and constraint changes) */
     for (TableDiff *td = diff->table_diffs; td; td = td->next) {
         if (td->table_added || td->table_removed) {
@@ -328,6 +466,9 @@ int generate_table_migration_sql(StringBuilder *sb, const SchemaDiff *diff,
 
         /* Handle constraint changes */
         for (ConstraintDiff *cd = td->constraints_removed; cd; cd = cd->next) {
+            if (drops_early(diff, cd) || dropped_with_table(diff, cd)) {
+                continue;
+            }
             generate_drop_constraint_sql(sb, td->table_name, cd->constraint_name, opts);
             sb_append(sb, "\n");
             stmt_count++;
@@ -337,6 +478,9 @@ int generate_table_migration_sql(StringBuilder *sb, const SchemaDiff *diff,
         }
 
         for (ConstraintDiff *cd = td->constraints_added; cd; cd = cd->next) {
+            if (adds_late(diff, cd)) {
+                continue;
+            }
             generate_add_constraint_sql(sb, td->table_name, cd, opts);
             sb_append(sb, "\n");
             stmt_count++;
@@ -344,15 +488,17 @@ int generate_table_migration_sql(StringBuilder *sb, const SchemaDiff *diff,
 
         for (ConstraintDiff *cd = td->constraints_modified; cd; cd = cd->next) {
             /* Drop old constraint and add new one */
-            if (cd->constraint_name) {
+            if (cd->constraint_name && !drops_early(diff, cd) && !dropped_with_table(diff, cd)) {
                 generate_drop_constraint_sql(sb, td->table_name, cd->constraint_name, opts);
                 sb_append(sb, "\n");
                 stmt_count++;
             }
 
-            generate_add_constraint_sql(sb, td->table_name, cd, opts);
-            sb_append(sb, "\n");
-            stmt_count++;
+            if (!adds_late(diff, cd)) {
+                generate_add_constraint_sql(sb, td->table_name, cd, opts);
+                sb_append(sb, "\n");
+                stmt_count++;
+            }
         }
     }
 
@@ -369,5 +515,22 @@ int generate_table_migration_sql(StringBuilder *sb, const SchemaDiff *diff,
         }
     }
 
+    /* Foreign keys of modified tables that waited for their referenced key */
+    for (TableDiff *td = diff->table_diffs; td; td = td->next) {
+        if (td->table_added || td->table_removed) {
+            continue;
+        }
+        for (int list = 0; list < 2; list++) {
+            ConstraintDiff *first = list == 0 ? td->constraints_added : td->constraints_modified;
+            for (ConstraintDiff *cd = first; cd; cd = cd->next) {
+                if (adds_late(diff, cd)) {
+                    generate_add_constraint_sql(sb, td->table_name, cd, opts);
+                    sb_append(sb, "\n");
+                    stmt_count++;
+                }
+            }
+        }
+    }
+
     return stmt_count;
 }
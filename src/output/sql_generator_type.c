@@ -0,0 +1,417 @@
+#include "sql_generator.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *unqualified_name(const char *type_name) {
+    const char *dot = strrchr(type_name, '.');
+    return dot ? dot + 1 : type_name;
+}
+
+static const char *alignment_name(char alignment) {
+    switch (alignment) {
+        case 'c': return "char";
+        case 's': return "int2";
+        case 'd': return "double";
+        default:  return "int4";
+    }
+}
+
+static const char *storage_name(char storage) {
+    switch (storage) {
+        case 'e': return "external";
+        case 'x': return "extended";
+        case 'm': return "main";
+        default:  return "plain";
+    }
+}
+
+/* Append "NAME = value" to a parenthesised option list */
+static void append_type_option(StringBuilder *sb, bool *first, const char *name, const char *value) {
+    if (!value) {
+        return;
+    }
+    sb_append(sb, *first ? "" : ", ");
+    sb_append_fmt(sb, "%s = %s", name, value);
+    *first = false;
+}
+
+static void append_range_definition(StringBuilder *sb, const RangeTypeDef *def) {
+    bool first = true;
+    sb_append(sb, " AS RANGE (");
+    append_type_option(sb, &first, "SUBTYPE", def->subtype);
+    append_type_option(sb, &first, "SUBTYPE_OPCLASS", def->subtype_opclass);
+    append_type_option(sb, &first, "COLLATION", def->collation);
+    append_type_option(sb, &first, "CANONICAL", def->canonical_function);
+    append_type_option(sb, &first, "SUBTYPE_DIFF", def->subtype_diff_function);
+    append_type_option(sb, &first, "MULTIRANGE_TYPE_NAME", def->multirange_type_name);
+    sb_append(sb, ")");
+}
+
+static void append_base_definition(StringBuilder *sb, const BaseTypeDef *def) {
+    bool first = true;
+    char buf[32];
+
+    sb_append(sb, " (");
+    append_type_option(sb, &first, "INPUT", def->input_function);
+    append_type_option(sb, &first, "OUTPUT", def->output_function);
+    append_type_option(sb, &first, "RECEIVE", def->receive_function);
+    append_type_option(sb, &first, "SEND", def->send_function);
+    append_type_option(sb, &first, "TYPMOD_IN", def->typmod_in_function);
+    append_type_option(sb, &first, "TYPMOD_OUT", def->typmod_out_function);
+    append_type_option(sb, &first, "ANALYZE", def->analyze_function);
+    if (def->has_internallength) {
+        if (def->is_variable_length) {
+            append_type_option(sb, &first, "INTERNALLENGTH", "VARIABLE");
+        } else {
+            snprintf(buf, sizeof(buf), "%d", def->internallength);
+            append_type_option(sb, &first, "INTERNALLENGTH", buf);
+        }
+    }
+    if (def->has_passedbyvalue && def->passedbyvalue) {
+        sb_append(sb, first ? "PASSEDBYVALUE" : ", PASSEDBYVALUE");
+        first = false;
+    }
+    if (def->has_alignment) {
+        append_type_option(sb, &first, "ALIGNMENT", alignment_name(def->alignment));
+    }
+    if (def->has_storage) {
+        append_type_option(sb, &first, "STORAGE", storage_name(def->storage));
+    }
+    append_type_option(sb, &first, "LIKE", def->like_type);
+    if (def->has_category) {
+        snprintf(buf, sizeof(buf), "'%c'", def->category);
+        append_type_option(sb, &first, "CATEGORY", buf);
+    }
+    if (def->has_preferred) {
+        append_type_option(sb, &first, "PREFERRED", def->preferred ? "true" : "false");
+    }
+    append_type_option(sb, &first, "DEFAULT", def->default_value);
+    append_type_option(sb, &first, "ELEMENT", def->element_type);
+    if (def->has_delimiter) {
+        snprintf(buf, sizeof(buf), "'%c'", def->delimiter);
+        append_type_option(sb, &first, "DELIMITER", buf);
+    }
+    append_type_option(sb, &first, "COLLATABLE", def->collatable);
+    sb_append(sb, ")");
+}
+
+/* Generate CREATE TYPE SQL */
+void generate_create_type_sql(StringBuilder *sb, const CreateTypeStmt *stmt, const SQLGenOptions *opts) {
+    if (!sb || !stmt || !stmt->type_name) {
+        return;
+    }
+
+    if (opts->add_comments) {
+        sb_append(sb, "-- Create type ");
+        sb_append(sb, stmt->type_name);
+        sb_append(sb, "\n");
+    }
+
+    sb_append(sb, "CREATE TYPE ");
+    sb_append_qualified_identifier(sb, stmt->type_name);
+
+    switch (stmt->variant) {
+        case TYPE_VARIANT_ENUM: {
+            const EnumTypeDef *def = &stmt->type_def.enum_def;
+            sb_append(sb, " AS ENUM (");
+            for (int i = 0; i < def->label_count; i++) {
+                if (i > 0) sb_append(sb, ", ");
+                sb_append_literal(sb, def->labels[i]);
+            }
+            sb_append(sb, ")");
+            break;
+        }
+        case TYPE_VARIANT_COMPOSITE:
+            sb_append(sb, " AS (");
+            for (int i = 0; i < stmt->type_def.composite_def.attribute_count; i++) {
+                const CompositeAttribute *attr = &stmt->type_def.composite_def.attributes[i];
+                if (i > 0) sb_append(sb, ", ");
+                sb_append_identifier(sb, attr->attr_name);
+                sb_append(sb, " ");
+                sb_append(sb, attr->data_type ? attr->data_type : "text");
+                if (attr->collation) {
+                    sb_append(sb, " COLLATE ");
+                    sb_append_identifier(sb, attr->collation);
+                }
+            }
+            sb_append(sb, ")");
+            break;
+        case TYPE_VARIANT_RANGE:
+            append_range_definition(sb, &stmt->type_def.range_def);
+            break;
+        case TYPE_VARIANT_BASE:
+            append_base_definition(sb, &stmt->type_def.base_def);
+            break;
+    }
+
+    sb_append(sb, ";\n");
+}
+
+/* Generate DROP TYPE SQL */
+void generate_drop_type_sql(StringBuilder *sb, const char *type_name, const SQLGenOptions *opts) {
+    if (!sb || !type_name) {
+        return;
+    }
+
+    if (opts->add_warnings) {
+        sb_append(sb, "-- WARNING: Dropping type - fails while a column still uses it\n");
+    }
+
+    if (opts->add_comments) {
+        sb_append(sb, "-- Drop type ");
+        sb_append(sb, type_name);
+        sb_append(sb, "\n");
+    }
+
+    sb_append(sb, "DROP TYPE ");
+    if (opts->use_if_exists) {
+        sb_append(sb, "IF EXISTS ");
+    }
+    sb_append_qualified_identifier(sb, type_name);
+    sb_append(sb, ";\n");
+}
+
+/* Generate ALTER TYPE ... ADD VALUE statements for every modified enum.
+ * A value added inside a transaction block cannot be used until that
+ * transaction commits, so these run before BEGIN; IF NOT EXISTS keeps the
+ * script re-runnable if the transaction later fails. */
+int generate_enum_value_sql(StringBuilder *sb, const SchemaDiff *diff, const SQLGenOptions *opts) {
+    if (!sb || !diff || !opts) {
+        return 0;
+    }
+
+    int stmt_count = 0;
+    for (TypeDiff *td = diff->type_diffs; td; td = td->next) {
+        if (!td->type_modified || td->requires_recreate || !td->values_added) {
+            continue;
+        }
+
+        if (opts->add_comments) {
+            sb_append_fmt(sb, "-- Add values to enum %s%s\n", td->type_name,
+                          opts->use_transactions ? " (outside the transaction)" : "");
+        }
+        for (EnumValueChange *change = td->values_added; change; change = change->next) {
+            sb_append(sb, "ALTER TYPE ");
+            sb_append_qualified_identifier(sb, td->type_name);
+            sb_append(sb, " ADD VALUE IF NOT EXISTS ");
+            sb_append_literal(sb, change->label);
+            if (change->anchor) {
+                sb_append(sb, change->before ? " BEFORE " : " AFTER ");
+                sb_append_literal(sb, change->anchor);
+            }
+            sb_append(sb, ";\n");
+            stmt_count++;
+        }
+        sb_append(sb, "\n");
+    }
+    return stmt_count;
+}
+
+static void append_alter_type(StringBuilder *sb, const char *type_name) {
+    sb_append(sb, "ALTER TYPE ");
+    sb_append_qualified_identifier(sb, type_name);
+}
+
+/* Rename, recreate with the desired definition, convert stored columns
+ * through text, then drop the renamed original */
+static int generate_recreate_type_sql(StringBuilder *sb, const TypeDiff *td,
+                                      const SQLGenOptions *opts) {
+    int stmt_count = 0;
+
+    if (td->target_type->variant == TYPE_VARIANT_BASE ||
+        td->source_type->variant == TYPE_VARIANT_BASE) {
+        if (opts->add_warnings) {
+            sb_append_fmt(sb, "-- WARNING: Base type %s changed; it must be recreated "
+                          "together with its I/O functions by hand\n\n", td->type_name);
+        }
+        return 0;
+    }
+
+    if (opts->add_warnings) {
+        sb_append_fmt(sb, "-- WARNING: Type %s cannot be changed in place; it is recreated "
+                      "and columns using it are converted through text\n", td->type_name);
+    }
+
+    size_t old_len = strlen(td->type_name) + sizeof("__old");
+    char *old_name = malloc(old_len);
+    if (!old_name) {
+        return 0;
+    }
+    snprintf(old_name, old_len, "%s__old", td->type_name);
+
+    append_alter_type(sb, td->type_name);
+    sb_append(sb, " RENAME TO ");
+    sb_append_identifier(sb, unqualified_name(old_name));
+    sb_append(sb, ";\n");
+    stmt_count++;
+
+    generate_create_type_sql(sb, td->target_type, opts);
+    stmt_count++;
+
+    for (TypeDependentColumn *dep = td->dependents; dep; dep = dep->next) {
+        if (dep->default_expr) {
+            sb_append(sb, "ALTER TABLE ");
+            sb_append_identifier(sb, dep->table_name);
+            sb_append(sb, " ALTER COLUMN ");
+            sb_append_identifier(sb, dep->column_name);
+            sb_append(sb, " DROP DEFAULT;\n");
+            stmt_count++;
+        }
+
+        sb_append(sb, "ALTER TABLE ");
+        sb_append_identifier(sb, dep->table_name);
+        sb_append(sb, " ALTER COLUMN ");
+        sb_append_identifier(sb, dep->column_name);
+        sb_append_fmt(sb, " TYPE %s USING ", dep->data_type);
+        sb_append_identifier(sb, dep->column_name);
+        sb_append_fmt(sb, "::text::%s;\n", dep->data_type);
+        stmt_count++;
+
+        if (dep->default_expr) {
+            sb_append(sb, "ALTER TABLE ");
+            sb_append_identifier(sb, dep->table_name);
+            sb_append(sb, " ALTER COLUMN ");
+            sb_append_identifier(sb, dep->column_name);
+            sb_append_fmt(sb, " SET DEFAULT %s;\n", dep->default_expr);
+            stmt_count++;
+        }
+    }
+
+    sb_append(sb, "DROP TYPE ");
+    sb_append_qualified_identifier(sb, old_name);
+    sb_append(sb, ";\n");
+    stmt_count++;
+
+    free(old_name);
+    return stmt_count;
+}
+
+static void append_attribute_collation(StringBuilder *sb, const ColumnDiff *cd) {
+    if (cd->new_collation) {
+        sb_append(sb, " COLLATE ");
+        sb_append_identifier(sb, cd->new_collation);
+    }
+}
+
+/* Generate migration SQL for added and modified types - returns statement count.
+ * Runs before the table migration so new columns can use the types. */
+int generate_type_migration_sql(StringBuilder *sb, const SchemaDiff *diff,
+                                const SQLGenOptions *opts,
+                                bool *has_destructive) {
+    if (!sb || !diff || !opts) {
+        return 0;
+    }
+
+    int stmt_count = 0;
+
+    for (TypeDiff *td = diff->type_diffs; td; td = td->next) {
+        if (td->type_added && td->target_type) {
+            generate_create_type_sql(sb, td->target_type, opts);
+            sb_append(sb, "\n");
+            stmt_count++;
+            continue;
+        }
+        if (!td->type_modified) {
+            continue;
+        }
+
+        if (opts->add_comments) {
+            sb_append_fmt(sb, "-- Alter type %s\n", td->type_name);
+        }
+
+        /* Renames first: a recreated enum then converts renamed values too */
+        for (EnumValueChange *change = td->values_renamed; change; change = change->next) {
+            append_alter_type(sb, td->type_name);
+            sb_append(sb, " RENAME VALUE ");
+            sb_append_literal(sb, change->old_label);
+            sb_append(sb, " TO ");
+            sb_append_literal(sb, change->label);
+            sb_append(sb, ";\n");
+            stmt_count++;
+        }
+
+        if (td->requires_recreate) {
+            stmt_count += generate_recreate_type_sql(sb, td, opts);
+            if (has_destructive) {
+                *has_destructive = true;
+            }
+            sb_append(sb, "\n");
+            continue;
+        }
+
+        for (ColumnDiff *cd = td->attributes_removed; cd; cd = cd->next) {
+            if (opts->add_warnings) {
+                sb_append(sb, "-- WARNING: Dropping attribute - its values are lost\n");
+            }
+            append_alter_type(sb, td->type_name);
+            sb_append(sb, " DROP ATTRIBUTE ");
+            if (opts->use_if_exists) {
+                sb_append(sb, "IF EXISTS ");
+            }
+            sb_append_identifier(sb, cd->column_name);
+            sb_append(sb, ";\n");
+            stmt_count++;
+            if (has_destructive) {
+                *has_destructive = true;
+            }
+        }
+
+        for (ColumnDiff *cd = td->attributes_added; cd; cd = cd->next) {
+            append_alter_type(sb, td->type_name);
+            sb_append(sb, " ADD ATTRIBUTE ");
+            sb_append_identifier(sb, cd->column_name);
+            sb_append_fmt(sb, " %s", cd->new_type ? cd->new_type : "text");
+            append_attribute_collation(sb, cd);
+            sb_append(sb, ";\n");
+            stmt_count++;
+        }
+
+        for (ColumnDiff *cd = td->attributes_modified; cd; cd = cd->next) {
+            if (opts->add_warnings) {
+                sb_append(sb, "-- WARNING: Fails while a table column stores this type\n");
+            }
+            append_alter_type(sb, td->type_name);
+            sb_append(sb, " ALTER ATTRIBUTE ");
+            sb_append_identifier(sb, cd->column_name);
+            sb_append_fmt(sb, " SET DATA TYPE %s", cd->new_type ? cd->new_type : "text");
+            append_attribute_collation(sb, cd);
+            sb_append(sb, ";\n");
+            stmt_count++;
+        }
+
+        for (Diff *d = td->diffs; d; d = d->next) {
+            if (d->type == DIFF_ATTRIBUTES_REORDERED && opts->add_warnings) {
+                sb_append(sb, "-- WARNING: ADD ATTRIBUTE appends; attribute order will "
+                          "differ from the definition\n");
+            }
+        }
+        sb_append(sb, "\n");
+    }
+
+    return stmt_count;
+}
+
+/* Generate DROP TYPE for removed types - returns statement count.
+ * Runs after the table migration has dropped the columns using them. */
+int generate_type_drop_sql(StringBuilder *sb, const SchemaDiff *diff,
+                           const SQLGenOptions *opts,
+                           bool *has_destructive) {
+    if (!sb || !diff || !opts) {
+        return 0;
+    }
+
+    int stmt_count = 0;
+    for (TypeDiff *td = diff->type_diffs; td; td = td->next) {
+        if (td->type_removed) {
+            generate_drop_type_sql(sb, td->type_name, opts);
+            sb_append(sb, "\n");
+            stmt_count++;
+            if (has_destructive) {
+                *has_destructive = true;
+            }
+        }
+    }
+    return stmt_count;
+}
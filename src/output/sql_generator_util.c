@@ -17,6 +17,7 @@ SQLGenOptions *sql_gen_options_default(void) {
     opts->add_warnings = true;
     opts->generate_rollback = false;
     opts->safe_mode = true;
+    opts->add_precondition = true;
     opts->schema_name = NULL;
 
     return opts;
@@ -59,7 +60,7 @@ static bool is_reserved_keyword(const char *identifier) {
 
     /* Convert to lowercase for comparison */
     for (size_t i = 0; i < len; i++) {
-        lower[i] = tolower(identifier[i]);
+        lower[i] = tolower((unsigned char)identifier[i]);
     }
     lower[len] = '\0';
 
@@ -86,10 +87,11 @@ void sb_append_identifier(StringBuilder *sb, const char *identifier) {
         needs_quote = true;
     }
 
-    /* Check if it contains special characters (except underscore) */
+    /* Check if it contains special characters (except underscore); non-ASCII
+     * letters need no quotes, as the lexer accepts them unquoted */
     if (!needs_quote) {
         for (const char *p = identifier; *p; p++) {
-            if (!isalnum(*p) && *p != '_') {
+            if (!isalnum((unsigned char)*p) && *p != '_' && (unsigned char)*p < 0x80) {
                 needs_quote = true;
                 break;
             }
@@ -97,7 +99,7 @@ void sb_append_identifier(StringBuilder *sb, const char *identifier) {
     }
 
     /* Check if it starts with a digit */
-    if (!needs_quote && isdigit(identifier[0])) {
+    if (!needs_quote && isdigit((unsigned char)identifier[0])) {
         needs_quote = true;
     }
 
@@ -121,6 +123,25 @@ void sb_append_identifier(StringBuilder *sb, const char *identifier) {
     sb_append(sb, "\"");
 }
 
+/* Append a possibly schema-qualified name, quoting each part */
+void sb_append_qualified_identifier(StringBuilder *sb, const char *name) {
+    if (!sb || !name) {
+        return;
+    }
+    const char *dot = strchr(name, '.');
+    if (!dot) {
+        sb_append_identifier(sb, name);
+        return;
+    }
+    char *schema = strndup(name, dot - name);
+    if (schema) {
+        sb_append_identifier(sb, schema);
+        sb_append(sb, ".");
+        free(schema);
+    }
+    sb_append_qualified_identifier(sb, dot + 1);
+}
+
 /* Append quoted SQL literal to string builder */
 void sb_append_literal(StringBuilder *sb, const char *literal) {
     if (!sb) {
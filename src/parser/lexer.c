@@ -165,6 +165,29 @@ static char peek_next(Lexer *lexer) {
     return lexer->current[1];
 }
 
+/* Bytes >= 0x80 are identifier characters, as in PostgreSQL's scanner
+ * (ident_start/ident_cont include \200-\377). Input is validated as UTF-8
+ * at load time, so they are always parts of multibyte letters. */
+static bool is_high_bit(char c) {
+    return (unsigned char)c >= 0x80;
+}
+
+static bool is_ident_start(char c) {
+    return isalpha((unsigned char)c) || c == '_' || is_high_bit(c);
+}
+
+static bool is_ident_char(char c) {
+    return isalnum((unsigned char)c) || c == '_' || c == '$' || is_high_bit(c);
+}
+
+/* Consume the rest of a multibyte character whose lead byte was just
+ * consumed; the column counts characters, not bytes */
+static void skip_continuation_bytes(Lexer *lexer) {
+    while (((unsigned char)*lexer->current & 0xC0) == 0x80) {
+        lexer->current++;
+    }
+}
+
 static bool match(Lexer *lexer, char expected) {
     if (is_at_end(lexer)) {
         return false;
@@ -232,7 +255,7 @@ static Token make_token(Lexer *lexer, TokenType type) {
     Token token;
     token.type = type;
     token.line = lexer->line;
-    token.column = lexer->column - (int)(lexer->current - lexer->start);
+    token.column = lexer->start_column;
     token.length = (size_t)(lexer->current - lexer->start);
     token.lexeme = strndup(lexer->start, token.length);
     return token;
@@ -283,8 +306,10 @@ bool is_keyword(const char *text, TokenType *type) {
 }
 
 static Token identifier(Lexer *lexer) {
-    while (isalnum(peek(lexer)) || peek(lexer) == '_') {
-        advance(lexer);
+    while (is_ident_char(peek(lexer))) {
+        if (is_high_bit(advance(lexer))) {
+            skip_continuation_bytes(lexer);
+        }
     }
 
     /* Check if it's a keyword */
@@ -315,7 +340,9 @@ static Token quoted_identifier(Lexer *lexer) {
                 lexer->line++;
                 lexer->column = 0;
             }
-            advance(lexer);
+            if (is_high_bit(advance(lexer))) {
+                skip_continuation_bytes(lexer);
+            }
         }
     }
 
@@ -348,7 +375,9 @@ static Token string_literal(Lexer *lexer) {
                 lexer->line++;
                 lexer->column = 0;
             }
-            advance(lexer);
+            if (is_high_bit(advance(lexer))) {
+                skip_continuation_bytes(lexer);
+            }
         }
     }
 
@@ -362,14 +391,14 @@ static Token string_literal(Lexer *lexer) {
 }
 
 static Token number(Lexer *lexer) {
-    while (isdigit(peek(lexer))) {
+    while (isdigit((unsigned char)peek(lexer))) {
         advance(lexer);
     }
 
     /* Decimal part */
-    if (peek(lexer) == '.' && isdigit(peek_next(lexer))) {
+    if (peek(lexer) == '.' && isdigit((unsigned char)peek_next(lexer))) {
         advance(lexer); /* . */
-        while (isdigit(peek(lexer))) {
+        while (isdigit((unsigned char)peek(lexer))) {
             advance(lexer);
         }
     }
@@ -380,7 +409,7 @@ static Token number(Lexer *lexer) {
         if (peek(lexer) == '+' || peek(lexer) == '-') {
             advance(lexer);
         }
-        while (isdigit(peek(lexer))) {
+        while (isdigit((unsigned char)peek(lexer))) {
             advance(lexer);
         }
     }
@@ -395,6 +424,7 @@ void lexer_init(Lexer *lexer, const char *source) {
     lexer->current = source;
     lexer->line = 1;
     lexer->column = 1;
+    lexer->start_column = 1;
     lexer->had_error = false;
     lexer->error_message = NULL;
 }
@@ -404,6 +434,7 @@ Token lexer_next_token(Lexer *lexer) {
     skip_whitespace(lexer);
 
     lexer->start = lexer->current;
+    lexer->start_column = lexer->column;
 
     if (is_at_end(lexer)) {
         return make_token(lexer, TOKEN_EOF);
@@ -412,12 +443,15 @@ Token lexer_next_token(Lexer *lexer) {
     char c = advance(lexer);
 
     /* Identifiers and keywords */
-    if (isalpha(c) || c == '_') {
+    if (is_ident_start(c)) {
+        if (is_high_bit(c)) {
+            skip_continuation_bytes(lexer);
+        }
         return identifier(lexer);
     }
 
     /* Numbers */
-    if (isdigit(c)) {
+    if (isdigit((unsigned char)c)) {
         return number(lexer);
     }
 
@@ -3,10 +3,11 @@
 #include "utils.h"
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 
 /* Parse column definition */
 ColumnDef *parse_column_def(Parser *parser) {
-    ColumnDef *col = column_def_alloc(parser->memory_ctx);
+    ColumnDef *col = parser_alloc(parser, sizeof(ColumnDef));
     if (!col) {
         parser_error(parser, "Out of memory");
         return NULL;
@@ -20,7 +21,7 @@ ColumnDef *parse_column_def(Parser *parser) {
         return NULL;
     }
 
-    col->column_name = strdup(parser->current.lexeme);
+    col->column_name = parser_strdup(parser, parser->current.lexeme);
     parser_advance(parser);
 
     /* Parse data type */
@@ -43,7 +44,7 @@ ColumnDef *parse_column_def(Parser *parser) {
                 parser_error(parser, "Expected collation name after COLLATE");
                 return NULL;
             }
-            col->collation = strdup(parser->current.lexeme);
+            col->collation = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_STORAGE)) {
             col->has_storage = true;
@@ -66,7 +67,7 @@ ColumnDef *parse_column_def(Parser *parser) {
                 parser_error(parser, "Expected compression method after COMPRESSION");
                 return NULL;
             }
-            col->compression_method = strdup(parser->current.lexeme);
+            col->compression_method = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_check(parser, TOKEN_CONSTRAINT) ||
                    parser_check(parser, TOKEN_NOT) ||
@@ -78,11 +79,14 @@ ColumnDef *parse_column_def(Parser *parser) {
                    parser_check(parser, TOKEN_PRIMARY) ||
                    parser_check(parser, TOKEN_REFERENCES)) {
             /* Parse column constraints */
+            size_t mark = parser_mark(parser);
             ColumnConstraint *constraint = parse_column_constraint(parser);
             if (constraint) {
                 /* Add to constraint list */
                 constraint->next = col->constraints;
                 col->constraints = constraint;
+            } else {
+                parser_discard(parser, mark);
             }
         } else {
             /* No more column attributes */
@@ -93,6 +97,25 @@ ColumnDef *parse_column_def(Parser *parser) {
     return col;
 }
 
+/* Type names are assembled in place and copied out once */
+#define TYPE_TEXT_MAX 512
+
+typedef struct {
+    char text[TYPE_TEXT_MAX];
+    size_t len;
+    bool overflow;
+} TypeText;
+
+static void type_text_append(TypeText *tt, const char *str) {
+    size_t n = strlen(str);
+    if (tt->len + n >= sizeof(tt->text)) {
+        tt->overflow = true;
+        return;
+    }
+    memcpy(tt->text + tt->len, str, n + 1);
+    tt->len += n;
+}
+
 /* Parse data type */
 char *parse_data_type(Parser *parser) {
     if (!parser_check(parser, TOKEN_IDENTIFIER)) {
@@ -100,88 +123,80 @@ char *parse_data_type(Parser *parser) {
     }
 
     /* Build data type string (may include modifiers like length, precision) */
-    StringBuilder *sb = sb_create();
-    if (!sb) {
-        return NULL;
-    }
+    TypeText tt = {.len = 0, .overflow = false};
+    tt.text[0] = '\0';
 
     /* Base type name */
-    sb_append(sb, parser->current.lexeme);
-    char *base_type = str_to_lower(parser->current.lexeme);
+    type_text_append(&tt, parser->current.lexeme);
+    bool is_double = strcasecmp(parser->current.lexeme, "double") == 0;
     parser_advance(parser);
 
     /* Check for multi-word type names like DOUBLE PRECISION */
-    if (base_type && strcmp(base_type, "double") == 0 && parser_check(parser, TOKEN_PRECISION)) {
-        sb_append(sb, " ");
-        sb_append(sb, parser->current.lexeme);
+    if (is_double && parser_check(parser, TOKEN_PRECISION)) {
+        type_text_append(&tt, " ");
+        type_text_append(&tt, parser->current.lexeme);
         parser_advance(parser);
     }
-    free(base_type);
 
     /* Check for schema-qualified type (schema.typename) */
     if (parser_match(parser, TOKEN_DOT)) {
-        sb_append(sb, ".");
+        type_text_append(&tt, ".");
         if (!parser_check(parser, TOKEN_IDENTIFIER)) {
             parser_error(parser, "Expected type name after schema qualifier");
-            sb_free(sb);
             return NULL;
         }
-        sb_append(sb, parser->current.lexeme);
+        type_text_append(&tt, parser->current.lexeme);
         parser_advance(parser);
     }
 
     /* Check for type modifiers: (length) or (precision, scale) */
     if (parser_match(parser, TOKEN_LPAREN)) {
-        sb_append(sb, "(");
+        type_text_append(&tt, "(");
 
         /* First number */
         if (!parser_check(parser, TOKEN_NUMBER)) {
             parser_error(parser, "Expected number in type modifier");
-            sb_free(sb);
             return NULL;
         }
-        sb_append(sb, parser->current.lexeme);
+        type_text_append(&tt, parser->current.lexeme);
         parser_advance(parser);
 
         /* Optional second number (for precision/scale) */
         if (parser_match(parser, TOKEN_COMMA)) {
-            sb_append(sb, ",");
+            type_text_append(&tt, ",");
             if (!parser_check(parser, TOKEN_NUMBER)) {
                 parser_error(parser, "Expected number after comma in type modifier");
-                sb_free(sb);
                 return NULL;
             }
-            sb_append(sb, parser->current.lexeme);
+            type_text_append(&tt, parser->current.lexeme);
             parser_advance(parser);
         }
 
         if (!parser_expect(parser, TOKEN_RPAREN, "Expected ')' after type modifier")) {
-            sb_free(sb);
             return NULL;
         }
-        sb_append(sb, ")");
+        type_text_append(&tt, ")");
     }
 
     /* Check for array notation [] */
     while (parser_match(parser, TOKEN_LBRACKET)) {
-        sb_append(sb, "[");
+        type_text_append(&tt, "[");
 
         /* Optional array size */
         if (parser_check(parser, TOKEN_NUMBER)) {
-            sb_append(sb, parser->current.lexeme);
+            type_text_append(&tt, parser->current.lexeme);
             parser_advance(parser);
         }
 
         if (!parser_expect(parser, TOKEN_RBRACKET, "Expected ']' in array type")) {
-            sb_free(sb);
             return NULL;
         }
-        sb_append(sb, "]");
+        type_text_append(&tt, "]");
     }
 
-    char *type_str = sb_to_string(sb);
-    sb_free(sb);
-
-    /* Return directly - no need to copy since stmt owns it */
-    return type_str;
+    if (tt.overflow) {
+        parser_error(parser, "Data type name too long");
+        return NULL;
+    }
+    return parser_strndup(parser, tt.text, tt.len);
 }
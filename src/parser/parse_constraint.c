@@ -6,7 +6,7 @@
 
 /* Parse column constraint */
 ColumnConstraint *parse_column_constraint(Parser *parser) {
-    ColumnConstraint *constraint = column_constraint_alloc(parser->memory_ctx);
+    ColumnConstraint *constraint = parser_alloc(parser, sizeof(ColumnConstraint));
     if (!constraint) {
         parser_error(parser, "Out of memory");
         return NULL;
@@ -25,7 +25,7 @@ ColumnConstraint *parse_column_constraint(Parser *parser) {
             parser_error(parser, "Expected constraint name after CONSTRAINT");
             return NULL;
         }
-        constraint->constraint_name = strdup(parser->current.lexeme);
+        constraint->constraint_name = parser_strdup(parser, parser->current.lexeme);
         parser_advance(parser);
     }
 
@@ -164,7 +164,7 @@ ColumnConstraint *parse_column_constraint(Parser *parser) {
             parser_error(parser, "Expected table name after REFERENCES");
             return NULL;
         }
-        constraint->constraint.references.reftable = strdup(parser->current.lexeme);
+        constraint->constraint.references.reftable = parser_strdup(parser, parser->current.lexeme);
         parser_advance(parser);
 
         /* Optional column name */
@@ -174,7 +174,7 @@ ColumnConstraint *parse_column_constraint(Parser *parser) {
                 parser_error(parser, "Expected column name");
                 return NULL;
             }
-            constraint->constraint.references.refcolumn = strdup(parser->current.lexeme);
+            constraint->constraint.references.refcolumn = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
             if (!parser_expect(parser, TOKEN_RPAREN, "Expected ')' after column name")) {
                 return NULL;
@@ -284,7 +284,7 @@ ColumnConstraint *parse_column_constraint(Parser *parser) {
 
 /* Parse table constraint */
 TableConstraint *parse_table_constraint(Parser *parser) {
-    TableConstraint *constraint = table_constraint_alloc(parser->memory_ctx);
+    TableConstraint *constraint = parser_alloc(parser, sizeof(TableConstraint));
     if (!constraint) {
         parser_error(parser, "Out of memory");
         return NULL;
@@ -303,7 +303,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
             parser_error(parser, "Expected constraint name after CONSTRAINT");
             return NULL;
         }
-        constraint->constraint_name = strdup(parser->current.lexeme);
+        constraint->constraint_name = parser_strdup(parser, parser->current.lexeme);
         parser_advance(parser);
     }
 
@@ -331,7 +331,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
         }
 
         int capacity = 4;
-        constraint->constraint.unique.columns = malloc(sizeof(char*) * capacity);
+        constraint->constraint.unique.columns = parser_alloc(parser, sizeof(char*) * capacity);
         constraint->constraint.unique.column_count = 0;
 
         do {
@@ -342,7 +342,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
 
             if (constraint->constraint.unique.column_count >= capacity) {
                 capacity *= 2;
-                char **new_cols = realloc(constraint->constraint.unique.columns,
+                char **new_cols = parser_realloc(parser, constraint->constraint.unique.columns,
                                          sizeof(char*) * capacity);
                 if (!new_cols) {
                     return NULL;
@@ -351,7 +351,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
             }
 
             constraint->constraint.unique.columns[constraint->constraint.unique.column_count++] =
-                strdup(parser->current.lexeme);
+                parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } while (parser_match(parser, TOKEN_COMMA));
 
@@ -394,7 +394,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
 
         /* Parse column names */
         int capacity = 4;
-        constraint->constraint.primary_key.columns = malloc(sizeof(char*) * capacity);
+        constraint->constraint.primary_key.columns = parser_alloc(parser, sizeof(char*) * capacity);
         constraint->constraint.primary_key.column_count = 0;
 
         do {
@@ -405,7 +405,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
 
             if (constraint->constraint.primary_key.column_count >= capacity) {
                 capacity *= 2;
-                char **new_cols = realloc(constraint->constraint.primary_key.columns,
+                char **new_cols = parser_realloc(parser, constraint->constraint.primary_key.columns,
                                          sizeof(char*) * capacity);
                 if (!new_cols) {
                     return NULL;
@@ -414,7 +414,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
             }
 
             constraint->constraint.primary_key.columns[constraint->constraint.primary_key.column_count++] =
-                strdup(parser->current.lexeme);
+                parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } while (parser_match(parser, TOKEN_COMMA));
 
@@ -437,7 +437,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
         }
 
         int capacity = 4;
-        constraint->constraint.foreign_key.columns = malloc(sizeof(char*) * capacity);
+        constraint->constraint.foreign_key.columns = parser_alloc(parser, sizeof(char*) * capacity);
         constraint->constraint.foreign_key.column_count = 0;
 
         do {
@@ -448,7 +448,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
 
             if (constraint->constraint.foreign_key.column_count >= capacity) {
                 capacity *= 2;
-                char **new_cols = realloc(constraint->constraint.foreign_key.columns,
+                char **new_cols = parser_realloc(parser, constraint->constraint.foreign_key.columns,
                                          sizeof(char*) * capacity);
                 if (!new_cols) {
                     return NULL;
@@ -457,7 +457,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
             }
 
             constraint->constraint.foreign_key.columns[constraint->constraint.foreign_key.column_count++] =
-                strdup(parser->current.lexeme);
+                parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } while (parser_match(parser, TOKEN_COMMA));
 
@@ -474,7 +474,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
             parser_error(parser, "Expected table name after REFERENCES");
             return NULL;
         }
-        constraint->constraint.foreign_key.reftable = strdup(parser->current.lexeme);
+        constraint->constraint.foreign_key.reftable = parser_strdup(parser, parser->current.lexeme);
         parser_advance(parser);
 
         /* Parse referenced column list */
@@ -482,7 +482,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
         constraint->constraint.foreign_key.refcolumn_count = 0;
 
         if (parser_match(parser, TOKEN_LPAREN)) {
-            constraint->constraint.foreign_key.refcolumns = malloc(sizeof(char*) * capacity);
+            constraint->constraint.foreign_key.refcolumns = parser_alloc(parser, sizeof(char*) * capacity);
 
             do {
                 if (!parser_check(parser, TOKEN_IDENTIFIER)) {
@@ -492,7 +492,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
 
                 if (constraint->constraint.foreign_key.refcolumn_count >= capacity) {
                     capacity *= 2;
-                    char **new_cols = realloc(constraint->constraint.foreign_key.refcolumns,
+                    char **new_cols = parser_realloc(parser, constraint->constraint.foreign_key.refcolumns,
                                              sizeof(char*) * capacity);
                     if (!new_cols) {
                         return NULL;
@@ -501,7 +501,7 @@ TableConstraint *parse_table_constraint(Parser *parser) {
                 }
 
                 constraint->constraint.foreign_key.refcolumns[constraint->constraint.foreign_key.refcolumn_count++] =
-                    strdup(parser->current.lexeme);
+                    parser_strdup(parser, parser->current.lexeme);
                 parser_advance(parser);
             } while (parser_match(parser, TOKEN_COMMA));
 
@@ -656,11 +656,7 @@ bool parse_constraint_attributes(Parser *parser, ColumnConstraint *constraint) {
 
 /* Parse expression (simplified - just grab tokens until we hit a delimiter) */
 Expression *parse_expression(Parser *parser) {
-    StringBuilder *sb = sb_create();
-    if (!sb) {
-        parser_error(parser, "Out of memory");
-        return NULL;
-    }
+    ParserText et = {NULL, 0, 0};
 
     int paren_depth = 0;
     bool first_token = true;
@@ -706,32 +702,37 @@ Expression *parse_expression(Parser *parser) {
             if (parser->current.type != TOKEN_LPAREN &&
                 parser->current.type != TOKEN_RPAREN &&
                 parser->previous.type != TOKEN_LPAREN) {
-                sb_append_char(sb, ' ');
+                if (!parser_text_append(parser, &et, " ", 1)) {
+                    parser_error(parser, "Out of memory");
+                    return NULL;
+                }
             }
         }
         first_token = false;
-        sb_append(sb, parser->current.lexeme);
+        if (!parser_text_append(parser, &et, parser->current.lexeme, strlen(parser->current.lexeme))) {
+            parser_error(parser, "Out of memory");
+            return NULL;
+        }
         parser_advance(parser);
     }
 
-    char *expr_str = sb_to_string(sb);
-    sb_free(sb);
-
-    if (!expr_str || strlen(expr_str) == 0) {
-        free(expr_str);
+    if (et.len == 0) {
         parser_error(parser, "Expected expression");
         return NULL;
     }
 
-    Expression *expr = expression_alloc(parser->memory_ctx, expr_str);
-    free(expr_str);
-
+    Expression *expr = parser_alloc(parser, sizeof(Expression));
+    if (!expr) {
+        parser_error(parser, "Out of memory");
+        return NULL;
+    }
+    expr->expression = et.text;
     return expr;
 }
 
 /* Parse sequence options for GENERATED IDENTITY constraints */
 SequenceOptions *parse_sequence_options(Parser *parser) {
-    SequenceOptions *opts = mem_calloc(parser->memory_ctx, 1, sizeof(SequenceOptions));
+    SequenceOptions *opts = parser_alloc(parser, sizeof(SequenceOptions));
     if (!opts) {
         parser_error(parser, "Out of memory");
         return NULL;
@@ -837,14 +838,14 @@ StorageParameterList *parse_with_options(Parser *parser) {
         return NULL;
     }
 
-    StorageParameterList *list = mem_calloc(parser->memory_ctx, 1, sizeof(StorageParameterList));
+    StorageParameterList *list = parser_alloc(parser, sizeof(StorageParameterList));
     if (!list) {
         parser_error(parser, "Out of memory");
         return NULL;
     }
 
     int capacity = 4;
-    list->parameters = mem_calloc(parser->memory_ctx, capacity, sizeof(StorageParameter));
+    list->parameters = parser_alloc(parser, capacity * sizeof(StorageParameter));
     if (!list->parameters) {
         parser_error(parser, "Out of memory");
         return NULL;
@@ -859,16 +860,16 @@ StorageParameterList *parse_with_options(Parser *parser) {
 
         if (list->count >= capacity) {
             capacity *= 2;
-            StorageParameter *new_params = mem_calloc(parser->memory_ctx, capacity, sizeof(StorageParameter));
+            StorageParameter *new_params = parser_realloc(parser, list->parameters,
+                                                          capacity * sizeof(StorageParameter));
             if (!new_params) {
                 parser_error(parser, "Out of memory");
                 return NULL;
             }
-            memcpy(new_params, list->parameters, sizeof(StorageParameter) * list->count);
             list->parameters = new_params;
         }
 
-        list->parameters[list->count].name = mem_strdup(parser->memory_ctx, parser->current.lexeme);
+        list->parameters[list->count].name = parser_strdup(parser, parser->current.lexeme);
         parser_advance(parser);
 
         if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after parameter name")) {
@@ -879,7 +880,7 @@ StorageParameterList *parse_with_options(Parser *parser) {
         if (parser_check(parser, TOKEN_IDENTIFIER) ||
             parser_check(parser, TOKEN_NUMBER) ||
             parser_check(parser, TOKEN_STRING_LITERAL)) {
-            list->parameters[list->count].value = mem_strdup(parser->memory_ctx, parser->current.lexeme);
+            list->parameters[list->count].value = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else {
             parser_error(parser, "Expected parameter value");
@@ -921,13 +922,13 @@ IndexParameters *parse_index_parameters(Parser *parser) {
             parser_error(parser, "Expected tablespace name after TABLESPACE");
             return NULL;
         }
-        tablespace = mem_strdup(parser->memory_ctx, parser->current.lexeme);
+        tablespace = parser_strdup(parser, parser->current.lexeme);
         parser_advance(parser);
     }
 
     /* Only allocate if we found at least one parameter we're storing */
     if (with_opts || tablespace) {
-        params = mem_calloc(parser->memory_ctx, 1, sizeof(IndexParameters));
+        params = parser_alloc(parser, sizeof(IndexParameters));
         if (!params) {
             parser_error(parser, "Out of memory");
             return NULL;
@@ -0,0 +1,352 @@
+#include "parser.h"
+#include "pg_create_index.h"
+#include "sc_memory.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+
+/* INDEX, CONCURRENTLY and ONLY are not lexer keywords, so that columns may
+ * still be called "index" or "only"; match them as identifiers */
+static bool match_word(Parser *parser, const char *word) {
+    if (!parser_check(parser, TOKEN_IDENTIFIER) || strcasecmp(parser->current.lexeme, word) != 0) {
+        return false;
+    }
+    parser_advance(parser);
+    return true;
+}
+
+/* Parse a possibly schema-qualified name */
+static char *parse_qualified_name(Parser *parser, const char *what) {
+    if (!parser_check(parser, TOKEN_IDENTIFIER)) {
+        parser_error(parser, "Expected %s", what);
+        return NULL;
+    }
+    ParserText name = {NULL, 0, 0};
+    if (!parser_text_append(parser, &name, parser->current.lexeme, strlen(parser->current.lexeme))) {
+        parser_error(parser, "Out of memory");
+        return NULL;
+    }
+    parser_advance(parser);
+
+    if (parser_match(parser, TOKEN_DOT)) {
+        if (!parser_check(parser, TOKEN_IDENTIFIER)) {
+            parser_error(parser, "Expected %s after '.'", what);
+            return NULL;
+        }
+        if (!parser_text_append(parser, &name, ".", 1) ||
+            !parser_text_append(parser, &name, parser->current.lexeme, strlen(parser->current.lexeme))) {
+            parser_error(parser, "Out of memory");
+            return NULL;
+        }
+        parser_advance(parser);
+    }
+    return name.text;
+}
+
+/* Collect raw tokens up to a ')' closing the current level (inside_parens)
+ * or to the end of the statement, with the spacing parse_expression uses */
+static char *collect_tokens(Parser *parser, bool inside_parens) {
+    ParserText text = {NULL, 0, 0};
+    int depth = 0;
+    bool first = true;
+    while (!parser_check(parser, TOKEN_EOF)) {
+        if (depth == 0 && (parser_check(parser, TOKEN_SEMICOLON) ||
+                           (inside_parens && parser_check(parser, TOKEN_RPAREN)))) {
+            break;
+        }
+        if (parser_check(parser, TOKEN_LPAREN)) {
+            depth++;
+        } else if (parser_check(parser, TOKEN_RPAREN) && depth > 0) {
+            depth--;
+        }
+
+        if (!first && parser->current.type != TOKEN_LPAREN &&
+            parser->current.type != TOKEN_RPAREN && parser->previous.type != TOKEN_LPAREN) {
+            if (!parser_text_append(parser, &text, " ", 1)) {
+                parser_error(parser, "Out of memory");
+                return NULL;
+            }
+        }
+        first = false;
+        if (!parser_text_append(parser, &text, parser->current.lexeme, strlen(parser->current.lexeme))) {
+            parser_error(parser, "Out of memory");
+            return NULL;
+        }
+        parser_advance(parser);
+    }
+
+    if (text.len == 0) {
+        parser_error(parser, "Expected expression");
+        return NULL;
+    }
+    return text.text;
+}
+
+/* Parse one key: column or (expression), then COLLATE, opclass, ASC/DESC
+ * and NULLS FIRST/LAST */
+static bool parse_index_element(Parser *parser, IndexElement *elem) {
+    memset(elem, 0, sizeof(IndexElement));
+    elem->sort_order = SORT_ASC;
+
+    if (parser_match(parser, TOKEN_LPAREN)) {
+        elem->expression = collect_tokens(parser, true);
+        if (!elem->expression || !parser_expect(parser, TOKEN_RPAREN, "Expected ')' after index expression")) {
+            return false;
+        }
+    } else if (parser_check(parser, TOKEN_IDENTIFIER)) {
+        elem->column_name = parser_strdup(parser, parser->current.lexeme);
+        parser_advance(parser);
+        /* Function-call keys such as lower(email) need no extra parentheses */
+        if (parser_check(parser, TOKEN_LPAREN)) {
+            char *args = NULL;
+            parser_advance(parser);
+            if (!parser_check(parser, TOKEN_RPAREN)) {
+                args = collect_tokens(parser, true);
+                if (!args) {
+                    return false;
+                }
+            }
+            if (!parser_expect(parser, TOKEN_RPAREN, "Expected ')' after function arguments")) {
+                return false;
+            }
+            size_t len = strlen(elem->column_name) + (args ? strlen(args) : 0) + 3;
+            elem->expression = parser_alloc(parser, len);
+            if (elem->expression) {
+                snprintf(elem->expression, len, "%s(%s)", elem->column_name, args ? args : "");
+            }
+            parser_free(parser, args);
+            parser_free(parser, elem->column_name);
+            elem->column_name = NULL;
+        }
+    } else {
+        parser_error(parser, "Expected column name or expression in index");
+        return false;
+    }
+
+    if (parser_match(parser, TOKEN_COLLATE)) {
+        if (!parser_check(parser, TOKEN_IDENTIFIER)) {
+            parser_error(parser, "Expected collation name after COLLATE");
+            return false;
+        }
+        elem->collation = parser_strdup(parser, parser->current.lexeme);
+        parser_advance(parser);
+    }
+
+    /* Any other identifier here is an operator class */
+    if (parser_check(parser, TOKEN_IDENTIFIER)) {
+        elem->opclass = parse_qualified_name(parser, "operator class");
+        if (!elem->opclass) {
+            return false;
+        }
+    }
+
+    if (parser_match(parser, TOKEN_DESC)) {
+        elem->sort_order = SORT_DESC;
+    } else {
+        parser_match(parser, TOKEN_ASC);
+    }
+
+    if (parser_match(parser, TOKEN_NULLS)) {
+        if (parser_match(parser, TOKEN_FIRST)) {
+            elem->nulls_order = NULLS_FIRST;
+        } else if (parser_match(parser, TOKEN_LAST)) {
+            elem->nulls_order = NULLS_LAST;
+        } else {
+            parser_error(parser, "Expected FIRST or LAST after NULLS");
+            return false;
+        }
+        elem->has_nulls_order = true;
+    }
+    return true;
+}
+
+/* Parse INCLUDE (column, ...) */
+static bool parse_include_columns(Parser *parser, CreateIndexStmt *stmt) {
+    if (!parser_expect(parser, TOKEN_LPAREN, "Expected '(' after INCLUDE")) {
+        return false;
+    }
+    do {
+        if (!parser_check(parser, TOKEN_IDENTIFIER)) {
+            parser_error(parser, "Expected column name in INCLUDE");
+            return false;
+        }
+        char **columns = parser_realloc(parser, stmt->include_columns, sizeof(char *) * (stmt->include_count + 1));
+        if (!columns) {
+            parser_error(parser, "Out of memory");
+            return false;
+        }
+        stmt->include_columns = columns;
+        stmt->include_columns[stmt->include_count++] = parser_strdup(parser, parser->current.lexeme);
+        parser_advance(parser);
+    } while (parser_match(parser, TOKEN_COMMA));
+
+    return parser_expect(parser, TOKEN_RPAREN, "Expected ')' after INCLUDE columns");
+}
+
+/* Parse WITH (name = value, ...) */
+static bool parse_index_with(Parser *parser, CreateIndexStmt *stmt) {
+    if (!parser_expect(parser, TOKEN_LPAREN, "Expected '(' after WITH")) {
+        return false;
+    }
+    StorageParameterList *list = parser_alloc(parser, sizeof(StorageParameterList));
+    if (!list) {
+        parser_error(parser, "Out of memory");
+        return false;
+    }
+    stmt->with_options = list;
+
+    do {
+        if (!parser_check(parser, TOKEN_IDENTIFIER)) {
+            parser_error(parser, "Expected storage parameter name");
+            return false;
+        }
+        StorageParameter *params = parser_realloc(parser, list->parameters, sizeof(StorageParameter) * (list->count + 1));
+        if (!params) {
+            parser_error(parser, "Out of memory");
+            return false;
+        }
+        list->parameters = params;
+        StorageParameter *param = &list->parameters[list->count++];
+        param->name = parser_strdup(parser, parser->current.lexeme);
+        param->value = NULL;
+        parser_advance(parser);
+
+        if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after parameter name")) {
+            return false;
+        }
+        if (!parser_check(parser, TOKEN_IDENTIFIER) &&
+            !parser_check(parser, TOKEN_NUMBER) &&
+            !parser_check(parser, TOKEN_STRING_LITERAL)) {
+            parser_error(parser, "Expected parameter value");
+            return false;
+        }
+        param->value = parser_strdup(parser, parser->current.lexeme);
+        parser_advance(parser);
+    } while (parser_match(parser, TOKEN_COMMA));
+
+    return parser_expect(parser, TOKEN_RPAREN, "Expected ')' after WITH options");
+}
+
+/* Parse the clauses after the key list */
+static bool parse_index_tail(Parser *parser, CreateIndexStmt *stmt) {
+    if (parser_match(parser, TOKEN_INCLUDE) && !parse_include_columns(parser, stmt)) {
+        return false;
+    }
+
+    if (parser_match(parser, TOKEN_NULLS)) {
+        stmt->nulls_not_distinct = parser_match(parser, TOKEN_NOT);
+        if (!parser_expect(parser, TOKEN_DISTINCT, "Expected DISTINCT after NULLS")) {
+            return false;
+        }
+    }
+
+    if (parser_match(parser, TOKEN_WITH) && !parse_index_with(parser, stmt)) {
+        return false;
+    }
+
+    if (parser_match(parser, TOKEN_TABLESPACE)) {
+        if (!parser_check(parser, TOKEN_IDENTIFIER)) {
+            parser_error(parser, "Expected tablespace name after TABLESPACE");
+            return false;
+        }
+        stmt->tablespace_name = parser_strdup(parser, parser->current.lexeme);
+        parser_advance(parser);
+    }
+
+    if (parser_match(parser, TOKEN_WHERE)) {
+        stmt->where_clause = collect_tokens(parser, false);
+        if (!stmt->where_clause) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Parse CREATE [UNIQUE] INDEX statement */
+static CreateIndexStmt *parse_create_index_stmt(Parser *parser) {
+    if (!parser_expect(parser, TOKEN_CREATE, "Expected CREATE")) {
+        return NULL;
+    }
+
+    CreateIndexStmt *stmt = parser_alloc(parser, sizeof(CreateIndexStmt));
+    if (!stmt) {
+        parser_error(parser, "Out of memory");
+        return NULL;
+    }
+
+    stmt->unique = parser_match(parser, TOKEN_UNIQUE);
+    if (!match_word(parser, "index")) {
+        parser_error(parser, "Expected INDEX");
+        return NULL;
+    }
+    stmt->concurrently = match_word(parser, "concurrently");
+
+    if (parser_match(parser, TOKEN_IF)) {
+        if (!parser_expect(parser, TOKEN_NOT, "Expected NOT after IF") ||
+            !parser_expect(parser, TOKEN_EXISTS, "Expected EXISTS after IF NOT")) {
+            return NULL;
+        }
+        stmt->if_not_exists = true;
+    }
+
+    /* The name is optional: CREATE INDEX ON t (...) */
+    if (!parser_check(parser, TOKEN_ON)) {
+        stmt->index_name = parse_qualified_name(parser, "index name");
+        if (!stmt->index_name) {
+            return NULL;
+        }
+    }
+
+    if (!parser_expect(parser, TOKEN_ON, "Expected ON after index name")) {
+        return NULL;
+    }
+    stmt->only = match_word(parser, "only");
+    stmt->table_name = parse_qualified_name(parser, "table name");
+    if (!stmt->table_name) {
+        return NULL;
+    }
+
+    if (parser_match(parser, TOKEN_USING)) {
+        if (!parser_check(parser, TOKEN_IDENTIFIER) && !parser_check(parser, TOKEN_HASH)) {
+            parser_error(parser, "Expected index method after USING");
+            return NULL;
+        }
+        stmt->access_method = parser_strdup(parser, parser->current.lexeme);
+        parser_advance(parser);
+    }
+
+    if (!parser_expect(parser, TOKEN_LPAREN, "Expected '(' before index columns")) {
+        return NULL;
+    }
+    do {
+        IndexElement *elements = parser_realloc(parser, stmt->elements, sizeof(IndexElement) * (stmt->element_count + 1));
+        if (!elements) {
+            parser_error(parser, "Out of memory");
+            return NULL;
+        }
+        stmt->elements = elements;
+        if (!parse_index_element(parser, &stmt->elements[stmt->element_count++])) {
+            return NULL;
+        }
+    } while (parser_match(parser, TOKEN_COMMA));
+
+    if (!parser_expect(parser, TOKEN_RPAREN, "Expected ')' after index columns") ||
+        !parse_index_tail(parser, stmt)) {
+        return NULL;
+    }
+    return stmt;
+}
+
+/* Parse CREATE [UNIQUE] INDEX statement; the caller owns the result */
+CreateIndexStmt *parser_parse_create_index(Parser *parser) {
+    size_t mark = parser_mark(parser);
+    CreateIndexStmt *stmt = parse_create_index_stmt(parser);
+    if (stmt) {
+        parser_keep(parser, mark);
+    } else {
+        parser_discard(parser, mark);
+    }
+    return stmt;
+}
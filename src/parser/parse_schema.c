@@ -1,6 +1,26 @@
 #include "parser.h"
 #include "pg_schema.h"
 #include <string.h>
+#include <strings.h>
+
+/* Look at the token after the current one without consuming anything.
+ * When 'word' is given, *is_word reports whether that token is the
+ * identifier 'word' (for non-keywords such as INDEX). */
+static TokenType parser_peek_next(Parser *parser, const char *word, bool *is_word) {
+    Lexer saved = parser->lexer;
+    parser->lexer.error_message = NULL;
+
+    Token next = lexer_next_token(&parser->lexer);
+    TokenType type = next.type;
+    if (word) {
+        *is_word = type == TOKEN_IDENTIFIER && next.lexeme && strcasecmp(next.lexeme, word) == 0;
+    }
+    lexer_free_token(&next);
+    lexer_cleanup(&parser->lexer);
+
+    parser->lexer = saved;
+    return type;
+}
 
 /* Parse a single CREATE statement and add it to the schema */
 void parser_parse_statement(Parser *parser, Schema *schema) {
@@ -13,19 +33,17 @@ void parser_parse_statement(Parser *parser, Schema *schema) {
         return;
     }
 
-    parser_advance(parser); // Consume CREATE
-
-    /* Peek at next token to determine statement type */
-    if (parser_check(parser, TOKEN_TABLE) ||
-        parser_check(parser, TOKEN_TEMPORARY) ||
-        parser_check(parser, TOKEN_TEMP) ||
-        parser_check(parser, TOKEN_UNLOGGED) ||
-        parser_check(parser, TOKEN_GLOBAL) ||
-        parser_check(parser, TOKEN_LOCAL)) {
+    /* Peek past CREATE to determine statement type; the statement parsers
+     * consume CREATE themselves */
+    bool is_index = false;
+    TokenType next = parser_peek_next(parser, "index", &is_index);
 
-        /* Back up to before CREATE (table parser expects to see CREATE) */
-        parser->current = parser->previous;
-        parser->previous.type = TOKEN_ERROR; // Mark as invalid
+    if (next == TOKEN_TABLE ||
+        next == TOKEN_TEMPORARY ||
+        next == TOKEN_TEMP ||
+        next == TOKEN_UNLOGGED ||
+        next == TOKEN_GLOBAL ||
+        next == TOKEN_LOCAL) {
 
         CreateTableStmt *table = parser_parse_create_table(parser);
         if (!table) {
@@ -44,11 +62,7 @@ void parser_parse_statement(Parser *parser, Schema *schema) {
         return;
     }
 
-    if (parser_check(parser, TOKEN_TYPE)) {
-        /* Back up to before CREATE */
-        parser->current = parser->previous;
-        parser->previous.type = TOKEN_ERROR;
-
+    if (next == TOKEN_TYPE) {
         CreateTypeStmt *type = parser_parse_create_type(parser);
         if (!type) {
             return;
@@ -66,8 +80,28 @@ void parser_parse_statement(Parser *parser, Schema *schema) {
         return;
     }
 
-    /* Future: TOKEN_INDEX, TOKEN_FUNCTION, etc. */
+    if (is_index || next == TOKEN_UNIQUE) {
+        CreateIndexStmt *index = parser_parse_create_index(parser);
+        if (!index) {
+            return;
+        }
+
+        /* Resize indexes array if needed */
+        CreateIndexStmt **new_indexes = mem_realloc(parser->memory_ctx, schema->indexes,
+                                                    (schema->index_count + 1) * sizeof(CreateIndexStmt *));
+        if (!new_indexes) {
+            free_create_index_stmt(index);
+            parser_error(parser, "Out of memory");
+            return;
+        }
+        schema->indexes = new_indexes;
+        schema->indexes[schema->index_count++] = index;
+        return;
+    }
+
+    /* Future: TOKEN_FUNCTION, etc. */
 
+    parser_advance(parser); // Consume CREATE so error recovery makes progress
     parser_error(parser, "Unknown CREATE statement type");
 }
 
@@ -88,10 +122,14 @@ Schema *parse_all_statements(Parser *parser) {
     schema->type_count = 0;
     schema->tables = NULL;
     schema->table_count = 0;
+    schema->indexes = NULL;
+    schema->index_count = 0;
     schema->functions = NULL;
     schema->function_count = 0;
     schema->procedures = NULL;
     schema->procedure_count = 0;
+    schema->files = NULL;
+    schema->file_count = 0;
 
     /* Parse statements until EOF */
     while (!parser_check(parser, TOKEN_EOF)) {
@@ -114,8 +152,10 @@ Schema *parse_all_statements(Parser *parser) {
             parser->panic_mode = false;
         }
 
-        /* Expect semicolon after statement (but don't error on EOF) */
-        if (!parser_check(parser, TOKEN_EOF) && !parser_check(parser, TOKEN_SEMICOLON)) {
+        /* Expect semicolon after statement (but don't error on EOF). Some
+         * statement parsers consume the terminating semicolon themselves. */
+        if (!parser_check(parser, TOKEN_EOF) && !parser_check(parser, TOKEN_SEMICOLON) &&
+            parser->previous.type != TOKEN_SEMICOLON) {
             parser_error(parser, "Expected semicolon after statement");
             parser_synchronize(parser);
         }
@@ -9,14 +9,17 @@ TableElement *parse_table_element_list(Parser *parser) {
         return NULL;
     }
 
+    size_t mark = parser_mark(parser);
     TableElement *head = NULL;
     TableElement *tail = NULL;
 
     while (!parser_check(parser, TOKEN_RPAREN) && !parser_check(parser, TOKEN_EOF)) {
         TableElement *elem = parse_table_element(parser);
         if (!elem) {
+            /* Synchronizing stops at the next statement, so the list is over */
             parser_synchronize(parser);
-            continue;
+            parser_discard(parser, mark);
+            return NULL;
         }
 
         if (!head) {
@@ -33,6 +36,7 @@ TableElement *parse_table_element_list(Parser *parser) {
     }
 
     if (!parser_expect(parser, TOKEN_RPAREN, "Expected ')' after table elements")) {
+        parser_discard(parser, mark);
         return NULL;
     }
 
@@ -41,7 +45,7 @@ TableElement *parse_table_element_list(Parser *parser) {
 
 /* Parse single table element */
 TableElement *parse_table_element(Parser *parser) {
-    TableElement *elem = table_element_alloc(parser->memory_ctx);
+    TableElement *elem = parser_alloc(parser, sizeof(TableElement));
     if (!elem) {
         parser_error(parser, "Out of memory");
         return NULL;
@@ -55,7 +59,7 @@ TableElement *parse_table_element(Parser *parser) {
             return NULL;
         }
         elem->elem.like = *like;
-        free(like); /* Free the temporary struct (contents were copied) */
+        parser_free(parser, like); /* Free the temporary struct (contents were copied) */
         return elem;
     }
 
@@ -82,13 +86,13 @@ TableElement *parse_table_element(Parser *parser) {
         return NULL;
     }
     elem->elem.column = *col;
-    free(col); /* Free the temporary struct (contents were copied) */
+    parser_free(parser, col); /* Free the temporary struct (contents were copied) */
     return elem;
 }
 
 /* Parse LIKE clause */
 LikeClause *parse_like_clause(Parser *parser) {
-    LikeClause *like = malloc(sizeof(LikeClause));
+    LikeClause *like = parser_alloc(parser, sizeof(LikeClause));
     if (!like) {
         parser_error(parser, "Out of memory");
         return NULL;
@@ -97,11 +101,10 @@ LikeClause *parse_like_clause(Parser *parser) {
     /* Parse source table name */
     if (!parser_check(parser, TOKEN_IDENTIFIER)) {
         parser_error(parser, "Expected table name after LIKE");
-        free(like);
         return NULL;
     }
 
-    like->source_table = strdup(parser->current.lexeme);
+    like->source_table = parser_strdup(parser, parser->current.lexeme);
     parser_advance(parser);
 
     /* Parse like options (INCLUDING/EXCLUDING) */
@@ -109,7 +112,7 @@ LikeClause *parse_like_clause(Parser *parser) {
     like->option_count = 0;
 
     int capacity = 4;
-    LikeOption *options = malloc(sizeof(LikeOption) * capacity);
+    LikeOption *options = parser_alloc(parser, sizeof(LikeOption) * capacity);
     if (!options) {
         parser_error(parser, "Out of memory");
         return NULL;
@@ -148,12 +151,9 @@ LikeClause *parse_like_clause(Parser *parser) {
         /* Expand array if needed */
         if (like->option_count >= capacity) {
             capacity *= 2;
-            LikeOption *new_options = realloc(options, sizeof(LikeOption) * capacity);
+            LikeOption *new_options = parser_realloc(parser, options, sizeof(LikeOption) * capacity);
             if (!new_options) {
                 parser_error(parser, "Out of memory");
-                free(options);
-                free(like->source_table);
-                free(like);
                 return NULL;
             }
             options = new_options;
@@ -169,7 +169,7 @@ LikeClause *parse_like_clause(Parser *parser) {
 }
 
 /* Parse CREATE TABLE statement */
-CreateTableStmt *parser_parse_create_table(Parser *parser) {
+static CreateTableStmt *parse_create_table_stmt(Parser *parser) {
     if (!parser_expect(parser, TOKEN_CREATE, "Expected CREATE")) {
         return NULL;
     }
@@ -214,11 +214,11 @@ CreateTableStmt *parser_parse_create_table(Parser *parser) {
         return NULL;
     }
 
-    char *table_name = strdup(parser->current.lexeme);
+    char *table_name = parser_strdup(parser, parser->current.lexeme);
     parser_advance(parser);
 
     /* Create statement */
-    CreateTableStmt *stmt = create_table_stmt_alloc(parser->memory_ctx);
+    CreateTableStmt *stmt = parser_alloc(parser, sizeof(CreateTableStmt));
     if (!stmt) {
         return NULL;
     }
@@ -262,7 +262,7 @@ CreateTableStmt *parser_parse_create_table(Parser *parser) {
 
             /* Count inherited tables */
             int capacity = 4;
-            char **inherits = malloc(sizeof(char *) * capacity);
+            char **inherits = parser_alloc(parser, sizeof(char *) * capacity);
             int count = 0;
 
             do {
@@ -273,17 +273,15 @@ CreateTableStmt *parser_parse_create_table(Parser *parser) {
 
                 if (count >= capacity) {
                     capacity *= 2;
-                    char **new_inherits = malloc(sizeof(char *) * capacity);
+                    char **new_inherits = parser_realloc(parser, inherits, sizeof(char *) * capacity);
                     if (!new_inherits) {
                         parser_error(parser, "Out of memory");
                         return NULL;
                     }
-                    memcpy(new_inherits, inherits, sizeof(char *) * count);
-                    free(inherits);
                     inherits = new_inherits;
                 }
 
-                inherits[count++] = strdup(parser->current.lexeme);
+                inherits[count++] = parser_strdup(parser, parser->current.lexeme);
                 parser_advance(parser);
             } while (parser_match(parser, TOKEN_COMMA));
 
@@ -304,7 +302,7 @@ CreateTableStmt *parser_parse_create_table(Parser *parser) {
                 parser_error(parser, "Expected access method name after USING");
                 return NULL;
             }
-            stmt->using_method = strdup(parser->current.lexeme);
+            stmt->using_method = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else {
             stmt->using_method = NULL;
@@ -325,14 +323,14 @@ CreateTableStmt *parser_parse_create_table(Parser *parser) {
                     return NULL;
                 }
 
-                StorageParameterList *list = calloc(1, sizeof(StorageParameterList));
+                StorageParameterList *list = parser_alloc(parser, sizeof(StorageParameterList));
                 if (!list) {
                     parser_error(parser, "Out of memory");
                     return NULL;
                 }
 
                 int capacity = 4;
-                list->parameters = calloc(capacity, sizeof(StorageParameter));
+                list->parameters = parser_alloc(parser, capacity * sizeof(StorageParameter));
                 if (!list->parameters) {
                     parser_error(parser, "Out of memory");
                     return NULL;
@@ -347,17 +345,16 @@ CreateTableStmt *parser_parse_create_table(Parser *parser) {
 
                     if (list->count >= capacity) {
                         capacity *= 2;
-                        StorageParameter *new_params = calloc(capacity, sizeof(StorageParameter));
+                        StorageParameter *new_params = parser_realloc(parser, list->parameters,
+                                                                      capacity * sizeof(StorageParameter));
                         if (!new_params) {
                             parser_error(parser, "Out of memory");
                             return NULL;
                         }
-                        memcpy(new_params, list->parameters, sizeof(StorageParameter) * list->count);
-                        free(list->parameters);
                         list->parameters = new_params;
                     }
 
-                    list->parameters[list->count].name = strdup(parser->current.lexeme);
+                    list->parameters[list->count].name = parser_strdup(parser, parser->current.lexeme);
                     parser_advance(parser);
 
                     if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after parameter name")) {
@@ -368,7 +365,7 @@ CreateTableStmt *parser_parse_create_table(Parser *parser) {
                     if (parser_check(parser, TOKEN_IDENTIFIER) ||
                         parser_check(parser, TOKEN_NUMBER) ||
                         parser_check(parser, TOKEN_STRING_LITERAL)) {
-                        list->parameters[list->count].value = strdup(parser->current.lexeme);
+                        list->parameters[list->count].value = parser_strdup(parser, parser->current.lexeme);
                         parser_advance(parser);
                     } else {
                         parser_error(parser, "Expected parameter value");
@@ -428,7 +425,7 @@ CreateTableStmt *parser_parse_create_table(Parser *parser) {
                 parser_error(parser, "Expected tablespace name after TABLESPACE");
                 return NULL;
             }
-            stmt->tablespace_name = strdup(parser->current.lexeme);
+            stmt->tablespace_name = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else {
             stmt->tablespace_name = NULL;
@@ -441,3 +438,15 @@ CreateTableStmt *parser_parse_create_table(Parser *parser) {
     return stmt;
 }
 
+
+/* Parse CREATE TABLE statement; the caller owns the result */
+CreateTableStmt *parser_parse_create_table(Parser *parser) {
+    size_t mark = parser_mark(parser);
+    CreateTableStmt *stmt = parse_create_table_stmt(parser);
+    if (stmt) {
+        parser_keep(parser, mark);
+    } else {
+        parser_discard(parser, mark);
+    }
+    return stmt;
+}
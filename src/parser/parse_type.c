@@ -12,36 +12,22 @@ static RangeTypeDef *parse_range_type_def(Parser *parser);
 static BaseTypeDef *parse_base_type_def(Parser *parser);
 
 /* Helper: Strip surrounding quotes from string literal */
-static char *strip_quotes(const char *str) {
+static char *strip_quotes(Parser *parser, const char *str) {
     if (!str) return NULL;
 
     size_t len = strlen(str);
-    if (len < 2) return strdup(str);
 
-    /* Check if surrounded by single quotes */
-    if (str[0] == '\'' && str[len - 1] == '\'') {
-        char *result = malloc(len - 1);
-        if (!result) return NULL;
-        memcpy(result, str + 1, len - 2);
-        result[len - 2] = '\0';
-        return result;
-    }
-
-    /* Check if surrounded by double quotes */
-    if (str[0] == '"' && str[len - 1] == '"') {
-        char *result = malloc(len - 1);
-        if (!result) return NULL;
-        memcpy(result, str + 1, len - 2);
-        result[len - 2] = '\0';
-        return result;
+    /* Surrounded by single or double quotes */
+    if (len >= 2 && (str[0] == '\'' || str[0] == '"') && str[len - 1] == str[0]) {
+        return parser_strndup(parser, str + 1, len - 2);
     }
 
     /* No quotes to strip */
-    return strdup(str);
+    return parser_strdup(parser, str);
 }
 
 /* Parse CREATE TYPE statement */
-CreateTypeStmt *parser_parse_create_type(Parser *parser) {
+static CreateTypeStmt *parse_create_type_stmt(Parser *parser) {
     if (!parser_expect(parser, TOKEN_CREATE, "Expected CREATE")) {
         return NULL;
     }
@@ -50,7 +36,7 @@ CreateTypeStmt *parser_parse_create_type(Parser *parser) {
         return NULL;
     }
 
-    CreateTypeStmt *stmt = malloc(sizeof(CreateTypeStmt));
+    CreateTypeStmt *stmt = parser_alloc(parser, sizeof(CreateTypeStmt));
     if (!stmt) {
         parser_error(parser, "Out of memory");
         return NULL;
@@ -76,7 +62,7 @@ CreateTypeStmt *parser_parse_create_type(Parser *parser) {
         parser_error(parser, "Expected type name");
         return NULL;
     }
-    stmt->type_name = strdup(parser->current.lexeme);
+    stmt->type_name = parser_strdup(parser, parser->current.lexeme);
     parser_advance(parser);
 
     /* Check for schema-qualified name */
@@ -90,8 +76,13 @@ CreateTypeStmt *parser_parse_create_type(Parser *parser) {
         char *schema = stmt->type_name;
         char *type_name = parser->current.lexeme;
         size_t len = strlen(schema) + strlen(type_name) + 2;
-        stmt->type_name = malloc(len);
+        stmt->type_name = parser_alloc(parser, len);
+        if (!stmt->type_name) {
+            parser_error(parser, "Out of memory");
+            return NULL;
+        }
         snprintf(stmt->type_name, len, "%s.%s", schema, type_name);
+        parser_free(parser, schema);
         parser_advance(parser);
     }
 
@@ -106,7 +97,7 @@ CreateTypeStmt *parser_parse_create_type(Parser *parser) {
                 return NULL;
             }
             stmt->type_def.enum_def = *enum_def;
-            free(enum_def);
+            parser_free(parser, enum_def);
         } else if (parser_match(parser, TOKEN_RANGE)) {
             /* RANGE type */
             stmt->variant = TYPE_VARIANT_RANGE;
@@ -115,7 +106,7 @@ CreateTypeStmt *parser_parse_create_type(Parser *parser) {
                 return NULL;
             }
             stmt->type_def.range_def = *range_def;
-            free(range_def);
+            parser_free(parser, range_def);
         } else if (parser_check(parser, TOKEN_LPAREN)) {
             /* COMPOSITE type */
             stmt->variant = TYPE_VARIANT_COMPOSITE;
@@ -124,7 +115,7 @@ CreateTypeStmt *parser_parse_create_type(Parser *parser) {
                 return NULL;
             }
             stmt->type_def.composite_def = *comp_def;
-            free(comp_def);
+            parser_free(parser, comp_def);
         } else {
             parser_error(parser, "Expected ENUM, RANGE, or '(' after AS");
             return NULL;
@@ -137,7 +128,7 @@ CreateTypeStmt *parser_parse_create_type(Parser *parser) {
             return NULL;
         }
         stmt->type_def.base_def = *base_def;
-        free(base_def);
+        parser_free(parser, base_def);
     } else {
         parser_error(parser, "Expected AS or '(' after type name");
         return NULL;
@@ -146,51 +137,82 @@ CreateTypeStmt *parser_parse_create_type(Parser *parser) {
     return stmt;
 }
 
-/* Parse ENUM type definition: ('label1', 'label2', ...) */
+/* Parse CREATE TYPE statement; the caller owns the result */
+CreateTypeStmt *parser_parse_create_type(Parser *parser) {
+    size_t mark = parser_mark(parser);
+    CreateTypeStmt *stmt = parse_create_type_stmt(parser);
+    if (stmt) {
+        parser_keep(parser, mark);
+    } else {
+        parser_discard(parser, mark);
+    }
+    return stmt;
+}
+
+/* Text of a string literal token without its quotes */
+static void literal_text(const char *lexeme, const char **text, size_t *len) {
+    size_t n = strlen(lexeme);
+    if (n >= 2 && (lexeme[0] == '\'' || lexeme[0] == '"') && lexeme[n - 1] == lexeme[0]) {
+        *text = lexeme + 1;
+        *len = n - 2;
+    } else {
+        *text = lexeme;
+        *len = n;
+    }
+}
+
+/* Parse ENUM type definition: ('label1', 'label2', ...). Labels are gathered
+ * into one scratch buffer, then copied into the type's block. */
 static EnumTypeDef *parse_enum_type_def(Parser *parser) {
-    EnumTypeDef *enum_def = malloc(sizeof(EnumTypeDef));
+    EnumTypeDef *enum_def = parser_alloc(parser, sizeof(EnumTypeDef));
     if (!enum_def) {
         parser_error(parser, "Out of memory");
         return NULL;
     }
 
-    enum_def->labels = NULL;
-    enum_def->label_count = 0;
-
     if (!parser_expect(parser, TOKEN_LPAREN, "Expected '(' after ENUM")) {
-        free(enum_def);
         return NULL;
     }
 
-    /* Count labels first */
+    /* NUL-separated label text, and where each label starts */
+    size_t text_capacity = 256;
+    size_t text_used = 0;
+    char *text = parser_alloc(parser, text_capacity);
     int capacity = 8;
-    char **labels = malloc(capacity * sizeof(char *));
-    if (!labels) {
+    int count = 0;
+    size_t *offsets = parser_alloc(parser, capacity * sizeof(size_t));
+    if (!text || !offsets) {
         parser_error(parser, "Out of memory");
-        free(enum_def);
         return NULL;
     }
 
     while (!parser_check(parser, TOKEN_RPAREN) && !parser_check(parser, TOKEN_EOF)) {
         if (!parser_check(parser, TOKEN_STRING_LITERAL)) {
             parser_error(parser, "Expected string literal for enum label");
-            free(enum_def);
             return NULL;
         }
 
-        /* Resize if needed */
-        if (enum_def->label_count >= capacity) {
+        const char *label;
+        size_t len;
+        literal_text(parser->current.lexeme, &label, &len);
+        if (count == capacity) {
             capacity *= 2;
-            labels = realloc(labels, capacity * sizeof(char *));
-            if (!labels) {
-                parser_error(parser, "Out of memory");
-                free(enum_def);
-                return NULL;
+            offsets = parser_realloc(parser, offsets, capacity * sizeof(size_t));
+        }
+        if (text_used + len + 1 > text_capacity) {
+            while (text_used + len + 1 > text_capacity) {
+                text_capacity *= 2;
             }
+            text = parser_realloc(parser, text, text_capacity);
         }
-
-        /* Strip quotes from the string literal */
-        labels[enum_def->label_count++] = strip_quotes(parser->current.lexeme);
+        if (!offsets || !text) {
+            parser_error(parser, "Out of memory");
+            return NULL;
+        }
+        offsets[count++] = text_used;
+        memcpy(text + text_used, label, len);
+        text[text_used + len] = '\0';
+        text_used += len + 1;
         parser_advance(parser);
 
         if (!parser_match(parser, TOKEN_COMMA)) {
@@ -199,56 +221,81 @@ static EnumTypeDef *parse_enum_type_def(Parser *parser) {
     }
 
     if (!parser_expect(parser, TOKEN_RPAREN, "Expected ')' after enum labels")) {
-        free(enum_def);
         return NULL;
     }
 
-    enum_def->labels = labels;
+    const char **labels = parser_alloc(parser, (count + 1) * sizeof(char *));
+    if (!labels) {
+        parser_error(parser, "Out of memory");
+        return NULL;
+    }
+    for (int i = 0; i < count; i++) {
+        labels[i] = text + offsets[i];
+    }
+    bool ok = enum_type_def_init(enum_def, labels, count, parser->memory_ctx);
+    parser_free(parser, labels);
+    parser_free(parser, offsets);
+    parser_free(parser, text);
+    if (!ok) {
+        parser_error(parser, "Out of memory");
+        return NULL;
+    }
     return enum_def;
 }
 
+/* Free the scratch attributes of parse_composite_type_def */
+static void free_scratch_attributes(Parser *parser, CompositeAttribute *attrs, int count) {
+    for (int i = 0; i < count; i++) {
+        parser_free(parser, attrs[i].attr_name);
+        parser_free(parser, attrs[i].data_type);
+        parser_free(parser, attrs[i].collation);
+    }
+    parser_free(parser, attrs);
+}
+
 /* Parse COMPOSITE type definition: (attr1 type1 [COLLATE ...], attr2 type2, ...) */
 static CompositeTypeDef *parse_composite_type_def(Parser *parser) {
-    CompositeTypeDef *comp_def = malloc(sizeof(CompositeTypeDef));
+    CompositeTypeDef *comp_def = parser_alloc(parser, sizeof(CompositeTypeDef));
     if (!comp_def) {
         parser_error(parser, "Out of memory");
         return NULL;
     }
 
-    comp_def->attributes = NULL;
-    comp_def->attribute_count = 0;
-
     if (!parser_expect(parser, TOKEN_LPAREN, "Expected '(' for composite type")) {
-        free(comp_def);
         return NULL;
     }
 
-    CompositeAttribute *head = NULL;
-    CompositeAttribute *tail = NULL;
+    int capacity = 8;
+    int count = 0;
+    CompositeAttribute *attrs = parser_alloc(parser, capacity * sizeof(CompositeAttribute));
+    if (!attrs) {
+        parser_error(parser, "Out of memory");
+        return NULL;
+    }
 
     while (!parser_check(parser, TOKEN_RPAREN) && !parser_check(parser, TOKEN_EOF)) {
-        CompositeAttribute *attr = malloc(sizeof(CompositeAttribute));
-        if (!attr) {
-            parser_error(parser, "Out of memory");
-            free(comp_def);
-            return NULL;
+        if (count == capacity) {
+            capacity *= 2;
+            attrs = parser_realloc(parser, attrs, capacity * sizeof(CompositeAttribute));
+            if (!attrs) {
+                parser_error(parser, "Out of memory");
+                return NULL;
+            }
         }
-
+        CompositeAttribute *attr = &attrs[count++];
         memset(attr, 0, sizeof(CompositeAttribute));
 
         /* Parse attribute name */
         if (!parser_check(parser, TOKEN_IDENTIFIER)) {
             parser_error(parser, "Expected attribute name");
-            free(comp_def);
             return NULL;
         }
-        attr->attr_name = strdup(parser->current.lexeme);
+        attr->attr_name = parser_strdup(parser, parser->current.lexeme);
         parser_advance(parser);
 
         /* Parse data type */
         attr->data_type = parse_data_type(parser);
         if (!attr->data_type) {
-            free(comp_def);
             return NULL;
         }
 
@@ -256,40 +303,33 @@ static CompositeTypeDef *parse_composite_type_def(Parser *parser) {
         if (parser_match(parser, TOKEN_COLLATE)) {
             if (!parser_check(parser, TOKEN_IDENTIFIER) && !parser_check(parser, TOKEN_STRING_LITERAL)) {
                 parser_error(parser, "Expected collation name");
-                free(comp_def);
                 return NULL;
             }
-            attr->collation = strip_quotes(parser->current.lexeme);
+            attr->collation = strip_quotes(parser, parser->current.lexeme);
             parser_advance(parser);
         }
 
-        /* Add to list */
-        if (!head) {
-            head = attr;
-            tail = attr;
-        } else {
-            tail->next = attr;
-            tail = attr;
-        }
-        comp_def->attribute_count++;
-
         if (!parser_match(parser, TOKEN_COMMA)) {
             break;
         }
     }
 
     if (!parser_expect(parser, TOKEN_RPAREN, "Expected ')' after composite type attributes")) {
-        free(comp_def);
         return NULL;
     }
 
-    comp_def->attributes = head;
+    bool ok = composite_type_def_init(comp_def, attrs, count, parser->memory_ctx);
+    free_scratch_attributes(parser, attrs, count);
+    if (!ok) {
+        parser_error(parser, "Out of memory");
+        return NULL;
+    }
     return comp_def;
 }
 
 /* Parse RANGE type definition: (SUBTYPE = type, ...) */
 static RangeTypeDef *parse_range_type_def(Parser *parser) {
-    RangeTypeDef *range_def = malloc(sizeof(RangeTypeDef));
+    RangeTypeDef *range_def = parser_alloc(parser, sizeof(RangeTypeDef));
     if (!range_def) {
         parser_error(parser, "Out of memory");
         return NULL;
@@ -298,7 +338,6 @@ static RangeTypeDef *parse_range_type_def(Parser *parser) {
     memset(range_def, 0, sizeof(RangeTypeDef));
 
     if (!parser_expect(parser, TOKEN_LPAREN, "Expected '(' after RANGE")) {
-        free(range_def);
         return NULL;
     }
 
@@ -306,86 +345,73 @@ static RangeTypeDef *parse_range_type_def(Parser *parser) {
     while (!parser_check(parser, TOKEN_RPAREN) && !parser_check(parser, TOKEN_EOF)) {
         if (parser_match(parser, TOKEN_SUBTYPE)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after SUBTYPE")) {
-                free(range_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected subtype name");
-                free(range_def);
                 return NULL;
             }
-            range_def->subtype = strdup(parser->current.lexeme);
+            range_def->subtype = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_check(parser, TOKEN_IDENTIFIER) &&
                    strcmp(parser->current.lexeme, "subtype_opclass") == 0) {
             parser_advance(parser);
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after SUBTYPE_OPCLASS")) {
-                free(range_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected operator class name");
-                free(range_def);
                 return NULL;
             }
-            range_def->subtype_opclass = strdup(parser->current.lexeme);
+            range_def->subtype_opclass = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_COLLATE)) {
             /* Note: In RANGE context, COLLATE is actually "collation =" */
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after COLLATION")) {
-                free(range_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER) && !parser_check(parser, TOKEN_STRING_LITERAL)) {
                 parser_error(parser, "Expected collation name");
-                free(range_def);
                 return NULL;
             }
-            range_def->collation = strdup(parser->current.lexeme);
+            range_def->collation = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_CANONICAL)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after CANONICAL")) {
-                free(range_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected canonical function name");
-                free(range_def);
                 return NULL;
             }
-            range_def->canonical_function = strdup(parser->current.lexeme);
+            range_def->canonical_function = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_check(parser, TOKEN_IDENTIFIER) &&
                    strcmp(parser->current.lexeme, "subtype_diff") == 0) {
             parser_advance(parser);
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after SUBTYPE_DIFF")) {
-                free(range_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected subtype diff function name");
-                free(range_def);
                 return NULL;
             }
-            range_def->subtype_diff_function = strdup(parser->current.lexeme);
+            range_def->subtype_diff_function = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_check(parser, TOKEN_IDENTIFIER) &&
                    strcmp(parser->current.lexeme, "multirange_type_name") == 0) {
             parser_advance(parser);
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after MULTIRANGE_TYPE_NAME")) {
-                free(range_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected multirange type name");
-                free(range_def);
                 return NULL;
             }
-            range_def->multirange_type_name = strdup(parser->current.lexeme);
+            range_def->multirange_type_name = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else {
             parser_error(parser, "Unknown RANGE parameter");
-            free(range_def);
             return NULL;
         }
 
@@ -395,13 +421,11 @@ static RangeTypeDef *parse_range_type_def(Parser *parser) {
     }
 
     if (!parser_expect(parser, TOKEN_RPAREN, "Expected ')' after RANGE parameters")) {
-        free(range_def);
         return NULL;
     }
 
     if (!range_def->subtype) {
         parser_error(parser, "RANGE type requires SUBTYPE parameter");
-        free(range_def);
         return NULL;
     }
 
@@ -410,7 +434,7 @@ static RangeTypeDef *parse_range_type_def(Parser *parser) {
 
 /* Parse BASE type definition: (INPUT = func, OUTPUT = func, ...) */
 static BaseTypeDef *parse_base_type_def(Parser *parser) {
-    BaseTypeDef *base_def = malloc(sizeof(BaseTypeDef));
+    BaseTypeDef *base_def = parser_alloc(parser, sizeof(BaseTypeDef));
     if (!base_def) {
         parser_error(parser, "Out of memory");
         return NULL;
@@ -419,7 +443,6 @@ static BaseTypeDef *parse_base_type_def(Parser *parser) {
     memset(base_def, 0, sizeof(BaseTypeDef));
 
     if (!parser_expect(parser, TOKEN_LPAREN, "Expected '(' for BASE type")) {
-        free(base_def);
         return NULL;
     }
 
@@ -427,91 +450,76 @@ static BaseTypeDef *parse_base_type_def(Parser *parser) {
     while (!parser_check(parser, TOKEN_RPAREN) && !parser_check(parser, TOKEN_EOF)) {
         if (parser_match(parser, TOKEN_INPUT)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after INPUT")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected input function name");
-                free(base_def);
                 return NULL;
             }
-            base_def->input_function = strdup(parser->current.lexeme);
+            base_def->input_function = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_OUTPUT)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after OUTPUT")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected output function name");
-                free(base_def);
                 return NULL;
             }
-            base_def->output_function = strdup(parser->current.lexeme);
+            base_def->output_function = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_RECEIVE)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after RECEIVE")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected receive function name");
-                free(base_def);
                 return NULL;
             }
-            base_def->receive_function = strdup(parser->current.lexeme);
+            base_def->receive_function = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_SEND)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after SEND")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected send function name");
-                free(base_def);
                 return NULL;
             }
-            base_def->send_function = strdup(parser->current.lexeme);
+            base_def->send_function = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_TYPMOD_IN)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after TYPMOD_IN")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected typmod_in function name");
-                free(base_def);
                 return NULL;
             }
-            base_def->typmod_in_function = strdup(parser->current.lexeme);
+            base_def->typmod_in_function = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_TYPMOD_OUT)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after TYPMOD_OUT")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected typmod_out function name");
-                free(base_def);
                 return NULL;
             }
-            base_def->typmod_out_function = strdup(parser->current.lexeme);
+            base_def->typmod_out_function = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_ANALYZE)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after ANALYZE")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected analyze function name");
-                free(base_def);
                 return NULL;
             }
-            base_def->analyze_function = strdup(parser->current.lexeme);
+            base_def->analyze_function = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_INTERNALLENGTH)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after INTERNALLENGTH")) {
-                free(base_def);
                 return NULL;
             }
             if (parser_match(parser, TOKEN_VARIABLE)) {
@@ -523,7 +531,6 @@ static BaseTypeDef *parse_base_type_def(Parser *parser) {
                 parser_advance(parser);
             } else {
                 parser_error(parser, "Expected VARIABLE or number for INTERNALLENGTH");
-                free(base_def);
                 return NULL;
             }
             base_def->has_internallength = true;
@@ -538,13 +545,11 @@ static BaseTypeDef *parse_base_type_def(Parser *parser) {
                         base_def->passedbyvalue = false;
                     } else {
                         parser_error(parser, "Expected true or false for PASSEDBYVALUE");
-                        free(base_def);
                         return NULL;
                     }
                     parser_advance(parser);
                 } else {
                     parser_error(parser, "Expected true or false for PASSEDBYVALUE");
-                    free(base_def);
                     return NULL;
                 }
             } else {
@@ -552,12 +557,10 @@ static BaseTypeDef *parse_base_type_def(Parser *parser) {
             }
         } else if (parser_match(parser, TOKEN_ALIGNMENT)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after ALIGNMENT")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected alignment value");
-                free(base_def);
                 return NULL;
             }
             /* Parse alignment: char, int2, int4, double */
@@ -572,14 +575,12 @@ static BaseTypeDef *parse_base_type_def(Parser *parser) {
                 base_def->alignment = 'd';
             } else {
                 parser_error(parser, "Invalid alignment value");
-                free(base_def);
                 return NULL;
             }
             base_def->has_alignment = true;
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_STORAGE)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after STORAGE")) {
-                free(base_def);
                 return NULL;
             }
             if (parser_match(parser, TOKEN_PLAIN)) {
@@ -592,40 +593,35 @@ static BaseTypeDef *parse_base_type_def(Parser *parser) {
                 base_def->storage = 'm';
             } else {
                 parser_error(parser, "Expected PLAIN, EXTERNAL, EXTENDED, or MAIN for STORAGE");
-                free(base_def);
                 return NULL;
             }
             base_def->has_storage = true;
         } else if (parser_match(parser, TOKEN_LIKE)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after LIKE")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected type name for LIKE");
-                free(base_def);
                 return NULL;
             }
-            base_def->like_type = strdup(parser->current.lexeme);
+            base_def->like_type = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_check(parser, TOKEN_IDENTIFIER) &&
                    strcmp(parser->current.lexeme, "category") == 0) {
             parser_advance(parser);
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after CATEGORY")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_STRING_LITERAL) && !parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected category value");
-                free(base_def);
                 return NULL;
             }
-            char *cat_str = strip_quotes(parser->current.lexeme);
+            char *cat_str = strip_quotes(parser, parser->current.lexeme);
             if (cat_str && strlen(cat_str) > 0) {
                 base_def->category = cat_str[0];
                 base_def->has_category = true;
             }
-            free(cat_str);
+            parser_free(parser, cat_str);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_PREFERRED)) {
             base_def->has_preferred = true;
@@ -637,13 +633,11 @@ static BaseTypeDef *parse_base_type_def(Parser *parser) {
                         base_def->preferred = false;
                     } else {
                         parser_error(parser, "Expected true or false for PREFERRED");
-                        free(base_def);
                         return NULL;
                     }
                     parser_advance(parser);
                 } else {
                     parser_error(parser, "Expected true or false for PREFERRED");
-                    free(base_def);
                     return NULL;
                 }
             } else {
@@ -651,60 +645,51 @@ static BaseTypeDef *parse_base_type_def(Parser *parser) {
             }
         } else if (parser_match(parser, TOKEN_DEFAULT)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after DEFAULT")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_STRING_LITERAL) && !parser_check(parser, TOKEN_IDENTIFIER) && !parser_check(parser, TOKEN_NUMBER)) {
                 parser_error(parser, "Expected default value");
-                free(base_def);
                 return NULL;
             }
-            base_def->default_value = strdup(parser->current.lexeme);
+            base_def->default_value = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_ELEMENT)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after ELEMENT")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected element type name");
-                free(base_def);
                 return NULL;
             }
-            base_def->element_type = strdup(parser->current.lexeme);
+            base_def->element_type = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_DELIMITER)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after DELIMITER")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_STRING_LITERAL)) {
                 parser_error(parser, "Expected string literal for DELIMITER");
-                free(base_def);
                 return NULL;
             }
-            char *delim_str = strip_quotes(parser->current.lexeme);
+            char *delim_str = strip_quotes(parser, parser->current.lexeme);
             if (delim_str && strlen(delim_str) > 0) {
                 base_def->delimiter = delim_str[0];
                 base_def->has_delimiter = true;
             }
-            free(delim_str);
+            parser_free(parser, delim_str);
             parser_advance(parser);
         } else if (parser_match(parser, TOKEN_COLLATABLE)) {
             if (!parser_expect(parser, TOKEN_EQUAL, "Expected '=' after COLLATABLE")) {
-                free(base_def);
                 return NULL;
             }
             if (!parser_check(parser, TOKEN_IDENTIFIER)) {
                 parser_error(parser, "Expected true or false for COLLATABLE");
-                free(base_def);
                 return NULL;
             }
-            base_def->collatable = strdup(parser->current.lexeme);
+            base_def->collatable = parser_strdup(parser, parser->current.lexeme);
             parser_advance(parser);
         } else {
             parser_error(parser, "Unknown BASE type parameter");
-            free(base_def);
             return NULL;
         }
 
@@ -714,14 +699,12 @@ static BaseTypeDef *parse_base_type_def(Parser *parser) {
     }
 
     if (!parser_expect(parser, TOKEN_RPAREN, "Expected ')' after BASE type parameters")) {
-        free(base_def);
         return NULL;
     }
 
     /* Validate required parameters */
     if (!base_def->input_function || !base_def->output_function) {
         parser_error(parser, "BASE type requires INPUT and OUTPUT functions");
-        free(base_def);
         return NULL;
     }
 
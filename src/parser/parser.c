@@ -46,6 +46,58 @@ void parser_destroy(Parser *parser) {
     free(parser);
 }
 
+/* Zeroed allocation in the parser's context */
+void *parser_alloc(Parser *parser, size_t size) {
+    return mem_calloc(parser->memory_ctx, 1, size);
+}
+
+void *parser_realloc(Parser *parser, void *ptr, size_t size) {
+    return mem_realloc(parser->memory_ctx, ptr, size);
+}
+
+char *parser_strdup(Parser *parser, const char *str) {
+    return mem_strdup(parser->memory_ctx, str);
+}
+
+char *parser_strndup(Parser *parser, const char *str, size_t n) {
+    return mem_strndup(parser->memory_ctx, str, n);
+}
+
+void parser_free(Parser *parser, void *ptr) {
+    mem_free(parser->memory_ctx, ptr);
+}
+
+size_t parser_mark(Parser *parser) {
+    return memory_context_mark(parser->memory_ctx);
+}
+
+void parser_discard(Parser *parser, size_t mark) {
+    memory_context_reset_to(parser->memory_ctx, mark);
+}
+
+void parser_keep(Parser *parser, size_t mark) {
+    memory_context_release(parser->memory_ctx, mark);
+}
+
+bool parser_text_append(Parser *parser, ParserText *pt, const char *str, size_t n) {
+    if (pt->len + n + 1 > pt->capacity) {
+        size_t capacity = pt->capacity ? pt->capacity : 64;
+        while (pt->len + n + 1 > capacity) {
+            capacity *= 2;
+        }
+        char *text = parser_realloc(parser, pt->text, capacity);
+        if (!text) {
+            return false;
+        }
+        pt->text = text;
+        pt->capacity = capacity;
+    }
+    memcpy(pt->text + pt->len, str, n);
+    pt->len += n;
+    pt->text[pt->len] = '\0';
+    return true;
+}
+
 /* Add error to list */
 void parser_error(Parser *parser, const char *format, ...) {
     if (parser->panic_mode) {
@@ -105,6 +157,7 @@ Token parser_advance(Parser *parser) {
         }
 
         parser_error(parser, "Lexer error: %s", parser->current.lexeme);
+        lexer_free_token(&parser->current);
     }
 
     return parser->previous;
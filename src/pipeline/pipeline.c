@@ -0,0 +1,707 @@
+#include "pipeline.h"
+#include "result_collector.h"
+#include "trace.h"
+#include "utils.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* How often the watchdog repeats the cancel of a target still fetching past
+ * its deadline, in case the query it cancelled was followed by another */
+#define WATCHDOG_RECANCEL_NS 500000000ull
+
+typedef enum {
+    STAGE_QUEUED,
+    STAGE_FETCHING,
+    STAGE_FETCHED,
+    STAGE_COMPARING,                 /* final; the result goes to the collector unlocked */
+    STAGE_DONE                       /* failed or skipped before comparison */
+} TargetStage;
+
+typedef enum {
+    SOURCE_LOADING,
+    SOURCE_READY,
+    SOURCE_FAILED
+} SourceState;
+
+typedef enum {
+    BUDGET_OK,
+    BUDGET_TIME,
+    BUDGET_MEMORY
+} BudgetState;
+
+/* A database target's budgets. exceeded is set once, by the watchdog (time)
+ * or by the fetch worker's memory context (memory), and stops the target's
+ * catalog queries through DBConnection.interrupt. */
+typedef struct {
+    atomic_int exceeded;             /* BudgetState */
+    uint64_t fetch_start_ns;         /* set with STAGE_FETCHING (lock held) */
+    PGcancel *cancel;                /* while connected (cancel_lock held) */
+} TargetBudget;
+
+typedef struct {
+    const PipelineConfig *config;
+    void *user_data;
+    PipelineTarget *targets;
+    TargetStage *stages;
+    TargetBudget *budgets;
+    ResultCollector *results;        /* finished targets, for the writer */
+
+    /* Guards claiming work, not handing back results */
+    pthread_mutex_t lock;
+    pthread_cond_t changed;          /* broadcast on every state change */
+    pthread_mutex_t cancel_lock;     /* guards every TargetBudget.cancel */
+
+    Schema *source_schema;
+    SourceState source_state;
+    bool aborted;                    /* source failed or workers could not start */
+    bool finished;                   /* the writer is done; stops the watchdog */
+
+    int next_fetch;                  /* next target to claim for fetching */
+    int next_write;                  /* next target the writer waits for */
+    int pending_compare;             /* targets not yet claimed for comparison or done */
+    int window;                      /* max targets fetched ahead of the writer */
+} Pipeline;
+
+static void set_error(PipelineTarget *target, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(target->error, sizeof(target->error), format, args);
+    va_end(args);
+    target->ok = false;
+}
+
+static double ms_since(uint64_t start_ns) {
+    return (double)(trace_now_ns() - start_ns) / 1e6;
+}
+
+static const char *schema_to_load(const SchemaSource *source, const char *schema_name) {
+    return schema_name ? schema_name : (source->schema_name ? source->schema_name : "public");
+}
+
+/* Connect to a database source; timeout_s > 0 caps its connect_timeout */
+static DBConnection *connect_source(const SchemaSource *source, int timeout_s,
+                                    char *error, size_t error_size) {
+    DBConfig db = source->source.db_config;
+    log_info("Connecting to database: %s@%s:%s/%s",
+             db.user ? db.user : "default", db.host, db.port, db.database);
+    if (timeout_s > 0 && (db.connect_timeout <= 0 || db.connect_timeout > timeout_s)) {
+        db.connect_timeout = timeout_s;
+    }
+
+    int span = TRACE_BEGIN(TRACE_PHASE_CONNECT, "connect", source->database_name);
+    DBConnection *conn = db_connect(&db);
+    TRACE_END(span);
+    if (!conn || !db_is_connected(conn)) {
+        snprintf(error, error_size, "Failed to connect to database %s: %s",
+                 source->database_name, conn ? db_get_error(conn) : "connection failed");
+        db_disconnect(conn);
+        /* libpq messages end in a newline */
+        size_t length = strlen(error);
+        while (length > 0 && (error[length - 1] == '\n' || error[length - 1] == ' ')) {
+            error[--length] = '\0';
+        }
+        return NULL;
+    }
+    return conn;
+}
+
+/* Whether a target is diffed on the server: it is another schema of the
+ * source's database */
+static bool compares_on_server(const PipelineConfig *config, const SchemaSource *target) {
+    return config->server_side && schema_sources_share_database(config->source, target) &&
+           strcmp(schema_to_load(config->source, config->schema_name),
+                  schema_to_load(target, config->schema_name)) != 0;
+}
+
+/* Server-side comparison: the drifting part of the target's schema into
+ * target->schema and of the source's into target->desired. On failure both
+ * are left for the caller to free with mem_ctx. */
+static bool load_drift(const PipelineConfig *config, DBConnection *conn, PipelineTarget *target,
+                       MemoryContext *mem_ctx) {
+    const char *current = schema_to_load(target->spec, config->schema_name);
+    const char *desired = schema_to_load(config->source, config->schema_name);
+    int span = TRACE_BEGIN(TRACE_PHASE_INTROSPECT, "read_drift", target->spec->database_name);
+    bool ok = db_read_drift(conn, current, desired, &target->schema, &target->desired, mem_ctx);
+    TRACE_END(span);
+    if (!ok) {
+        snprintf(target->error, sizeof(target->error),
+                 "Failed to compare schemas %s and %s in database %s",
+                 current, desired, target->spec->database_name);
+        return false;
+    }
+    log_info("Compared schemas %s and %s on the server: %d and %d tables differ",
+             current, desired, target->schema->table_count, target->desired->table_count);
+    return true;
+}
+
+/* Load a schema source of any type */
+Schema *pipeline_load_source(const SchemaSource *source, const char *schema_name,
+                             char *error, size_t error_size) {
+    Schema *schema = NULL;
+    error[0] = '\0';
+
+    if (source->type == SOURCE_TYPE_DATABASE) {
+        DBConnection *conn = connect_source(source, 0, error, error_size);
+        if (!conn) {
+            return NULL;
+        }
+
+        schema = load_from_database(conn, schema_to_load(source, schema_name), NULL);
+        db_disconnect(conn);
+        if (!schema) {
+            snprintf(error, error_size, "Failed to load schema from database %s",
+                     source->database_name);
+            return NULL;
+        }
+        log_info("Loaded %d tables from database %s", schema->table_count, source->database_name);
+    } else if (source->type == SOURCE_TYPE_DIRECTORY) {
+        log_info("Loading from directory: %s", source->source.directory_path);
+        schema = load_from_directory(source->source.directory_path, NULL);
+        if (!schema) {
+            snprintf(error, error_size, "Failed to load schema from directory %s",
+                     source->source.directory_path);
+            return NULL;
+        }
+        log_info("Loaded %d tables from directory", schema->table_count);
+    } else {
+        log_info("Loading from file: %s", source->source.file_path);
+        schema = load_from_file(source->source.file_path, NULL);
+        if (!schema) {
+            snprintf(error, error_size, "Failed to load schema from file %s",
+                     source->source.file_path);
+            return NULL;
+        }
+        log_info("Loaded %d tables from file", schema->table_count);
+    }
+
+    return schema;
+}
+
+/* Record the first budget a target exceeds; later ones are ignored */
+static void exceed_budget(TargetBudget *budget, BudgetState state) {
+    int expected = BUDGET_OK;
+    atomic_compare_exchange_strong(&budget->exceeded, &expected, (int)state);
+}
+
+static void memory_exceeded(void *arg) {
+    exceed_budget(arg, BUDGET_MEMORY);
+}
+
+/* Connect to a database target, bounded by its time budget, and publish the
+ * connection's cancel handle for the watchdog */
+static DBConnection *connect_target(Pipeline *pipeline, PipelineTarget *target) {
+    const PipelineConfig *config = pipeline->config;
+    TargetBudget *budget = &pipeline->budgets[target->index];
+    int timeout_s = config->target_timeout_ms > 0 ? (int)((config->target_timeout_ms + 999) / 1000)
+                                                  : 0;
+    DBConnection *conn = connect_source(target->spec, timeout_s,
+                                        target->error, sizeof(target->error));
+    if (!conn) {
+        return NULL;
+    }
+
+    conn->interrupt = &budget->exceeded;
+    PGcancel *cancel = PQgetCancel(conn->conn);
+    pthread_mutex_lock(&pipeline->cancel_lock);
+    budget->cancel = cancel;
+    pthread_mutex_unlock(&pipeline->cancel_lock);
+    return conn;
+}
+
+static void disconnect_target(Pipeline *pipeline, PipelineTarget *target, DBConnection *conn) {
+    TargetBudget *budget = &pipeline->budgets[target->index];
+    pthread_mutex_lock(&pipeline->cancel_lock);
+    PGcancel *cancel = budget->cancel;
+    budget->cancel = NULL;
+    pthread_mutex_unlock(&pipeline->cancel_lock);
+    PQfreeCancel(cancel);
+    db_disconnect(conn);
+}
+
+/* Introspect a database target into a memory context of its own, so that a
+ * target abandoned part-way is freed whole, however far it got. Only what
+ * the reader keeps counts against the memory budget, not libpq's results. */
+static void load_database_target(Pipeline *pipeline, PipelineTarget *target) {
+    const PipelineConfig *config = pipeline->config;
+    TargetBudget *budget = &pipeline->budgets[target->index];
+    uint64_t start_ns = trace_now_ns();
+
+    MemoryContext *mem_ctx = memory_context_create("pipeline_target");
+    if (!mem_ctx) {
+        set_error(target, "Out of memory loading database %s", target->spec->database_name);
+        return;
+    }
+    memory_context_set_limit(mem_ctx, config->target_memory_limit, memory_exceeded, budget);
+
+    bool ok = false;
+    DBConnection *conn = connect_target(pipeline, target);
+    if (conn) {
+        if (target->server_side) {
+            ok = load_drift(config, conn, target, mem_ctx);
+        } else {
+            const char *schema = schema_to_load(target->spec, config->schema_name);
+            target->schema = load_from_database(conn, schema, mem_ctx);
+            ok = target->schema != NULL;
+            if (!ok) {
+                set_error(target, "Failed to load schema from database %s",
+                          target->spec->database_name);
+            }
+        }
+        disconnect_target(pipeline, target, conn);
+    }
+
+    /* A connect that gave up at the capped connect_timeout ran out of time */
+    if (!ok && config->target_timeout_ms > 0 && ms_since(start_ns) >= config->target_timeout_ms) {
+        exceed_budget(budget, BUDGET_TIME);
+    }
+
+    BudgetState state = (BudgetState)atomic_load(&budget->exceeded);
+    if (ok && state == BUDGET_OK) {
+        memory_context_release(mem_ctx, 0);
+        if (!target->server_side) {
+            log_info("Loaded %d tables from database %s", target->schema->table_count,
+                     target->spec->database_name);
+        }
+    } else {
+        /* Whatever was read, even a complete schema, goes with the context */
+        target->schema = NULL;
+        target->desired = NULL;
+        if (state == BUDGET_TIME) {
+            target->timed_out = true;
+            set_error(target, "Timed out after %.0f ms reading database %s (budget %.0f ms)",
+                      ms_since(start_ns), target->spec->database_name, config->target_timeout_ms);
+        } else if (state == BUDGET_MEMORY) {
+            target->timed_out = true;
+            set_error(target, "Exceeded the memory budget of %zu bytes reading database %s",
+                      config->target_memory_limit, target->spec->database_name);
+        }
+    }
+    memory_context_destroy(mem_ctx);
+}
+
+/* Cancel whatever query a target is running (no-op between queries) */
+static void cancel_target_query(Pipeline *pipeline, int index) {
+    char error[256];
+    pthread_mutex_lock(&pipeline->cancel_lock);
+    PGcancel *cancel = pipeline->budgets[index].cancel;
+    if (cancel && !PQcancel(cancel, error, sizeof(error))) {
+        log_warn("Failed to cancel the query of target #%d: %s", index + 1, error);
+    }
+    pthread_mutex_unlock(&pipeline->cancel_lock);
+}
+
+/* Time budgets: mark targets fetching for longer than the budget as over it
+ * and cancel their running query. The cancel is sent without the pipeline
+ * lock held, as PQcancel waits for the server. */
+static void *watchdog_stage(void *arg) {
+    Pipeline *pipeline = arg;
+    const PipelineConfig *config = pipeline->config;
+    uint64_t budget_ns = (uint64_t)(config->target_timeout_ms * 1e6);
+    int *overdue = malloc(sizeof(int) * (config->target_count > 0 ? config->target_count : 1));
+    if (!overdue) {
+        log_error("Out of memory starting the target watchdog; only connects are bounded");
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pipeline->lock);
+    while (!pipeline->finished) {
+        uint64_t now_ns = trace_now_ns();
+        uint64_t wait_ns = 0;        /* 0: until the next state change */
+        int overdue_count = 0;
+        for (int i = pipeline->next_write; i < config->target_count; i++) {
+            if (pipeline->stages[i] != STAGE_FETCHING) {
+                continue;
+            }
+            uint64_t deadline_ns = pipeline->budgets[i].fetch_start_ns + budget_ns;
+            if (now_ns >= deadline_ns) {
+                exceed_budget(&pipeline->budgets[i], BUDGET_TIME);
+                overdue[overdue_count++] = i;
+            } else if (wait_ns == 0 || deadline_ns - now_ns < wait_ns) {
+                wait_ns = deadline_ns - now_ns;
+            }
+        }
+
+        if (overdue_count > 0) {
+            pthread_mutex_unlock(&pipeline->lock);
+            for (int i = 0; i < overdue_count; i++) {
+                cancel_target_query(pipeline, overdue[i]);
+            }
+            pthread_mutex_lock(&pipeline->lock);
+            if (wait_ns == 0 || wait_ns > WATCHDOG_RECANCEL_NS) {
+                wait_ns = WATCHDOG_RECANCEL_NS;
+            }
+        }
+        if (pipeline->finished) {
+            break;
+        }
+
+        if (wait_ns == 0) {
+            pthread_cond_wait(&pipeline->changed, &pipeline->lock);
+        } else {
+            struct timespec until;
+            clock_gettime(CLOCK_REALTIME, &until);
+            until.tv_sec += (time_t)(wait_ns / 1000000000ull);
+            until.tv_nsec += (long)(wait_ns % 1000000000ull);
+            if (until.tv_nsec >= 1000000000L) {
+                until.tv_sec++;
+                until.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&pipeline->changed, &pipeline->lock, &until);
+        }
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+    free(overdue);
+    return NULL;
+}
+
+/* Mark every unclaimed target done so no worker waits for it (lock held) */
+static void abort_locked(Pipeline *pipeline) {
+    pipeline->aborted = true;
+    result_collector_abort(pipeline->results);
+    for (int i = pipeline->next_fetch; i < pipeline->config->target_count; i++) {
+        pipeline->stages[i] = STAGE_DONE;
+        set_error(&pipeline->targets[i], "skipped");
+        pipeline->pending_compare--;
+    }
+    pipeline->next_fetch = pipeline->config->target_count;
+    pthread_cond_broadcast(&pipeline->changed);
+}
+
+/* Stage 1: the source schema */
+static void *source_stage(void *arg) {
+    Pipeline *pipeline = arg;
+    const PipelineConfig *config = pipeline->config;
+    char error[256];
+
+    /* Not needed when every target is diffed on the server */
+    bool needed = config->source_loaded != NULL;
+    for (int i = 0; i < config->target_count && !needed; i++) {
+        needed = !compares_on_server(config, config->targets[i]);
+    }
+    if (!needed) {
+        pthread_mutex_lock(&pipeline->lock);
+        pipeline->source_state = SOURCE_READY;
+        pthread_cond_broadcast(&pipeline->changed);
+        pthread_mutex_unlock(&pipeline->lock);
+        return NULL;
+    }
+
+    Schema *schema = pipeline_load_source(config->source, config->schema_name,
+                                          error, sizeof(error));
+    if (!schema) {
+        log_error("%s", error);
+    } else if (config->source_loaded) {
+        config->source_loaded(schema, pipeline->user_data);
+    }
+
+    pthread_mutex_lock(&pipeline->lock);
+    pipeline->source_schema = schema;
+    pipeline->source_state = schema ? SOURCE_READY : SOURCE_FAILED;
+    if (!schema) {
+        abort_locked(pipeline);
+    }
+    pthread_cond_broadcast(&pipeline->changed);
+    pthread_mutex_unlock(&pipeline->lock);
+    return NULL;
+}
+
+/* Stage 2: connect to and introspect targets */
+static void *fetch_stage(void *arg) {
+    Pipeline *pipeline = arg;
+    const PipelineConfig *config = pipeline->config;
+
+    pthread_mutex_lock(&pipeline->lock);
+    for (;;) {
+        while (!pipeline->aborted && pipeline->next_fetch < config->target_count &&
+               (pipeline->next_fetch - pipeline->next_write >= pipeline->window ||
+                (config->skip && pipeline->source_state == SOURCE_LOADING))) {
+            pthread_cond_wait(&pipeline->changed, &pipeline->lock);
+        }
+        if (pipeline->aborted || pipeline->next_fetch >= config->target_count) {
+            break;
+        }
+
+        int index = pipeline->next_fetch++;
+        pipeline->stages[index] = STAGE_FETCHING;
+        pipeline->budgets[index].fetch_start_ns = trace_now_ns();
+        pthread_mutex_unlock(&pipeline->lock);
+
+        PipelineTarget *target = &pipeline->targets[index];
+        if (config->skip && config->skip(index, pipeline->user_data)) {
+            target->ok = true;
+            target->skipped = true;
+            result_collector_push(pipeline->results, index);
+            pthread_mutex_lock(&pipeline->lock);
+            pipeline->stages[index] = STAGE_DONE;
+            pipeline->pending_compare--;
+            pthread_cond_broadcast(&pipeline->changed);
+            continue;
+        }
+
+        uint64_t start_ns = trace_now_ns();
+        target->server_side = compares_on_server(config, target->spec);
+        if (target->spec->type == SOURCE_TYPE_DATABASE) {
+            load_database_target(pipeline, target);
+        } else {
+            target->schema = pipeline_load_source(target->spec, config->schema_name,
+                                                  target->error, sizeof(target->error));
+        }
+        target->fetch_ms = ms_since(start_ns);
+        target->ok = target->schema != NULL;
+        if (!target->schema) {
+            result_collector_push(pipeline->results, index);
+        }
+
+        pthread_mutex_lock(&pipeline->lock);
+        if (target->schema) {
+            pipeline->stages[index] = STAGE_FETCHED;
+        } else {
+            pipeline->stages[index] = STAGE_DONE;
+            pipeline->pending_compare--;
+        }
+        pthread_cond_broadcast(&pipeline->changed);
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+    return NULL;
+}
+
+/* Diff one target against the source and generate its outputs */
+static void compare_target(Pipeline *pipeline, PipelineTarget *target) {
+    const PipelineConfig *config = pipeline->config;
+    uint64_t start_ns = trace_now_ns();
+
+    /* Current state (target) first, desired state (source) second */
+    const Schema *desired = target->desired ? target->desired : pipeline->source_schema;
+    int span = TRACE_BEGIN(TRACE_PHASE_COMPARE, "compare_schemas", target->spec->database_name);
+    target->diff = compare_schemas(target->schema, desired, config->compare_opts, NULL);
+    TRACE_END(span);
+    if (!target->diff) {
+        set_error(target, "Failed to compare schemas");
+        return;
+    }
+
+    if (config->generate_sql) {
+        span = TRACE_BEGIN(TRACE_PHASE_SQLGEN, "generate_migration_sql",
+                           target->spec->database_name);
+        target->migration = generate_migration_sql(target->diff, config->sql_opts);
+        TRACE_END(span);
+        if (!target->migration) {
+            set_error(target, "Failed to generate SQL migration");
+            return;
+        }
+    }
+
+    if (config->generate_report) {
+        span = TRACE_BEGIN(TRACE_PHASE_SQLGEN, "generate_report", target->spec->database_name);
+        target->report = generate_report(target->diff, config->report_opts);
+        TRACE_END(span);
+        if (!target->report) {
+            set_error(target, "Failed to generate report");
+            return;
+        }
+    }
+
+    target->ok = true;
+    target->compare_ms = ms_since(start_ns);
+}
+
+/* Lowest-numbered target waiting for comparison, or -1 (lock held) */
+static int next_fetched_locked(const Pipeline *pipeline) {
+    for (int i = pipeline->next_write; i < pipeline->config->target_count; i++) {
+        if (pipeline->stages[i] == STAGE_FETCHED) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Stage 3: compare targets as soon as both sides are loaded. A target is
+ * claimed under the lock; its result is handed to the writer without it. */
+static void *compare_stage(void *arg) {
+    Pipeline *pipeline = arg;
+
+    pthread_mutex_lock(&pipeline->lock);
+    for (;;) {
+        int index = -1;
+        while (!pipeline->aborted && pipeline->pending_compare > 0 &&
+               (pipeline->source_state != SOURCE_READY ||
+                (index = next_fetched_locked(pipeline)) < 0)) {
+            pthread_cond_wait(&pipeline->changed, &pipeline->lock);
+        }
+        if (pipeline->aborted || pipeline->pending_compare == 0) {
+            break;
+        }
+
+        pipeline->stages[index] = STAGE_COMPARING;
+        if (--pipeline->pending_compare == 0) {
+            pthread_cond_broadcast(&pipeline->changed);
+        }
+        pthread_mutex_unlock(&pipeline->lock);
+
+        compare_target(pipeline, &pipeline->targets[index]);
+        result_collector_push(pipeline->results, index);
+
+        pthread_mutex_lock(&pipeline->lock);
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+    return NULL;
+}
+
+static void target_release(PipelineTarget *target) {
+    free(target->report);
+    target->report = NULL;
+    sql_migration_free(target->migration);
+    target->migration = NULL;
+    schema_diff_free(target->diff);
+    target->diff = NULL;
+    schema_free(target->schema);
+    target->schema = NULL;
+    schema_free(target->desired);
+    target->desired = NULL;
+}
+
+static int default_compare_jobs(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+}
+
+/* Count a written target's outcome */
+static void record_outcome(ResultCollector *results, const PipelineTarget *target, bool written) {
+    if (target->server_side && target->ok) {
+        result_collector_add(results, RESULT_SERVER_SIDE);
+    }
+    if (target->skipped) {
+        result_collector_add(results, RESULT_SKIPPED);
+    } else if (written && target->ok) {
+        result_collector_add(results, RESULT_WRITTEN);
+    } else {
+        result_collector_add(results, RESULT_FAILED);
+        if (target->timed_out) {
+            result_collector_add(results, RESULT_TIMED_OUT);
+        }
+    }
+}
+
+/* Run all stages; the calling thread is the writer */
+bool pipeline_run(const PipelineConfig *config, PipelineWriteFn write, void *user_data,
+                  PipelineSummary *summary) {
+    memset(summary, 0, sizeof(*summary));
+    uint64_t start_ns = trace_now_ns();
+    int count = config->target_count;
+
+    int fetch_jobs = config->fetch_jobs > 0 ? config->fetch_jobs : PIPELINE_DEFAULT_FETCH_JOBS;
+    int compare_jobs = config->compare_jobs > 0 ? config->compare_jobs : default_compare_jobs();
+    if (fetch_jobs > count) {
+        fetch_jobs = count > 0 ? count : 1;
+    }
+    if (compare_jobs > count) {
+        compare_jobs = count > 0 ? count : 1;
+    }
+
+    Pipeline pipeline;
+    memset(&pipeline, 0, sizeof(pipeline));
+    pipeline.config = config;
+    pipeline.user_data = user_data;
+    pipeline.targets = calloc(count > 0 ? count : 1, sizeof(PipelineTarget));
+    pipeline.stages = calloc(count > 0 ? count : 1, sizeof(TargetStage));
+    pipeline.budgets = calloc(count > 0 ? count : 1, sizeof(TargetBudget));
+    pipeline.results = result_collector_create(count);
+    pthread_t *threads = calloc(2 + fetch_jobs + compare_jobs, sizeof(pthread_t));
+    if (!pipeline.targets || !pipeline.stages || !pipeline.budgets || !pipeline.results ||
+        !threads) {
+        log_error("Out of memory starting pipeline");
+        result_collector_free(pipeline.results);
+        free(pipeline.targets);
+        free(pipeline.stages);
+        free(pipeline.budgets);
+        free(threads);
+        return false;
+    }
+
+    pthread_mutex_init(&pipeline.lock, NULL);
+    pthread_cond_init(&pipeline.changed, NULL);
+    pthread_mutex_init(&pipeline.cancel_lock, NULL);
+    pipeline.source_state = SOURCE_LOADING;
+    pipeline.pending_compare = count;
+    pipeline.window = fetch_jobs + compare_jobs;
+    for (int i = 0; i < count; i++) {
+        pipeline.targets[i].index = i;
+        pipeline.targets[i].spec = config->targets[i];
+    }
+
+    log_debug("Pipeline: %d target(s), %d fetch job(s), %d compare job(s)",
+              count, fetch_jobs, compare_jobs);
+
+    /* Start the stages */
+    int started = 0;
+    void *(*const stages[])(void *) = {source_stage, fetch_stage, compare_stage, watchdog_stage};
+    int stage_threads[] = {1, fetch_jobs, compare_jobs, config->target_timeout_ms > 0 ? 1 : 0};
+    for (int s = 0; s < 4; s++) {
+        for (int t = 0; t < stage_threads[s]; t++) {
+            if (pthread_create(&threads[started], NULL, stages[s], &pipeline) != 0) {
+                log_error("Failed to start pipeline worker thread");
+                pthread_mutex_lock(&pipeline.lock);
+                abort_locked(&pipeline);
+                pthread_mutex_unlock(&pipeline.lock);
+                s = 4;
+                break;
+            }
+            started++;
+        }
+    }
+
+    /* Stage 4: write results in target order as the collector hands them out */
+    int i;
+    while ((i = result_collector_next(pipeline.results)) >= 0) {
+        PipelineTarget *target = &pipeline.targets[i];
+        bool written = write(target, user_data);
+        record_outcome(pipeline.results, target, written);
+        target_release(target);
+        log_debug("Targets processed: %d/%d (%d finished)", i + 1, count,
+                  result_collector_finished(pipeline.results));
+
+        /* Let the fetch workers move their window on */
+        pthread_mutex_lock(&pipeline.lock);
+        pipeline.next_write = i + 1;
+        pthread_cond_broadcast(&pipeline.changed);
+        pthread_mutex_unlock(&pipeline.lock);
+    }
+    pthread_mutex_lock(&pipeline.lock);
+    pipeline.finished = true;
+    pthread_cond_broadcast(&pipeline.changed);
+    pthread_mutex_unlock(&pipeline.lock);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    bool ok = !pipeline.aborted;
+    summary->source_ok = pipeline.source_state == SOURCE_READY;
+    summary->source_table_count = pipeline.source_schema ? pipeline.source_schema->table_count : 0;
+    summary->elapsed_ms = ms_since(start_ns);
+    summary->targets_written = result_collector_count(pipeline.results, RESULT_WRITTEN);
+    summary->targets_failed = result_collector_count(pipeline.results, RESULT_FAILED);
+    summary->targets_timed_out = result_collector_count(pipeline.results, RESULT_TIMED_OUT);
+    summary->targets_skipped = result_collector_count(pipeline.results, RESULT_SKIPPED);
+    summary->targets_server_side = result_collector_count(pipeline.results, RESULT_SERVER_SIDE);
+
+    for (int i = 0; i < count; i++) {
+        target_release(&pipeline.targets[i]);
+    }
+    schema_free(pipeline.source_schema);
+    pthread_mutex_destroy(&pipeline.cancel_lock);
+    pthread_cond_destroy(&pipeline.changed);
+    pthread_mutex_destroy(&pipeline.lock);
+    result_collector_free(pipeline.results);
+    free(threads);
+    free(pipeline.budgets);
+    free(pipeline.stages);
+    free(pipeline.targets);
+    return ok;
+}
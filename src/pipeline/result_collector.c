@@ -0,0 +1,180 @@
+#include "result_collector.h"
+#include "utils.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Ring slot: sequence == position when free for the producer claiming that
+ * position, position + 1 once its index is published */
+typedef struct {
+    atomic_size_t sequence;
+    int index;
+} RingSlot;
+
+struct ResultCollector {
+    RingSlot *slots;
+    size_t mask;                     /* capacity - 1 (a power of two >= count) */
+    atomic_size_t tail;              /* next position producers claim */
+    size_t head;                     /* next position the consumer pops (consumer only) */
+
+    int count;
+    int next;                        /* next target handed out (consumer only) */
+    bool *finished;                  /* popped, by target index (consumer only) */
+    atomic_int finished_count;
+    atomic_int counters[RESULT_COUNTER_COUNT];
+    atomic_bool aborted;
+
+    /* Only for sleeping: producers take the lock when the consumer waits */
+    atomic_bool waiting;
+    pthread_mutex_t wake_lock;
+    pthread_cond_t wake;
+};
+
+ResultCollector *result_collector_create(int count) {
+    ResultCollector *collector = calloc(1, sizeof(ResultCollector));
+    if (!collector) {
+        return NULL;
+    }
+
+    size_t capacity = 1;
+    while (capacity < (size_t)(count > 0 ? count : 1)) {
+        capacity <<= 1;
+    }
+    collector->slots = calloc(capacity, sizeof(RingSlot));
+    collector->finished = calloc(count > 0 ? count : 1, sizeof(bool));
+    if (!collector->slots || !collector->finished) {
+        free(collector->slots);
+        free(collector->finished);
+        free(collector);
+        return NULL;
+    }
+
+    collector->mask = capacity - 1;
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&collector->slots[i].sequence, i);
+    }
+    atomic_init(&collector->tail, 0);
+    collector->count = count;
+    atomic_init(&collector->finished_count, 0);
+    for (int c = 0; c < RESULT_COUNTER_COUNT; c++) {
+        atomic_init(&collector->counters[c], 0);
+    }
+    atomic_init(&collector->aborted, false);
+    atomic_init(&collector->waiting, false);
+    pthread_mutex_init(&collector->wake_lock, NULL);
+    pthread_cond_init(&collector->wake, NULL);
+    return collector;
+}
+
+void result_collector_free(ResultCollector *collector) {
+    if (!collector) {
+        return;
+    }
+    pthread_cond_destroy(&collector->wake);
+    pthread_mutex_destroy(&collector->wake_lock);
+    free(collector->finished);
+    free(collector->slots);
+    free(collector);
+}
+
+static void wake_consumer(ResultCollector *collector) {
+    pthread_mutex_lock(&collector->wake_lock);
+    pthread_cond_signal(&collector->wake);
+    pthread_mutex_unlock(&collector->wake_lock);
+}
+
+void result_collector_push(ResultCollector *collector, int index) {
+    size_t pos = atomic_load_explicit(&collector->tail, memory_order_relaxed);
+    RingSlot *slot;
+    for (;;) {
+        slot = &collector->slots[pos & collector->mask];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&collector->tail, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* Only possible if an index was pushed twice */
+            log_error("Result collector full; target #%d dropped", index + 1);
+            return;
+        } else {
+            pos = atomic_load_explicit(&collector->tail, memory_order_relaxed);
+        }
+    }
+    slot->index = index;
+    atomic_fetch_add(&collector->finished_count, 1);
+
+    /* The publish and the check of waiting are seq_cst, as are their
+     * counterparts in wait_for_push: either the consumer sees the slot
+     * before sleeping, or this sees it waiting */
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_seq_cst);
+    if (atomic_load_explicit(&collector->waiting, memory_order_seq_cst)) {
+        wake_consumer(collector);
+    }
+}
+
+void result_collector_abort(ResultCollector *collector) {
+    atomic_store(&collector->aborted, true);
+    pthread_mutex_lock(&collector->wake_lock);
+    pthread_cond_broadcast(&collector->wake);
+    pthread_mutex_unlock(&collector->wake_lock);
+}
+
+static bool slot_ready(const ResultCollector *collector) {
+    const RingSlot *slot = &collector->slots[collector->head & collector->mask];
+    return atomic_load_explicit(&slot->sequence, memory_order_seq_cst) == collector->head + 1;
+}
+
+/* Pop every published index into finished[] */
+static void drain(ResultCollector *collector) {
+    while (slot_ready(collector)) {
+        RingSlot *slot = &collector->slots[collector->head & collector->mask];
+        int index = slot->index;
+        atomic_store_explicit(&slot->sequence, collector->head + collector->mask + 1,
+                              memory_order_release);
+        collector->head++;
+        if (index >= 0 && index < collector->count) {
+            collector->finished[index] = true;
+        }
+    }
+}
+
+static void wait_for_push(ResultCollector *collector) {
+    pthread_mutex_lock(&collector->wake_lock);
+    atomic_store_explicit(&collector->waiting, true, memory_order_seq_cst);
+    if (!slot_ready(collector) && !atomic_load(&collector->aborted)) {
+        pthread_cond_wait(&collector->wake, &collector->wake_lock);
+    }
+    atomic_store_explicit(&collector->waiting, false, memory_order_relaxed);
+    pthread_mutex_unlock(&collector->wake_lock);
+}
+
+int result_collector_next(ResultCollector *collector) {
+    while (collector->next < collector->count) {
+        if (atomic_load(&collector->aborted)) {
+            return -1;
+        }
+        drain(collector);
+        if (collector->finished[collector->next]) {
+            return collector->next++;
+        }
+        wait_for_push(collector);
+    }
+    return -1;
+}
+
+int result_collector_finished(const ResultCollector *collector) {
+    return atomic_load(&collector->finished_count);
+}
+
+void result_collector_add(ResultCollector *collector, ResultCounter counter) {
+    atomic_fetch_add_explicit(&collector->counters[counter], 1, memory_order_relaxed);
+}
+
+int result_collector_count(const ResultCollector *collector, ResultCounter counter) {
+    return atomic_load_explicit(&collector->counters[counter], memory_order_relaxed);
+}
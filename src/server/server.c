@@ -0,0 +1,641 @@
+#include "server.h"
+#include "utils.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#define SERVER_MAX_CLIENTS 64
+#define SERVER_MAX_LINE (1024 * 1024)
+#define SERVER_MAX_OUTPUT (1024 * 1024)   /* unsent bytes before a client's requests wait */
+
+/* Daemon state */
+struct Server {
+    ServerConfig config;
+    Schema *source_schema;
+    DBPool *pool;
+    uint64_t started_ns;
+    uint64_t source_loaded_ns;
+    int requests;
+    int errors;
+    int reloads;
+    bool stop;
+};
+
+/* One connected client: its partial input and its unsent responses */
+typedef struct {
+    int fd;
+    char *buffer;
+    size_t length;
+    size_t capacity;
+    char *output;
+    size_t output_length;
+    size_t output_capacity;
+} ServerClient;
+
+static volatile sig_atomic_t g_server_signalled = 0;
+
+static void server_signal_handler(int sig) {
+    (void)sig;
+    g_server_signalled = 1;
+}
+
+/* Schema name for a request: explicit, then --schema, then the source's, then public */
+static const char *resolve_schema(const Server *server, const char *requested,
+                                  const SchemaSource *source) {
+    if (requested) {
+        return requested;
+    }
+    if (server->config.schema_name) {
+        return server->config.schema_name;
+    }
+    if (source && source->schema_name) {
+        return source->schema_name;
+    }
+    return "public";
+}
+
+/* Load the configured source; database sources go through the pool */
+static Schema *load_source(Server *server, const char **error) {
+    SchemaSource *source = parse_schema_source(server->config.source_spec);
+    if (!source) {
+        *error = "Invalid source";
+        return NULL;
+    }
+
+    Schema *schema = NULL;
+    if (source->type == SOURCE_TYPE_DATABASE) {
+        DBConnection *conn = db_pool_acquire(server->pool, &source->source.db_config);
+        if (!conn || !db_is_connected(conn)) {
+            *error = "Failed to connect to source database";
+        } else {
+            schema = load_from_database(conn, resolve_schema(server, NULL, source), NULL);
+        }
+        db_pool_release(server->pool, conn, conn && db_is_connected(conn));
+    } else if (source->type == SOURCE_TYPE_DIRECTORY) {
+        schema = load_from_directory(source->source.directory_path, NULL);
+    } else {
+        schema = load_from_file(source->source.file_path, NULL);
+    }
+
+    if (!schema && !*error) {
+        *error = "Failed to load source schema";
+    }
+    schema_source_free(source);
+    return schema;
+}
+
+/* Create a server with the source schema loaded */
+Server *server_create(const ServerConfig *config) {
+    if (!config || !config->source_spec || !config->compare_opts ||
+        !config->report_opts || !config->sql_opts) {
+        return NULL;
+    }
+
+    Server *server = calloc(1, sizeof(Server));
+    if (!server) {
+        return NULL;
+    }
+    server->config = *config;
+    server->started_ns = trace_now_ns();
+    server->pool = db_pool_create(config->pool_size);
+    if (!server->pool) {
+        free(server);
+        return NULL;
+    }
+
+    const char *error = NULL;
+    server->source_schema = load_source(server, &error);
+    if (!server->source_schema) {
+        log_error("%s: %s", error, config->source_spec);
+        server_destroy(server);
+        return NULL;
+    }
+    server->source_loaded_ns = trace_now_ns();
+    log_info("Loaded %d tables from source", server->source_schema->table_count);
+    return server;
+}
+
+/* Free the server, its source schema and pooled connections */
+void server_destroy(Server *server) {
+    if (!server) {
+        return;
+    }
+    schema_free(server->source_schema);
+    db_pool_destroy(server->pool);
+    free(server);
+}
+
+bool server_should_stop(const Server *server) {
+    return server && server->stop;
+}
+
+/* Start a response object: {"ok":<ok>[,"id":<id>] */
+static StringBuilder *response_begin(bool ok, const JsonObject *request) {
+    StringBuilder *sb = sb_create();
+    sb_append_fmt(sb, "{\"ok\":%s", ok ? "true" : "false");
+    const JsonField *id = json_object_get(request, "id");
+    if (id) {
+        sb_append(sb, ",\"id\":");
+        sb_append_json_value(sb, id);
+    }
+    return sb;
+}
+
+/* Close a response with elapsed_ms and return it */
+static char *response_end(StringBuilder *sb, uint64_t start_ns) {
+    sb_append_fmt(sb, ",\"elapsed_ms\":%.3f}", (double)(trace_now_ns() - start_ns) / 1e6);
+    char *response = sb_to_string(sb);
+    sb_free(sb);
+    return response;
+}
+
+static char *error_response(Server *server, const JsonObject *request,
+                            const char *message, uint64_t start_ns) {
+    server->errors++;
+    StringBuilder *sb = response_begin(false, request);
+    sb_append(sb, ",\"error\":");
+    sb_append_json_string(sb, message);
+    return response_end(sb, start_ns);
+}
+
+/* Introspect the request's target and diff it against the warm source */
+static SchemaDiff *diff_target(Server *server, const JsonObject *request,
+                               Schema **target_out, const char **error) {
+    const char *spec = json_object_get_string(request, "target");
+    if (!spec) {
+        *error = "Missing \"target\"";
+        return NULL;
+    }
+
+    SchemaSource *target = parse_schema_source(spec);
+    if (!target || target->type != SOURCE_TYPE_DATABASE) {
+        schema_source_free(target);
+        *error = "Target must be a PostgreSQL database URI";
+        return NULL;
+    }
+
+    const char *schema = resolve_schema(server, json_object_get_string(request, "schema"), target);
+    DBConnection *conn = db_pool_acquire(server->pool, &target->source.db_config);
+    if (!conn || !db_is_connected(conn)) {
+        db_pool_release(server->pool, conn, false);
+        schema_source_free(target);
+        *error = "Failed to connect to target database";
+        return NULL;
+    }
+
+    Schema *target_schema = load_from_database(conn, schema, NULL);
+    db_pool_release(server->pool, conn, db_is_connected(conn));
+    schema_source_free(target);
+    if (!target_schema) {
+        *error = "Failed to load schema from target database";
+        return NULL;
+    }
+
+    /* Current state first, desired state second - as in the CLI */
+    SchemaDiff *diff = compare_schemas(target_schema, server->source_schema,
+                                       server->config.compare_opts, NULL);
+    if (!diff) {
+        schema_free(target_schema);
+        *error = "Failed to compare schemas";
+        return NULL;
+    }
+
+    /* The diff points into both schemas; the caller frees the target after it */
+    *target_out = target_schema;
+    return diff;
+}
+
+static void append_diff_counts(StringBuilder *sb, const SchemaDiff *diff) {
+    sb_append_fmt(sb, ",\"changes\":%d,\"tables_added\":%d,\"tables_removed\":%d,"
+                  "\"tables_modified\":%d,\"types_added\":%d,\"types_removed\":%d,"
+                  "\"types_modified\":%d,\"indexes_added\":%d,\"indexes_removed\":%d,"
+                  "\"indexes_modified\":%d",
+                  diff->total_diffs, diff->tables_added, diff->tables_removed,
+                  diff->tables_modified, diff->types_added, diff->types_removed,
+                  diff->types_modified, diff->indexes_added, diff->indexes_removed,
+                  diff->indexes_modified);
+}
+
+static char *handle_compare(Server *server, const JsonObject *request, bool check_only,
+                            uint64_t start_ns) {
+    ReportOptions report_opts = *server->config.report_opts;
+    report_opts.use_color = false;
+    report_opts.output_file = NULL;
+
+    const char *format = json_object_get_string(request, "format");
+    if (format && strcmp(format, "markdown") == 0) {
+        report_opts.format = REPORT_FORMAT_MARKDOWN;
+    } else if (format && strcmp(format, "text") == 0) {
+        report_opts.format = REPORT_FORMAT_TEXT;
+    } else if (format) {
+        return error_response(server, request, "Unknown format (use text or markdown)", start_ns);
+    }
+
+    const char *error = NULL;
+    Schema *target_schema = NULL;
+    SchemaDiff *diff = diff_target(server, request, &target_schema, &error);
+    if (!diff) {
+        return error_response(server, request, error, start_ns);
+    }
+
+    StringBuilder *sb = response_begin(true, request);
+    append_diff_counts(sb, diff);
+    if (check_only) {
+        sb_append_fmt(sb, ",\"in_sync\":%s", diff->total_diffs == 0 ? "true" : "false");
+    } else {
+        char *report = generate_report(diff, &report_opts);
+        sb_append(sb, ",\"report\":");
+        sb_append_json_string(sb, report ? report : "");
+        free(report);
+    }
+
+    schema_diff_free(diff);
+    schema_free(target_schema);
+    return response_end(sb, start_ns);
+}
+
+static char *handle_generate(Server *server, const JsonObject *request, uint64_t start_ns) {
+    const char *error = NULL;
+    Schema *target_schema = NULL;
+    SchemaDiff *diff = diff_target(server, request, &target_schema, &error);
+    if (!diff) {
+        return error_response(server, request, error, start_ns);
+    }
+
+    SQLMigration *migration = generate_migration_sql(diff, server->config.sql_opts);
+    if (!migration) {
+        schema_diff_free(diff);
+        schema_free(target_schema);
+        return error_response(server, request, "Failed to generate migration", start_ns);
+    }
+
+    StringBuilder *sb = response_begin(true, request);
+    append_diff_counts(sb, diff);
+    sb_append_fmt(sb, ",\"statements\":%d,\"destructive\":%s,\"sql\":",
+                  migration->statement_count,
+                  migration->has_destructive_changes ? "true" : "false");
+    sb_append_json_string(sb, migration->forward_sql ? migration->forward_sql : "");
+
+    sql_migration_free(migration);
+    schema_diff_free(diff);
+    schema_free(target_schema);
+    return response_end(sb, start_ns);
+}
+
+/* Reload the source; the old schema stays in place if loading fails */
+static char *handle_reload(Server *server, const JsonObject *request, uint64_t start_ns) {
+    const char *error = NULL;
+    Schema *schema = load_source(server, &error);
+    if (!schema) {
+        return error_response(server, request, error, start_ns);
+    }
+
+    schema_free(server->source_schema);
+    server->source_schema = schema;
+    server->source_loaded_ns = trace_now_ns();
+    server->reloads++;
+
+    StringBuilder *sb = response_begin(true, request);
+    sb_append_fmt(sb, ",\"source_tables\":%d", schema->table_count);
+    return response_end(sb, start_ns);
+}
+
+static char *handle_stats(Server *server, const JsonObject *request, uint64_t start_ns) {
+    DBPoolStats pool;
+    db_pool_get_stats(server->pool, &pool);
+    uint64_t now = trace_now_ns();
+
+    StringBuilder *sb = response_begin(true, request);
+    sb_append_fmt(sb, ",\"uptime_s\":%.1f,\"requests\":%d,\"errors\":%d,\"reloads\":%d",
+                  (double)(now - server->started_ns) / 1e9, server->requests,
+                  server->errors, server->reloads);
+    sb_append_fmt(sb, ",\"source_tables\":%d,\"source_age_s\":%.1f",
+                  server->source_schema->table_count,
+                  (double)(now - server->source_loaded_ns) / 1e9);
+    sb_append_fmt(sb, ",\"pool\":{\"connects\":%d,\"reused\":%d,\"discarded\":%d,"
+                  "\"idle\":%d,\"targets\":%d}",
+                  pool.connects, pool.reused, pool.discarded, pool.idle, pool.targets);
+    return response_end(sb, start_ns);
+}
+
+/* Handle one request line */
+char *server_handle_request(Server *server, const char *line) {
+    uint64_t start_ns = trace_now_ns();
+    server->requests++;
+
+    const char *parse_error = NULL;
+    JsonObject *request = json_parse_object(line, &parse_error);
+    if (!request) {
+        return error_response(server, NULL, parse_error ? parse_error : "Invalid JSON", start_ns);
+    }
+
+    char *response;
+    const char *op = json_object_get_string(request, "op");
+    if (!op) {
+        response = error_response(server, request, "Missing \"op\"", start_ns);
+    } else if (strcmp(op, "compare") == 0) {
+        response = handle_compare(server, request, false, start_ns);
+    } else if (strcmp(op, "check") == 0) {
+        response = handle_compare(server, request, true, start_ns);
+    } else if (strcmp(op, "generate") == 0) {
+        response = handle_generate(server, request, start_ns);
+    } else if (strcmp(op, "reload") == 0) {
+        response = handle_reload(server, request, start_ns);
+    } else if (strcmp(op, "stats") == 0) {
+        response = handle_stats(server, request, start_ns);
+    } else if (strcmp(op, "ping") == 0) {
+        response = response_end(response_begin(true, request), start_ns);
+    } else if (strcmp(op, "shutdown") == 0) {
+        server->stop = true;
+        response = response_end(response_begin(true, request), start_ns);
+    } else {
+        response = error_response(server, request, "Unknown op", start_ns);
+    }
+
+    json_object_free(request);
+    return response;
+}
+
+/* Grow *buffer to hold at least needed bytes */
+static bool reserve(char **buffer, size_t *capacity, size_t needed) {
+    if (needed <= *capacity) {
+        return true;
+    }
+    size_t grown = *capacity ? *capacity : 4096;
+    while (grown < needed) {
+        grown *= 2;
+    }
+    char *resized = realloc(*buffer, grown);
+    if (!resized) {
+        return false;
+    }
+    *buffer = resized;
+    *capacity = grown;
+    return true;
+}
+
+static void client_close(ServerClient *client) {
+    close(client->fd);
+    free(client->buffer);
+    free(client->output);
+    memset(client, 0, sizeof(*client));
+    client->fd = -1;
+}
+
+/* Queue a response line for the client */
+static bool client_queue(ServerClient *client, const char *response) {
+    size_t length = strlen(response);
+    if (!reserve(&client->output, &client->output_capacity,
+                 client->output_length + length + 1)) {
+        return false;
+    }
+    memcpy(client->output + client->output_length, response, length);
+    client->output[client->output_length + length] = '\n';
+    client->output_length += length + 1;
+    return true;
+}
+
+/* Write as much queued output as the socket takes without blocking; false
+ * to drop the client */
+static bool client_flush(ServerClient *client) {
+    size_t sent = 0;
+    while (sent < client->output_length) {
+        ssize_t n = write(client->fd, client->output + sent, client->output_length - sent);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN) {
+                break;
+            }
+            return false;
+        }
+        sent += (size_t)n;
+    }
+    memmove(client->output, client->output + sent, client->output_length - sent);
+    client->output_length -= sent;
+    return true;
+}
+
+static bool client_has_line(const ServerClient *client) {
+    return client->length > 0 && memchr(client->buffer, '\n', client->length) != NULL;
+}
+
+/* Answer complete request lines until the client is SERVER_MAX_OUTPUT
+ * behind; the rest wait in the buffer. False to drop the client. */
+static bool client_answer(Server *server, ServerClient *client) {
+    if (!client->buffer) {
+        return true;
+    }
+    char *line = client->buffer;
+    char *newline = NULL;
+    while (!server->stop && client->output_length < SERVER_MAX_OUTPUT &&
+           (newline = memchr(line, '\n', client->length - (size_t)(line - client->buffer)))) {
+        *newline = '\0';
+        if (newline > line && newline[-1] == '\r') {
+            newline[-1] = '\0';
+        }
+        if (*line) {
+            char *response = server_handle_request(server, line);
+            bool queued = response && client_queue(client, response);
+            free(response);
+            if (!queued) {
+                return false;
+            }
+        }
+        line = newline + 1;
+    }
+
+    size_t rest = client->length - (size_t)(line - client->buffer);
+    memmove(client->buffer, line, rest);
+    client->length = rest;
+    client->buffer[rest] = '\0';
+    if (client->length > SERVER_MAX_LINE && !client_has_line(client)) {
+        log_warn("Dropping client: request line exceeds %d bytes", SERVER_MAX_LINE);
+        return false;
+    }
+    return true;
+}
+
+/* Answer buffered requests and write responses until the socket is full or
+ * nothing is left to answer. False to drop the client. */
+static bool client_progress(Server *server, ServerClient *client) {
+    do {
+        if (!client_answer(server, client) || !client_flush(client)) {
+            return false;
+        }
+    } while (!server->stop && client->output_length == 0 && client_has_line(client));
+    return true;
+}
+
+/* Read from a client and answer every complete line; false to drop it */
+static bool client_service(Server *server, ServerClient *client) {
+    char chunk[4096];
+    ssize_t n = read(client->fd, chunk, sizeof(chunk));
+    if (n < 0) {
+        return errno == EINTR || errno == EAGAIN;
+    }
+    if (n == 0) {
+        return false;
+    }
+
+    if (!reserve(&client->buffer, &client->capacity, client->length + (size_t)n + 1)) {
+        return false;
+    }
+    memcpy(client->buffer + client->length, chunk, (size_t)n);
+    client->length += (size_t)n;
+    client->buffer[client->length] = '\0';
+    return client_progress(server, client);
+}
+
+/* Bind and listen on the configured socket path */
+static int server_listen(const char *path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        log_error("Socket path too long: %s", path);
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        log_error("socket: %s", strerror(errno));
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    /* Replace a stale socket left by a previous run */
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        unlink(path);
+    }
+
+    mode_t old_mask = umask(0077);
+    int rc = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    umask(old_mask);
+    if (rc < 0 || listen(fd, SERVER_MAX_CLIENTS) < 0) {
+        log_error("Cannot listen on %s: %s", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Serve requests until shutdown or a termination signal */
+int server_run(Server *server) {
+    if (!server || !server->config.socket_path) {
+        return 1;
+    }
+
+    int listen_fd = server_listen(server->config.socket_path);
+    if (listen_fd < 0) {
+        return 1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = server_signal_handler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &sa, NULL);
+
+    log_info("Listening on %s", server->config.socket_path);
+
+    ServerClient clients[SERVER_MAX_CLIENTS];
+    for (int i = 0; i < SERVER_MAX_CLIENTS; i++) {
+        memset(&clients[i], 0, sizeof(clients[i]));
+        clients[i].fd = -1;
+    }
+
+    while (!server->stop && !g_server_signalled) {
+        struct pollfd fds[SERVER_MAX_CLIENTS + 1];
+        int slot_of[SERVER_MAX_CLIENTS + 1];
+        int nfds = 0;
+
+        fds[nfds].fd = listen_fd;
+        fds[nfds].events = POLLIN;
+        slot_of[nfds++] = -1;
+        for (int i = 0; i < SERVER_MAX_CLIENTS; i++) {
+            if (clients[i].fd >= 0) {
+                /* A client that does not read its responses is not read
+                 * from either, so it only ever holds up itself */
+                fds[nfds].fd = clients[i].fd;
+                fds[nfds].events = clients[i].output_length < SERVER_MAX_OUTPUT ? POLLIN : 0;
+                if (clients[i].output_length > 0) {
+                    fds[nfds].events |= POLLOUT;
+                }
+                slot_of[nfds++] = i;
+            }
+        }
+
+        int ready = poll(fds, (nfds_t)nfds, 1000);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            log_error("poll: %s", strerror(errno));
+            break;
+        }
+
+        for (int i = 1; i < nfds; i++) {
+            ServerClient *client = &clients[slot_of[i]];
+            bool keep = true;
+            if (fds[i].revents & POLLOUT) {
+                keep = client_progress(server, client);
+            }
+            if (keep && (fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                keep = client_service(server, client);
+            }
+            if (!keep) {
+                client_close(client);
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listen_fd, NULL, NULL);
+            if (fd >= 0) {
+                int slot = -1;
+                for (int i = 0; i < SERVER_MAX_CLIENTS && slot < 0; i++) {
+                    if (clients[i].fd < 0) {
+                        slot = i;
+                    }
+                }
+                int flags = fcntl(fd, F_GETFL);
+                if (slot < 0) {
+                    log_warn("Too many clients; rejecting connection");
+                    close(fd);
+                } else if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+                    log_warn("Cannot make client socket non-blocking: %s", strerror(errno));
+                    close(fd);
+                } else {
+                    clients[slot].fd = fd;
+                }
+            }
+        }
+    }
+
+    /* The shutdown response, and whatever else the sockets still take */
+    for (int i = 0; i < SERVER_MAX_CLIENTS; i++) {
+        if (clients[i].fd >= 0) {
+            client_flush(&clients[i]);
+            client_close(&clients[i]);
+        }
+    }
+    close(listen_fd);
+    unlink(server->config.socket_path);
+    log_info("Server stopped after %d requests", server->requests);
+    return 0;
+}
@@ -123,6 +123,8 @@ void log_message(LogLevel level, const char *format, ...) {
             level_str = "UNKNOWN";
     }
 
+    /* One line per message even when pipeline workers log concurrently */
+    flockfile(log_state.log_file);
     fprintf(log_state.log_file, "[%s] ", level_str);
 
     va_list args;
@@ -132,6 +134,7 @@ void log_message(LogLevel level, const char *format, ...) {
 
     fprintf(log_state.log_file, "\n");
     fflush(log_state.log_file);
+    funlockfile(log_state.log_file);
 }
 
 void log_debug(const char *format, ...) {
@@ -139,6 +142,7 @@ void log_debug(const char *format, ...) {
         return;
     }
 
+    flockfile(log_state.log_file);
     fprintf(log_state.log_file, "[DEBUG] ");
 
     va_list args;
@@ -148,6 +152,7 @@ void log_debug(const char *format, ...) {
 
     fprintf(log_state.log_file, "\n");
     fflush(log_state.log_file);
+    funlockfile(log_state.log_file);
 }
 
 void log_info(const char *format, ...) {
@@ -155,6 +160,7 @@ void log_info(const char *format, ...) {
         return;
     }
 
+    flockfile(log_state.log_file);
     fprintf(log_state.log_file, "[INFO] ");
 
     va_list args;
@@ -164,6 +170,7 @@ void log_info(const char *format, ...) {
 
     fprintf(log_state.log_file, "\n");
     fflush(log_state.log_file);
+    funlockfile(log_state.log_file);
 }
 
 void log_warn(const char *format, ...) {
@@ -171,6 +178,7 @@ void log_warn(const char *format, ...) {
         return;
     }
 
+    flockfile(log_state.log_file);
     fprintf(log_state.log_file, "[WARN] ");
 
     va_list args;
@@ -180,6 +188,7 @@ void log_warn(const char *format, ...) {
 
     fprintf(log_state.log_file, "\n");
     fflush(log_state.log_file);
+    funlockfile(log_state.log_file);
 }
 
 void log_error(const char *format, ...) {
@@ -187,6 +196,7 @@ void log_error(const char *format, ...) {
         return;
     }
 
+    flockfile(log_state.log_file);
     fprintf(log_state.log_file, "[ERROR] ");
 
     va_list args;
@@ -196,6 +206,7 @@ void log_error(const char *format, ...) {
 
     fprintf(log_state.log_file, "\n");
     fflush(log_state.log_file);
+    funlockfile(log_state.log_file);
 }
 
 void log_shutdown(void) {
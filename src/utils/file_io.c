@@ -4,6 +4,7 @@
 #include <string.h>
 #include <dirent.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 /* Read entire file to string */
 char *read_file_to_string(const char *filename) {
@@ -59,6 +60,39 @@ bool write_string_to_file(const char *filename, const char *content) {
     return written == len;
 }
 
+/* Write string to file atomically: readers see the old file or the whole
+ * new one, never a partial write. The content goes to a temporary file in
+ * the same directory, which is synced and renamed over the target. */
+bool write_string_to_file_atomic(const char *filename, const char *content) {
+    if (!filename || !content) {
+        return false;
+    }
+
+    size_t path_len = strlen(filename) + 32;
+    char *tmp_path = malloc(path_len);
+    if (!tmp_path) {
+        return false;
+    }
+    snprintf(tmp_path, path_len, "%s.tmp.%ld", filename, (long)getpid());
+
+    FILE *file = fopen(tmp_path, "w");
+    if (!file) {
+        free(tmp_path);
+        return false;
+    }
+
+    size_t len = strlen(content);
+    bool ok = fwrite(content, 1, len, file) == len && fflush(file) == 0 &&
+              fsync(fileno(file)) == 0;
+    ok = fclose(file) == 0 && ok;
+    ok = ok && rename(tmp_path, filename) == 0;
+    if (!ok) {
+        unlink(tmp_path);
+    }
+    free(tmp_path);
+    return ok;
+}
+
 /* Check if string ends with suffix */
 static bool str_ends_with(const char *str, const char *suffix) {
     if (!str || !suffix) {
@@ -163,3 +163,13 @@ void hash_table_remove(HashTable *ht, const char *key) {
 int hash_table_size(HashTable *ht) {
     return ht ? ht->size : 0;
 }
+
+/* 64-bit FNV-1a over a byte range */
+uint64_t fnv1a_64(uint64_t hash, const void *data, size_t length) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,273 @@
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/* Reader for flat JSON objects: {"key": "string" | number | true | false | null, ...}.
+ * Enough for line-oriented request protocols; nested values are rejected. */
+
+typedef struct {
+    const char *p;
+    const char *error;
+} JsonReader;
+
+static void skip_ws(JsonReader *r) {
+    while (*r->p == ' ' || *r->p == '\t' || *r->p == '\n' || *r->p == '\r') {
+        r->p++;
+    }
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/* Append a code point as UTF-8 */
+static void append_utf8(StringBuilder *sb, unsigned int cp) {
+    if (cp < 0x80) {
+        sb_append_char(sb, (char)cp);
+    } else if (cp < 0x800) {
+        sb_append_char(sb, (char)(0xC0 | (cp >> 6)));
+        sb_append_char(sb, (char)(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        sb_append_char(sb, (char)(0xE0 | (cp >> 12)));
+        sb_append_char(sb, (char)(0x80 | ((cp >> 6) & 0x3F)));
+        sb_append_char(sb, (char)(0x80 | (cp & 0x3F)));
+    } else {
+        sb_append_char(sb, (char)(0xF0 | (cp >> 18)));
+        sb_append_char(sb, (char)(0x80 | ((cp >> 12) & 0x3F)));
+        sb_append_char(sb, (char)(0x80 | ((cp >> 6) & 0x3F)));
+        sb_append_char(sb, (char)(0x80 | (cp & 0x3F)));
+    }
+}
+
+static bool read_hex4(JsonReader *r, unsigned int *out) {
+    unsigned int value = 0;
+    for (int i = 0; i < 4; i++) {
+        int h = hex_value(r->p[i]);
+        if (h < 0) {
+            r->error = "Invalid \\u escape";
+            return false;
+        }
+        value = (value << 4) | (unsigned int)h;
+    }
+    r->p += 4;
+    *out = value;
+    return true;
+}
+
+/* Read a string literal (r->p at the opening quote) */
+static char *read_string(JsonReader *r) {
+    r->p++;
+    StringBuilder *sb = sb_create();
+
+    while (*r->p && *r->p != '"') {
+        char c = *r->p++;
+        if ((unsigned char)c < 0x20) {
+            r->error = "Control character in string";
+            sb_free(sb);
+            return NULL;
+        }
+        if (c != '\\') {
+            sb_append_char(sb, c);
+            continue;
+        }
+
+        char esc = *r->p++;
+        switch (esc) {
+            case '"': sb_append_char(sb, '"'); break;
+            case '\\': sb_append_char(sb, '\\'); break;
+            case '/': sb_append_char(sb, '/'); break;
+            case 'b': sb_append_char(sb, '\b'); break;
+            case 'f': sb_append_char(sb, '\f'); break;
+            case 'n': sb_append_char(sb, '\n'); break;
+            case 'r': sb_append_char(sb, '\r'); break;
+            case 't': sb_append_char(sb, '\t'); break;
+            case 'u': {
+                unsigned int cp;
+                if (!read_hex4(r, &cp)) {
+                    sb_free(sb);
+                    return NULL;
+                }
+                /* Surrogate pair */
+                if (cp >= 0xD800 && cp <= 0xDBFF && r->p[0] == '\\' && r->p[1] == 'u') {
+                    unsigned int low;
+                    r->p += 2;
+                    if (!read_hex4(r, &low)) {
+                        sb_free(sb);
+                        return NULL;
+                    }
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+                append_utf8(sb, cp);
+                break;
+            }
+            default:
+                r->error = "Invalid escape in string";
+                sb_free(sb);
+                return NULL;
+        }
+    }
+
+    if (*r->p != '"') {
+        r->error = "Unterminated string";
+        sb_free(sb);
+        return NULL;
+    }
+    r->p++;
+
+    char *value = sb_to_string(sb);
+    sb_free(sb);
+    return value;
+}
+
+/* Read a number or literal as raw text */
+static char *read_scalar(JsonReader *r) {
+    const char *start = r->p;
+    while (*r->p && (isalnum((unsigned char)*r->p) || *r->p == '-' || *r->p == '+' ||
+                     *r->p == '.')) {
+        r->p++;
+    }
+
+    size_t len = (size_t)(r->p - start);
+    bool literal = (len == 4 && (strncmp(start, "true", 4) == 0 || strncmp(start, "null", 4) == 0)) ||
+                   (len == 5 && strncmp(start, "false", 5) == 0);
+    bool number = len > 0 && (isdigit((unsigned char)start[0]) || start[0] == '-');
+    if (!literal && !number) {
+        r->error = (*start == '{' || *start == '[') ? "Nested values are not supported"
+                                                   : "Invalid value";
+        return NULL;
+    }
+    return strndup(start, len);
+}
+
+/* Parse a flat JSON object; on failure returns NULL and sets *error */
+JsonObject *json_parse_object(const char *text, const char **error) {
+    JsonReader r = {text ? text : "", NULL};
+    JsonObject *obj = calloc(1, sizeof(JsonObject));
+    if (!obj) {
+        if (error) *error = "Out of memory";
+        return NULL;
+    }
+
+    skip_ws(&r);
+    if (*r.p != '{') {
+        r.error = "Expected '{'";
+        goto fail;
+    }
+    r.p++;
+    skip_ws(&r);
+
+    if (*r.p == '}') {
+        r.p++;
+    } else {
+        while (true) {
+            skip_ws(&r);
+            if (*r.p != '"') {
+                r.error = "Expected string key";
+                goto fail;
+            }
+            char *key = read_string(&r);
+            if (!key) {
+                goto fail;
+            }
+
+            skip_ws(&r);
+            if (*r.p != ':') {
+                free(key);
+                r.error = "Expected ':'";
+                goto fail;
+            }
+            r.p++;
+            skip_ws(&r);
+
+            bool is_string = *r.p == '"';
+            char *value = is_string ? read_string(&r) : read_scalar(&r);
+            if (!value) {
+                free(key);
+                goto fail;
+            }
+
+            JsonField *fields = realloc(obj->fields, sizeof(JsonField) * (obj->count + 1));
+            if (!fields) {
+                free(key);
+                free(value);
+                r.error = "Out of memory";
+                goto fail;
+            }
+            obj->fields = fields;
+            obj->fields[obj->count].key = key;
+            obj->fields[obj->count].value = value;
+            obj->fields[obj->count].is_string = is_string;
+            obj->count++;
+
+            skip_ws(&r);
+            if (*r.p == ',') {
+                r.p++;
+                continue;
+            }
+            if (*r.p == '}') {
+                r.p++;
+                break;
+            }
+            r.error = "Expected ',' or '}'";
+            goto fail;
+        }
+    }
+
+    skip_ws(&r);
+    if (*r.p != '\0') {
+        r.error = "Trailing characters after object";
+        goto fail;
+    }
+    return obj;
+
+fail:
+    if (error) {
+        *error = r.error;
+    }
+    json_object_free(obj);
+    return NULL;
+}
+
+/* Look up a field */
+const JsonField *json_object_get(const JsonObject *obj, const char *key) {
+    for (int i = 0; obj && i < obj->count; i++) {
+        if (strcmp(obj->fields[i].key, key) == 0) {
+            return &obj->fields[i];
+        }
+    }
+    return NULL;
+}
+
+/* Look up a string field */
+const char *json_object_get_string(const JsonObject *obj, const char *key) {
+    const JsonField *field = json_object_get(obj, key);
+    return field && field->is_string ? field->value : NULL;
+}
+
+/* Append a field's value as JSON (re-escaping strings) */
+void sb_append_json_value(StringBuilder *sb, const JsonField *field) {
+    if (!field) {
+        sb_append(sb, "null");
+    } else if (field->is_string) {
+        sb_append_json_string(sb, field->value);
+    } else {
+        sb_append(sb, field->value);
+    }
+}
+
+/* Free a parsed object */
+void json_object_free(JsonObject *obj) {
+    if (!obj) {
+        return;
+    }
+    for (int i = 0; i < obj->count; i++) {
+        free(obj->fields[i].key);
+        free(obj->fields[i].value);
+    }
+    free(obj->fields);
+    free(obj);
+}
@@ -11,7 +11,7 @@ char *str_trim(const char *str) {
     }
 
     /* Skip leading whitespace */
-    while (isspace(*str)) {
+    while (isspace((unsigned char)*str)) {
         str++;
     }
 
@@ -21,7 +21,7 @@ char *str_trim(const char *str) {
 
     /* Find end of string */
     const char *end = str + strlen(str) - 1;
-    while (end > str && isspace(*end)) {
+    while (end > str && isspace((unsigned char)*end)) {
         end--;
     }
 
@@ -51,7 +51,7 @@ char *str_remove_whitespace(const char *str) {
 
     char *dst = result;
     for (const char *src = str; *src; src++) {
-        if (!isspace(*src)) {
+        if (!isspace((unsigned char)*src)) {
             *dst++ = *src;
         }
     }
@@ -73,7 +73,7 @@ char *str_to_upper(const char *str) {
     }
 
     for (size_t i = 0; i < len; i++) {
-        upper[i] = toupper(str[i]);
+        upper[i] = toupper((unsigned char)str[i]);
     }
     upper[len] = '\0';
 
@@ -93,7 +93,7 @@ char *str_to_lower(const char *str) {
     }
 
     for (size_t i = 0; i < len; i++) {
-        lower[i] = tolower(str[i]);
+        lower[i] = tolower((unsigned char)str[i]);
     }
     lower[len] = '\0';
 
@@ -107,7 +107,7 @@ bool str_equals_ignore_case(const char *s1, const char *s2) {
     }
 
     while (*s1 && *s2) {
-        if (tolower(*s1) != tolower(*s2)) {
+        if (tolower((unsigned char)*s1) != tolower((unsigned char)*s2)) {
             return false;
         }
         s1++;
@@ -297,6 +297,37 @@ void sb_append_fmt(StringBuilder *sb, const char *format, ...) {
     va_end(args);
 }
 
+/* Append a JSON string literal (quoted and escaped) */
+void sb_append_json_string(StringBuilder *sb, const char *str) {
+    if (!sb) {
+        return;
+    }
+
+    if (!str) {
+        sb_append(sb, "null");
+        return;
+    }
+
+    sb_append_char(sb, '"');
+    for (const unsigned char *p = (const unsigned char *)str; *p; p++) {
+        switch (*p) {
+            case '"': sb_append(sb, "\\\""); break;
+            case '\\': sb_append(sb, "\\\\"); break;
+            case '\n': sb_append(sb, "\\n"); break;
+            case '\r': sb_append(sb, "\\r"); break;
+            case '\t': sb_append(sb, "\\t"); break;
+            default:
+                if (*p < 0x20) {
+                    sb_append_fmt(sb, "\\u%04x", *p);
+                } else {
+                    sb_append_char(sb, (char)*p);
+                }
+                break;
+        }
+    }
+    sb_append_char(sb, '"');
+}
+
 char *sb_to_string(StringBuilder *sb) {
     if (!sb) {
         return NULL;
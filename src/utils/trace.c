@@ -0,0 +1,382 @@
+#include "trace.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdatomic.h>
+
+#define TRACE_MAX_DEPTH 64
+
+/* Recorded span */
+typedef struct {
+    const char *name;
+    char *detail;
+    TracePhase phase;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    int tid;
+    int depth;
+} TraceEvent;
+
+bool g_trace_enabled = false;
+
+static struct {
+    TraceEvent *events;
+    int count;
+    int capacity;
+    uint64_t origin_ns;
+    bool record_events;     /* false: phase totals and counters only */
+    atomic_flag lock;
+    atomic_int next_tid;
+} trace_state = {NULL, 0, 0, 0, false, ATOMIC_FLAG_INIT, 1};
+
+static atomic_llong trace_counters[TRACE_COUNTER_COUNT];
+
+/* Phase totals, added to as spans end */
+static struct {
+    atomic_ullong total_ns;
+    atomic_ullong max_ns;
+    atomic_int span_count;
+} phase_totals[TRACE_PHASE_COUNT];
+
+/* Per-thread stack of open spans, used for nesting and phase accounting */
+static _Thread_local int tls_tid = 0;
+static _Thread_local int tls_depth = 0;
+static _Thread_local TracePhase tls_phase_stack[TRACE_MAX_DEPTH];
+static _Thread_local int tls_span_stack[TRACE_MAX_DEPTH];
+static _Thread_local uint64_t tls_start_stack[TRACE_MAX_DEPTH];
+static _Thread_local bool tls_counts_stack[TRACE_MAX_DEPTH];
+
+static void trace_lock(void) {
+    while (atomic_flag_test_and_set_explicit(&trace_state.lock, memory_order_acquire)) {
+        /* spin - critical sections are a few stores long */
+    }
+}
+
+static void trace_unlock(void) {
+    atomic_flag_clear_explicit(&trace_state.lock, memory_order_release);
+}
+
+/* Monotonic clock in nanoseconds */
+uint64_t trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Enable tracing and start the trace clock */
+void trace_init(void) {
+    trace_reset();
+    trace_state.origin_ns = trace_now_ns();
+    trace_state.record_events = true;
+    g_trace_enabled = true;
+}
+
+/* Enable phase totals and counters without recording spans: memory stays
+ * constant however many spans a run opens */
+void trace_init_stats(void) {
+    trace_reset();
+    trace_state.origin_ns = trace_now_ns();
+    trace_state.record_events = false;
+    g_trace_enabled = true;
+}
+
+/* Drop all recorded events (tracing stays enabled if it was) */
+void trace_reset(void) {
+    trace_lock();
+    for (int i = 0; i < trace_state.count; i++) {
+        free(trace_state.events[i].detail);
+    }
+    trace_state.count = 0;
+    trace_state.origin_ns = trace_now_ns();
+    trace_unlock();
+    for (int i = 0; i < TRACE_COUNTER_COUNT; i++) {
+        atomic_store(&trace_counters[i], 0);
+    }
+    for (int i = 0; i < TRACE_PHASE_COUNT; i++) {
+        atomic_store(&phase_totals[i].total_ns, 0);
+        atomic_store(&phase_totals[i].max_ns, 0);
+        atomic_store(&phase_totals[i].span_count, 0);
+    }
+    tls_depth = 0;
+}
+
+/* Disable tracing and release all events */
+void trace_shutdown(void) {
+    g_trace_enabled = false;
+    trace_reset();
+    trace_lock();
+    free(trace_state.events);
+    trace_state.events = NULL;
+    trace_state.capacity = 0;
+    trace_unlock();
+}
+
+/* Append a span to the recorded events; returns its index or -1 */
+static int record_event(TracePhase phase, const char *name, const char *detail) {
+    char *detail_copy = detail ? strdup(detail) : NULL;
+
+    trace_lock();
+    if (trace_state.count >= trace_state.capacity) {
+        int new_capacity = trace_state.capacity ? trace_state.capacity * 2 : 256;
+        TraceEvent *new_events = realloc(trace_state.events, sizeof(TraceEvent) * new_capacity);
+        if (!new_events) {
+            trace_unlock();
+            free(detail_copy);
+            return -1;
+        }
+        trace_state.events = new_events;
+        trace_state.capacity = new_capacity;
+    }
+
+    int span = trace_state.count++;
+    TraceEvent *ev = &trace_state.events[span];
+    ev->name = name;
+    ev->detail = detail_copy;
+    ev->phase = phase;
+    ev->tid = tls_tid;
+    ev->depth = tls_depth;
+    ev->end_ns = 0;
+    ev->start_ns = trace_now_ns();
+    trace_unlock();
+    return span;
+}
+
+/* Begin a span */
+int trace_span_begin(TracePhase phase, const char *name, const char *detail) {
+    if (!g_trace_enabled || tls_depth >= TRACE_MAX_DEPTH) {
+        return -1;
+    }
+
+    if (tls_tid == 0) {
+        tls_tid = atomic_fetch_add(&trace_state.next_tid, 1);
+    }
+
+    bool counts = true;
+    for (int i = 0; i < tls_depth; i++) {
+        if (tls_phase_stack[i] == phase) {
+            counts = false;
+            break;
+        }
+    }
+
+    int span = tls_depth;
+    if (trace_state.record_events) {
+        span = record_event(phase, name, detail);
+        if (span < 0) {
+            return -1;
+        }
+    }
+
+    tls_phase_stack[tls_depth] = phase;
+    tls_span_stack[tls_depth] = span;
+    tls_counts_stack[tls_depth] = counts;
+    tls_start_stack[tls_depth] = trace_now_ns();
+    tls_depth++;
+
+    return span;
+}
+
+/* Add a closed span's duration to its phase totals */
+static void add_to_phase(TracePhase phase, uint64_t duration_ns) {
+    atomic_fetch_add(&phase_totals[phase].total_ns, duration_ns);
+    atomic_fetch_add(&phase_totals[phase].span_count, 1);
+    unsigned long long max = atomic_load(&phase_totals[phase].max_ns);
+    while (duration_ns > max &&
+           !atomic_compare_exchange_weak(&phase_totals[phase].max_ns, &max, duration_ns)) {
+        /* max reloaded by the failed exchange */
+    }
+}
+
+/* End a span (also closes any inner spans left open on this thread) */
+void trace_span_end(int span) {
+    if (span < 0) {
+        return;
+    }
+
+    uint64_t now = trace_now_ns();
+
+    if (trace_state.record_events) {
+        trace_lock();
+        if (span < trace_state.count && trace_state.events[span].end_ns == 0) {
+            trace_state.events[span].end_ns = now;
+        }
+        trace_unlock();
+    }
+
+    while (tls_depth > 0) {
+        tls_depth--;
+        if (tls_span_stack[tls_depth] == span) {
+            if (tls_counts_stack[tls_depth]) {
+                add_to_phase(tls_phase_stack[tls_depth], now - tls_start_stack[tls_depth]);
+            }
+            break;
+        }
+    }
+}
+
+/* Number of recorded spans */
+int trace_event_count(void) {
+    trace_lock();
+    int count = trace_state.count;
+    trace_unlock();
+    return count;
+}
+
+/* Totals of the closed spans of one phase */
+void trace_get_phase_stats(TracePhase phase, TracePhaseStats *stats) {
+    if (!stats) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    if (phase < 0 || phase >= TRACE_PHASE_COUNT) {
+        return;
+    }
+    stats->total_ns = atomic_load(&phase_totals[phase].total_ns);
+    stats->max_ns = atomic_load(&phase_totals[phase].max_ns);
+    stats->span_count = atomic_load(&phase_totals[phase].span_count);
+}
+
+/* Phase display name */
+const char *trace_phase_name(TracePhase phase) {
+    switch (phase) {
+        case TRACE_PHASE_READ: return "read";
+        case TRACE_PHASE_CONNECT: return "connect";
+        case TRACE_PHASE_INTROSPECT: return "introspect";
+        case TRACE_PHASE_PARSE: return "parse";
+        case TRACE_PHASE_COMPARE: return "compare";
+        case TRACE_PHASE_SQLGEN: return "sqlgen";
+        case TRACE_PHASE_WRITE: return "write";
+        case TRACE_PHASE_OTHER: return "other";
+        default: return "unknown";
+    }
+}
+
+/* Add to a counter */
+void trace_counter_add(TraceCounter counter, int64_t delta) {
+    if (counter >= 0 && counter < TRACE_COUNTER_COUNT) {
+        atomic_fetch_add(&trace_counters[counter], delta);
+    }
+}
+
+int64_t trace_counter_get(TraceCounter counter) {
+    if (counter < 0 || counter >= TRACE_COUNTER_COUNT) {
+        return 0;
+    }
+    return atomic_load(&trace_counters[counter]);
+}
+
+const char *trace_counter_name(TraceCounter counter) {
+    switch (counter) {
+        case TRACE_COUNTER_CATALOG_PLANS: return "catalog plans";
+        case TRACE_COUNTER_CATALOG_EXECUTIONS: return "catalog queries";
+        case TRACE_COUNTER_CATALOG_BYTES: return "catalog bytes";
+        default: return "unknown";
+    }
+}
+
+/* Build Chrome/Perfetto trace-event JSON */
+char *trace_to_chrome_json(void) {
+    StringBuilder *sb = sb_create();
+    if (!sb) {
+        return NULL;
+    }
+
+    int pid = (int)getpid();
+
+    sb_append(sb, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    trace_lock();
+    uint64_t now = trace_now_ns();
+    for (int i = 0; i < trace_state.count; i++) {
+        const TraceEvent *ev = &trace_state.events[i];
+        uint64_t end = ev->end_ns ? ev->end_ns : now;
+
+        if (i > 0) {
+            sb_append_char(sb, ',');
+        }
+        sb_append(sb, "\n{\"name\":");
+        sb_append_json_string(sb, ev->name);
+        sb_append_fmt(sb, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d",
+                      trace_phase_name(ev->phase),
+                      (double)(ev->start_ns - trace_state.origin_ns) / 1000.0,
+                      (double)(end - ev->start_ns) / 1000.0,
+                      pid, ev->tid);
+        if (ev->detail) {
+            sb_append(sb, ",\"args\":{\"detail\":");
+            sb_append_json_string(sb, ev->detail);
+            sb_append_char(sb, '}');
+        }
+        sb_append_char(sb, '}');
+    }
+    trace_unlock();
+
+    sb_append(sb, "\n]}\n");
+
+    char *json = sb_to_string(sb);
+    sb_free(sb);
+    return json;
+}
+
+/* Write Chrome trace JSON to file */
+bool trace_write_chrome_json(const char *filename) {
+    if (!filename) {
+        return false;
+    }
+
+    char *json = trace_to_chrome_json();
+    if (!json) {
+        return false;
+    }
+
+    bool ok = write_string_to_file(filename, json);
+    free(json);
+    return ok;
+}
+
+/* Format per-phase summary table */
+char *trace_format_timings(void) {
+    StringBuilder *sb = sb_create();
+    if (!sb) {
+        return NULL;
+    }
+
+    trace_lock();
+    uint64_t wall_ns = trace_now_ns() - trace_state.origin_ns;
+    trace_unlock();
+
+    sb_append(sb, "\n=== Timings ===\n");
+    sb_append_fmt(sb, "%-12s %8s %12s %12s %12s %7s\n",
+                  "Phase", "Spans", "Total ms", "Mean ms", "Max ms", "Wall %");
+
+    for (int p = 0; p < TRACE_PHASE_COUNT; p++) {
+        TracePhaseStats stats;
+        trace_get_phase_stats((TracePhase)p, &stats);
+        if (stats.span_count == 0) {
+            continue;
+        }
+
+        double total_ms = (double)stats.total_ns / 1e6;
+        double share = wall_ns ? 100.0 * (double)stats.total_ns / (double)wall_ns : 0.0;
+        sb_append_fmt(sb, "%-12s %8d %12.3f %12.3f %12.3f %6.1f%%\n",
+                      trace_phase_name((TracePhase)p), stats.span_count,
+                      total_ms, total_ms / stats.span_count,
+                      (double)stats.max_ns / 1e6, share);
+    }
+
+    sb_append_fmt(sb, "%-12s %8s %12.3f\n", "wall", "", (double)wall_ns / 1e6);
+
+    for (int c = 0; c < TRACE_COUNTER_COUNT; c++) {
+        int64_t value = trace_counter_get((TraceCounter)c);
+        if (value != 0) {
+            sb_append_fmt(sb, "%-20s %lld\n", trace_counter_name((TraceCounter)c), (long long)value);
+        }
+    }
+
+    char *result = sb_to_string(sb);
+    sb_free(sb);
+    return result;
+}
@@ -0,0 +1,104 @@
+#include "utils.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/* Length of the ASCII run at the start of data. DDL is almost all ASCII, so
+ * this is where validation spends its time: 16 bytes per step with SSE2
+ * (NEON on arm64), 8 bytes per step on other targets. */
+static size_t ascii_prefix(const unsigned char *data, size_t length) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(data + i));
+        int mask = _mm_movemask_epi8(chunk);
+        if (mask != 0) {
+            return i + (size_t)__builtin_ctz((unsigned)mask);
+        }
+    }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    for (; i + 16 <= length; i += 16) {
+        if (vmaxvq_u8(vld1q_u8(data + i)) >= 0x80) {
+            break;
+        }
+    }
+#else
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        if (word & 0x8080808080808080ULL) {
+            break;
+        }
+    }
+#endif
+    while (i < length && data[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+/* Length of the well-formed multibyte sequence at data (Unicode 3.9,
+ * table 3-7: no overlongs, surrogates or code points past U+10FFFF), or 0 */
+static size_t multibyte_length(const unsigned char *data, size_t length) {
+    unsigned char lead = data[0];
+    unsigned char min = 0x80, max = 0xBF;
+    size_t len;
+
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        len = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        len = 3;
+        if (lead == 0xE0) {
+            min = 0xA0;
+        } else if (lead == 0xED) {
+            max = 0x9F;
+        }
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        len = 4;
+        if (lead == 0xF0) {
+            min = 0x90;
+        } else if (lead == 0xF4) {
+            max = 0x8F;
+        }
+    } else {
+        return 0;
+    }
+
+    if (len > length || data[1] < min || data[1] > max) {
+        return 0;
+    }
+    for (size_t i = 2; i < len; i++) {
+        if (data[i] < 0x80 || data[i] > 0xBF) {
+            return 0;
+        }
+    }
+    return len;
+}
+
+/* Validate UTF-8. On failure, error_offset (if non-NULL) receives the byte
+ * offset of the first invalid sequence. */
+bool utf8_validate(const char *data, size_t length, size_t *error_offset) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t i = 0;
+
+    while (i < length) {
+        i += ascii_prefix(bytes + i, length - i);
+        if (i >= length) {
+            break;
+        }
+        size_t len = multibyte_length(bytes + i, length - i);
+        if (len == 0) {
+            if (error_offset) {
+                *error_offset = i;
+            }
+            return false;
+        }
+        i += len;
+    }
+    return true;
+}
@@ -0,0 +1,646 @@
+#include "watch.h"
+#include "utils.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+/* Events settle for this long before a batch of changes is applied, so an
+ * editor's write-rename-chmod sequence becomes one update */
+#define WATCH_SETTLE_MS 30
+#define WATCH_SETTLE_MAX_MS 250
+
+/* One parsed source file */
+typedef struct {
+    char *path;
+    Schema *schema;
+} WatchFile;
+
+/* Watched directory */
+typedef struct {
+    int wd;
+    char *path;
+} WatchDir;
+
+struct WatchSession {
+    char *root;
+    const CompareOptions *opts;
+    const Schema *current;
+    HashTable *current_tables;   /* name -> current CreateTableStmt */
+
+    WatchFile *files;
+    int file_count;
+    int file_capacity;
+    HashTable *source_tables;    /* name -> source CreateTableStmt, rebuilt on change */
+    bool source_stale;
+
+    HashTable *diffs;            /* name -> TableDiff, changed tables only */
+    char **dirty;                /* names to compare again */
+    int dirty_count;
+    int dirty_capacity;
+    SchemaDiff *view;            /* diffs linked in report order */
+
+    int inotify_fd;
+    WatchDir *dirs;
+    int dir_count;
+
+    WatchStats stats;
+    int pending_files;           /* files parsed since the last diff */
+    uint64_t pending_ns;         /* parse time since the last diff */
+};
+
+static bool has_sql_extension(const char *name) {
+    size_t len = strlen(name);
+    return len > 4 && strcmp(name + len - 4, ".sql") == 0;
+}
+
+static void mark_dirty(WatchSession *session, const char *name) {
+    if (session->dirty_count >= session->dirty_capacity) {
+        int capacity = session->dirty_capacity ? session->dirty_capacity * 2 : 64;
+        char **dirty = realloc(session->dirty, sizeof(char *) * capacity);
+        if (!dirty) {
+            return;
+        }
+        session->dirty = dirty;
+        session->dirty_capacity = capacity;
+    }
+    char *copy = strdup(name);
+    if (copy) {
+        session->dirty[session->dirty_count++] = copy;
+    }
+}
+
+/* Drop cached diffs for a schema's tables; they point into statements that
+ * are about to be replaced or freed */
+static void drop_cached_diffs(WatchSession *session, const Schema *schema) {
+    for (int i = 0; schema && i < schema->table_count; i++) {
+        const char *name = schema->tables[i]->table_name;
+        TableDiff *diff = name ? hash_table_get(session->diffs, name) : NULL;
+        if (diff) {
+            hash_table_remove(session->diffs, name);
+            table_diff_free(diff);
+        }
+    }
+}
+
+/* Queue a schema's tables for comparison */
+static void invalidate_tables(WatchSession *session, const Schema *schema) {
+    drop_cached_diffs(session, schema);
+    for (int i = 0; schema && i < schema->table_count; i++) {
+        if (schema->tables[i]->table_name) {
+            mark_dirty(session, schema->tables[i]->table_name);
+        }
+    }
+}
+
+static int find_file(const WatchSession *session, const char *path) {
+    for (int i = 0; i < session->file_count; i++) {
+        if (strcmp(session->files[i].path, path) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Re-parse one file, or drop it if it no longer exists */
+bool watch_session_update_file(WatchSession *session, const char *path) {
+    if (!session || !path) {
+        return false;
+    }
+
+    uint64_t start = trace_now_ns();
+    int index = find_file(session, path);
+
+    struct stat st;
+    bool exists = stat(path, &st) == 0 && S_ISREG(st.st_mode);
+    Schema *schema = NULL;
+    if (exists) {
+        schema = load_from_file(path, NULL);
+        if (!schema) {
+            /* Usually a half-written file; keep the last good parse */
+            log_warn("Failed to parse %s; keeping previous version", path);
+            return false;
+        }
+    } else if (index < 0) {
+        return false;
+    }
+
+    if (index >= 0) {
+        invalidate_tables(session, session->files[index].schema);
+        schema_free(session->files[index].schema);
+        session->files[index].schema = NULL;
+    }
+
+    if (!exists) {
+        free(session->files[index].path);
+        session->files[index] = session->files[--session->file_count];
+    } else {
+        if (index < 0) {
+            if (session->file_count >= session->file_capacity) {
+                int capacity = session->file_capacity ? session->file_capacity * 2 : 64;
+                WatchFile *files = realloc(session->files, sizeof(WatchFile) * capacity);
+                if (!files) {
+                    schema_free(schema);
+                    return false;
+                }
+                session->files = files;
+                session->file_capacity = capacity;
+            }
+            index = session->file_count++;
+            session->files[index].path = strdup(path);
+        }
+        session->files[index].schema = schema;
+        invalidate_tables(session, schema);
+    }
+
+    session->source_stale = true;
+    session->pending_files++;
+    session->pending_ns += trace_now_ns() - start;
+    return true;
+}
+
+/* Map source table names to statements; the first definition wins, as when
+ * a table is defined twice in one directory load */
+static void rebuild_source_tables(WatchSession *session) {
+    int table_count = 0;
+    for (int i = 0; i < session->file_count; i++) {
+        table_count += session->files[i].schema->table_count;
+    }
+
+    hash_table_destroy(session->source_tables);
+    session->source_tables = hash_table_create(table_count * 2 + 16);
+    for (int i = 0; i < session->file_count; i++) {
+        const Schema *schema = session->files[i].schema;
+        for (int j = 0; j < schema->table_count; j++) {
+            const char *name = schema->tables[j]->table_name;
+            if (name && !hash_table_contains(session->source_tables, name)) {
+                hash_table_insert(session->source_tables, name, schema->tables[j]);
+            }
+        }
+    }
+
+    session->stats.file_count = session->file_count;
+    session->stats.table_count = table_count;
+    session->source_stale = false;
+}
+
+/* Link a cached diff into the view and add up its counts */
+static void view_append(SchemaDiff *view, TableDiff **last, TableDiff *diff) {
+    diff->next = NULL;
+    if (*last) {
+        (*last)->next = diff;
+    } else {
+        view->table_diffs = diff;
+    }
+    *last = diff;
+
+    if (diff->table_added) {
+        view->tables_added++;
+    } else if (diff->table_removed) {
+        view->tables_removed++;
+    } else {
+        view->tables_modified++;
+        view->total_diffs += diff->diff_count;
+    }
+
+    for (Diff *d = diff->diffs; d; d = d->next) {
+        switch (d->severity) {
+            case SEVERITY_CRITICAL:
+                view->critical_count++;
+                break;
+            case SEVERITY_WARNING:
+                view->warning_count++;
+                break;
+            case SEVERITY_INFO:
+                view->info_count++;
+                break;
+        }
+    }
+}
+
+/* Types and indexes are few and cheap to compare, so they are diffed in
+ * full on every update rather than cached per name */
+static void compare_view_types_and_indexes(WatchSession *session) {
+    Schema desired = {0};
+    for (int i = 0; i < session->file_count; i++) {
+        desired.type_count += session->files[i].schema->type_count;
+        desired.table_count += session->files[i].schema->table_count;
+        desired.index_count += session->files[i].schema->index_count;
+    }
+    if (desired.type_count == 0 && session->current->type_count == 0 &&
+        desired.index_count == 0 && session->current->index_count == 0) {
+        return;
+    }
+
+    desired.types = malloc(sizeof(CreateTypeStmt *) * (desired.type_count + 1));
+    desired.tables = malloc(sizeof(CreateTableStmt *) * (desired.table_count + 1));
+    desired.indexes = malloc(sizeof(CreateIndexStmt *) * (desired.index_count + 1));
+    if (desired.types && desired.tables && desired.indexes) {
+        int types = 0, tables = 0, indexes = 0;
+        for (int i = 0; i < session->file_count; i++) {
+            const Schema *schema = session->files[i].schema;
+            for (int j = 0; j < schema->type_count; j++) {
+                desired.types[types++] = schema->types[j];
+            }
+            for (int j = 0; j < schema->table_count; j++) {
+                desired.tables[tables++] = schema->tables[j];
+            }
+            for (int j = 0; j < schema->index_count; j++) {
+                desired.indexes[indexes++] = schema->indexes[j];
+            }
+        }
+        compare_all_types(session->current, &desired, session->view, session->opts, NULL);
+        compare_all_indexes(session->current, &desired, session->view, session->opts, NULL);
+    }
+    free(desired.types);
+    free(desired.tables);
+    free(desired.indexes);
+}
+
+/* Rebuild the view in compare_schemas order: source tables as listed,
+ * then tables only present in the target */
+static void rebuild_view(WatchSession *session) {
+    if (session->view) {
+        session->view->table_diffs = NULL;  /* owned by session->diffs */
+        schema_diff_free(session->view);
+    }
+    session->view = schema_diff_create("public");
+    if (!session->view) {
+        return;
+    }
+
+    TableDiff *last = NULL;
+    for (int i = 0; i < session->file_count; i++) {
+        const Schema *schema = session->files[i].schema;
+        for (int j = 0; j < schema->table_count; j++) {
+            const CreateTableStmt *table = schema->tables[j];
+            if (!table->table_name ||
+                hash_table_get(session->source_tables, table->table_name) != table) {
+                continue;
+            }
+            TableDiff *diff = hash_table_get(session->diffs, table->table_name);
+            if (diff) {
+                view_append(session->view, &last, diff);
+            }
+        }
+    }
+
+    for (int i = 0; i < session->current->table_count; i++) {
+        const char *name = session->current->tables[i]->table_name;
+        if (name && !hash_table_contains(session->source_tables, name)) {
+            TableDiff *diff = hash_table_get(session->diffs, name);
+            if (diff) {
+                view_append(session->view, &last, diff);
+            }
+        }
+    }
+    schema_diff_index_tables(session->view);
+
+    compare_view_types_and_indexes(session);
+}
+
+/* Re-compare dirty tables and return the full diff */
+const SchemaDiff *watch_session_diff(WatchSession *session) {
+    if (!session) {
+        return NULL;
+    }
+
+    uint64_t start = trace_now_ns();
+    if (session->source_stale || !session->source_tables) {
+        rebuild_source_tables(session);
+    }
+
+    int recompared = 0;
+    HashTable *seen = hash_table_create(session->dirty_count * 2 + 16);
+    for (int i = 0; i < session->dirty_count; i++) {
+        const char *name = session->dirty[i];
+        if (seen && !hash_table_contains(seen, name)) {
+            hash_table_insert(seen, name, NULL);
+
+            TableDiff *cached = hash_table_get(session->diffs, name);
+            if (cached) {
+                hash_table_remove(session->diffs, name);
+                table_diff_free(cached);
+            }
+
+            if (should_compare_table(name, session->opts)) {
+                /* Current state is the "source" side, as in the CLI */
+                CreateTableStmt *current = hash_table_get(session->current_tables, name);
+                CreateTableStmt *desired = hash_table_get(session->source_tables, name);
+                int span = TRACE_BEGIN(TRACE_PHASE_COMPARE, "compare_tables", name);
+                TableDiff *diff = compare_table_pair(current, desired, session->opts, NULL);
+                TRACE_END(span);
+                if (diff) {
+                    hash_table_insert(session->diffs, name, diff);
+                }
+                recompared++;
+            }
+        }
+        free(session->dirty[i]);
+    }
+    hash_table_destroy(seen);
+    session->dirty_count = 0;
+
+    rebuild_view(session);
+
+    session->stats.files_reparsed = session->pending_files;
+    session->stats.tables_recompared = recompared;
+    session->stats.update_ms = (double)(session->pending_ns + trace_now_ns() - start) / 1e6;
+    session->pending_files = 0;
+    session->pending_ns = 0;
+    return session->view;
+}
+
+void watch_session_get_stats(const WatchSession *session, WatchStats *stats) {
+    if (session && stats) {
+        *stats = session->stats;
+    }
+}
+
+#ifdef __linux__
+#define WATCH_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE)
+
+/* Watch dir and all of its subdirectories */
+static void watch_add_tree(WatchSession *session, const char *dir) {
+    int wd = inotify_add_watch(session->inotify_fd, dir, WATCH_EVENTS | IN_ONLYDIR);
+    if (wd < 0) {
+        log_warn("Cannot watch %s: %s", dir, strerror(errno));
+        return;
+    }
+
+    bool known = false;
+    for (int i = 0; i < session->dir_count && !known; i++) {
+        known = session->dirs[i].wd == wd;
+    }
+    if (!known) {
+        WatchDir *dirs = realloc(session->dirs, sizeof(WatchDir) * (session->dir_count + 1));
+        if (!dirs) {
+            return;
+        }
+        session->dirs = dirs;
+        session->dirs[session->dir_count].wd = wd;
+        session->dirs[session->dir_count].path = strdup(dir);
+        session->dir_count++;
+    }
+
+    DIR *handle = opendir(dir);
+    if (!handle) {
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(handle)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        struct stat st;
+        if (stat(path, &st) == 0 && S_ISDIR(st.st_mode)) {
+            watch_add_tree(session, path);
+        }
+    }
+    closedir(handle);
+}
+
+static const char *watch_dir_path(const WatchSession *session, int wd) {
+    for (int i = 0; i < session->dir_count; i++) {
+        if (session->dirs[i].wd == wd) {
+            return session->dirs[i].path;
+        }
+    }
+    return NULL;
+}
+
+/* Add path to the batch unless it is already there */
+static void batch_add(char ***paths, int *count, const char *path) {
+    for (int i = 0; i < *count; i++) {
+        if (strcmp((*paths)[i], path) == 0) {
+            return;
+        }
+    }
+    char **grown = realloc(*paths, sizeof(char *) * (*count + 1));
+    if (!grown) {
+        return;
+    }
+    *paths = grown;
+    (*paths)[(*count)++] = strdup(path);
+}
+
+/* Turn pending inotify events into a batch of file paths */
+static bool read_events(WatchSession *session, char ***paths, int *count) {
+    char buffer[16384] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t length = read(session->inotify_fd, buffer, sizeof(buffer));
+    if (length < 0) {
+        return errno == EAGAIN || errno == EINTR;
+    }
+
+    for (char *p = buffer; p < buffer + length;) {
+        struct inotify_event *event = (struct inotify_event *)p;
+        p += sizeof(struct inotify_event) + event->len;
+
+        if (event->mask & IN_Q_OVERFLOW) {
+            log_warn("inotify queue overflowed; rescanning %s", session->root);
+            int file_count = 0;
+            char **files = find_sql_files_recursive(session->root, &file_count);
+            for (int i = 0; files && i < file_count; i++) {
+                batch_add(paths, count, files[i]);
+                free(files[i]);
+            }
+            free(files);
+            for (int i = 0; i < session->file_count; i++) {
+                batch_add(paths, count, session->files[i].path);
+            }
+            continue;
+        }
+
+        const char *dir = watch_dir_path(session, event->wd);
+        if (!dir || event->len == 0) {
+            continue;
+        }
+
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s", dir, event->name);
+
+        if (event->mask & IN_ISDIR) {
+            /* New directory: watch it and pick up files already inside;
+             * removed directory: drop the files we had from it */
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                watch_add_tree(session, path);
+                int file_count = 0;
+                char **files = find_sql_files_recursive(path, &file_count);
+                for (int i = 0; files && i < file_count; i++) {
+                    batch_add(paths, count, files[i]);
+                    free(files[i]);
+                }
+                free(files);
+            } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                size_t prefix = strlen(path);
+                for (int i = 0; i < session->file_count; i++) {
+                    const char *file = session->files[i].path;
+                    if (strncmp(file, path, prefix) == 0 && file[prefix] == '/') {
+                        batch_add(paths, count, file);
+                    }
+                }
+            }
+        } else if (has_sql_extension(event->name) && !(event->mask & IN_CREATE)) {
+            /* IN_CREATE is followed by IN_CLOSE_WRITE once the file is written */
+            batch_add(paths, count, path);
+        }
+    }
+    return true;
+}
+
+/* Wait for changes and apply them */
+int watch_session_poll(WatchSession *session, int timeout_ms) {
+    if (!session || session->inotify_fd < 0) {
+        return -1;
+    }
+
+    struct pollfd pfd = {session->inotify_fd, POLLIN, 0};
+    int ready = poll(&pfd, 1, timeout_ms);
+    if (ready <= 0) {
+        return (ready < 0 && errno != EINTR) ? -1 : 0;
+    }
+
+    char **paths = NULL;
+    int count = 0;
+    uint64_t first = trace_now_ns();
+    do {
+        if (!read_events(session, &paths, &count)) {
+            break;
+        }
+        if ((trace_now_ns() - first) / 1000000 >= WATCH_SETTLE_MAX_MS) {
+            break;
+        }
+    } while (poll(&pfd, 1, WATCH_SETTLE_MS) > 0);
+
+    int updated = 0;
+    for (int i = 0; i < count; i++) {
+        if (paths[i] && watch_session_update_file(session, paths[i])) {
+            updated++;
+        }
+        free(paths[i]);
+    }
+    free(paths);
+    return updated;
+}
+
+static bool watch_start(WatchSession *session) {
+    session->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (session->inotify_fd < 0) {
+        log_error("inotify_init1: %s", strerror(errno));
+        return false;
+    }
+    watch_add_tree(session, session->root);
+    return true;
+}
+#else
+int watch_session_poll(WatchSession *session, int timeout_ms) {
+    (void)session;
+    (void)timeout_ms;
+    return -1;
+}
+
+static bool watch_start(WatchSession *session) {
+    (void)session;
+    log_error("--watch requires inotify (Linux)");
+    return false;
+}
+#endif
+
+/* Parse every .sql file under dir and start watching it */
+WatchSession *watch_session_create(const char *dir, const Schema *current,
+                                   const CompareOptions *opts) {
+    if (!dir || !current) {
+        return NULL;
+    }
+
+    WatchSession *session = calloc(1, sizeof(WatchSession));
+    if (!session) {
+        return NULL;
+    }
+    session->root = strdup(dir);
+    session->opts = opts;
+    session->current = current;
+    session->inotify_fd = -1;
+    session->current_tables = hash_table_create(current->table_count * 2 + 16);
+    session->diffs = hash_table_create(current->table_count * 2 + 64);
+    if (!session->root || !session->current_tables || !session->diffs) {
+        watch_session_destroy(session);
+        return NULL;
+    }
+
+    for (int i = 0; i < current->table_count; i++) {
+        const char *name = current->tables[i]->table_name;
+        if (name) {
+            hash_table_insert(session->current_tables, name, current->tables[i]);
+            mark_dirty(session, name);
+        }
+    }
+
+    /* Start watching before the initial parse so no edit is missed */
+    if (!watch_start(session)) {
+        watch_session_destroy(session);
+        return NULL;
+    }
+
+    int file_count = 0;
+    char **files = find_sql_files_recursive(dir, &file_count);
+    for (int i = 0; files && i < file_count; i++) {
+        watch_session_update_file(session, files[i]);
+        free(files[i]);
+    }
+    free(files);
+    return session;
+}
+
+/* Free the session, its parsed files and cached diffs */
+void watch_session_destroy(WatchSession *session) {
+    if (!session) {
+        return;
+    }
+
+    if (session->view) {
+        session->view->table_diffs = NULL;
+        schema_diff_free(session->view);
+    }
+
+    /* Every cached diff is keyed by a table name in one of the two schemas */
+    for (int i = 0; i < session->file_count; i++) {
+        drop_cached_diffs(session, session->files[i].schema);
+    }
+    drop_cached_diffs(session, session->current);
+    for (int i = 0; i < session->dirty_count; i++) {
+        free(session->dirty[i]);
+    }
+    free(session->dirty);
+
+    for (int i = 0; i < session->file_count; i++) {
+        schema_free(session->files[i].schema);
+        free(session->files[i].path);
+    }
+    free(session->files);
+
+    for (int i = 0; i < session->dir_count; i++) {
+        free(session->dirs[i].path);
+    }
+    free(session->dirs);
+    if (session->inotify_fd >= 0) {
+        close(session->inotify_fd);
+    }
+
+    hash_table_destroy(session->current_tables);
+    hash_table_destroy(session->source_tables);
+    hash_table_destroy(session->diffs);
+    free(session->root);
+    free(session);
+}
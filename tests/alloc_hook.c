@@ -0,0 +1,75 @@
+/* Allocation counting for the test binary
+ *
+ * On glibc the test runner replaces malloc/calloc/realloc/free with thin
+ * wrappers around the __libc_* entry points, so every heap allocation made
+ * by library code (including strdup and friends) is counted. Elsewhere, and
+ * under the sanitizers that own the allocator themselves (address, thread,
+ * memory), counting falls back to the mem_* counters from sc_memory.h.
+ */
+#include "test_framework.h"
+#include "sc_memory.h"
+#include <stdatomic.h>
+
+#ifndef __has_feature
+#define __has_feature(x) 0
+#endif
+
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__) || \
+    __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || \
+    __has_feature(memory_sanitizer)
+#define ALLOC_HOOK_SANITIZER 1
+#endif
+
+#if defined(__GLIBC__) && !defined(ALLOC_HOOK_SANITIZER)
+#define ALLOC_HOOK_INTERPOSE 1
+#endif
+
+#ifdef ALLOC_HOOK_INTERPOSE
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static atomic_size_t hook_allocations;
+
+void *malloc(size_t size) {
+    atomic_fetch_add_explicit(&hook_allocations, 1, memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+    atomic_fetch_add_explicit(&hook_allocations, 1, memory_order_relaxed);
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    atomic_fetch_add_explicit(&hook_allocations, 1, memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+
+bool test_alloc_hook_active(void) {
+    return true;
+}
+
+size_t test_alloc_count(void) {
+    return atomic_load_explicit(&hook_allocations, memory_order_relaxed);
+}
+
+#else
+
+bool test_alloc_hook_active(void) {
+    return false;
+}
+
+size_t test_alloc_count(void) {
+    MemoryCounters counters;
+    memory_counters_get(&counters);
+    return counters.allocations;
+}
+
+#endif
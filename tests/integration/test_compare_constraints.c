@@ -1,9 +1,12 @@
 #include "../test_framework.h"
+#include "test_helpers.h"
 #include "compare.h"
 #include "parser.h"
 #include "pg_create_table.h"
 #include "diff.h"
+#include "schema_compare.h"
 #include "sc_memory.h"
+#include "sql_generator.h"
 #include "utils.h"
 #include <string.h>
 
@@ -214,6 +217,63 @@ TEST_CASE(compare_constraints, check_add) {
     TEST_PASS();
 }
 
+/* Test 9: A new foreign key is added after the key it references */
+TEST_CASE(compare_constraints, fk_added_after_referenced_key) {
+    Schema *current = NULL;
+    Schema *desired = NULL;
+    SchemaDiff *diff = diff_sql(
+        "CREATE TABLE orders (id integer, customer_code text);\n"
+        "CREATE TABLE customers (id integer, code text);\n",
+        "CREATE TABLE orders (id integer, customer_code text,\n"
+        "    CONSTRAINT orders_customer_fk FOREIGN KEY (customer_code) REFERENCES customers (code));\n"
+        "CREATE TABLE customers (id integer, code text, CONSTRAINT customers_code_key UNIQUE (code));\n",
+        &current, &desired);
+    ASSERT_NOT_NULL(diff);
+    ASSERT_NOT_NULL(schema_diff_find_table(diff, "customers"));
+    ASSERT_TRUE(schema_diff_find_table(diff, "customers")->keys_added);
+
+    char *sql = migration_sql(diff);
+    ASSERT_NOT_NULL(sql);
+    long key = find_offset(sql, "ADD CONSTRAINT customers_code_key");
+    long fk = find_offset(sql, "ADD CONSTRAINT orders_customer_fk");
+    ASSERT_TRUE(key >= 0);
+    ASSERT_TRUE(fk > key);
+
+    free(sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test 10: A removed foreign key is dropped before the key it references */
+TEST_CASE(compare_constraints, fk_dropped_before_referenced_key) {
+    Schema *current = NULL;
+    Schema *desired = NULL;
+    SchemaDiff *diff = diff_sql(
+        "CREATE TABLE customers (id integer, code text, CONSTRAINT customers_code_key UNIQUE (code));\n"
+        "CREATE TABLE orders (id integer, customer_code text,\n"
+        "    CONSTRAINT orders_customer_fk FOREIGN KEY (customer_code) REFERENCES customers (code));\n",
+        "CREATE TABLE customers (id integer, code text);\n"
+        "CREATE TABLE orders (id integer, customer_code text);\n",
+        &current, &desired);
+    ASSERT_NOT_NULL(diff);
+
+    char *sql = migration_sql(diff);
+    ASSERT_NOT_NULL(sql);
+    long fk = find_offset(sql, "DROP CONSTRAINT IF EXISTS orders_customer_fk");
+    long key = find_offset(sql, "DROP CONSTRAINT IF EXISTS customers_code_key");
+    ASSERT_TRUE(fk >= 0);
+    ASSERT_TRUE(key > fk);
+    ASSERT_TRUE(find_offset(sql + fk + 1, "DROP CONSTRAINT IF EXISTS orders_customer_fk") < 0);
+
+    free(sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
 /* ============================================================================
  * Test Suite Definition
  * ============================================================================ */
@@ -227,6 +287,8 @@ static TestCase compare_constraints_tests[] = {
     {"unique_add", test_compare_constraints_unique_add, "compare_constraints"},
     {"ignore_constraint_names", test_compare_constraints_ignore_constraint_names, "compare_constraints"},
     {"check_add", test_compare_constraints_check_add, "compare_constraints"},
+    {"fk_added_after_referenced_key", test_compare_constraints_fk_added_after_referenced_key, "compare_constraints"},
+    {"fk_dropped_before_referenced_key", test_compare_constraints_fk_dropped_before_referenced_key, "compare_constraints"},
 };
 
 void run_compare_constraints_tests(void) {
@@ -0,0 +1,243 @@
+#include "../test_framework.h"
+#include "test_helpers.h"
+#include "compare.h"
+#include "diff.h"
+#include "parser.h"
+#include "schema_compare.h"
+#include "sql_generator.h"
+#include "utils.h"
+#include <string.h>
+
+/* ============================================================================
+ * Helper Functions
+ * ============================================================================ */
+
+static const char *users_table =
+    "CREATE TABLE users (id integer, email text, name text, active boolean);\n";
+
+/* ============================================================================
+ * Parser and Signature Tests
+ * ============================================================================ */
+
+/* Test: Every clause of CREATE INDEX is parsed */
+TEST_CASE(compare_indexes, parse_all_clauses) {
+    Schema *schema = load_from_string(
+        "CREATE UNIQUE INDEX CONCURRENTLY IF NOT EXISTS idx_users ON ONLY public.users "
+        "USING btree (lower(email), name DESC NULLS LAST, id text_pattern_ops) "
+        "INCLUDE (active) NULLS NOT DISTINCT WITH (fillfactor = 70) "
+        "TABLESPACE fast WHERE active;", NULL);
+    ASSERT_NOT_NULL(schema);
+    ASSERT_EQ(schema->index_count, 1);
+
+    CreateIndexStmt *stmt = schema->indexes[0];
+    ASSERT_STR_EQ(stmt->index_name, "idx_users");
+    ASSERT_STR_EQ(stmt->table_name, "public.users");
+    ASSERT_TRUE(stmt->unique && stmt->concurrently && stmt->if_not_exists);
+    ASSERT_TRUE(stmt->only && stmt->nulls_not_distinct);
+    ASSERT_STR_EQ(stmt->access_method, "btree");
+    ASSERT_EQ(stmt->element_count, 3);
+    ASSERT_STR_EQ(stmt->elements[0].expression, "lower(email)");
+    ASSERT_STR_EQ(stmt->elements[1].column_name, "name");
+    ASSERT_EQ(stmt->elements[1].sort_order, SORT_DESC);
+    ASSERT_TRUE(stmt->elements[1].has_nulls_order);
+    ASSERT_STR_EQ(stmt->elements[2].opclass, "text_pattern_ops");
+    ASSERT_EQ(stmt->include_count, 1);
+    ASSERT_STR_EQ(stmt->include_columns[0], "active");
+    ASSERT_NOT_NULL(stmt->with_options);
+    ASSERT_EQ(stmt->with_options->count, 1);
+    ASSERT_STR_EQ(stmt->tablespace_name, "fast");
+    ASSERT_STR_EQ(stmt->where_clause, "active");
+
+    schema_free(schema);
+    TEST_PASS();
+}
+
+/* Test: The signature ignores the name, whitespace, casts and storage options */
+TEST_CASE(compare_indexes, signature_normalizes_definition) {
+    Schema *schema = load_from_string(
+        "CREATE INDEX a ON users (lower(email)) WHERE (active = true);\n"
+        "CREATE INDEX b ON Users (LOWER( email::text )) WITH (fillfactor = 90) WHERE active = true;\n"
+        "CREATE INDEX c ON users (lower(name)) WHERE active = true;", NULL);
+    ASSERT_NOT_NULL(schema);
+    ASSERT_EQ(schema->index_count, 3);
+
+    uint64_t a = index_signature(schema->indexes[0]);
+    uint64_t b = index_signature(schema->indexes[1]);
+    uint64_t c = index_signature(schema->indexes[2]);
+    ASSERT_TRUE(a == b);
+    ASSERT_TRUE(a != c);
+
+    schema_free(schema);
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Migration Tests
+ * ============================================================================ */
+
+/* Test: An index on an existing table is built concurrently after COMMIT */
+TEST_CASE(compare_indexes, added_index_built_concurrently) {
+    const char *desired_sql =
+        "CREATE TABLE users (id integer, email text, name text, active boolean, age integer);\n"
+        "CREATE INDEX idx_users_email ON users (email);";
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(users_table, desired_sql, &current, &desired);
+    ASSERT_NOT_NULL(diff);
+    ASSERT_EQ(diff->indexes_added, 1);
+
+    char *sql = migration_sql(diff);
+    ASSERT_NOT_NULL(sql);
+    long create = find_offset(sql, "CREATE INDEX CONCURRENTLY idx_users_email ON users (email);");
+    long commit = find_offset(sql, "COMMIT;");
+    ASSERT_TRUE(commit >= 0 && create > commit);
+
+    free(sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test: A removed index is dropped concurrently before BEGIN */
+TEST_CASE(compare_indexes, removed_index_dropped_concurrently) {
+    char current_sql[512];
+    snprintf(current_sql, sizeof(current_sql), "%s%s", users_table,
+             "CREATE INDEX idx_users_name ON users (name);");
+    char desired_sql[512];
+    snprintf(desired_sql, sizeof(desired_sql), "%s%s", users_table,
+             "CREATE TABLE audit (id integer);");
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(current_sql, desired_sql, &current, &desired);
+    ASSERT_NOT_NULL(diff);
+    ASSERT_EQ(diff->indexes_removed, 1);
+
+    char *sql = migration_sql(diff);
+    ASSERT_NOT_NULL(sql);
+    long drop = find_offset(sql, "DROP INDEX CONCURRENTLY IF EXISTS idx_users_name;");
+    long begin = find_offset(sql, "BEGIN;");
+    ASSERT_TRUE(drop >= 0);
+    ASSERT_TRUE(begin > drop);
+
+    free(sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test: Same definition under a new name is a rename, not a rebuild */
+TEST_CASE(compare_indexes, renamed_index) {
+    char current_sql[512];
+    snprintf(current_sql, sizeof(current_sql), "%s%s", users_table,
+             "CREATE INDEX users_email_idx ON users (email);");
+    char desired_sql[512];
+    snprintf(desired_sql, sizeof(desired_sql), "%s%s", users_table,
+             "CREATE INDEX idx_users_email ON users ( email );");
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(current_sql, desired_sql, &current, &desired);
+    ASSERT_NOT_NULL(diff);
+    ASSERT_EQ(diff->indexes_added, 0);
+    ASSERT_EQ(diff->indexes_removed, 0);
+    ASSERT_EQ(diff->indexes_modified, 1);
+
+    char *sql = migration_sql(diff);
+    ASSERT_NOT_NULL(sql);
+    ASSERT_NOT_NULL(strstr(sql, "ALTER INDEX users_email_idx RENAME TO idx_users_email;"));
+    ASSERT_NULL(strstr(sql, "CREATE INDEX"));
+    ASSERT_NULL(strstr(sql, "DROP INDEX"));
+
+    free(sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test: A changed definition is rebuilt under a temporary name and swapped in */
+TEST_CASE(compare_indexes, modified_index_rebuilt) {
+    char current_sql[512];
+    snprintf(current_sql, sizeof(current_sql), "%s%s", users_table,
+             "CREATE INDEX idx_users_email ON users (email);");
+    char desired_sql[512];
+    snprintf(desired_sql, sizeof(desired_sql), "%s%s", users_table,
+             "CREATE UNIQUE INDEX idx_users_email ON users (email) WHERE active;");
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(current_sql, desired_sql, &current, &desired);
+    ASSERT_NOT_NULL(diff);
+    ASSERT_EQ(diff->indexes_modified, 1);
+
+    char *sql = migration_sql(diff);
+    ASSERT_NOT_NULL(sql);
+    long create = find_offset(sql,
+        "CREATE UNIQUE INDEX CONCURRENTLY idx_users_email__new ON users (email) WHERE active;");
+    long drop = find_offset(sql, "DROP INDEX CONCURRENTLY IF EXISTS idx_users_email;");
+    long rename = find_offset(sql, "ALTER INDEX idx_users_email__new RENAME TO idx_users_email;");
+    ASSERT_TRUE(create >= 0 && drop > create && rename > drop);
+
+    free(sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test: Indexes of a table created by the migration are built in the transaction */
+TEST_CASE(compare_indexes, index_on_new_table_in_transaction) {
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(
+        users_table,
+        "CREATE TABLE users (id integer, email text, name text, active boolean);\n"
+        "CREATE TABLE orders (id integer, user_id integer);\n"
+        "CREATE INDEX idx_orders_user ON orders (user_id);",
+        &current, &desired);
+    ASSERT_NOT_NULL(diff);
+    ASSERT_EQ(diff->indexes_added, 1);
+
+    char *sql = migration_sql(diff);
+    ASSERT_NOT_NULL(sql);
+    long table = find_offset(sql, "CREATE TABLE orders");
+    long create = find_offset(sql, "CREATE INDEX idx_orders_user ON orders (user_id);");
+    long commit = find_offset(sql, "COMMIT;");
+    ASSERT_TRUE(table >= 0 && create > table && commit > create);
+    ASSERT_NULL(strstr(sql, "CONCURRENTLY"));
+
+    free(sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test: Identical indexes produce no diff */
+TEST_CASE(compare_indexes, identical_indexes_no_diff) {
+    const char *sql = "CREATE TABLE users (id integer, email text);\n"
+                      "CREATE UNIQUE INDEX idx_email ON users (lower(email));\n"
+                      "CREATE INDEX ON users USING hash (id);";
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(sql, sql, &current, &desired);
+    ASSERT_NOT_NULL(diff);
+    ASSERT_NULL(diff->index_diffs);
+    ASSERT_EQ(diff->total_diffs, 0);
+
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test suite definition */
+static TestCase compare_indexes_tests[] = {
+    {"parse_all_clauses", test_compare_indexes_parse_all_clauses, "compare_indexes"},
+    {"signature_normalizes_definition", test_compare_indexes_signature_normalizes_definition, "compare_indexes"},
+    {"added_index_built_concurrently", test_compare_indexes_added_index_built_concurrently, "compare_indexes"},
+    {"removed_index_dropped_concurrently", test_compare_indexes_removed_index_dropped_concurrently, "compare_indexes"},
+    {"renamed_index", test_compare_indexes_renamed_index, "compare_indexes"},
+    {"modified_index_rebuilt", test_compare_indexes_modified_index_rebuilt, "compare_indexes"},
+    {"index_on_new_table_in_transaction", test_compare_indexes_index_on_new_table_in_transaction, "compare_indexes"},
+    {"identical_indexes_no_diff", test_compare_indexes_identical_indexes_no_diff, "compare_indexes"},
+};
+
+void run_compare_indexes_tests(void) {
+    run_test_suite("compare_indexes", NULL, NULL, compare_indexes_tests,
+                   sizeof(compare_indexes_tests) / sizeof(compare_indexes_tests[0]));
+}
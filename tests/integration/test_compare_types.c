@@ -0,0 +1,280 @@
+#include "../test_framework.h"
+#include "test_helpers.h"
+#include "compare.h"
+#include "diff.h"
+#include "report.h"
+#include "schema_compare.h"
+#include "sql_generator.h"
+#include "utils.h"
+#include <string.h>
+
+/* ============================================================================
+ * Helper Functions
+ * ============================================================================ */
+
+static TypeDiff *find_type_diff(const SchemaDiff *diff, const char *type_name) {
+    for (TypeDiff *td = diff->type_diffs; td; td = td->next) {
+        if (strcmp(td->type_name, type_name) == 0) return td;
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ * Enum Tests
+ * ============================================================================ */
+
+/* Test: New labels are added in place, anchored to their neighbours, before BEGIN */
+TEST_CASE(compare_types, enum_values_added_in_place) {
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(
+        "CREATE TYPE mood AS ENUM ('sad', 'ok', 'happy');",
+        "CREATE TYPE mood AS ENUM ('meh', 'sad', 'ok', 'great', 'happy', 'ecstatic');",
+        &current, &desired);
+    ASSERT_NOT_NULL(diff);
+    ASSERT_EQ(diff->types_modified, 1);
+    ASSERT_EQ(diff->total_diffs, 3);
+
+    TypeDiff *td = find_type_diff(diff, "mood");
+    ASSERT_NOT_NULL(td);
+    ASSERT_FALSE(td->requires_recreate);
+    ASSERT_EQ(td->value_add_count, 3);
+    ASSERT_EQ(td->value_rename_count, 0);
+
+    char *sql = migration_sql(diff);
+    ASSERT_NOT_NULL(sql);
+    long meh = find_offset(sql, "ALTER TYPE mood ADD VALUE IF NOT EXISTS 'meh' BEFORE 'sad';");
+    long great = find_offset(sql, "ALTER TYPE mood ADD VALUE IF NOT EXISTS 'great' AFTER 'ok';");
+    long ecstatic = find_offset(sql, "ALTER TYPE mood ADD VALUE IF NOT EXISTS 'ecstatic' AFTER 'happy';");
+    long begin = find_offset(sql, "BEGIN;");
+    ASSERT_TRUE(meh >= 0 && great > meh && ecstatic > great);
+    ASSERT_TRUE(begin > ecstatic);
+    ASSERT_NULL(strstr(sql, "CREATE TYPE"));
+    ASSERT_NULL(strstr(sql, "DROP TYPE"));
+
+    free(sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test: A label replaced at the same position is renamed, and additions next
+ * to it anchor to the name it has before the rename runs */
+TEST_CASE(compare_types, enum_value_renamed) {
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(
+        "CREATE TYPE pri AS ENUM ('low', 'mid', 'high');",
+        "CREATE TYPE pri AS ENUM ('low', 'medium', 'medium_plus', 'high');",
+        &current, &desired);
+    ASSERT_NOT_NULL(diff);
+
+    TypeDiff *td = find_type_diff(diff, "pri");
+    ASSERT_NOT_NULL(td);
+    ASSERT_FALSE(td->requires_recreate);
+    ASSERT_EQ(td->value_rename_count, 1);
+    ASSERT_STR_EQ(td->values_renamed->old_label, "mid");
+    ASSERT_STR_EQ(td->values_renamed->label, "medium");
+    ASSERT_EQ(td->value_add_count, 1);
+    ASSERT_STR_EQ(td->values_added->anchor, "mid");
+
+    char *sql = migration_sql(diff);
+    ASSERT_NOT_NULL(sql);
+    long add = find_offset(sql, "ADD VALUE IF NOT EXISTS 'medium_plus' AFTER 'mid';");
+    long rename = find_offset(sql, "ALTER TYPE pri RENAME VALUE 'mid' TO 'medium';");
+    ASSERT_TRUE(add >= 0);
+    ASSERT_TRUE(rename > add);
+    ASSERT_NULL(strstr(sql, "CREATE TYPE"));
+
+    free(sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test: A large enum with labels added at both ends keeps every diff in order */
+TEST_CASE(compare_types, large_enum_added_labels) {
+    StringBuilder *current_sb = sb_create();
+    StringBuilder *desired_sb = sb_create();
+    ASSERT_NOT_NULL(current_sb);
+    ASSERT_NOT_NULL(desired_sb);
+    sb_append(current_sb, "CREATE TYPE code AS ENUM (");
+    sb_append(desired_sb, "CREATE TYPE code AS ENUM ('first', ");
+    for (int i = 0; i < 5000; i++) {
+        sb_append_fmt(current_sb, "%s'c%04d'", i ? ", " : "", i);
+        sb_append_fmt(desired_sb, "%s'c%04d'", i ? ", " : "", i);
+    }
+    sb_append(current_sb, ");");
+    sb_append(desired_sb, ", 'last');");
+    char *current_sql = sb_to_string(current_sb);
+    char *desired_sql = sb_to_string(desired_sb);
+    sb_free(current_sb);
+    sb_free(desired_sb);
+
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(current_sql, desired_sql, &current, &desired);
+    ASSERT_NOT_NULL(diff);
+    TypeDiff *td = find_type_diff(diff, "code");
+    ASSERT_NOT_NULL(td);
+    ASSERT_FALSE(td->requires_recreate);
+    ASSERT_EQ(td->value_add_count, 2);
+    ASSERT_STR_EQ(td->values_added->anchor, "c0000");
+    ASSERT_TRUE(td->values_added->before);
+    ASSERT_STR_EQ(td->values_added->next->anchor, "c4999");
+    ASSERT_STR_EQ(td->diffs->element_name, "first");
+    ASSERT_STR_EQ(td->diffs->next->element_name, "last");
+
+    free(current_sql);
+    free(desired_sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test: Removed or reordered labels recreate the type and convert its columns */
+TEST_CASE(compare_types, enum_removed_label_recreates) {
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(
+        "CREATE TYPE pri AS ENUM ('low', 'mid', 'high');\n"
+        "CREATE TABLE task (id integer, p pri DEFAULT 'low', history pri[]);",
+        "CREATE TYPE pri AS ENUM ('high', 'low');\n"
+        "CREATE TABLE task (id integer, p pri DEFAULT 'low', history pri[]);",
+        &current, &desired);
+    ASSERT_NOT_NULL(diff);
+
+    TypeDiff *td = find_type_diff(diff, "pri");
+    ASSERT_NOT_NULL(td);
+    ASSERT_TRUE(td->requires_recreate);
+    ASSERT_TRUE(diff->critical_count >= 2);
+    ASSERT_NOT_NULL(td->dependents);
+    ASSERT_NOT_NULL(td->dependents->next);
+
+    char *sql = migration_sql(diff);
+    ASSERT_NOT_NULL(sql);
+    long rename = find_offset(sql, "ALTER TYPE pri RENAME TO pri__old;");
+    long create = find_offset(sql, "CREATE TYPE pri AS ENUM ('high', 'low');");
+    long drop_default = find_offset(sql, "ALTER TABLE task ALTER COLUMN p DROP DEFAULT;");
+    long convert = find_offset(sql, "ALTER TABLE task ALTER COLUMN p TYPE pri USING p::text::pri;");
+    long set_default = find_offset(sql, "ALTER TABLE task ALTER COLUMN p SET DEFAULT 'low';");
+    long drop_old = find_offset(sql, "DROP TYPE pri__old;");
+    ASSERT_TRUE(rename >= 0 && create > rename);
+    ASSERT_TRUE(drop_default > create && convert > drop_default && set_default > convert);
+    ASSERT_TRUE(drop_old > set_default);
+    ASSERT_NOT_NULL(strstr(sql, "ALTER COLUMN history TYPE pri[] USING history::text::pri[];"));
+    ASSERT_NULL(strstr(sql, "ADD VALUE"));
+
+    free(sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Composite and Schema-Level Tests
+ * ============================================================================ */
+
+/* Test: Composite attributes are added, dropped and retyped with ALTER TYPE */
+TEST_CASE(compare_types, composite_attributes) {
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(
+        "CREATE TYPE addr AS (street text, zip integer, city text);",
+        "CREATE TYPE addr AS (street text, zip varchar(10), country text);",
+        &current, &desired);
+    ASSERT_NOT_NULL(diff);
+
+    TypeDiff *td = find_type_diff(diff, "addr");
+    ASSERT_NOT_NULL(td);
+    ASSERT_FALSE(td->requires_recreate);
+    ASSERT_EQ(td->attribute_add_count, 1);
+    ASSERT_EQ(td->attribute_remove_count, 1);
+    ASSERT_EQ(td->attribute_modify_count, 1);
+
+    char *sql = migration_sql(diff);
+    ASSERT_NOT_NULL(sql);
+    ASSERT_NOT_NULL(strstr(sql, "ALTER TYPE addr DROP ATTRIBUTE IF EXISTS city;"));
+    ASSERT_NOT_NULL(strstr(sql, "ALTER TYPE addr ADD ATTRIBUTE country text;"));
+    ASSERT_NOT_NULL(strstr(sql, "ALTER TYPE addr ALTER ATTRIBUTE zip SET DATA TYPE varchar(10);"));
+    ASSERT_NULL(strstr(sql, "CREATE TYPE"));
+
+    free(sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test: Added types are created before tables, removed ones dropped after */
+TEST_CASE(compare_types, types_added_and_removed) {
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(
+        "CREATE TYPE gone AS ENUM ('x');\n"
+        "CREATE TABLE old_t (g gone);",
+        "CREATE TYPE status AS ENUM ('on', 'off');\n"
+        "CREATE TABLE new_t (s status);",
+        &current, &desired);
+    ASSERT_NOT_NULL(diff);
+    ASSERT_EQ(diff->types_added, 1);
+    ASSERT_EQ(diff->types_removed, 1);
+    ASSERT_EQ(diff->types_modified, 0);
+
+    char *sql = migration_sql(diff);
+    ASSERT_NOT_NULL(sql);
+    long create_type = find_offset(sql, "CREATE TYPE status AS ENUM ('on', 'off');");
+    long create_table = find_offset(sql, "CREATE TABLE new_t");
+    long drop_table = find_offset(sql, "DROP TABLE IF EXISTS old_t");
+    long drop_type = find_offset(sql, "DROP TYPE IF EXISTS gone;");
+    ASSERT_TRUE(create_type >= 0 && create_table > create_type);
+    ASSERT_TRUE(drop_table >= 0 && drop_type > drop_table);
+
+    ReportOptions *report_opts = report_options_default();
+    report_opts->use_color = false;
+    char *report = generate_report(diff, report_opts);
+    ASSERT_NOT_NULL(report);
+    ASSERT_NOT_NULL(strstr(report, "Types Added:     1"));
+    ASSERT_NOT_NULL(strstr(report, "Type: status"));
+    ASSERT_NOT_NULL(strstr(report, "- Type REMOVED"));
+    free(report);
+    report_options_free(report_opts);
+
+    free(sql);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test: Identical types produce no diff */
+TEST_CASE(compare_types, identical_types_no_diff) {
+    const char *sql = "CREATE TYPE mood AS ENUM ('sad', 'ok');\n"
+                      "CREATE TYPE addr AS (street text, zip integer);\n"
+                      "CREATE TYPE span AS RANGE (SUBTYPE = integer);\n"
+                      "CREATE TABLE t (id integer);";
+    Schema *current, *desired;
+    SchemaDiff *diff = diff_sql(sql, sql, &current, &desired);
+    ASSERT_NOT_NULL(diff);
+    ASSERT_NULL(diff->type_diffs);
+    ASSERT_EQ(diff->total_diffs, 0);
+
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
+/* Test suite definition */
+static TestCase compare_types_tests[] = {
+    {"enum_values_added_in_place", test_compare_types_enum_values_added_in_place, "compare_types"},
+    {"enum_value_renamed", test_compare_types_enum_value_renamed, "compare_types"},
+    {"large_enum_added_labels", test_compare_types_large_enum_added_labels, "compare_types"},
+    {"enum_removed_label_recreates", test_compare_types_enum_removed_label_recreates, "compare_types"},
+    {"composite_attributes", test_compare_types_composite_attributes, "compare_types"},
+    {"types_added_and_removed", test_compare_types_types_added_and_removed, "compare_types"},
+    {"identical_types_no_diff", test_compare_types_identical_types_no_diff, "compare_types"},
+};
+
+void run_compare_types_tests(void) {
+    run_test_suite("compare_types", NULL, NULL, compare_types_tests,
+                   sizeof(compare_types_tests) / sizeof(compare_types_tests[0]));
+}
@@ -1,5 +1,7 @@
 #include "../test_framework.h"
 #include "db_reader.h"
+#include "compare.h"
+#include "sql_generator.h"
 #include "sc_memory.h"
 #include "utils.h"
 #include <stdlib.h>
@@ -207,6 +209,21 @@ TEST_CASE(db_reader, test_db_read_schema) {
     ASSERT_TRUE(found_simple);
     ASSERT_TRUE(found_constraints);
 
+    /* Catalog statements are prepared once per connection and reused */
+    unsigned int prepared = conn->prepared;
+    ASSERT_TRUE(prepared != 0);
+    Schema *again = db_read_schema(conn, "public", ctx);
+    ASSERT_NOT_NULL(again);
+    ASSERT_EQ(again->table_count, schema->table_count);
+    ASSERT_EQ(conn->prepared, prepared);
+
+    /* A lost session state (DISCARD ALL) is recovered by preparing again */
+    execute_sql(conn, "DISCARD ALL;");
+    execute_sql(conn, "SET client_min_messages = WARNING;");
+    again = db_read_schema(conn, "public", ctx);
+    ASSERT_NOT_NULL(again);
+    ASSERT_EQ(again->table_count, schema->table_count);
+
     /* Cleanup */
     cleanup_test_tables(conn);
     db_disconnect(conn);
@@ -840,6 +857,172 @@ TEST_CASE(db_reader, test_db_edge_case_identifiers) {
     TEST_PASS();
 }
 
+static bool schema_has_table(const Schema *schema, const char *name) {
+    for (int i = 0; i < schema->table_count; i++) {
+        if (strcmp(schema->tables[i]->table_name, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST_CASE(db_reader, test_db_read_drift) {
+    if (!g_db_available) {
+        TEST_SKIP("Database not available");
+    }
+
+    MemoryContext *ctx = memory_context_create("test_db_read_drift");
+    ASSERT_NOT_NULL(ctx);
+
+    DBConnection *conn = connect_test_db();
+    ASSERT_NOT_NULL(conn);
+
+    /* Identical tables (with a foreign key into their own schema) must not
+     * come back; changed and one-sided ones must */
+    const char *schemas[] = {"drift_current", "drift_desired"};
+    for (int i = 0; i < 2; i++) {
+        char sql[512];
+        snprintf(sql, sizeof(sql),
+                 "DROP SCHEMA IF EXISTS %s CASCADE; CREATE SCHEMA %s;"
+                 "CREATE TABLE %s.same_parent (id INTEGER PRIMARY KEY);"
+                 "CREATE TABLE %s.same_child (id INTEGER REFERENCES %s.same_parent (id));"
+                 "CREATE TABLE %s.changed (id INTEGER, note %s);"
+                 "CREATE TABLE %s.only_%s (id INTEGER);",
+                 schemas[i], schemas[i], schemas[i], schemas[i], schemas[i],
+                 schemas[i], i == 0 ? "VARCHAR(20)" : "TEXT",
+                 schemas[i], i == 0 ? "current" : "desired");
+        execute_sql(conn, sql);
+    }
+
+    Schema *current = NULL;
+    Schema *desired = NULL;
+    ASSERT_TRUE(db_read_drift(conn, "drift_current", "drift_desired", &current, &desired, ctx));
+    ASSERT_EQ(current->table_count, 2);
+    ASSERT_TRUE(schema_has_table(current, "changed"));
+    ASSERT_TRUE(schema_has_table(current, "only_current"));
+    ASSERT_EQ(desired->table_count, 2);
+    ASSERT_TRUE(schema_has_table(desired, "changed"));
+    ASSERT_TRUE(schema_has_table(desired, "only_desired"));
+
+    execute_sql(conn, "DROP SCHEMA drift_current CASCADE; DROP SCHEMA drift_desired CASCADE;");
+    db_disconnect(conn);
+    memory_context_destroy(ctx);
+    TEST_PASS();
+}
+
+/* A server-side migration between two non-public schemas passes its own
+ * drift guard when applied, with serial columns, a same-schema foreign key
+ * and a user type in the guarded table */
+TEST_CASE(db_reader, test_db_server_side_migration_applies) {
+    if (!g_db_available) {
+        TEST_SKIP("Database not available");
+    }
+
+    MemoryContext *ctx = memory_context_create("test_db_server_side_migration_applies");
+    ASSERT_NOT_NULL(ctx);
+
+    DBConnection *conn = connect_test_db();
+    ASSERT_NOT_NULL(conn);
+
+    const char *schemas[] = {"apply_current", "apply_desired"};
+    for (int i = 0; i < 2; i++) {
+        char sql[1024];
+        snprintf(sql, sizeof(sql),
+                 "DROP SCHEMA IF EXISTS %s CASCADE; CREATE SCHEMA %s;"
+                 "CREATE TYPE %s.mood AS ENUM ('calm', 'busy');"
+                 "CREATE TABLE %s.parent (id SERIAL PRIMARY KEY);"
+                 "CREATE TABLE %s.child (id SERIAL PRIMARY KEY, "
+                 "parent_id INTEGER REFERENCES %s.parent (id), mood %s.mood, note %s);",
+                 schemas[i], schemas[i], schemas[i], schemas[i], schemas[i],
+                 schemas[i], schemas[i], i == 0 ? "VARCHAR(20)" : "TEXT");
+        execute_sql(conn, sql);
+    }
+
+    Schema *current = NULL;
+    Schema *desired = NULL;
+    ASSERT_TRUE(db_read_drift(conn, "apply_current", "apply_desired", &current, &desired, ctx));
+    ASSERT_EQ(current->table_count, 1);
+    ASSERT_NOT_NULL(current->tables[0]->catalog_digest);
+
+    CompareOptions *compare_opts = compare_options_default();
+    SchemaDiff *diff = compare_schemas(current, desired, compare_opts, NULL);
+    ASSERT_NOT_NULL(diff);
+    SQLGenOptions *sql_opts = sql_gen_options_default();
+    SQLMigration *migration = generate_migration_sql(diff, sql_opts);
+    ASSERT_NOT_NULL(migration);
+    ASSERT_NOT_NULL(strstr(migration->forward_sql, "$precondition$"));
+    db_disconnect(conn);
+
+    /* Applied from a session of its own, as a deploy would */
+    conn = connect_test_db();
+    ASSERT_NOT_NULL(conn);
+    execute_sql(conn, "SET search_path = apply_current, public;");
+    PGresult *res = PQexec(conn->conn, migration->forward_sql);
+    ASSERT_EQ(PQresultStatus(res), PGRES_COMMAND_OK);
+    PQclear(res);
+
+    Schema *after_current = NULL;
+    Schema *after_desired = NULL;
+    ASSERT_TRUE(db_read_drift(conn, "apply_current", "apply_desired",
+                              &after_current, &after_desired, ctx));
+    ASSERT_EQ(after_current->table_count, 0);
+
+    sql_migration_free(migration);
+    sql_gen_options_free(sql_opts);
+    schema_diff_free(diff);
+    compare_options_free(compare_opts);
+    execute_sql(conn, "DROP SCHEMA apply_current CASCADE; DROP SCHEMA apply_desired CASCADE;");
+    db_disconnect(conn);
+    memory_context_destroy(ctx);
+    TEST_PASS();
+}
+
+/* Rows are matched to tables by OID, so names differing only in case stay apart */
+TEST_CASE(db_reader, test_db_catalog_identity) {
+    if (!g_db_available) {
+        TEST_SKIP("Database not available");
+    }
+
+    MemoryContext *ctx = memory_context_create("test_db_catalog_identity");
+    ASSERT_NOT_NULL(ctx);
+
+    DBConnection *conn = connect_test_db();
+    ASSERT_NOT_NULL(conn);
+
+    execute_sql(conn, "DROP TABLE IF EXISTS test_ids, \"Test_Ids\" CASCADE;");
+    execute_sql(conn, "CREATE TABLE test_ids (id INTEGER PRIMARY KEY, note TEXT);"
+                      "CREATE TABLE \"Test_Ids\" (code TEXT UNIQUE);");
+
+    const char *names[] = {"test_ids", "Test_Ids"};
+    CreateTableStmt **tables = db_read_tables(conn, "public", names, 2, ctx);
+    ASSERT_NOT_NULL(tables);
+
+    PGresult *res = PQexec(conn->conn, "SELECT 'test_ids'::regclass::oid, '\"Test_Ids\"'::regclass::oid");
+    ASSERT_EQ(PQresultStatus(res), PGRES_TUPLES_OK);
+    ASSERT_EQ(tables[0]->relid, (uint32_t)strtoul(PQgetvalue(res, 0, 0), NULL, 10));
+    ASSERT_EQ(tables[1]->relid, (uint32_t)strtoul(PQgetvalue(res, 0, 1), NULL, 10));
+    PQclear(res);
+
+    /* Each table got its own columns, numbered as the catalog numbers them */
+    TableElement *elem = tables[0]->table_def.regular.elements;
+    ASSERT_STR_EQ(elem->elem.column.column_name, "id");
+    ASSERT_EQ(elem->elem.column.attnum, 1);
+    ASSERT_STR_EQ(elem->next->elem.column.column_name, "note");
+    ASSERT_EQ(elem->next->elem.column.attnum, 2);
+    ASSERT_EQ(elem->next->next->type, TABLE_ELEM_TABLE_CONSTRAINT);
+    ASSERT_TRUE(elem->next->next->elem.table_constraint->conoid != 0);
+
+    elem = tables[1]->table_def.regular.elements;
+    ASSERT_STR_EQ(elem->elem.column.column_name, "code");
+    ASSERT_EQ(elem->next->type, TABLE_ELEM_TABLE_CONSTRAINT);
+    ASSERT_NULL(elem->next->next);
+
+    execute_sql(conn, "DROP TABLE test_ids, \"Test_Ids\";");
+    db_disconnect(conn);
+    memory_context_destroy(ctx);
+    TEST_PASS();
+}
+
 /* ============================================================================
  * Test Suite Definition and Runner
  * ============================================================================ */
@@ -865,6 +1048,9 @@ static TestCase db_reader_tests[] = {
     {"test_db_temp_table", test_db_reader_test_db_temp_table, "db_reader"},
     {"test_db_unlogged_table", test_db_reader_test_db_unlogged_table, "db_reader"},
     {"test_db_edge_case_identifiers", test_db_reader_test_db_edge_case_identifiers, "db_reader"},
+    {"test_db_read_drift", test_db_reader_test_db_read_drift, "db_reader"},
+    {"test_db_catalog_identity", test_db_reader_test_db_catalog_identity, "db_reader"},
+    {"test_db_server_side_migration_applies", test_db_reader_test_db_server_side_migration_applies, "db_reader"},
 };
 
 void run_db_reader_tests(void) {
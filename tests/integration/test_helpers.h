@@ -2,8 +2,11 @@
 #define TEST_HELPERS_H
 
 #include "pg_create_table.h"
+#include "compare.h"
 #include "db_reader.h"
+#include "schema_compare.h"
 #include "sc_memory.h"
+#include "sql_generator.h"
 #include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
@@ -86,6 +89,47 @@ static bool column_has_constraint(ColumnDef *col, ConstraintType type) {
     return find_column_constraint(col->constraints, type) != NULL;
 }
 
+/**
+ * Diff current against desired DDL.
+ * Both schemas are returned for the caller to free.
+ */
+__attribute__((unused))
+static SchemaDiff *diff_sql(const char *current_sql, const char *desired_sql,
+                            Schema **current, Schema **desired) {
+    *current = load_from_string(current_sql, NULL);
+    *desired = load_from_string(desired_sql, NULL);
+    if (!*current || !*desired) {
+        return NULL;
+    }
+    CompareOptions *opts = compare_options_default();
+    SchemaDiff *diff = compare_schemas(*current, *desired, opts, NULL);
+    compare_options_free(opts);
+    return diff;
+}
+
+/**
+ * Forward migration SQL for a diff, with default options.
+ * Returns a string to free, or NULL.
+ */
+__attribute__((unused))
+static char *migration_sql(const SchemaDiff *diff) {
+    SQLGenOptions *opts = sql_gen_options_default();
+    SQLMigration *migration = generate_migration_sql(diff, opts);
+    char *sql = migration && migration->forward_sql ? strdup(migration->forward_sql) : NULL;
+    sql_migration_free(migration);
+    sql_gen_options_free(opts);
+    return sql;
+}
+
+/**
+ * Offset of needle in haystack, -1 if absent.
+ */
+__attribute__((unused))
+static long find_offset(const char *haystack, const char *needle) {
+    const char *found = strstr(haystack, needle);
+    return found ? found - haystack : -1;
+}
+
 /**
  * Execute SQL and check for errors.
  */
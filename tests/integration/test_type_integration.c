@@ -69,6 +69,11 @@ TEST_CASE(type_integration, parse_enum_many_labels) {
     ASSERT_STR_EQ(stmt->type_def.enum_def.labels[5], "sat");
     ASSERT_STR_EQ(stmt->type_def.enum_def.labels[6], "sun");
 
+    /* The label index gives declaration order; labels are case-sensitive */
+    ASSERT_EQ(enum_type_def_find(&stmt->type_def.enum_def, "sun"), 6);
+    ASSERT_EQ(enum_type_def_find(&stmt->type_def.enum_def, "mon"), 0);
+    ASSERT_EQ(enum_type_def_find(&stmt->type_def.enum_def, "Sun"), -1);
+
     parser_destroy(parser);
     free_create_type_stmt(stmt);
     TEST_PASS();
@@ -173,19 +178,23 @@ TEST_CASE(type_integration, parse_composite_basic) {
     ASSERT_NULL(attr->collation);
 
     /* Verify second attribute */
-    attr = attr->next;
-    ASSERT_NOT_NULL(attr);
+    attr = &stmt->type_def.composite_def.attributes[1];
     ASSERT_STR_EQ(attr->attr_name, "city");
     ASSERT_STR_EQ(attr->data_type, "text");
     ASSERT_NULL(attr->collation);
 
     /* Verify third attribute */
-    attr = attr->next;
-    ASSERT_NOT_NULL(attr);
+    attr = &stmt->type_def.composite_def.attributes[2];
     ASSERT_STR_EQ(attr->attr_name, "zip");
     ASSERT_STR_EQ(attr->data_type, "int");
     ASSERT_NULL(attr->collation);
-    ASSERT_NULL(attr->next);
+
+    /* Repeated data types are stored once; names are indexed by position */
+    ASSERT_TRUE(stmt->type_def.composite_def.attributes[0].data_type ==
+                stmt->type_def.composite_def.attributes[1].data_type);
+    ASSERT_EQ(composite_type_def_find(&stmt->type_def.composite_def, "zip", true), 2);
+    ASSERT_EQ(composite_type_def_find(&stmt->type_def.composite_def, "CITY", false), 1);
+    ASSERT_EQ(composite_type_def_find(&stmt->type_def.composite_def, "CITY", true), -1);
 
     parser_destroy(parser);
     free_create_type_stmt(stmt);
@@ -212,8 +221,7 @@ TEST_CASE(type_integration, parse_composite_with_collation) {
     ASSERT_STR_EQ(attr->collation, "C");
 
     /* Verify second attribute */
-    attr = attr->next;
-    ASSERT_NOT_NULL(attr);
+    attr = &stmt->type_def.composite_def.attributes[1];
     ASSERT_STR_EQ(attr->attr_name, "age");
     ASSERT_STR_EQ(attr->data_type, "int");
     ASSERT_NULL(attr->collation);
@@ -237,7 +245,6 @@ TEST_CASE(type_integration, parse_composite_single_attr) {
     ASSERT_NOT_NULL(attr);
     ASSERT_STR_EQ(attr->attr_name, "value");
     ASSERT_STR_EQ(attr->data_type, "bigint");
-    ASSERT_NULL(attr->next);
 
     parser_destroy(parser);
     free_create_type_stmt(stmt);
@@ -259,22 +266,21 @@ TEST_CASE(type_integration, parse_composite_many_attrs) {
     ASSERT_STR_EQ(attr->attr_name, "f1");
     ASSERT_STR_EQ(attr->data_type, "int");
 
-    attr = attr->next;
+    attr++;
     ASSERT_STR_EQ(attr->attr_name, "f2");
     ASSERT_STR_EQ(attr->data_type, "text");
 
-    attr = attr->next;
+    attr++;
     ASSERT_STR_EQ(attr->attr_name, "f3");
     ASSERT_STR_EQ(attr->data_type, "bool");
 
-    attr = attr->next;
+    attr++;
     ASSERT_STR_EQ(attr->attr_name, "f4");
     ASSERT_STR_EQ(attr->data_type, "numeric");
 
-    attr = attr->next;
+    attr++;
     ASSERT_STR_EQ(attr->attr_name, "f5");
     ASSERT_STR_EQ(attr->data_type, "timestamp");
-    ASSERT_NULL(attr->next);
 
     parser_destroy(parser);
     free_create_type_stmt(stmt);
@@ -295,7 +301,7 @@ TEST_CASE(type_integration, parse_composite_array_types) {
     ASSERT_STR_EQ(attr->attr_name, "tags");
     ASSERT_STR_EQ(attr->data_type, "text[]");
 
-    attr = attr->next;
+    attr++;
     ASSERT_STR_EQ(attr->attr_name, "scores");
     ASSERT_STR_EQ(attr->data_type, "integer[]");
 
@@ -318,7 +324,7 @@ TEST_CASE(type_integration, parse_composite_precision) {
     ASSERT_STR_EQ(attr->attr_name, "amount");
     ASSERT_STR_EQ(attr->data_type, "numeric(10,2)");
 
-    attr = attr->next;
+    attr++;
     ASSERT_STR_EQ(attr->attr_name, "created");
     ASSERT_STR_EQ(attr->data_type, "timestamp(6)");
 
@@ -124,6 +124,25 @@ extern TestStats g_test_stats;
     } \
 } while(0)
 
+/* Allocation counting (tests/alloc_hook.c). Counts every heap allocation when
+ * malloc is interposed, otherwise only mem_* allocations. */
+bool test_alloc_hook_active(void);
+size_t test_alloc_count(void);
+
+/* Run the statements in ... and fail if they allocate more than max_allocs
+ * times. max_allocs is evaluated after the statements run, so it may depend
+ * on counts they compute (e.g. tokens lexed). */
+#define ASSERT_ALLOCS_LE(max_allocs, ...) do { \
+    size_t allocs_before_ = test_alloc_count(); \
+    __VA_ARGS__; \
+    size_t allocs_ = test_alloc_count() - allocs_before_; \
+    size_t allocs_max_ = (size_t)(max_allocs); \
+    if (allocs_ > allocs_max_) { \
+        TEST_FAIL("Allocation budget exceeded: %zu > %s (%zu) (at %s:%d)", \
+                  allocs_, #max_allocs, allocs_max_, __FILE__, __LINE__); \
+    } \
+} while(0)
+
 /* Test function typedef */
 typedef bool (*TestFunc)(void);
 
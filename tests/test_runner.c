@@ -26,6 +26,17 @@ void run_compare_columns_tests(void);
 void run_compare_constraints_tests(void);
 void run_compare_schema_tests(void);
 void run_type_integration_tests(void);
+void run_compare_types_tests(void);
+void run_compare_indexes_tests(void);
+void run_trace_tests(void);
+void run_alloc_budget_tests(void);
+void run_json_tests(void);
+void run_server_tests(void);
+void run_watch_tests(void);
+void run_api_tests(void);
+void run_pipeline_tests(void);
+void run_journal_tests(void);
+void run_metrics_tests(void);
 /* Add more test suite declarations here */
 
 /* Global filter variables (defined in test_framework.c) */
@@ -69,6 +80,17 @@ static void list_test_suites(void) {
     printf("  - compare_constraints\n");
     printf("  - compare_schema\n");
     printf("  - type_integration\n");
+    printf("  - compare_types\n");
+    printf("  - compare_indexes\n");
+    printf("  - trace\n");
+    printf("  - alloc_budget\n");
+    printf("  - json\n");
+    printf("  - server\n");
+    printf("  - watch\n");
+    printf("  - api\n");
+    printf("  - pipeline\n");
+    printf("  - journal\n");
+    printf("  - metrics\n");
 }
 
 int main(int argc, char **argv) {
@@ -159,6 +181,17 @@ int main(int argc, char **argv) {
     run_compare_constraints_tests();
     run_compare_schema_tests();
     run_type_integration_tests();
+    run_compare_types_tests();
+    run_compare_indexes_tests();
+    run_trace_tests();
+    run_alloc_budget_tests();
+    run_json_tests();
+    run_server_tests();
+    run_watch_tests();
+    run_api_tests();
+    run_pipeline_tests();
+    run_journal_tests();
+    run_metrics_tests();
     /* Add more test suite calls here */
 
     /* Print summary */
@@ -0,0 +1,160 @@
+#include "../test_framework.h"
+#include "compare.h"
+#include "parser.h"
+#include "pg_create_table.h"
+#include "sc_memory.h"
+#include "utils.h"
+#include <string.h>
+
+/* Allocation budgets for hot paths. The per-item ceilings are pinned just
+ * above the current cost; lower one when a change reduces allocations and
+ * raise one only together with the change that needs it.
+ *
+ * A word token currently costs 3 allocations (lexeme plus two copies for the
+ * keyword lookup), punctuation 1. */
+#define ALLOCS_PER_TOKEN 2.5
+#define ALLOCS_PER_TABLE 127
+#define ALLOCS_PER_COLUMN_COMPARED 5.3
+
+/* Build "CREATE TABLE name (c0 integer NOT NULL, c1 text, ...);" */
+static char *build_table_sql(const char *name, int columns, const char *alt_type) {
+    StringBuilder *sb = sb_create();
+    sb_append_fmt(sb, "CREATE TABLE %s (\n", name);
+    for (int c = 0; c < columns; c++) {
+        const char *type = (c % 2) ? "text" : "integer";
+        if (alt_type && c % 10 == 5) {
+            type = alt_type;
+        }
+        sb_append_fmt(sb, "    c%d %s%s%s\n", c, type, c % 3 ? "" : " NOT NULL",
+                      c + 1 < columns ? "," : "");
+    }
+    sb_append(sb, ");\n");
+    char *sql = sb_to_string(sb);
+    sb_free(sb);
+    return sql;
+}
+
+static CreateTableStmt *parse_one_table(const char *sql) {
+    Parser *parser = parser_create(sql);
+    if (!parser) {
+        return NULL;
+    }
+    CreateTableStmt *stmt = parser_parse_create_table(parser);
+    parser_destroy(parser);
+    return stmt;
+}
+
+/* Test: malloc interposition sees allocations made by library code */
+TEST_CASE(alloc_budget, hook_counts_malloc) {
+    if (!test_alloc_hook_active()) {
+        TEST_SKIP("malloc interposition not available on this platform");
+    }
+
+    char *copy = NULL;
+    ASSERT_ALLOCS_LE(1, copy = strdup("counted"));
+    ASSERT_NOT_NULL(copy);
+
+    size_t before = test_alloc_count();
+    free(copy);
+    copy = strdup("counted");
+    ASSERT_EQ(test_alloc_count() - before, 1);
+    free(copy);
+
+    TEST_PASS();
+}
+
+/* Test: Lexing allocates at most ALLOCS_PER_TOKEN per token */
+TEST_CASE(alloc_budget, lexer_per_token) {
+    char *sql = build_table_sql("lexed", 200, NULL);
+    ASSERT_NOT_NULL(sql);
+
+    size_t tokens = 0;
+    ASSERT_ALLOCS_LE(tokens * ALLOCS_PER_TOKEN, {
+        Lexer lexer;
+        lexer_init(&lexer, sql);
+        while (true) {
+            Token token = lexer_next_token(&lexer);
+            TokenType type = token.type;
+            lexer_free_token(&token);
+            tokens++;
+            if (type == TOKEN_EOF || type == TOKEN_ERROR) {
+                break;
+            }
+        }
+        lexer_cleanup(&lexer);
+    });
+    ASSERT_TRUE(tokens > 700);
+
+    free(sql);
+    TEST_PASS();
+}
+
+/* Test: Parsing allocates at most ALLOCS_PER_TABLE per 8-column table */
+TEST_CASE(alloc_budget, parser_per_table) {
+    const int table_count = 50;
+    StringBuilder *sb = sb_create();
+    for (int t = 0; t < table_count; t++) {
+        char name[32];
+        snprintf(name, sizeof(name), "t%d", t);
+        char *sql = build_table_sql(name, 8, NULL);
+        sb_append(sb, sql);
+        free(sql);
+    }
+    char *ddl = sb_to_string(sb);
+    sb_free(sb);
+
+    int parsed = 0;
+    ASSERT_ALLOCS_LE(table_count * ALLOCS_PER_TABLE, {
+        Parser *parser = parser_create(ddl);
+        Schema *schema = parse_all_statements(parser);
+        parsed = schema ? schema->table_count : 0;
+        for (int i = 0; i < parsed; i++) {
+            free_create_table_stmt(schema->tables[i]);
+        }
+        parser_destroy(parser);
+    });
+    ASSERT_EQ(parsed, table_count);
+
+    free(ddl);
+    TEST_PASS();
+}
+
+/* Test: Comparing tables allocates at most ALLOCS_PER_COLUMN_COMPARED per column */
+TEST_CASE(alloc_budget, compare_per_column) {
+    const int columns = 200;
+    char *source_sql = build_table_sql("cmp", columns, NULL);
+    char *target_sql = build_table_sql("cmp", columns, "bigint");
+    CreateTableStmt *source = parse_one_table(source_sql);
+    CreateTableStmt *target = parse_one_table(target_sql);
+    ASSERT_NOT_NULL(source);
+    ASSERT_NOT_NULL(target);
+
+    CompareOptions *opts = compare_options_default();
+    int diffs = 0;
+    ASSERT_ALLOCS_LE(columns * ALLOCS_PER_COLUMN_COMPARED, {
+        TableDiff *diff = compare_tables(source, target, opts, NULL);
+        diffs = diff ? diff->diff_count : 0;
+        table_diff_free(diff);
+    });
+    ASSERT_TRUE(diffs > 0);
+
+    compare_options_free(opts);
+    free_create_table_stmt(source);
+    free_create_table_stmt(target);
+    free(source_sql);
+    free(target_sql);
+    TEST_PASS();
+}
+
+/* Test suite definition */
+static TestCase alloc_budget_tests[] = {
+    {"hook_counts_malloc", test_alloc_budget_hook_counts_malloc, "alloc_budget"},
+    {"lexer_per_token", test_alloc_budget_lexer_per_token, "alloc_budget"},
+    {"parser_per_table", test_alloc_budget_parser_per_table, "alloc_budget"},
+    {"compare_per_column", test_alloc_budget_compare_per_column, "alloc_budget"},
+};
+
+void run_alloc_budget_tests(void) {
+    run_test_suite("alloc_budget", NULL, NULL, alloc_budget_tests,
+                   sizeof(alloc_budget_tests) / sizeof(alloc_budget_tests[0]));
+}
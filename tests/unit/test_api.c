@@ -0,0 +1,241 @@
+#include "../test_framework.h"
+#include "libschemacompare.h"
+#include "utils.h"
+#include <libpq-fe.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CURRENT_SQL \
+    "CREATE TABLE users (id integer, name varchar(50));\n" \
+    "CREATE TABLE legacy (id integer);\n"
+
+#define DESIRED_SQL \
+    "CREATE TABLE users (id integer, name text, email text);\n" \
+    "CREATE TABLE items (id integer);\n"
+
+/* Test: Comparing two SQL sources reports the expected counts and output */
+TEST_CASE(api, compare_sql_sources) {
+    SCContext *ctx = sc_context_create();
+    ASSERT_NOT_NULL(ctx);
+    ASSERT_EQ(sc_version() >> 16, SC_API_VERSION_MAJOR);
+
+    SCSchema *current = NULL;
+    SCSchema *desired = NULL;
+    ASSERT_EQ(sc_load_sql(ctx, CURRENT_SQL, &current), SC_OK);
+    ASSERT_EQ(sc_load_sql(ctx, DESIRED_SQL, &desired), SC_OK);
+    ASSERT_EQ(sc_schema_table_count(current), 2);
+
+    SCDiff *diff = NULL;
+    ASSERT_EQ(sc_compare(ctx, current, desired, &diff), SC_OK);
+    ASSERT_EQ(sc_diff_count(diff, SC_COUNT_TABLES_ADDED), 1);
+    ASSERT_EQ(sc_diff_count(diff, SC_COUNT_TABLES_REMOVED), 1);
+    ASSERT_EQ(sc_diff_count(diff, SC_COUNT_TABLES_MODIFIED), 1);
+    ASSERT_EQ(sc_diff_count(diff, SC_COUNT_DESTRUCTIVE), 1);
+    ASSERT_TRUE(sc_diff_count(diff, SC_COUNT_STATEMENTS) > 0);
+
+    /* The diff keeps both schemas alive */
+    sc_schema_release(current);
+    sc_schema_release(desired);
+
+    const char *sql = NULL;
+    ASSERT_EQ(sc_diff_sql(diff, &sql), SC_OK);
+    ASSERT_NOT_NULL(strstr(sql, "CREATE TABLE"));
+    ASSERT_NOT_NULL(strstr(sql, "items"));
+    ASSERT_NOT_NULL(strstr(sql, "BEGIN"));
+
+    const char *report = NULL;
+    ASSERT_EQ(sc_diff_report(diff, &report), SC_OK);
+    ASSERT_NOT_NULL(strstr(report, "legacy"));
+
+    sc_diff_release(diff);
+    sc_context_free(ctx);
+    TEST_PASS();
+}
+
+/* Test: Options are validated and apply to later output */
+TEST_CASE(api, options) {
+    SCContext *ctx = sc_context_create();
+    ASSERT_NOT_NULL(ctx);
+
+    ASSERT_EQ(sc_context_set_option(ctx, "no_such_option", "1"), SC_ERROR_INVALID_ARG);
+    ASSERT_NOT_NULL(strstr(sc_context_error(ctx), "no_such_option"));
+    ASSERT_EQ(sc_context_set_option(ctx, "transactions", "maybe"), SC_ERROR_INVALID_ARG);
+    ASSERT_EQ(sc_context_set_option(ctx, "report_format", "xml"), SC_ERROR_INVALID_ARG);
+    ASSERT_EQ(sc_context_set_option(ctx, "transactions", "off"), SC_OK);
+    ASSERT_EQ(sc_context_set_option(ctx, "report_format", "markdown"), SC_OK);
+
+    SCSchema *current = NULL;
+    SCSchema *desired = NULL;
+    SCDiff *diff = NULL;
+    ASSERT_EQ(sc_load_sql(ctx, CURRENT_SQL, &current), SC_OK);
+    ASSERT_EQ(sc_load_sql(ctx, DESIRED_SQL, &desired), SC_OK);
+    ASSERT_EQ(sc_compare(ctx, current, desired, &diff), SC_OK);
+
+    const char *sql = NULL;
+    ASSERT_EQ(sc_diff_sql(diff, &sql), SC_OK);
+    ASSERT_NULL(strstr(sql, "BEGIN;"));
+
+    const char *report = NULL;
+    ASSERT_EQ(sc_diff_report(diff, &report), SC_OK);
+    ASSERT_NOT_NULL(report);
+    ASSERT_NOT_NULL(strstr(report, "users"));
+
+    /* Reset releases everything but keeps the options */
+    sc_context_reset(ctx);
+    ASSERT_EQ(sc_load_sql(ctx, CURRENT_SQL, &current), SC_OK);
+    ASSERT_EQ(sc_load_sql(ctx, DESIRED_SQL, &desired), SC_OK);
+    ASSERT_EQ(sc_compare(ctx, current, desired, &diff), SC_OK);
+    ASSERT_EQ(sc_diff_sql(diff, &sql), SC_OK);
+    ASSERT_NULL(strstr(sql, "BEGIN;"));
+
+    sc_context_free(ctx);
+    TEST_PASS();
+}
+
+/* Test: File loads are served from the cache until the file changes */
+TEST_CASE(api, file_cache) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/sc_api_%d.sql", (int)getpid());
+    ASSERT_TRUE(write_string_to_file(path, CURRENT_SQL));
+
+    SCContext *ctx = sc_context_create();
+    ASSERT_NOT_NULL(ctx);
+
+    SCSchema *first = NULL;
+    SCSchema *second = NULL;
+    ASSERT_EQ(sc_load_file(ctx, path, &first), SC_OK);
+    ASSERT_EQ(sc_load_file(ctx, path, &second), SC_OK);
+    ASSERT_PTR_EQ(first, second);
+    sc_schema_release(first);
+    sc_schema_release(second);
+
+    /* Still cached after the caller released every handle */
+    ASSERT_EQ(sc_load_file(ctx, path, &second), SC_OK);
+    ASSERT_PTR_EQ(first, second);
+    sc_schema_release(second);
+
+    ASSERT_TRUE(write_string_to_file(path, DESIRED_SQL "CREATE TABLE extra (id integer);\n"));
+    SCSchema *changed = NULL;
+    ASSERT_EQ(sc_load_file(ctx, path, &changed), SC_OK);
+    ASSERT_EQ(sc_schema_table_count(changed), 3);
+
+    ASSERT_EQ(sc_load_file(ctx, "/nonexistent/schema.sql", &first), SC_ERROR_IO);
+    ASSERT_NULL(first);
+    ASSERT_EQ(sc_load_directory(ctx, path, &first), SC_ERROR_IO);
+
+    sc_context_free(ctx);
+    unlink(path);
+    TEST_PASS();
+}
+
+/* Write name under dir with the given contents */
+static bool write_in_dir(const char *dir, const char *name, const char *sql) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    return write_string_to_file(path, sql);
+}
+
+static void remove_dir(const char *dir, const char *const *names, int count) {
+    char path[128];
+    for (int i = 0; i < count; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        unlink(path);
+    }
+    rmdir(dir);
+}
+
+/* Test: Byte-identical files are borrowed from the reference and compare equal */
+TEST_CASE(api, directory_against_reference) {
+    static const char *names[] = {"orders.sql", "status.sql", "users.sql"};
+    char desired_dir[64];
+    char current_dir[64];
+    snprintf(desired_dir, sizeof(desired_dir), "/tmp/sc_api_desired_XXXXXX");
+    snprintf(current_dir, sizeof(current_dir), "/tmp/sc_api_current_XXXXXX");
+    ASSERT_NOT_NULL(mkdtemp(desired_dir));
+    ASSERT_NOT_NULL(mkdtemp(current_dir));
+
+    const char *orders = "CREATE TABLE orders (id integer, status order_status);\n";
+    const char *status = "CREATE TYPE order_status AS ENUM ('new', 'paid');\n";
+    for (int d = 0; d < 2; d++) {
+        const char *dir = d ? current_dir : desired_dir;
+        ASSERT_TRUE(write_in_dir(dir, names[0], orders));
+        ASSERT_TRUE(write_in_dir(dir, names[1], status));
+    }
+    ASSERT_TRUE(write_in_dir(desired_dir, names[2], "CREATE TABLE users (id integer, email text);\n"));
+    ASSERT_TRUE(write_in_dir(current_dir, names[2], "CREATE TABLE users (id integer);\n"));
+
+    SCContext *ctx = sc_context_create();
+    ASSERT_NOT_NULL(ctx);
+    SCSchema *desired = NULL;
+    SCSchema *current = NULL;
+    ASSERT_EQ(sc_load_directory(ctx, desired_dir, &desired), SC_OK);
+    ASSERT_EQ(sc_load_directory_against(ctx, current_dir, desired, &current), SC_OK);
+    ASSERT_EQ(sc_schema_table_count(current), 2);
+
+    /* The borrowed statements outlive the caller's handle on the reference */
+    sc_schema_release(desired);
+    SCDiff *diff = NULL;
+    ASSERT_EQ(sc_compare(ctx, current, desired, &diff), SC_OK);
+    ASSERT_EQ(sc_diff_count(diff, SC_COUNT_TABLES_ADDED), 0);
+    ASSERT_EQ(sc_diff_count(diff, SC_COUNT_TABLES_REMOVED), 0);
+    ASSERT_EQ(sc_diff_count(diff, SC_COUNT_TABLES_MODIFIED), 1);
+    ASSERT_EQ(sc_diff_count(diff, SC_COUNT_CHANGES), 1);
+    sc_diff_release(diff);
+    sc_schema_release(current);
+
+    ASSERT_EQ(sc_load_directory_against(ctx, current_dir, NULL, &current),
+              SC_ERROR_INVALID_ARG);
+    sc_context_free(ctx);
+    remove_dir(desired_dir, names, 3);
+    remove_dir(current_dir, names, 3);
+    TEST_PASS();
+}
+
+/* Test: Invalid arguments and unusable connections fail with a status */
+TEST_CASE(api, error_paths) {
+    SCContext *ctx = sc_context_create();
+    ASSERT_NOT_NULL(ctx);
+
+    SCSchema *schema = NULL;
+    ASSERT_EQ(sc_load_sql(ctx, NULL, &schema), SC_ERROR_INVALID_ARG);
+    ASSERT_EQ(sc_load_sql(NULL, CURRENT_SQL, &schema), SC_ERROR_INVALID_ARG);
+    ASSERT_EQ(sc_introspect(ctx, NULL, NULL, &schema), SC_ERROR_INVALID_ARG);
+
+    PGconn *conn = PQconnectdb("host=/nonexistent dbname=none connect_timeout=1");
+    ASSERT_NOT_NULL(conn);
+    ASSERT_EQ(sc_introspect(ctx, conn, NULL, &schema), SC_ERROR_DB);
+    ASSERT_NULL(schema);
+    ASSERT_NOT_NULL(strstr(sc_context_error(ctx), "not usable"));
+    PQfinish(conn);
+
+    /* Schemas from another context are rejected */
+    SCContext *other = sc_context_create();
+    SCSchema *mine = NULL;
+    SCSchema *theirs = NULL;
+    SCDiff *diff = NULL;
+    ASSERT_EQ(sc_load_sql(ctx, CURRENT_SQL, &mine), SC_OK);
+    ASSERT_EQ(sc_load_sql(other, CURRENT_SQL, &theirs), SC_OK);
+    ASSERT_EQ(sc_compare(ctx, mine, theirs, &diff), SC_ERROR_INVALID_ARG);
+    ASSERT_NULL(diff);
+
+    ASSERT_STR_EQ(sc_status_string(SC_ERROR_PARSE), "parse error");
+    sc_context_free(other);
+    sc_context_free(ctx);
+    TEST_PASS();
+}
+
+/* Test suite definition */
+static TestCase api_tests[] = {
+    {"compare_sql_sources", test_api_compare_sql_sources, "api"},
+    {"options", test_api_options, "api"},
+    {"file_cache", test_api_file_cache, "api"},
+    {"directory_against_reference", test_api_directory_against_reference, "api"},
+    {"error_paths", test_api_error_paths, "api"},
+};
+
+void run_api_tests(void) {
+    run_test_suite("api", NULL, NULL, api_tests,
+                   sizeof(api_tests) / sizeof(api_tests[0]));
+}
@@ -190,6 +190,42 @@ TEST_CASE(diff, constraint_diff_create) {
     TEST_PASS();
 }
 
+/* Test: Table diffs are indexed by name, with their key changes */
+TEST_CASE(diff, schema_diff_index_tables) {
+    SchemaDiff *sd = schema_diff_create("public");
+    TableDiff *users = table_diff_create("users");
+    TableDiff *orders = table_diff_create("orders");
+    ConstraintDiff *key = constraint_diff_create("users_email_key");
+    ASSERT_NOT_NULL(sd);
+    ASSERT_NOT_NULL(users);
+    ASSERT_NOT_NULL(orders);
+    ASSERT_NOT_NULL(key);
+    key->new_type = TABLE_CONSTRAINT_UNIQUE;
+    users->constraints_added = key;
+    users->next = orders;
+    sd->table_diffs = users;
+
+    ASSERT_NULL(schema_diff_find_table(sd, "users"));
+    ASSERT_TRUE(schema_diff_index_tables(sd));
+    ASSERT_EQ(sd->table_entry_count, 2);
+
+    const TableDiffEntry *entry = schema_diff_find_table(sd, "users");
+    ASSERT_NOT_NULL(entry);
+    ASSERT_TRUE(entry->diff == users);
+    ASSERT_TRUE(entry->keys_added);
+    ASSERT_FALSE(entry->keys_removed);
+    ASSERT_TRUE(schema_diff_find_table(sd, "public.orders") == &sd->table_entries[1]);
+    ASSERT_FALSE(sd->table_entries[1].keys_added);
+    ASSERT_NULL(schema_diff_find_table(sd, "customers"));
+
+    /* Reindexing replaces the previous index */
+    ASSERT_TRUE(schema_diff_index_tables(sd));
+    ASSERT_EQ(sd->table_entry_count, 2);
+
+    schema_diff_free(sd);
+    TEST_PASS();
+}
+
 /* Test suite definition */
 static TestCase diff_tests[] = {
     {"create_diff", test_diff_create_diff, "diff"},
@@ -205,6 +241,7 @@ static TestCase diff_tests[] = {
     {"table_diff_create", test_diff_table_diff_create, "diff"},
     {"column_diff_create", test_diff_column_diff_create, "diff"},
     {"constraint_diff_create", test_diff_constraint_diff_create, "diff"},
+    {"schema_diff_index_tables", test_diff_schema_diff_index_tables, "diff"},
 };
 
 void run_diff_tests(void) {
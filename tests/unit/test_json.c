@@ -0,0 +1,93 @@
+#include "../test_framework.h"
+#include "utils.h"
+#include <string.h>
+
+/* Test: Strings, numbers and literals are read; strings are unescaped */
+TEST_CASE(json, parse_flat_object) {
+    JsonObject *obj = json_parse_object(
+        " {\"op\": \"compare\", \"id\": 42, \"quiet\": true, \"note\": null,"
+        " \"path\": \"a\\\\b\\n\\\"c\\\"\"} ", NULL);
+    ASSERT_NOT_NULL(obj);
+    ASSERT_EQ(obj->count, 5);
+    ASSERT_STR_EQ(json_object_get_string(obj, "op"), "compare");
+    ASSERT_STR_EQ(json_object_get_string(obj, "path"), "a\\b\n\"c\"");
+
+    const JsonField *id = json_object_get(obj, "id");
+    ASSERT_NOT_NULL(id);
+    ASSERT_FALSE(id->is_string);
+    ASSERT_STR_EQ(id->value, "42");
+    ASSERT_NULL(json_object_get_string(obj, "id"));
+    ASSERT_STR_EQ(json_object_get(obj, "quiet")->value, "true");
+    ASSERT_NULL(json_object_get(obj, "missing"));
+
+    json_object_free(obj);
+    TEST_PASS();
+}
+
+/* Test: \u escapes, including surrogate pairs, decode to UTF-8 */
+TEST_CASE(json, unicode_escapes) {
+    JsonObject *obj = json_parse_object("{\"s\":\"\\u00e9\\u20ac\\ud83d\\ude00\"}", NULL);
+    ASSERT_NOT_NULL(obj);
+    ASSERT_STR_EQ(json_object_get_string(obj, "s"), "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80");
+    json_object_free(obj);
+
+    obj = json_parse_object("{}", NULL);
+    ASSERT_NOT_NULL(obj);
+    ASSERT_EQ(obj->count, 0);
+    json_object_free(obj);
+
+    TEST_PASS();
+}
+
+/* Test: Malformed and nested input is rejected with a message */
+TEST_CASE(json, rejects_invalid) {
+    const char *inputs[] = {
+        "", "[]", "{\"a\"}", "{\"a\":1,}", "{\"a\":\"unterminated}",
+        "{\"a\":{\"b\":1}}", "{\"a\":[1]}", "{\"a\":bogus}", "{\"a\":1} x",
+        "{\"a\":\"\\q\"}", "{a:1}",
+    };
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        const char *error = NULL;
+        ASSERT_NULL(json_parse_object(inputs[i], &error));
+        ASSERT_NOT_NULL(error);
+    }
+
+    const char *error = NULL;
+    json_parse_object("{\"a\":{}}", &error);
+    ASSERT_STR_EQ(error, "Nested values are not supported");
+
+    TEST_PASS();
+}
+
+/* Test: Values are re-encoded as JSON */
+TEST_CASE(json, append_value) {
+    JsonObject *obj = json_parse_object("{\"s\":\"x\\\"y\",\"n\":-1.5}", NULL);
+    ASSERT_NOT_NULL(obj);
+
+    StringBuilder *sb = sb_create();
+    sb_append_json_value(sb, json_object_get(obj, "s"));
+    sb_append_char(sb, ' ');
+    sb_append_json_value(sb, json_object_get(obj, "n"));
+    sb_append_char(sb, ' ');
+    sb_append_json_value(sb, json_object_get(obj, "missing"));
+    char *out = sb_to_string(sb);
+    ASSERT_STR_EQ(out, "\"x\\\"y\" -1.5 null");
+
+    free(out);
+    sb_free(sb);
+    json_object_free(obj);
+    TEST_PASS();
+}
+
+/* Test suite definition */
+static TestCase json_tests[] = {
+    {"parse_flat_object", test_json_parse_flat_object, "json"},
+    {"unicode_escapes", test_json_unicode_escapes, "json"},
+    {"rejects_invalid", test_json_rejects_invalid, "json"},
+    {"append_value", test_json_append_value, "json"},
+};
+
+void run_json_tests(void) {
+    run_test_suite("json", NULL, NULL, json_tests,
+                   sizeof(json_tests) / sizeof(json_tests[0]));
+}
@@ -1,5 +1,7 @@
 #include "../test_framework.h"
 #include "lexer.h"
+#include "schema_compare.h"
+#include "utils.h"
 #include <string.h>
 
 /* Test: Tokenize CREATE keyword */
@@ -440,6 +442,78 @@ TEST_CASE(lexer, number_formats) {
     TEST_PASS();
 }
 
+/* Test: Non-ASCII letters are identifier characters; columns count characters */
+TEST_CASE(lexer, utf8_identifiers) {
+    Lexer lexer;
+    lexer_init(&lexer, "CREATE TABLE \xC3\xA9l\xC3\xA8ves (\xE5\x90\x8D\xE5\x89\x8D text)");
+
+    Token token = lexer_next_token(&lexer);
+    lexer_free_token(&token);
+    token = lexer_next_token(&lexer);
+    lexer_free_token(&token);
+
+    token = lexer_next_token(&lexer);
+    ASSERT_EQ(token.type, TOKEN_IDENTIFIER);
+    ASSERT_STR_EQ(token.lexeme, "\xC3\xA9l\xC3\xA8ves");
+    ASSERT_EQ(token.column, 14);
+    lexer_free_token(&token);
+
+    token = lexer_next_token(&lexer);
+    ASSERT_EQ(token.type, TOKEN_LPAREN);
+    ASSERT_EQ(token.column, 21);
+    lexer_free_token(&token);
+
+    token = lexer_next_token(&lexer);
+    ASSERT_EQ(token.type, TOKEN_IDENTIFIER);
+    ASSERT_STR_EQ(token.lexeme, "\xE5\x90\x8D\xE5\x89\x8D");
+    lexer_free_token(&token);
+
+    token = lexer_next_token(&lexer);
+    ASSERT_EQ(token.type, TOKEN_IDENTIFIER);
+    ASSERT_STR_EQ(token.lexeme, "text");
+    lexer_free_token(&token);
+
+    ASSERT_FALSE(lexer.had_error);
+    lexer_cleanup(&lexer);
+    TEST_PASS();
+}
+
+/* Test: Validation accepts well-formed UTF-8 and reports the first bad byte */
+TEST_CASE(lexer, utf8_validation) {
+    /* Long ASCII runs exercise the vectorized path */
+    const char *ascii = "CREATE TABLE customers (id integer, name text, email text);";
+    ASSERT_TRUE(utf8_validate(ascii, strlen(ascii), NULL));
+
+    const char *mixed = "CREATE TABLE caf\xC3\xA9 (\xF0\x9F\x98\x80 text, \xE2\x82\xAC numeric);";
+    ASSERT_TRUE(utf8_validate(mixed, strlen(mixed), NULL));
+
+    size_t offset = 0;
+    const char *latin1 = "CREATE TABLE customers_and_orders (caf\xE9 text);";
+    ASSERT_FALSE(utf8_validate(latin1, strlen(latin1), &offset));
+    ASSERT_EQ(offset, 38);
+
+    const char *invalid[] = {
+        "\xC0\xAF",          /* overlong */
+        "\xED\xA0\x80",      /* surrogate */
+        "\xF4\x90\x80\x80",  /* past U+10FFFF */
+        "\xE2\x82",          /* truncated */
+        "\x80",              /* stray continuation */
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        ASSERT_FALSE(utf8_validate(invalid[i], strlen(invalid[i]), &offset));
+        ASSERT_EQ(offset, 0);
+    }
+
+    /* The loader rejects invalid input before parsing */
+    ASSERT_NULL(load_from_string("CREATE TABLE caf\xE9 (id integer);", NULL));
+    Schema *schema = load_from_string("CREATE TABLE caf\xC3\xA9 (n\xC2\xBA integer);", NULL);
+    ASSERT_NOT_NULL(schema);
+    ASSERT_EQ(schema->table_count, 1);
+    ASSERT_STR_EQ(schema->tables[0]->table_name, "caf\xC3\xA9");
+    schema_free(schema);
+    TEST_PASS();
+}
+
 /* Test suite definition */
 static TestCase lexer_tests[] = {
     {"tokenize_create", test_lexer_tokenize_create, "lexer"},
@@ -466,6 +540,8 @@ static TestCase lexer_tests[] = {
     {"only_comments", test_lexer_only_comments, "lexer"},
     {"all_keywords", test_lexer_all_keywords, "lexer"},
     {"number_formats", test_lexer_number_formats, "lexer"},
+    {"utf8_identifiers", test_lexer_utf8_identifiers, "lexer"},
+    {"utf8_validation", test_lexer_utf8_validation, "lexer"},
 };
 
 void run_lexer_tests(void) {
@@ -1,5 +1,8 @@
 #include "../test_framework.h"
 #include "sc_memory.h"
+#include "parser.h"
+#include "pg_table_layout.h"
+#include <stdlib.h>
 #include <string.h>
 
 /* Test: Create and destroy memory context */
@@ -135,6 +138,181 @@ TEST_CASE(memory, strdup) {
     TEST_PASS();
 }
 
+/* Test: mem_* calls update the allocation counters */
+TEST_CASE(memory, allocation_counters) {
+    MemoryContext *ctx = memory_context_create("test_counters");
+    ASSERT_NOT_NULL(ctx);
+
+    MemoryCounters before;
+    memory_counters_get(&before);
+
+    void *ptr = mem_alloc(ctx, 64);
+    char *copy = mem_strdup(ctx, "abc");
+    ptr = mem_realloc(ctx, ptr, 128);
+    mem_free(ctx, copy);
+
+    MemoryCounters after;
+    memory_counters_get(&after);
+    ASSERT_EQ(after.allocations - before.allocations, 3);
+    ASSERT_EQ(after.frees - before.frees, 1);
+    ASSERT_EQ(after.bytes - before.bytes, 64 + 4 + 128);
+
+    memory_context_destroy(ctx);
+    TEST_PASS();
+}
+
+/* Test: Marks free or hand over everything allocated after them */
+TEST_CASE(memory, context_marks) {
+    MemoryContext *ctx = memory_context_create("test_marks");
+    ASSERT_NOT_NULL(ctx);
+
+    void *kept = mem_alloc(ctx, 16);
+    size_t before = memory_context_get_allocated(ctx);
+    size_t mark = memory_context_mark(ctx);
+    (void)mem_alloc(ctx, 32);
+    (void)mem_strdup(ctx, "discarded");
+    memory_context_reset_to(ctx, mark);
+    ASSERT_EQ(memory_context_get_allocated(ctx), before);
+
+    /* Released blocks belong to the caller and survive the context */
+    mark = memory_context_mark(ctx);
+    char *owned = mem_strdup(ctx, "owned");
+    kept = mem_realloc(ctx, kept, 64);
+    memory_context_release(ctx, mark);
+    ASSERT_NOT_NULL(kept);
+    ASSERT_EQ(memory_context_get_allocated(ctx), 64);
+
+    memory_context_destroy(ctx);
+    ASSERT_STR_EQ(owned, "owned");
+    free(owned);
+    TEST_PASS();
+}
+
+static void count_exceeded(void *arg) {
+    (*(int *)arg)++;
+}
+
+/* Test: Passing the limit calls back once; allocations keep succeeding */
+TEST_CASE(memory, context_limit) {
+    MemoryContext *ctx = memory_context_create("test_limit");
+    ASSERT_NOT_NULL(ctx);
+    int exceeded = 0;
+    memory_context_set_limit(ctx, 100, count_exceeded, &exceeded);
+
+    void *block = mem_alloc(ctx, 60);
+    ASSERT_EQ(exceeded, 0);
+    ASSERT_FALSE(memory_context_over_limit(ctx));
+
+    /* Growing a block counts too */
+    block = mem_realloc(ctx, block, 120);
+    ASSERT_NOT_NULL(block);
+    ASSERT_EQ(exceeded, 1);
+    ASSERT_TRUE(memory_context_over_limit(ctx));
+
+    ASSERT_NOT_NULL(mem_alloc(ctx, 1000));
+    ASSERT_EQ(exceeded, 1);
+
+    /* No limit: never called */
+    memory_context_set_limit(ctx, 0, count_exceeded, &exceeded);
+    ASSERT_NOT_NULL(mem_alloc(ctx, 1000));
+    ASSERT_EQ(exceeded, 1);
+    ASSERT_FALSE(memory_context_over_limit(ctx));
+
+    memory_context_destroy(ctx);
+    TEST_PASS();
+}
+
+/* Test: A statement that fails to parse leaves nothing behind */
+TEST_CASE(memory, failed_parse_frees_partial_statement) {
+    Parser *parser = parser_create(
+        "CREATE TABLE t (a INTEGER DEFAULT 1 CHECK (a > 0), b VARCHAR(10)) INHERITS (");
+    ASSERT_NOT_NULL(parser);
+    size_t before = memory_context_get_allocated(parser->memory_ctx);
+
+    CreateTableStmt *stmt = parser_parse_create_table(parser);
+    ASSERT_NULL(stmt);
+    ASSERT_EQ(memory_context_get_allocated(parser->memory_ctx), before);
+
+    parser_destroy(parser);
+    TEST_PASS();
+}
+
+/* Test: Table layout flattens columns and constraints */
+TEST_CASE(memory, table_layout_build) {
+    Parser *parser = parser_create(
+        "CREATE TABLE t (id INTEGER PRIMARY KEY DEFERRABLE INITIALLY DEFERRED, "
+        "name TEXT COLLATE \"C\" NOT NULL DEFAULT 'x', "
+        "CONSTRAINT fk FOREIGN KEY (id) REFERENCES p (id));");
+    ASSERT_NOT_NULL(parser);
+    CreateTableStmt *stmt = parser_parse_create_table(parser);
+    parser_destroy(parser);
+    ASSERT_NOT_NULL(stmt);
+
+    TableLayout *layout = table_layout_build(stmt, NULL);
+    ASSERT_NOT_NULL(layout);
+    ASSERT_EQ(layout->column_count, 2);
+    ASSERT_EQ(layout->table_constraint_count, 1);
+
+    /* Table constraints come first */
+    const LayoutConstraint *fk = &layout->constraints[0];
+    ASSERT_EQ(fk->column, -1);
+    ASSERT_EQ(fk->type, TABLE_CONSTRAINT_FOREIGN_KEY);
+    ASSERT_STR_EQ(table_layout_string(layout, fk->name), "fk");
+    ASSERT_FALSE(fk->flags.has_deferrable);
+    ASSERT_NOT_NULL(table_layout_table_constraint(layout, 0));
+    ASSERT_NULL(table_layout_column_constraint(layout, 0));
+
+    const LayoutColumn *name = &layout->columns[1];
+    ASSERT_STR_EQ(table_layout_string(layout, name->name), "name");
+    ASSERT_STR_EQ(table_layout_string(layout, name->data_type), "TEXT");
+    ASSERT_STR_EQ(table_layout_string(layout, name->default_expr), "'x'");
+    ASSERT_NULL(table_layout_string(layout, name->compression));
+    ASSERT_TRUE(name->not_null);
+    ASSERT_FALSE(layout->columns[0].not_null);
+
+    /* Each column's constraints are contiguous and map back to the AST */
+    const LayoutColumn *id = &layout->columns[0];
+    ASSERT_EQ(id->constraint_count, 1);
+    const LayoutConstraint *pk = &layout->constraints[id->first_constraint];
+    ASSERT_EQ(pk->type, CONSTRAINT_PRIMARY_KEY);
+    ASSERT_TRUE(pk->flags.has_deferrable && pk->flags.deferrable);
+    ASSERT_TRUE(pk->flags.initially_deferred);
+    ASSERT_EQ(layout->constraints[name->first_constraint].column, 1);
+    ASSERT_EQ(id->first_constraint + id->constraint_count, name->first_constraint);
+    ASSERT_PTR_EQ(table_layout_column_constraint(layout, id->first_constraint),
+                  table_layout_column_def(layout, 0)->constraints);
+    ASSERT_NULL(table_layout_column_def(layout, 2));
+
+    table_layout_free(layout, NULL);
+    free_create_table_stmt(stmt);
+    TEST_PASS();
+}
+
+/* Test: Byte-identical columns are recognised across layouts */
+TEST_CASE(memory, table_layout_columns_identical) {
+    Parser *p1 = parser_create("CREATE TABLE t (a INTEGER NOT NULL, b TEXT);");
+    Parser *p2 = parser_create("CREATE TABLE t (b TEXT DEFAULT 'y', a INTEGER NOT NULL);");
+    CreateTableStmt *s1 = parser_parse_create_table(p1);
+    CreateTableStmt *s2 = parser_parse_create_table(p2);
+    parser_destroy(p1);
+    parser_destroy(p2);
+    ASSERT_NOT_NULL(s1);
+    ASSERT_NOT_NULL(s2);
+
+    TableLayout *l1 = table_layout_build(s1, NULL);
+    TableLayout *l2 = table_layout_build(s2, NULL);
+    ASSERT_NOT_NULL(l1);
+    ASSERT_NOT_NULL(l2);
+    ASSERT_TRUE(table_layout_columns_identical(l1, 0, l2, 1));
+    ASSERT_FALSE(table_layout_columns_identical(l1, 1, l2, 0));
+
+    table_layout_free(l1, NULL);
+    table_layout_free(l2, NULL);
+    free_create_table_stmt(s1);
+    free_create_table_stmt(s2);
+    TEST_PASS();
+}
+
 /* Test suite definition */
 static TestCase memory_tests[] = {
     {"context_create_destroy", test_memory_context_create_destroy, "memory"},
@@ -145,6 +323,12 @@ static TestCase memory_tests[] = {
     {"large_allocation", test_memory_large_allocation, "memory"},
     {"many_small_allocations", test_memory_many_small_allocations, "memory"},
     {"strdup", test_memory_strdup, "memory"},
+    {"allocation_counters", test_memory_allocation_counters, "memory"},
+    {"context_marks", test_memory_context_marks, "memory"},
+    {"context_limit", test_memory_context_limit, "memory"},
+    {"failed_parse_frees_partial_statement", test_memory_failed_parse_frees_partial_statement, "memory"},
+    {"table_layout_build", test_memory_table_layout_build, "memory"},
+    {"table_layout_columns_identical", test_memory_table_layout_columns_identical, "memory"},
 };
 
 void run_memory_tests(void) {
@@ -0,0 +1,121 @@
+#include "../test_framework.h"
+#include "metrics.h"
+#include "trace.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int count_occurrences(const char *text, const char *needle) {
+    int count = 0;
+    for (const char *p = strstr(text, needle); p; p = strstr(p + 1, needle)) {
+        count++;
+    }
+    return count;
+}
+
+/* Test: Each family appears once with every target's samples under it */
+TEST_CASE(metrics, format_groups_samples_by_family) {
+    Metrics *metrics = metrics_create(3);
+    ASSERT_NOT_NULL(metrics);
+    metrics->source_ok = true;
+    metrics->elapsed_ms = 1500.0;
+
+    SchemaDiff *diff = schema_diff_create("public");
+    ASSERT_NOT_NULL(diff);
+    diff->tables_added = 2;
+    diff->tables_modified = 1;
+    diff->critical_count = 1;
+    diff->warning_count = 4;
+
+    ASSERT_TRUE(metrics_set_target(metrics, 0, "app@db1:5432/app/public", METRICS_TARGET_OK,
+                                   diff, 12.5, 3.0));
+    ASSERT_TRUE(metrics_set_target(metrics, 1, "app@db2:5432/app/\"odd\"", METRICS_TARGET_FAILED,
+                                   NULL, 30000.0, 0.0));
+    ASSERT_TRUE(metrics_set_target(metrics, 2, "app@db3:5432/app/public", METRICS_TARGET_SKIPPED,
+                                   NULL, 0.0, 0.0));
+    schema_diff_free(diff);
+
+    char *text = metrics_format(metrics);
+    ASSERT_NOT_NULL(text);
+
+    ASSERT_EQ(count_occurrences(text, "# TYPE schema_compare_target_up "), 1);
+    ASSERT_EQ(count_occurrences(text, "schema_compare_target_up{"), 3);
+    ASSERT_NOT_NULL(strstr(text, "schema_compare_source_up 1\n"));
+    ASSERT_NOT_NULL(strstr(text, "schema_compare_targets{status=\"failed\"} 1\n"));
+    ASSERT_NOT_NULL(strstr(text, "schema_compare_targets{status=\"skipped\"} 1\n"));
+    ASSERT_NOT_NULL(strstr(text, "schema_compare_targets{status=\"timed_out\"} 0\n"));
+    ASSERT_NOT_NULL(strstr(text, "schema_compare_target_up{target=\"app@db2:5432/app/\\\"odd\\\"\"} 0\n"));
+    ASSERT_NOT_NULL(strstr(text, "schema_compare_target_up{target=\"app@db3:5432/app/public\"} 1\n"));
+    ASSERT_NOT_NULL(strstr(text,
+        "schema_compare_target_drift{target=\"app@db1:5432/app/public\",severity=\"warning\"} 4\n"));
+    ASSERT_NOT_NULL(strstr(text,
+        "schema_compare_target_tables{target=\"app@db1:5432/app/public\",change=\"added\"} 2\n"));
+    ASSERT_NOT_NULL(strstr(text,
+        "schema_compare_target_fetch_duration_seconds{target=\"app@db1:5432/app/public\"} 0.0125\n"));
+
+    /* Only compared targets have drift samples */
+    ASSERT_EQ(count_occurrences(text, "schema_compare_target_drift{"), 3);
+    ASSERT_NOT_NULL(strstr(text, "schema_compare_phase_duration_seconds{phase=\"compare\"}"));
+
+    free(text);
+    metrics_free(metrics);
+    TEST_PASS();
+}
+
+/* Test: Phase totals are kept in stats-only tracing, without span events */
+TEST_CASE(metrics, stats_tracing_records_no_events) {
+    trace_init_stats();
+    int span = TRACE_BEGIN(TRACE_PHASE_COMPARE, "compare_schemas", "db1");
+    int inner = TRACE_BEGIN(TRACE_PHASE_COMPARE, "compare_tables", "t");
+    TRACE_END(inner);
+    TRACE_END(span);
+    TRACE_COUNT(TRACE_COUNTER_CATALOG_BYTES, 42);
+
+    TracePhaseStats stats;
+    trace_get_phase_stats(TRACE_PHASE_COMPARE, &stats);
+    ASSERT_EQ(stats.span_count, 1);
+    ASSERT_EQ(trace_event_count(), 0);
+    ASSERT_EQ(trace_counter_get(TRACE_COUNTER_CATALOG_BYTES), 42);
+    trace_shutdown();
+    TEST_PASS();
+}
+
+/* Test: The file is replaced whole, with no temporary left behind */
+TEST_CASE(metrics, write_replaces_file) {
+    char path[64];
+    char tmp_path[96];
+    snprintf(path, sizeof(path), "/tmp/sc_metrics_%d.prom", (int)getpid());
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%d", path, (int)getpid());
+    ASSERT_TRUE(write_string_to_file(path, "stale\n"));
+
+    Metrics *metrics = metrics_create(1);
+    ASSERT_NOT_NULL(metrics);
+    ASSERT_TRUE(metrics_set_target(metrics, 0, "app@db1:5432/app/public", METRICS_TARGET_OK,
+                                   NULL, 1.0, 1.0));
+    ASSERT_TRUE(metrics_write(metrics, path));
+
+    char *text = read_file_to_string(path);
+    ASSERT_NOT_NULL(text);
+    ASSERT_NULL(strstr(text, "stale"));
+    ASSERT_NOT_NULL(strstr(text, "schema_compare_target_up{target=\"app@db1:5432/app/public\"} 1\n"));
+    ASSERT_TRUE(access(tmp_path, F_OK) != 0);
+
+    free(text);
+    metrics_free(metrics);
+    unlink(path);
+    TEST_PASS();
+}
+
+/* Test suite definition */
+static TestCase metrics_tests[] = {
+    {"format_groups_samples_by_family", test_metrics_format_groups_samples_by_family, "metrics"},
+    {"stats_tracing_records_no_events", test_metrics_stats_tracing_records_no_events, "metrics"},
+    {"write_replaces_file", test_metrics_write_replaces_file, "metrics"},
+};
+
+void run_metrics_tests(void) {
+    run_test_suite("metrics", NULL, NULL, metrics_tests,
+                   sizeof(metrics_tests) / sizeof(metrics_tests[0]));
+}
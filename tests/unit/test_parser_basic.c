@@ -253,6 +253,56 @@ TEST_CASE(parser_basic, combined_modifiers) {
     TEST_PASS();
 }
 
+/* Test: Parse several statements in one source */
+TEST_CASE(parser_basic, parse_all_statements_multiple) {
+    Parser *parser = parser_create(
+        "CREATE TABLE a (id INTEGER);\n"
+        "CREATE TYPE mood AS ENUM ('sad', 'happy');\n"
+        "CREATE TEMP TABLE b (id INTEGER, name TEXT);\n"
+        "CREATE TABLE c (id INTEGER)");
+    ASSERT_NOT_NULL(parser);
+
+    Schema *schema = parse_all_statements(parser);
+    ASSERT_NOT_NULL(schema);
+    ASSERT_FALSE(parser->had_error);
+    ASSERT_EQ(schema->table_count, 3);
+    ASSERT_EQ(schema->type_count, 1);
+    ASSERT_STR_EQ(schema->tables[0]->table_name, "a");
+    ASSERT_STR_EQ(schema->tables[1]->table_name, "b");
+    ASSERT_STR_EQ(schema->tables[2]->table_name, "c");
+
+    for (int i = 0; i < schema->table_count; i++) {
+        free_create_table_stmt(schema->tables[i]);
+    }
+    free_create_type_stmt(schema->types[0]);
+    parser_destroy(parser);
+    TEST_PASS();
+}
+
+/* Test: A bad table element does not stall parsing of later statements */
+TEST_CASE(parser_basic, parse_all_statements_recovers) {
+    Parser *parser = parser_create(
+        "CREATE TABLE a (id INTEGER, CHECK (id IS NOT NULL OR id = 1));\n"
+        "CREATE TABLE b (id INTEGER);");
+    ASSERT_NOT_NULL(parser);
+
+    Schema *schema = parse_all_statements(parser);
+    ASSERT_NOT_NULL(schema);
+    ASSERT_TRUE(parser->had_error);
+
+    bool found_b = false;
+    for (int i = 0; i < schema->table_count; i++) {
+        if (strcmp(schema->tables[i]->table_name, "b") == 0) {
+            found_b = true;
+        }
+        free_create_table_stmt(schema->tables[i]);
+    }
+    ASSERT_TRUE(found_b);
+
+    parser_destroy(parser);
+    TEST_PASS();
+}
+
 /* Test suite definition */
 static TestCase parser_basic_tests[] = {
     {"parse_simple_table", test_parser_basic_parse_simple_table, "parser_basic"},
@@ -270,6 +320,8 @@ static TestCase parser_basic_tests[] = {
     {"whitespace_handling", test_parser_basic_whitespace_handling, "parser_basic"},
     {"with_comments", test_parser_basic_with_comments, "parser_basic"},
     {"combined_modifiers", test_parser_basic_combined_modifiers, "parser_basic"},
+    {"parse_all_statements_multiple", test_parser_basic_parse_all_statements_multiple, "parser_basic"},
+    {"parse_all_statements_recovers", test_parser_basic_parse_all_statements_recovers, "parser_basic"},
 };
 
 void run_parser_basic_tests(void) {
@@ -0,0 +1,356 @@
+#include "../test_framework.h"
+#include "pipeline.h"
+#include "result_collector.h"
+#include <pthread.h>
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TARGET_COUNT 6
+
+static char g_dir[64];
+
+typedef struct {
+    int calls;
+    int order[TARGET_COUNT];
+    int added[TARGET_COUNT];
+    bool ok[TARGET_COUNT];
+    bool had_sql[TARGET_COUNT];
+} WriteLog;
+
+static bool record_write(const PipelineTarget *target, void *user_data) {
+    WriteLog *log = user_data;
+    if (log->calls < TARGET_COUNT) {
+        log->order[log->calls] = target->index;
+        log->ok[log->calls] = target->ok;
+        log->added[log->calls] = target->diff ? target->diff->tables_added : -1;
+        log->had_sql[log->calls] = target->migration != NULL;
+    }
+    log->calls++;
+    return true;
+}
+
+static char *write_sql_file(const char *name, const char *sql) {
+    char *path = malloc(128);
+    snprintf(path, 128, "%s/%s", g_dir, name);
+    if (!write_string_to_file(path, sql)) {
+        free(path);
+        return NULL;
+    }
+    return path;
+}
+
+/* Source with three tables; target i has the first (i % 3) of them */
+static bool setup_sources(SchemaSource **source, SchemaSource **targets) {
+    static const char *tables[] = {
+        "CREATE TABLE a (id integer);\n",
+        "CREATE TABLE b (id integer);\n",
+        "CREATE TABLE c (id integer);\n",
+    };
+
+    snprintf(g_dir, sizeof(g_dir), "/tmp/sc_pipeline_XXXXXX");
+    if (!mkdtemp(g_dir)) {
+        return false;
+    }
+
+    char sql[256] = "";
+    for (int t = 0; t < 3; t++) {
+        strcat(sql, tables[t]);
+    }
+    char *path = write_sql_file("source.sql", sql);
+    *source = path ? parse_schema_source(path) : NULL;
+    free(path);
+
+    for (int i = 0; i < TARGET_COUNT; i++) {
+        char name[32];
+        sql[0] = '\0';
+        for (int t = 0; t < i % 3; t++) {
+            strcat(sql, tables[t]);
+        }
+        strcat(sql, "CREATE TABLE legacy (id integer);\n");
+        snprintf(name, sizeof(name), "target%d.sql", i);
+        path = write_sql_file(name, sql);
+        targets[i] = path ? parse_schema_source(path) : NULL;
+        free(path);
+        if (!targets[i]) {
+            return false;
+        }
+    }
+    return *source != NULL;
+}
+
+static void teardown_sources(SchemaSource *source, SchemaSource **targets) {
+    char path[128];
+    schema_source_free(source);
+    snprintf(path, sizeof(path), "%s/source.sql", g_dir);
+    unlink(path);
+    for (int i = 0; i < TARGET_COUNT; i++) {
+        schema_source_free(targets[i]);
+        snprintf(path, sizeof(path), "%s/target%d.sql", g_dir, i);
+        unlink(path);
+    }
+    rmdir(g_dir);
+}
+
+static PipelineConfig make_config(SchemaSource *source, SchemaSource **targets,
+                                  CompareOptions *compare_opts, SQLGenOptions *sql_opts) {
+    PipelineConfig config = {
+        .source = source,
+        .targets = targets,
+        .target_count = TARGET_COUNT,
+        .compare_opts = compare_opts,
+        .sql_opts = sql_opts,
+        .generate_sql = true,
+    };
+    return config;
+}
+
+/* Test: Every target is written once, in target order, for any job counts */
+TEST_CASE(pipeline, writes_in_target_order) {
+    SchemaSource *source = NULL;
+    SchemaSource *targets[TARGET_COUNT] = {0};
+    ASSERT_TRUE(setup_sources(&source, targets));
+    CompareOptions *compare_opts = compare_options_default();
+    SQLGenOptions *sql_opts = sql_gen_options_default();
+
+    int jobs[][2] = {{1, 1}, {4, 2}, {8, 8}};
+    for (int j = 0; j < 3; j++) {
+        PipelineConfig config = make_config(source, targets, compare_opts, sql_opts);
+        config.fetch_jobs = jobs[j][0];
+        config.compare_jobs = jobs[j][1];
+
+        WriteLog log = {0};
+        PipelineSummary summary;
+        ASSERT_TRUE(pipeline_run(&config, record_write, &log, &summary));
+        ASSERT_TRUE(summary.source_ok);
+        ASSERT_EQ(summary.source_table_count, 3);
+        ASSERT_EQ(summary.targets_written, TARGET_COUNT);
+        ASSERT_EQ(summary.targets_failed, 0);
+        ASSERT_EQ(log.calls, TARGET_COUNT);
+        for (int i = 0; i < TARGET_COUNT; i++) {
+            ASSERT_EQ(log.order[i], i);
+            ASSERT_TRUE(log.ok[i]);
+            ASSERT_TRUE(log.had_sql[i]);
+            ASSERT_EQ(log.added[i], 3 - i % 3);
+        }
+    }
+
+    sql_gen_options_free(sql_opts);
+    compare_options_free(compare_opts);
+    teardown_sources(source, targets);
+    TEST_PASS();
+}
+
+/* Test: A failing target is reported in place without stopping the others */
+TEST_CASE(pipeline, failed_target_reported_in_order) {
+    SchemaSource *source = NULL;
+    SchemaSource *targets[TARGET_COUNT] = {0};
+    ASSERT_TRUE(setup_sources(&source, targets));
+    CompareOptions *compare_opts = compare_options_default();
+    SQLGenOptions *sql_opts = sql_gen_options_default();
+
+    /* Target 2's file disappears after its spec was parsed */
+    unlink(targets[2]->source.file_path);
+
+    PipelineConfig config = make_config(source, targets, compare_opts, sql_opts);
+    config.fetch_jobs = 3;
+    config.compare_jobs = 2;
+    WriteLog log = {0};
+    PipelineSummary summary;
+    ASSERT_TRUE(pipeline_run(&config, record_write, &log, &summary));
+    ASSERT_EQ(summary.targets_written, TARGET_COUNT - 1);
+    ASSERT_EQ(summary.targets_failed, 1);
+    ASSERT_EQ(log.calls, TARGET_COUNT);
+    ASSERT_EQ(log.order[2], 2);
+    ASSERT_FALSE(log.ok[2]);
+    ASSERT_TRUE(log.ok[3]);
+
+    sql_gen_options_free(sql_opts);
+    compare_options_free(compare_opts);
+    teardown_sources(source, targets);
+    TEST_PASS();
+}
+
+typedef struct {
+    WriteLog log;
+    int source_tables;           /* seen by the source hook */
+} HookLog;
+
+static void record_source(const Schema *source, void *user_data) {
+    ((HookLog *)user_data)->source_tables = source->table_count;
+}
+
+static bool skip_even_targets(int index, void *user_data) {
+    return ((HookLog *)user_data)->source_tables == 3 && index % 2 == 0;
+}
+
+static bool record_hooked_write(const PipelineTarget *target, void *user_data) {
+    HookLog *hooks = user_data;
+    if (target->skipped && (target->diff || target->schema)) {
+        return false;
+    }
+    return record_write(target, &hooks->log);
+}
+
+/* Test: Skipped targets reach the writer without being fetched or compared */
+TEST_CASE(pipeline, skip_hook_bypasses_fetch_and_compare) {
+    SchemaSource *source = NULL;
+    SchemaSource *targets[TARGET_COUNT] = {0};
+    ASSERT_TRUE(setup_sources(&source, targets));
+    CompareOptions *compare_opts = compare_options_default();
+    SQLGenOptions *sql_opts = sql_gen_options_default();
+
+    PipelineConfig config = make_config(source, targets, compare_opts, sql_opts);
+    config.fetch_jobs = 2;
+    config.source_loaded = record_source;
+    config.skip = skip_even_targets;
+    HookLog hooks = {0};
+    PipelineSummary summary;
+    ASSERT_TRUE(pipeline_run(&config, record_hooked_write, &hooks, &summary));
+    ASSERT_EQ(summary.targets_skipped, TARGET_COUNT / 2);
+    ASSERT_EQ(summary.targets_written, TARGET_COUNT / 2);
+    ASSERT_EQ(summary.targets_failed, 0);
+    ASSERT_EQ(hooks.log.calls, TARGET_COUNT);
+    for (int i = 0; i < TARGET_COUNT; i++) {
+        ASSERT_EQ(hooks.log.order[i], i);
+        ASSERT_EQ(hooks.log.had_sql[i], i % 2 == 1);
+    }
+
+    sql_gen_options_free(sql_opts);
+    compare_options_free(compare_opts);
+    teardown_sources(source, targets);
+    TEST_PASS();
+}
+
+/* Test: Without a source nothing is written */
+TEST_CASE(pipeline, source_failure_writes_nothing) {
+    SchemaSource *source = NULL;
+    SchemaSource *targets[TARGET_COUNT] = {0};
+    ASSERT_TRUE(setup_sources(&source, targets));
+    CompareOptions *compare_opts = compare_options_default();
+    SQLGenOptions *sql_opts = sql_gen_options_default();
+
+    unlink(source->source.file_path);
+
+    PipelineConfig config = make_config(source, targets, compare_opts, sql_opts);
+    WriteLog log = {0};
+    PipelineSummary summary;
+    ASSERT_FALSE(pipeline_run(&config, record_write, &log, &summary));
+    ASSERT_FALSE(summary.source_ok);
+    ASSERT_EQ(log.calls, 0);
+
+    sql_gen_options_free(sql_opts);
+    compare_options_free(compare_opts);
+    teardown_sources(source, targets);
+    TEST_PASS();
+}
+
+/* Test: A URI's ?schema= names its schema; server-side comparison needs
+ * both sources on the same server and database */
+TEST_CASE(pipeline, uri_schema_and_shared_database) {
+    SchemaSource *staging = parse_schema_source("postgresql://app@db1:5433/shop?schema=staging_x");
+    SchemaSource *prod = parse_schema_source("postgresql://db1:5433/shop?sslmode=off&schema=prod_x");
+    SchemaSource *other = parse_schema_source("postgresql://db1:5433/shop_archive");
+    ASSERT_NOT_NULL(staging);
+    ASSERT_NOT_NULL(prod);
+    ASSERT_NOT_NULL(other);
+
+    ASSERT_STR_EQ(staging->database_name, "shop");
+    ASSERT_STR_EQ(staging->schema_name, "staging_x");
+    ASSERT_STR_EQ(prod->schema_name, "prod_x");
+    ASSERT_NULL(other->schema_name);
+
+    ASSERT_TRUE(schema_sources_share_database(staging, prod));
+    ASSERT_FALSE(schema_sources_share_database(staging, other));
+
+    schema_source_free(staging);
+    schema_source_free(prod);
+    schema_source_free(other);
+    TEST_PASS();
+}
+
+#define COLLECTOR_TARGETS 64
+#define COLLECTOR_WORKERS 4
+
+/* Each worker pushes its share of the targets, highest index first */
+static void *push_descending(void *arg) {
+    ResultCollector *collector = ((void **)arg)[0];
+    int worker = *(int *)((void **)arg)[1];
+    for (int i = COLLECTOR_TARGETS - 1 - worker; i >= 0; i -= COLLECTOR_WORKERS) {
+        result_collector_push(collector, i);
+    }
+    return NULL;
+}
+
+/* Test: Targets pushed out of order from many threads come out in order */
+TEST_CASE(pipeline, collector_hands_out_in_order) {
+    ResultCollector *collector = result_collector_create(COLLECTOR_TARGETS);
+    ASSERT_NOT_NULL(collector);
+
+    pthread_t threads[COLLECTOR_WORKERS];
+    int workers[COLLECTOR_WORKERS];
+    void *args[COLLECTOR_WORKERS][2];
+    for (int w = 0; w < COLLECTOR_WORKERS; w++) {
+        workers[w] = w;
+        args[w][0] = collector;
+        args[w][1] = &workers[w];
+        ASSERT_EQ(pthread_create(&threads[w], NULL, push_descending, args[w]), 0);
+    }
+
+    for (int i = 0; i < COLLECTOR_TARGETS; i++) {
+        ASSERT_EQ(result_collector_next(collector), i);
+        result_collector_add(collector, i % 2 ? RESULT_WRITTEN : RESULT_FAILED);
+    }
+    ASSERT_EQ(result_collector_next(collector), -1);
+    for (int w = 0; w < COLLECTOR_WORKERS; w++) {
+        pthread_join(threads[w], NULL);
+    }
+
+    ASSERT_EQ(result_collector_finished(collector), COLLECTOR_TARGETS);
+    ASSERT_EQ(result_collector_count(collector, RESULT_WRITTEN), COLLECTOR_TARGETS / 2);
+    ASSERT_EQ(result_collector_count(collector, RESULT_FAILED), COLLECTOR_TARGETS / 2);
+    ASSERT_EQ(result_collector_count(collector, RESULT_SKIPPED), 0);
+    result_collector_free(collector);
+    TEST_PASS();
+}
+
+static void *abort_collector(void *arg) {
+    struct timespec delay = {0, 10000000};
+    nanosleep(&delay, NULL);
+    result_collector_abort(arg);
+    return NULL;
+}
+
+/* Test: Abort wakes a writer waiting on an unfinished target */
+TEST_CASE(pipeline, collector_abort_wakes_writer) {
+    ResultCollector *collector = result_collector_create(3);
+    ASSERT_NOT_NULL(collector);
+    result_collector_push(collector, 1);
+
+    pthread_t thread;
+    ASSERT_EQ(pthread_create(&thread, NULL, abort_collector, collector), 0);
+    ASSERT_EQ(result_collector_next(collector), -1);
+    pthread_join(thread, NULL);
+
+    result_collector_free(collector);
+    TEST_PASS();
+}
+
+/* Test suite definition */
+static TestCase pipeline_tests[] = {
+    {"writes_in_target_order", test_pipeline_writes_in_target_order, "pipeline"},
+    {"failed_target_reported_in_order", test_pipeline_failed_target_reported_in_order, "pipeline"},
+    {"skip_hook_bypasses_fetch_and_compare", test_pipeline_skip_hook_bypasses_fetch_and_compare, "pipeline"},
+    {"source_failure_writes_nothing", test_pipeline_source_failure_writes_nothing, "pipeline"},
+    {"uri_schema_and_shared_database", test_pipeline_uri_schema_and_shared_database, "pipeline"},
+    {"collector_hands_out_in_order", test_pipeline_collector_hands_out_in_order, "pipeline"},
+    {"collector_abort_wakes_writer", test_pipeline_collector_abort_wakes_writer, "pipeline"},
+};
+
+void run_pipeline_tests(void) {
+    run_test_suite("pipeline", NULL, NULL, pipeline_tests,
+                   sizeof(pipeline_tests) / sizeof(pipeline_tests[0]));
+}
@@ -0,0 +1,257 @@
+#include "../test_framework.h"
+#include "server.h"
+#include "utils.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+static char g_source_path[64];
+
+/* Write a two-table source file and start a server on it */
+static Server *create_test_server(CompareOptions *compare_opts, ReportOptions *report_opts,
+                                  SQLGenOptions *sql_opts, const char *socket_path) {
+    snprintf(g_source_path, sizeof(g_source_path), "/tmp/sc_server_test_%d.sql", (int)getpid());
+    if (!write_string_to_file(g_source_path,
+                              "CREATE TABLE users (id integer PRIMARY KEY, name text);\n"
+                              "CREATE TABLE orders (id integer, user_id integer);\n")) {
+        return NULL;
+    }
+
+    ServerConfig config = {0};
+    config.source_spec = g_source_path;
+    config.socket_path = socket_path;
+    config.pool_size = 1;
+    config.compare_opts = compare_opts;
+    config.report_opts = report_opts;
+    config.sql_opts = sql_opts;
+    return server_create(&config);
+}
+
+/* Test: ping, stats and reload answer against the warm source */
+TEST_CASE(server, basic_ops) {
+    CompareOptions *compare_opts = compare_options_default();
+    ReportOptions *report_opts = report_options_default();
+    SQLGenOptions *sql_opts = sql_gen_options_default();
+    Server *server = create_test_server(compare_opts, report_opts, sql_opts, NULL);
+    ASSERT_NOT_NULL(server);
+
+    char *response = server_handle_request(server, "{\"op\":\"ping\",\"id\":7}");
+    ASSERT_NOT_NULL(response);
+    ASSERT_TRUE(strncmp(response, "{\"ok\":true,\"id\":7,\"elapsed_ms\":", 31) == 0);
+    free(response);
+
+    response = server_handle_request(server, "{\"op\":\"stats\"}");
+    ASSERT_NOT_NULL(strstr(response, "\"source_tables\":2"));
+    ASSERT_NOT_NULL(strstr(response, "\"requests\":2"));
+    ASSERT_NOT_NULL(strstr(response, "\"pool\":{"));
+    free(response);
+
+    /* Reload picks up file changes */
+    ASSERT_TRUE(write_string_to_file(g_source_path, "CREATE TABLE only_one (id integer);\n"));
+    response = server_handle_request(server, "{\"op\":\"reload\",\"id\":\"r1\"}");
+    ASSERT_NOT_NULL(strstr(response, "\"ok\":true,\"id\":\"r1\""));
+    ASSERT_NOT_NULL(strstr(response, "\"source_tables\":1"));
+    free(response);
+
+    ASSERT_FALSE(server_should_stop(server));
+    response = server_handle_request(server, "{\"op\":\"shutdown\"}");
+    ASSERT_NOT_NULL(strstr(response, "\"ok\":true"));
+    ASSERT_TRUE(server_should_stop(server));
+    free(response);
+
+    server_destroy(server);
+    unlink(g_source_path);
+    compare_options_free(compare_opts);
+    report_options_free(report_opts);
+    sql_gen_options_free(sql_opts);
+    TEST_PASS();
+}
+
+/* Test: Bad requests get an error response and are counted */
+TEST_CASE(server, error_responses) {
+    CompareOptions *compare_opts = compare_options_default();
+    ReportOptions *report_opts = report_options_default();
+    SQLGenOptions *sql_opts = sql_gen_options_default();
+    Server *server = create_test_server(compare_opts, report_opts, sql_opts, NULL);
+    ASSERT_NOT_NULL(server);
+
+    const char *requests[] = {
+        "not json",
+        "{\"id\":1}",
+        "{\"op\":\"explode\"}",
+        "{\"op\":\"compare\"}",
+        "{\"op\":\"check\",\"target\":\"/tmp\"}",
+        "{\"op\":\"compare\",\"target\":\"postgresql://localhost/db\",\"format\":\"xml\"}",
+        "{\"op\":\"generate\",\"target\":\"postgresql://127.0.0.1:1/nodb\"}",
+    };
+    int count = (int)(sizeof(requests) / sizeof(requests[0]));
+    for (int i = 0; i < count; i++) {
+        char *response = server_handle_request(server, requests[i]);
+        ASSERT_NOT_NULL(response);
+        ASSERT_TRUE(strncmp(response, "{\"ok\":false", 11) == 0);
+        ASSERT_NOT_NULL(strstr(response, "\"error\":"));
+        free(response);
+    }
+
+    char *response = server_handle_request(server, "{\"op\":\"stats\"}");
+    char expected[32];
+    snprintf(expected, sizeof(expected), "\"errors\":%d", count);
+    ASSERT_NOT_NULL(strstr(response, expected));
+    free(response);
+
+    server_destroy(server);
+    unlink(g_source_path);
+    compare_options_free(compare_opts);
+    report_options_free(report_opts);
+    sql_gen_options_free(sql_opts);
+    TEST_PASS();
+}
+
+static void *run_server_thread(void *arg) {
+    server_run(arg);
+    return NULL;
+}
+
+/* Connect to the server's socket, waiting for it to start listening */
+static int connect_test_socket(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    for (int attempt = 0; attempt < 500; attempt++) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+            return fd;
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+        struct timespec pause = {0, 10000000};
+        nanosleep(&pause, NULL);
+    }
+    return -1;
+}
+
+/* Read until lines newlines arrived or timeout_ms passed without data;
+ * returns the number of lines read */
+static int read_lines(int fd, int lines, int timeout_ms) {
+    int seen = 0;
+    char chunk[4096];
+    while (seen < lines) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, timeout_ms) <= 0) {
+            break;
+        }
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < n; i++) {
+            seen += chunk[i] == '\n';
+        }
+    }
+    return seen;
+}
+
+/* Test: A client that never reads its responses does not hold up others */
+TEST_CASE(server, slow_reader_isolated) {
+    CompareOptions *compare_opts = compare_options_default();
+    ReportOptions *report_opts = report_options_default();
+    SQLGenOptions *sql_opts = sql_gen_options_default();
+    char socket_path[64];
+    snprintf(socket_path, sizeof(socket_path), "/tmp/sc_server_test_%d.sock", (int)getpid());
+    Server *server = create_test_server(compare_opts, report_opts, sql_opts, socket_path);
+    ASSERT_NOT_NULL(server);
+
+    pthread_t thread;
+    ASSERT_EQ(pthread_create(&thread, NULL, run_server_thread, server), 0);
+
+    /* The slow client sends pings (more replies than the socket buffers
+     * hold) until the server stops taking them, and reads nothing */
+    int slow = connect_test_socket(socket_path);
+    ASSERT_TRUE(slow >= 0);
+    ASSERT_TRUE(fcntl(slow, F_SETFL, fcntl(slow, F_GETFL) | O_NONBLOCK) == 0);
+    static const char ping[] = "{\"op\":\"ping\"}\n";
+    size_t line_length = sizeof(ping) - 1;
+    size_t sent = 0;
+    int stalls = 0;
+    while (sent < 40000 * line_length && stalls < 100) {
+        size_t offset = sent % line_length;
+        ssize_t n = write(slow, ping + offset, line_length - offset);
+        if (n > 0) {
+            sent += (size_t)n;
+            stalls = 0;
+        } else if (n < 0 && errno == EAGAIN) {
+            struct timespec pause = {0, 1000000};
+            nanosleep(&pause, NULL);
+            stalls++;
+        } else {
+            break;
+        }
+    }
+    ASSERT_TRUE(sent > 1000 * line_length);
+
+    int other = connect_test_socket(socket_path);
+    ASSERT_TRUE(other >= 0);
+    ASSERT_TRUE(write(other, ping, line_length) == (ssize_t)line_length);
+    ASSERT_EQ(read_lines(other, 1, 5000), 1);
+
+    /* Once the slow client reads, every complete request it sent is answered */
+    int slow_fd_flags = fcntl(slow, F_GETFL);
+    ASSERT_TRUE(fcntl(slow, F_SETFL, slow_fd_flags & ~O_NONBLOCK) == 0);
+    ASSERT_EQ(read_lines(slow, (int)(sent / line_length), 5000), (int)(sent / line_length));
+    close(slow);
+
+    static const char shutdown_request[] = "{\"op\":\"shutdown\"}\n";
+    ASSERT_TRUE(write(other, shutdown_request, sizeof(shutdown_request) - 1) ==
+                (ssize_t)(sizeof(shutdown_request) - 1));
+    ASSERT_EQ(read_lines(other, 1, 5000), 1);
+    close(other);
+    pthread_join(thread, NULL);
+
+    server_destroy(server);
+    unlink(g_source_path);
+    compare_options_free(compare_opts);
+    report_options_free(report_opts);
+    sql_gen_options_free(sql_opts);
+    TEST_PASS();
+}
+
+/* Test: A source that cannot be loaded fails server creation */
+TEST_CASE(server, missing_source) {
+    CompareOptions *compare_opts = compare_options_default();
+    ReportOptions *report_opts = report_options_default();
+    SQLGenOptions *sql_opts = sql_gen_options_default();
+
+    ServerConfig config = {0};
+    config.source_spec = "/nonexistent/schema.sql";
+    config.compare_opts = compare_opts;
+    config.report_opts = report_opts;
+    config.sql_opts = sql_opts;
+    ASSERT_NULL(server_create(&config));
+
+    compare_options_free(compare_opts);
+    report_options_free(report_opts);
+    sql_gen_options_free(sql_opts);
+    TEST_PASS();
+}
+
+/* Test suite definition */
+static TestCase server_tests[] = {
+    {"basic_ops", test_server_basic_ops, "server"},
+    {"error_responses", test_server_error_responses, "server"},
+    {"slow_reader_isolated", test_server_slow_reader_isolated, "server"},
+    {"missing_source", test_server_missing_source, "server"},
+};
+
+void run_server_tests(void) {
+    run_test_suite("server", NULL, NULL, server_tests,
+                   sizeof(server_tests) / sizeof(server_tests[0]));
+}
@@ -1,7 +1,9 @@
 #include "../test_framework.h"
 #include "sql_generator.h"
+#include "schema_compare.h"
 #include "diff.h"
 #include "utils.h"
+#include <stdlib.h>
 #include <string.h>
 
 /* Test: SQL generation options default */
@@ -265,6 +267,59 @@ TEST_CASE(sql_generator, generate_migration_empty) {
     TEST_PASS();
 }
 
+/* Test: Migrations against an introspected target start with a digest guard */
+TEST_CASE(sql_generator, generate_migration_precondition) {
+    Schema *current = load_from_string(
+        "CREATE TABLE users (id INTEGER);"
+        "CREATE TABLE audit (id INTEGER);", NULL);
+    Schema *desired = load_from_string(
+        "CREATE TABLE users (id INTEGER, name TEXT);"
+        "CREATE TABLE orders (id INTEGER);", NULL);
+    ASSERT_NOT_NULL(current);
+    ASSERT_NOT_NULL(desired);
+
+    SchemaDiff *diff = compare_schemas(current, desired, NULL, NULL);
+    ASSERT_NOT_NULL(diff);
+    SQLGenOptions *opts = sql_gen_options_default();
+
+    /* Parsed from DDL: nothing to check against */
+    SQLMigration *migration = generate_migration_sql(diff, opts);
+    ASSERT_NOT_NULL(migration);
+    ASSERT_NULL(strstr(migration->forward_sql, "$precondition$"));
+    int statement_count = migration->statement_count;
+    sql_migration_free(migration);
+
+    for (int i = 0; i < current->table_count; i++) {
+        bool users = strcmp(current->tables[i]->table_name, "users") == 0;
+        current->tables[i]->catalog_digest = strdup(users ? "d1" : "d2");
+        current->tables[i]->relid = users ? 16384 : 0;
+    }
+    migration = generate_migration_sql(diff, opts);
+    ASSERT_NOT_NULL(migration);
+    const char *sql = migration->forward_sql;
+    const char *guard = strstr(sql, "DO $precondition$");
+    ASSERT_NOT_NULL(guard);
+    /* Introspected tables are matched by OID when they have one */
+    ASSERT_NOT_NULL(strstr(sql, "('users', 16384, 'd1')"));
+    ASSERT_NOT_NULL(strstr(sql, "('audit', NULL, 'd2')"));
+    ASSERT_NOT_NULL(strstr(sql, "('orders', NULL, NULL)"));
+    ASSERT_TRUE(guard < strstr(sql, "BEGIN;"));
+    /* The guard is not a migration statement */
+    ASSERT_EQ(migration->statement_count, statement_count);
+    sql_migration_free(migration);
+
+    opts->add_precondition = false;
+    migration = generate_migration_sql(diff, opts);
+    ASSERT_NULL(strstr(migration->forward_sql, "$precondition$"));
+    sql_migration_free(migration);
+
+    sql_gen_options_free(opts);
+    schema_diff_free(diff);
+    schema_free(current);
+    schema_free(desired);
+    TEST_PASS();
+}
+
 /* Test suite definition */
 static TestCase sql_generator_tests[] = {
     {"sql_gen_options_default", test_sql_generator_sql_gen_options_default, "sql_generator"},
@@ -280,6 +335,7 @@ static TestCase sql_generator_tests[] = {
     {"generate_alter_column_nullable_sql", test_sql_generator_generate_alter_column_nullable_sql, "sql_generator"},
     {"generate_alter_column_default_sql", test_sql_generator_generate_alter_column_default_sql, "sql_generator"},
     {"generate_migration_empty", test_sql_generator_generate_migration_empty, "sql_generator"},
+    {"generate_migration_precondition", test_sql_generator_generate_migration_precondition, "sql_generator"},
 };
 
 void run_sql_generator_tests(void) {
@@ -0,0 +1,157 @@
+#include "../test_framework.h"
+#include "trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Test: Spans are not recorded while tracing is disabled */
+TEST_CASE(trace, disabled_records_nothing) {
+    trace_shutdown();
+
+    int span = TRACE_BEGIN(TRACE_PHASE_PARSE, "parse_file", "a.sql");
+    ASSERT_EQ(span, -1);
+    TRACE_END(span);
+    ASSERT_EQ(trace_event_count(), 0);
+
+    TEST_PASS();
+}
+
+/* Test: Begin/end records a span with its phase */
+TEST_CASE(trace, records_span) {
+    trace_init();
+
+    int span = TRACE_BEGIN(TRACE_PHASE_CONNECT, "connect", "db1");
+    ASSERT_TRUE(span >= 0);
+    TRACE_END(span);
+
+    ASSERT_EQ(trace_event_count(), 1);
+
+    TracePhaseStats stats;
+    trace_get_phase_stats(TRACE_PHASE_CONNECT, &stats);
+    ASSERT_EQ(stats.span_count, 1);
+    ASSERT_TRUE(stats.max_ns <= stats.total_ns);
+
+    trace_get_phase_stats(TRACE_PHASE_COMPARE, &stats);
+    ASSERT_EQ(stats.span_count, 0);
+
+    trace_shutdown();
+    TEST_PASS();
+}
+
+/* Test: Nested spans of the same phase are not double counted */
+TEST_CASE(trace, nested_same_phase) {
+    trace_init();
+
+    int outer = TRACE_BEGIN(TRACE_PHASE_COMPARE, "compare_schemas", NULL);
+    int inner1 = TRACE_BEGIN(TRACE_PHASE_COMPARE, "compare_tables", "users");
+    TRACE_END(inner1);
+    int inner2 = TRACE_BEGIN(TRACE_PHASE_COMPARE, "compare_tables", "orders");
+    TRACE_END(inner2);
+    TRACE_END(outer);
+
+    ASSERT_EQ(trace_event_count(), 3);
+
+    TracePhaseStats stats;
+    trace_get_phase_stats(TRACE_PHASE_COMPARE, &stats);
+    ASSERT_EQ(stats.span_count, 1);
+
+    trace_shutdown();
+    TEST_PASS();
+}
+
+/* Test: Nested spans of a different phase count towards their own phase */
+TEST_CASE(trace, nested_other_phase) {
+    trace_init();
+
+    int outer = TRACE_BEGIN(TRACE_PHASE_INTROSPECT, "load_from_database", "public");
+    int inner = TRACE_BEGIN(TRACE_PHASE_CONNECT, "connect", NULL);
+    TRACE_END(inner);
+    TRACE_END(outer);
+
+    TracePhaseStats stats;
+    trace_get_phase_stats(TRACE_PHASE_INTROSPECT, &stats);
+    ASSERT_EQ(stats.span_count, 1);
+    trace_get_phase_stats(TRACE_PHASE_CONNECT, &stats);
+    ASSERT_EQ(stats.span_count, 1);
+
+    trace_shutdown();
+    TEST_PASS();
+}
+
+/* Test: Chrome JSON export contains complete events with escaped details */
+TEST_CASE(trace, chrome_json) {
+    trace_init();
+
+    int span = TRACE_BEGIN(TRACE_PHASE_READ, "read_file", "dir/\"quoted\".sql");
+    TRACE_END(span);
+
+    char *json = trace_to_chrome_json();
+    ASSERT_NOT_NULL(json);
+    ASSERT_TRUE(strstr(json, "\"traceEvents\"") != NULL);
+    ASSERT_TRUE(strstr(json, "\"name\":\"read_file\"") != NULL);
+    ASSERT_TRUE(strstr(json, "\"cat\":\"read\"") != NULL);
+    ASSERT_TRUE(strstr(json, "\"ph\":\"X\"") != NULL);
+    ASSERT_TRUE(strstr(json, "dir/\\\"quoted\\\".sql") != NULL);
+    free(json);
+
+    trace_shutdown();
+    TEST_PASS();
+}
+
+/* Test: Timings table lists recorded phases only */
+TEST_CASE(trace, format_timings) {
+    trace_init();
+
+    int span = TRACE_BEGIN(TRACE_PHASE_SQLGEN, "generate_migration_sql", NULL);
+    TRACE_END(span);
+
+    char *timings = trace_format_timings();
+    ASSERT_NOT_NULL(timings);
+    ASSERT_TRUE(strstr(timings, "sqlgen") != NULL);
+    ASSERT_TRUE(strstr(timings, "wall") != NULL);
+    ASSERT_TRUE(strstr(timings, "introspect") == NULL);
+    free(timings);
+
+    trace_shutdown();
+    TEST_PASS();
+}
+
+/* Test: Counters only count while enabled and are listed under the timings */
+TEST_CASE(trace, counters) {
+    TRACE_COUNT(TRACE_COUNTER_CATALOG_PLANS, 5);
+    ASSERT_EQ(trace_counter_get(TRACE_COUNTER_CATALOG_PLANS), 0);
+
+    trace_init();
+    TRACE_COUNT(TRACE_COUNTER_CATALOG_PLANS, 3);
+    TRACE_COUNT(TRACE_COUNTER_CATALOG_EXECUTIONS, 1);
+    TRACE_COUNT(TRACE_COUNTER_CATALOG_EXECUTIONS, 1);
+    ASSERT_EQ(trace_counter_get(TRACE_COUNTER_CATALOG_PLANS), 3);
+    ASSERT_EQ(trace_counter_get(TRACE_COUNTER_CATALOG_EXECUTIONS), 2);
+
+    char *timings = trace_format_timings();
+    ASSERT_NOT_NULL(timings);
+    ASSERT_NOT_NULL(strstr(timings, "catalog plans        3"));
+    ASSERT_NOT_NULL(strstr(timings, "catalog queries      2"));
+    free(timings);
+
+    trace_reset();
+    ASSERT_EQ(trace_counter_get(TRACE_COUNTER_CATALOG_PLANS), 0);
+
+    trace_shutdown();
+    TEST_PASS();
+}
+
+/* Test suite definition */
+static TestCase trace_tests[] = {
+    {"disabled_records_nothing", test_trace_disabled_records_nothing, "trace"},
+    {"records_span", test_trace_records_span, "trace"},
+    {"nested_same_phase", test_trace_nested_same_phase, "trace"},
+    {"nested_other_phase", test_trace_nested_other_phase, "trace"},
+    {"chrome_json", test_trace_chrome_json, "trace"},
+    {"format_timings", test_trace_format_timings, "trace"},
+    {"counters", test_trace_counters, "trace"},
+};
+
+void run_trace_tests(void) {
+    run_test_suite("trace", NULL, NULL, trace_tests,
+                   sizeof(trace_tests) / sizeof(trace_tests[0]));
+}
@@ -0,0 +1,175 @@
+#include "../test_framework.h"
+#include "watch.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CURRENT_SQL \
+    "CREATE TABLE users (id integer, name varchar(50));\n" \
+    "CREATE TABLE orders (id integer, user_id integer);\n" \
+    "CREATE TABLE legacy (id integer);\n"
+
+static char g_dir[64];
+
+static bool write_source_file(const char *name, const char *sql) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s", g_dir, name);
+    return write_string_to_file(path, sql);
+}
+
+static void remove_source_file(const char *name) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s", g_dir, name);
+    unlink(path);
+}
+
+/* Temp directory with a.sql (users, orders) and b.sql (items), plus the
+ * current schema to diff against */
+static Schema *setup_source(void) {
+    snprintf(g_dir, sizeof(g_dir), "/tmp/sc_watch_XXXXXX");
+    if (!mkdtemp(g_dir) ||
+        !write_source_file("a.sql", "CREATE TABLE users (id integer, name text);\n"
+                                    "CREATE TABLE orders (id integer, user_id integer);\n") ||
+        !write_source_file("b.sql", "CREATE TABLE items (id integer);\n") ||
+        !write_source_file("current.ddl", CURRENT_SQL)) {
+        return NULL;
+    }
+
+    char path[128];
+    snprintf(path, sizeof(path), "%s/current.ddl", g_dir);
+    return load_from_file(path, NULL);
+}
+
+static void teardown_source(void) {
+    remove_source_file("a.sql");
+    remove_source_file("b.sql");
+    remove_source_file("c.sql");
+    remove_source_file("current.ddl");
+    rmdir(g_dir);
+}
+
+/* Test: The initial diff matches a full compare_schemas run */
+TEST_CASE(watch, initial_diff_matches_full_compare) {
+    Schema *current = setup_source();
+    ASSERT_NOT_NULL(current);
+    CompareOptions *opts = compare_options_default();
+
+    WatchSession *session = watch_session_create(g_dir, current, opts);
+    ASSERT_NOT_NULL(session);
+    const SchemaDiff *diff = watch_session_diff(session);
+    ASSERT_NOT_NULL(diff);
+
+    Schema *source = load_from_directory(g_dir, NULL);
+    ASSERT_NOT_NULL(source);
+    SchemaDiff *full = compare_schemas(current, source, opts, NULL);
+    ASSERT_NOT_NULL(full);
+
+    ASSERT_EQ(diff->tables_added, full->tables_added);
+    ASSERT_EQ(diff->tables_removed, full->tables_removed);
+    ASSERT_EQ(diff->tables_modified, full->tables_modified);
+    ASSERT_EQ(diff->total_diffs, full->total_diffs);
+    ASSERT_EQ(diff->tables_added, 1);      /* items */
+    ASSERT_EQ(diff->tables_removed, 1);    /* legacy */
+    ASSERT_EQ(diff->tables_modified, 1);   /* users */
+
+    WatchStats stats;
+    watch_session_get_stats(session, &stats);
+    ASSERT_EQ(stats.file_count, 2);
+    ASSERT_EQ(stats.table_count, 3);
+    ASSERT_EQ(stats.files_reparsed, 2);
+
+    schema_diff_free(full);
+    schema_free(source);
+    watch_session_destroy(session);
+    compare_options_free(opts);
+    schema_free(current);
+    teardown_source();
+    TEST_PASS();
+}
+
+/* Test: Updating one file re-compares only the tables it defines */
+TEST_CASE(watch, update_recompares_affected_tables) {
+    Schema *current = setup_source();
+    ASSERT_NOT_NULL(current);
+    CompareOptions *opts = compare_options_default();
+    WatchSession *session = watch_session_create(g_dir, current, opts);
+    ASSERT_NOT_NULL(session);
+    watch_session_diff(session);
+
+    /* items goes away, legacy comes back unchanged */
+    ASSERT_TRUE(write_source_file("b.sql", "CREATE TABLE legacy (id integer);\n"));
+    char path[128];
+    snprintf(path, sizeof(path), "%s/b.sql", g_dir);
+    ASSERT_TRUE(watch_session_update_file(session, path));
+
+    const SchemaDiff *diff = watch_session_diff(session);
+    ASSERT_EQ(diff->tables_added, 0);
+    ASSERT_EQ(diff->tables_removed, 0);
+    ASSERT_EQ(diff->tables_modified, 1);
+    ASSERT_STR_EQ(diff->table_diffs->table_name, "users");
+    ASSERT_NULL(diff->table_diffs->next);
+
+    WatchStats stats;
+    watch_session_get_stats(session, &stats);
+    ASSERT_EQ(stats.files_reparsed, 1);
+    ASSERT_EQ(stats.tables_recompared, 2);
+
+    /* A file that fails to parse keeps its previous tables */
+    ASSERT_TRUE(write_source_file("b.sql", "CREATE TABLE legacy (id integer"));
+    watch_session_update_file(session, path);
+    diff = watch_session_diff(session);
+    ASSERT_EQ(diff->tables_removed, 0);
+
+    watch_session_destroy(session);
+    compare_options_free(opts);
+    schema_free(current);
+    teardown_source();
+    TEST_PASS();
+}
+
+/* Test: inotify picks up created and deleted files */
+TEST_CASE(watch, poll_applies_file_events) {
+    Schema *current = setup_source();
+    ASSERT_NOT_NULL(current);
+    CompareOptions *opts = compare_options_default();
+    WatchSession *session = watch_session_create(g_dir, current, opts);
+    ASSERT_NOT_NULL(session);
+    watch_session_diff(session);
+
+    ASSERT_EQ(watch_session_poll(session, 0), 0);
+
+    ASSERT_TRUE(write_source_file("c.sql", "CREATE TABLE audit (id integer);\n"));
+    ASSERT_EQ(watch_session_poll(session, 2000), 1);
+    const SchemaDiff *diff = watch_session_diff(session);
+    ASSERT_EQ(diff->tables_added, 2);      /* items, audit */
+
+    remove_source_file("a.sql");
+    ASSERT_EQ(watch_session_poll(session, 2000), 1);
+    diff = watch_session_diff(session);
+    ASSERT_EQ(diff->tables_removed, 3);    /* users, orders, legacy */
+    ASSERT_EQ(diff->tables_modified, 0);
+
+    /* Non-.sql files are ignored */
+    ASSERT_TRUE(write_source_file("current.ddl", CURRENT_SQL));
+    ASSERT_EQ(watch_session_poll(session, 100), 0);
+
+    watch_session_destroy(session);
+    compare_options_free(opts);
+    schema_free(current);
+    teardown_source();
+    TEST_PASS();
+}
+
+/* Test suite definition */
+static TestCase watch_tests[] = {
+    {"initial_diff_matches_full_compare", test_watch_initial_diff_matches_full_compare, "watch"},
+    {"update_recompares_affected_tables", test_watch_update_recompares_affected_tables, "watch"},
+    {"poll_applies_file_events", test_watch_poll_applies_file_events, "watch"},
+};
+
+void run_watch_tests(void) {
+    run_test_suite("watch", NULL, NULL, watch_tests,
+                   sizeof(watch_tests) / sizeof(watch_tests[0]));
+}